@@ -13,7 +13,7 @@ using namespace machinery::util;
 int
 main(int argc, char* argv[]) {
   //persistent_buffer buffer(stdout);
-  appendable_buffer buffer;
+  executable_buffer buffer;
   x86_emitter<decltype(buffer)> emit(buffer);
 
   /* Function prolog: */
@@ -21,8 +21,7 @@ main(int argc, char* argv[]) {
   emit.mov(reg64::rbp, reg64::rsp);
 
   /* Clear the RAX register: */
-  emit.mov(reg64::rax, imm64{0});
-  //emit.xor_(reg64::rax, reg64::rax); // TODO
+  emit.xor_(reg64::rax, reg64::rax);
 
   /* For each command-line argument: */
   for (auto i = 1; i < argc; i++) {
@@ -38,9 +37,9 @@ main(int argc, char* argv[]) {
   emit.ret();
 
 #if 1
-  /* Execute the code buffer and print out the result: */
-  executable_buffer exec(buffer);
-  std::printf("%d\n", exec.execute<std::int32_t>());
+  /* Seal the code in place, execute it, and print out the result: */
+  const function_handle function = buffer.finalize();
+  std::printf("%d\n", function.execute<std::int32_t>());
 #endif
 
   return EXIT_SUCCESS;
@@ -19,7 +19,24 @@
 namespace machinery {
   namespace arch {
     namespace arm {
-      using emitter = arm_emitter<class Buffer>; // FIXME
+      using emitter     = arm_emitter<class Buffer>; // FIXME
+      using arrangement = arm_arrangement;
+      using barrier     = arm_barrier;
+      using cc          = arm_cc;
+      using element     = arm_element;
+      using extend      = arm_extend;
+      using label       = arm_label;
+      using mem         = arm_mem;
+      using order       = arm_order;
+      using padding     = arm_padding;
+      using pattern     = arm_pattern;
+      using preg        = arm_preg;
+      using reg         = arm_reg;
+      using shift       = arm_shift;
+      using vreg        = arm_vreg;
+      using wreg        = arm_wreg;
+      using xreg        = arm_xreg;
+      using zreg        = arm_zreg;
     }
   }
 }
@@ -10,9 +10,37 @@
 namespace {
 
 class compiler final : public machinery::jit::compiler {
-  using emitter = machinery::arch::arm_emitter<buffer>;
+  using emitter   = machinery::arch::arm_emitter<buffer>;
+  using label     = machinery::jit::label;
+  using reg       = machinery::jit::reg;
+  using condition = machinery::jit::condition;
+  using cc        = machinery::arch::arm_cc;
+  using mem       = machinery::arch::arm_mem;
+  using xreg      = machinery::arch::arm_xreg;
 
   emitter _emitter;
+  std::size_t _emitter_label_count {0};
+
+  /**
+   * Returns the emitter label for the given compiler label, creating
+   * emitter labels as needed so that their indices coincide.
+   */
+  machinery::arch::arm_label resolve(const label target) {
+    for (; _emitter_label_count <= target.id; _emitter_label_count++) {
+      _emitter.new_label();
+    }
+    return machinery::arch::arm_label(target.id);
+  }
+
+  /**
+   * Returns the condition code for the given comparison condition.
+   */
+  static cc cc_of(const condition cond) noexcept {
+    static const cc codes[] = {
+      cc::eq, cc::ne, cc::lt, cc::le, cc::gt, cc::ge, cc::lo, cc::ls, cc::hi, cc::hs,
+    };
+    return codes[static_cast<std::size_t>(cond)];
+  }
 
 public:
   /**
@@ -27,22 +55,36 @@ public:
   virtual ~compiler() noexcept override {}
 
   virtual compiler& enter() override {
-    // TODO
+    /* Push the frame record and point the frame pointer at it: */
+    _emitter.stp(xreg::x29, xreg::x30, mem::pre_index(xreg::sp, -16));
+    _emitter.add(xreg::x29, xreg::sp, 0);
     return *this;
   }
 
-  virtual compiler& jmp(...) override {
-    // TODO
+  virtual compiler& bind(const label target) override {
+    _emitter.bind(resolve(target));
+    return *this;
+  }
+
+  virtual compiler& align(const std::size_t boundary,
+                          const machinery::jit::padding fill) override {
+    _emitter.align(boundary, (fill == machinery::jit::padding::trap) ?
+      machinery::arch::arm_padding::trap : machinery::arch::arm_padding::nop);
+    return *this;
+  }
+
+  virtual compiler& jmp(const label target) override {
+    _emitter.b(resolve(target));
     return *this;
   }
 
   virtual compiler& leave() override {
-    // TODO
+    _emitter.ldp(xreg::x29, xreg::x30, mem::post_index(xreg::sp, 16));
     return *this;
   }
 
   virtual compiler& ret() override {
-    // TODO
+    _emitter.ret();
     return *this;
   }
 
@@ -61,13 +103,15 @@ public:
     return *this;
   }
 
-  virtual compiler& clz(...) override {
-    // TODO
+  virtual compiler& clz(const reg dst, const reg src) override {
+    _emitter.clz(static_cast<xreg>(dst.id), static_cast<xreg>(src.id));
     return *this;
   }
 
-  virtual compiler& cmp(...) override {
-    // TODO
+  virtual compiler& cmp(const condition cond, const reg dst,
+                        const reg lhs, const reg rhs) override {
+    _emitter.cmp(static_cast<xreg>(lhs.id), static_cast<xreg>(rhs.id));
+    _emitter.cset(static_cast<xreg>(dst.id), cc_of(cond));
     return *this;
   }
 
@@ -10,17 +10,43 @@
  */
 
 #include "encoding.h"
+#include "../../bits/endian.h"
 
-#include <cstddef>   /* for std::size_t */
-#include <cstdint>   /* for std::uint8_t */
-#include <stdexcept> /* for std::runtime_error */
+#include <algorithm>   /* for std::copy(), std::upper_bound() */
+#include <cstddef>     /* for std::size_t */
+#include <cstdint>     /* for std::int64_t, std::uint8_t, std::uintptr_t */
+#include <stdexcept>   /* for std::invalid_argument, std::logic_error, std::out_of_range, std::runtime_error */
+#include <type_traits> /* for std::integral_constant, std::is_same */
+#include <utility>     /* for std::declval() */
+#include <vector>      /* for std::vector */
 
 namespace machinery {
   namespace arch {
     template<class Buffer> class arm_emitter;
+    class arm_label;
   }
 }
 
+/**
+ * A branch target in code emitted by an `arm_emitter`.
+ *
+ * Labels are created by `arm_emitter::new_label()`, can be referenced by
+ * branches before or after they are bound, and are only meaningful to the
+ * emitter that created them.
+ */
+class machinery::arch::arm_label final {
+public:
+  std::size_t id;
+
+  /**
+   * Constructor.
+   *
+   * @param id the label index within its emitter
+   */
+  explicit arm_label(const std::size_t id) noexcept
+    : id(id) {}
+};
+
 /**
  * ARMv8 A64 machine code emitter.
  *
@@ -28,8 +54,30 @@ namespace machinery {
  */
 template <class Buffer>
 class machinery::arch::arm_emitter {
+  /* A branch to a label, as recorded for fixups: */
+  struct branch {
+    std::size_t offset;   /* buffer offset of the instruction */
+    std::size_t label;    /* target label index */
+    std::uint32_t insn;   /* the instruction, with a zero displacement */
+    std::uint8_t bits;    /* the width of the displacement: 14, 19, or 26 */
+    bool veneer;          /* whether inverted around a `B` to the target */
+  };
+
+  /* An alignment directive, as recorded for fixups: */
+  struct alignment {
+    std::size_t offset;   /* buffer offset of the padding */
+    std::size_t boundary; /* a power of two */
+    std::size_t size;     /* current byte size of the padding */
+    arm_padding fill;
+  };
+
+  static constexpr std::size_t unbound = static_cast<std::size_t>(-1);
+
   Buffer& _buffer;
   std::size_t _buffer_start;
+  std::vector<std::size_t> _labels;
+  std::vector<branch> _branches;
+  std::vector<alignment> _alignments;
 
 public:
   /**
@@ -71,6 +119,60 @@ public:
    */
   arm_emitter& operator=(arm_emitter&& other) noexcept = default;
 
+  /**
+   * The byte size of the sequence emitted by `far_jump()`.
+   */
+  static constexpr std::size_t far_jump_size = 16;
+
+  /**
+   * Encodes a value as a bitmask immediate for `AND`, `ANDS`, `EOR`, `ORR`,
+   * and `TST`.
+   *
+   * Bitmask immediates are a repeated element of 2, 4, 8, 16, 32, or 64
+   * bits, which holds a single run of ones rotated by any amount. Neither
+   * zero nor all ones can be encoded.
+   *
+   * @param value    the value to encode
+   * @param width    the register width: 32 or 64
+   * @param encoding set to the `N:immr:imms` fields on success
+   * @return `true` if the value is encodable, `false` otherwise
+   */
+  static bool encode_bitmask(std::uint64_t value, const unsigned width,
+                             std::uint32_t& encoding) noexcept {
+    if (width == 32) {
+      value = (value & 0xFFFFFFFF) | (value << 32);
+    }
+    if (value == 0 || value == ~std::uint64_t{0}) {
+      return false;
+    }
+    /* Find the smallest element that the value repeats: */
+    unsigned size = 64;
+    while (size > 2) {
+      const unsigned half = size / 2;
+      const std::uint64_t mask = (std::uint64_t{1} << half) - 1;
+      if ((value & mask) != ((value >> half) & mask)) break;
+      size = half;
+    }
+    const std::uint64_t mask = (size == 64) ? ~std::uint64_t{0} : (std::uint64_t{1} << size) - 1;
+    const std::uint64_t element = value & mask;
+    unsigned ones = 0;
+    for (std::uint64_t bits = element; bits; bits &= bits - 1) {
+      ones++;
+    }
+    /* Find the rotation of a run of ones that yields the element: */
+    const std::uint64_t run = (std::uint64_t{1} << ones) - 1;
+    for (unsigned rotation = 0; rotation < size; rotation++) {
+      const std::uint64_t rotated = rotation ?
+        ((run >> rotation) | (run << (size - rotation))) & mask : run;
+      if (rotated == element) {
+        const std::uint32_t imms = ((~(size * 2 - 1)) & 0x3F) | (ones - 1);
+        encoding = ((size == 64) << 12) | (rotation << 6) | imms;
+        return true;
+      }
+    }
+    return false;
+  }
+
   /**
    * Returns the current buffer offset as a byte count.
    *
@@ -88,76 +190,5089 @@ public:
    *
    * @copydetails emit_instruction
    */
-  inline arm_emitter& emit(std::uint32_t insn) {
-    for (auto i = 0; i < 4; i++) {
-      _buffer.append(insn & 0xFF);
-      insn >>= 8;
+  inline arm_emitter& emit(const std::uint32_t insn) {
+    machinery::bits::store_le32(_buffer.extend(4), insn);
+    return *this;
+  }
+
+  /**
+   * Creates a new, unbound label.
+   */
+  arm_label new_label() {
+    _labels.push_back(unbound);
+    return arm_label(_labels.size() - 1);
+  }
+
+  /**
+   * Emits an `ABS` (vector absolute value) instruction.
+   *
+   * @copydetails emit_vector_instruction
+   */
+  arm_emitter& abs(const arm_vreg dst, const arm_vreg src, const arm_arrangement arrangement) {
+    return emit_simd(0x0E20B800, dst, src, 0, arrangement, no_1d);
+  }
+
+  /**
+   * Emits an `ADD` (vector add) instruction.
+   *
+   * @copydetails emit_vector_instruction
+   */
+  arm_emitter& add(const arm_vreg dst, const arm_vreg src1, const arm_vreg src2,
+                   const arm_arrangement arrangement) {
+    return emit_simd(0x0E208400, dst, src1, code_of(src2), arrangement, no_1d);
+  }
+
+  /**
+   * Emits an `ADD` (predicated add) instruction.
+   *
+   * @copydetails emit_sve_predicated_instruction
+   */
+  arm_emitter& add(const arm_zreg dst, const arm_preg pg, const arm_zreg src,
+                   const arm_element element) {
+    return emit_sve(0x04000000 | (governing_of(pg) << 10) | (code_of(src) << 5) | code_of(dst),
+                    element, any_element);
+  }
+
+  /**
+   * Emits an `ADD` (unpredicated add) instruction.
+   *
+   * @copydetails emit_sve_instruction
+   */
+  arm_emitter& add(const arm_zreg dst, const arm_zreg src1, const arm_zreg src2,
+                   const arm_element element) {
+    return emit_sve(0x04200000 | (code_of(src2) << 16) | (code_of(src1) << 5) | code_of(dst),
+                    element, any_element);
+  }
+
+  /**
+   * Emits an `ADDP` (add pairwise) instruction.
+   *
+   * @copydetails emit_vector_instruction
+   */
+  arm_emitter& addp(const arm_vreg dst, const arm_vreg src1, const arm_vreg src2,
+                    const arm_arrangement arrangement) {
+    return emit_simd(0x0E20BC00, dst, src1, code_of(src2), arrangement, no_1d);
+  }
+
+  /**
+   * Emits an `ADDV` (add across vector) instruction.
+   *
+   * Reduces the lanes of `src` into the lowest lane of `dst`, clearing the
+   * rest of it.
+   *
+   * @copydetails emit_vector_instruction
+   */
+  arm_emitter& addv(const arm_vreg dst, const arm_vreg src, const arm_arrangement arrangement) {
+    return emit_simd(0x0E31B800, dst, src, 0, arrangement, across_lanes);
+  }
+
+  /**
+   * Emits an `AND` (vector bitwise AND) instruction.
+   *
+   * @copydetails emit_vector_instruction
+   */
+  arm_emitter& and_(const arm_vreg dst, const arm_vreg src1, const arm_vreg src2,
+                    const arm_arrangement arrangement) {
+    return emit_simd(0x0E201C00, dst, src1, code_of(src2), arrangement, byte_lanes);
+  }
+
+  /**
+   * Emits an `AND` (predicated bitwise AND) instruction.
+   *
+   * @copydetails emit_sve_predicated_instruction
+   */
+  arm_emitter& and_(const arm_zreg dst, const arm_preg pg, const arm_zreg src,
+                    const arm_element element) {
+    return emit_sve(0x041A0000 | (governing_of(pg) << 10) | (code_of(src) << 5) | code_of(dst),
+                    element, any_element);
+  }
+
+  /**
+   * Emits a `B` (branch) instruction to the given label, which reaches
+   * 128 MiB either way.
+   *
+   * @copydetails emit_branch_instruction
+   */
+  arm_emitter& b(const arm_label target) {
+    return branch_to(0x14000000, 26, target);
+  }
+
+  /**
+   * Emits a `B.cond` (conditional branch) instruction to the given label.
+   *
+   * An `AL` condition emits a plain `B`.
+   *
+   * @copydetails emit_branch_instruction
+   */
+  arm_emitter& b(const arm_cc cc, const arm_label target) {
+    if (cc == arm_cc::al || cc == arm_cc::nv) {
+      return b(target);
+    }
+    return branch_to(0x54000000 | static_cast<std::uint32_t>(cc), 19, target);
+  }
+
+  /**
+   * Emits a `BIC` (vector bitwise bit clear) instruction.
+   *
+   * @copydetails emit_vector_instruction
+   */
+  arm_emitter& bic(const arm_vreg dst, const arm_vreg src1, const arm_vreg src2,
+                   const arm_arrangement arrangement) {
+    return emit_simd(0x0E601C00, dst, src1, code_of(src2), arrangement, byte_lanes);
+  }
+
+  /**
+   * Emits a `BIF` (bitwise insert if false) instruction.
+   *
+   * @copydetails emit_vector_instruction
+   */
+  arm_emitter& bif(const arm_vreg dst, const arm_vreg src1, const arm_vreg src2,
+                   const arm_arrangement arrangement) {
+    return emit_simd(0x2EE01C00, dst, src1, code_of(src2), arrangement, byte_lanes);
+  }
+
+  /**
+   * Binds the given label to the current offset, and patches all branches
+   * emitted so far that refer to it.
+   *
+   * A conditional branch reaches only 32 KiB (`TBZ`, `TBNZ`) or 1 MiB
+   * (`B.cond`, `CBZ`, `CBNZ`) either way. Any that would not reach this
+   * label is inverted to skip over a veneer, a `B` to the label inserted
+   * right after it, which reaches 128 MiB. This moves the code that
+   * follows, so the code must not contain other relative references
+   * across such a branch, such as `ADR` or literal loads.
+   *
+   * Code can only be moved in a buffer that implements `truncate()`. In
+   * others, such as a `segmented_buffer` or `persistent_buffer`, every
+   * conditional branch to a label not yet bound gets its veneer up front.
+   *
+   * @param label the label to bind
+   * @return `*this`
+   * @throws std::bad_alloc if out of memory
+   * @throws std::logic_error if the label is already bound
+   * @throws std::out_of_range if an unconditional branch cannot reach it
+   */
+  arm_emitter& bind(const arm_label label) {
+    if (_labels.at(label.id) != unbound) {
+      throw std::logic_error("label already bound");
+    }
+    _labels[label.id] = _buffer.size();
+    add_veneers(std::integral_constant<bool, rewritable()>());
+    for (const auto& entry : _branches) {
+      if (entry.label == label.id) {
+        patch_branch(entry, _labels[label.id]);
+      }
     }
     return *this;
   }
 
   /**
-   * Emits a `HINT` instruction.
+   * Returns whether the given label has been bound.
+   */
+  bool bound(const arm_label label) const {
+    return _labels.at(label.id) != unbound;
+  }
+
+  /**
+   * Returns the offset that the given label is bound to.
    *
-   * @copydetails emit_general_purpose_instruction
+   * @return a zero-based byte offset, as per `offset()`
+   * @throws std::logic_error if the label is unbound
    */
-  arm_emitter& hint(const arm_imm7 imm = 0) {
-    return emit(0xD503201F | (imm.u8 << 5));
+  std::size_t offset(const arm_label label) const {
+    if (!bound(label)) {
+      throw std::logic_error("label not bound");
+    }
+    return _labels[label.id] - _buffer_start;
   }
 
   /**
-   * Emits a `NOP` instruction.
+   * Pads the code with `NOP` or `BRK #0` instructions up to the next
+   * multiple of the given boundary.
    *
-   * @copydetails emit_general_purpose_instruction
+   * The boundary applies to the buffer offset, so the code is aligned in
+   * memory insofar as the buffer itself is.
+   *
+   * @param boundary a power of two of at least 4, e.g. 16, 32, or 64
+   * @param fill     the filler for the padding
+   * @return `*this`
+   * @throws std::bad_alloc if out of memory
+   * @throws std::invalid_argument if `boundary` is not a power of two of at
+   *         least 4
+   * @throws std::logic_error if the buffer offset is not a multiple of 4
    */
-  arm_emitter& nop() {
-    return hint(0);
+  arm_emitter& align(const std::size_t boundary,
+                     const arm_padding fill = arm_padding::nop) {
+    if (boundary < 4 || (boundary & (boundary - 1))) {
+      throw std::invalid_argument("alignment boundary must be a power of two of at least 4");
+    }
+    const std::size_t offset = _buffer.size();
+    const std::size_t size = padding_size(offset, boundary);
+    if (size & 3) {
+      throw std::logic_error("code is not aligned to instruction boundaries");
+    }
+    store_padding(_buffer.extend(size), size, fill);
+    if (boundary > 4) {
+      _alignments.push_back({offset, boundary, size, fill});
+    }
+    return *this;
   }
 
   /**
-   * Emits a `SEV` instruction.
+   * @class emit_general_purpose_instruction
    *
-   * @copydetails emit_general_purpose_instruction
+   * @return `*this`
+   * @throws std::bad_alloc if out of memory
    */
-  arm_emitter& sev() {
-    return hint(4);
+
+  /**
+   * @class emit_arithmetic_instruction
+   *
+   * Accepts these operand combinations, where `reg` is an `arm_wreg` or an
+   * `arm_xreg` and all registers have the same width unless noted:
+   *
+   * - `reg, reg, imm`, with an unsigned 12-bit immediate value, optionally
+   *   shifted left by 12 bits; the shift is chosen automatically, so the
+   *   value may be any multiple of 4096 up to `0xFFF000`;
+   * - `reg, reg, reg, shift, amount`, with the last register shifted by
+   *   `LSL`, `LSR`, or `ASR` (the default being no shift);
+   * - `reg, reg, reg, extend, amount`, with the last register zero- or
+   *   sign-extended and then shifted left by 0..4 bits; for a 64-bit
+   *   operation, this register is 32-bit unless the extension is `UXTX`
+   *   or `SXTX`.
+   *
+   * Register 31 denotes `SP` in the first and last forms, except as the
+   * target of a flag-setting instruction, and the zero register otherwise.
+   *
+   * @return `*this`
+   * @throws std::bad_alloc if out of memory
+   * @throws std::out_of_range if an immediate value, shift amount, or
+   *         extension shift is not encodable
+   * @throws std::invalid_argument if the shift is `ROR`
+   */
+
+  /**
+   * @class emit_logical_instruction
+   *
+   * Accepts these operand combinations, where `reg` is an `arm_wreg` or an
+   * `arm_xreg` and all registers have the same width:
+   *
+   * - `reg, reg, imm`, with a bitmask immediate value: a repeated element of
+   *   2, 4, 8, 16, 32, or 64 bits holding a rotated run of ones, as checked
+   *   by `encode_bitmask()`;
+   * - `reg, reg, reg, shift, amount`, with the last register shifted by
+   *   `LSL`, `LSR`, `ASR`, or `ROR` (the default being no shift).
+   *
+   * Register 31 denotes `SP` as the target of the immediate form of a
+   * non-flag-setting instruction, and the zero register otherwise.
+   *
+   * @return `*this`
+   * @throws std::bad_alloc if out of memory
+   * @throws std::invalid_argument if an immediate value is not a bitmask
+   *         immediate
+   * @throws std::out_of_range if a shift amount is not encodable
+   */
+
+  /**
+   * @class emit_bitfield_instruction
+   *
+   * @param dst   a 32- or 64-bit target register
+   * @param src   the source register of the same width
+   * @param lsb   the least significant bit of the field
+   * @param width the width of the field, at least 1
+   * @return `*this`
+   * @throws std::bad_alloc if out of memory
+   * @throws std::out_of_range if the field does not fit in the register
+   */
+
+  /**
+   * @class emit_load_store_instruction
+   *
+   * Accepts any `arm_mem` operand. An immediate offset uses the scaled,
+   * unsigned 12-bit form where it is a non-negative multiple of the access
+   * size, and the unscaled, signed 9-bit form of `LDUR` and `STUR`
+   * otherwise. Pre- and post-indexed offsets are signed 9-bit values. A
+   * register offset may be shifted by 0 or by log2 of the access size.
+   *
+   * @return `*this`
+   * @throws std::bad_alloc if out of memory
+   * @throws std::out_of_range if the offset is not encodable
+   * @throws std::invalid_argument if the index shift is not encodable
+   */
+
+  /**
+   * @class emit_load_store_unscaled_instruction
+   *
+   * Accepts an `arm_mem` operand with an immediate offset in the range
+   * -256..255, which need not be a multiple of the access size.
+   *
+   * @return `*this`
+   * @throws std::bad_alloc if out of memory
+   * @throws std::out_of_range if the offset is not encodable
+   * @throws std::invalid_argument if the operand is pre- or post-indexed or
+   *         has a register offset
+   */
+
+  /**
+   * @class emit_load_store_pair_instruction
+   *
+   * Accepts an `arm_mem` operand with an immediate offset, which may be
+   * pre- or post-indexed, and must be a multiple of the register size in
+   * the range -64..63 times that size.
+   *
+   * @return `*this`
+   * @throws std::bad_alloc if out of memory
+   * @throws std::out_of_range if the offset is not encodable
+   * @throws std::invalid_argument if the operand has a register offset
+   */
+
+  /**
+   * @class emit_atomic_instruction
+   *
+   * @param src   the operand, a 32- or 64-bit register
+   * @param dst   the register receiving the old memory contents, of the
+   *              same width
+   * @param base  the 64-bit base address register, which may be `SP`
+   * @param order the memory ordering, selecting among the plain, `A`, `L`,
+   *              and `AL` forms of the instruction
+   * @return `*this`
+   * @throws std::bad_alloc if out of memory
+   */
+
+  /**
+   * @class emit_sve_instruction
+   *
+   * Operates on scalable vector and predicate registers, whose size is a
+   * multiple of 128 bits chosen by the processor. Code that works for any
+   * size counts lanes at run time: a loop keeps a predicate of the lanes
+   * still in range with `WHILELT`, and advances by `INCW` and the like.
+   *
+   * Requires the scalable vector extension (SVE).
+   *
+   * @return `*this`
+   * @throws std::bad_alloc if out of memory
+   * @throws std::invalid_argument if the instruction does not support the
+   *         element size or a register operand
+   * @throws std::out_of_range if a multiplier does not fit
+   */
+
+  /**
+   * @class emit_sve_predicated_instruction
+   *
+   * Operates on the lanes that are active in the governing predicate `pg`,
+   * which must be one of `P0` through `P7`. The inactive lanes of `dst`
+   * keep their values, unless noted otherwise.
+   *
+   * @copydetails emit_sve_instruction
+   */
+
+  /**
+   * @class emit_sve_load_store_instruction
+   *
+   * Accepts an `arm_mem` operand with an immediate offset of -8..7 times
+   * the vector size in bytes, or with a 64-bit index register shifted left
+   * by log2 of the access size. The governing predicate `pg` must be one of
+   * `P0` through `P7`.
+   *
+   * Requires the scalable vector extension (SVE).
+   *
+   * @return `*this`
+   * @throws std::bad_alloc if out of memory
+   * @throws std::invalid_argument if the predicate, the addressing mode, or
+   *         the index is invalid
+   * @throws std::out_of_range if the offset is not encodable
+   */
+
+  /**
+   * @class emit_vector_instruction
+   *
+   * Operates on the lanes of Advanced SIMD (NEON) registers, laid out as
+   * per `arrangement`. The 64-bit arrangements use the lower half of each
+   * register and clear the upper half of `dst`.
+   *
+   * @return `*this`
+   * @throws std::bad_alloc if out of memory
+   * @throws std::invalid_argument if the instruction does not support the
+   *         arrangement
+   * @throws std::out_of_range if a shift amount or index does not fit
+   */
+
+  /**
+   * @class emit_vector_widening_instruction
+   *
+   * The arrangement is that of the narrow sources; `dst` has lanes twice
+   * as wide. A 128-bit arrangement selects the `2` form of the instruction,
+   * e.g. `SADDL2`, which reads the upper halves of the sources.
+   *
+   * @copydetails emit_vector_instruction
+   */
+
+  /**
+   * @class emit_vector_narrowing_instruction
+   *
+   * The arrangement is that of the narrow `dst`; `src` has lanes twice as
+   * wide. A 128-bit arrangement selects the `2` form of the instruction,
+   * e.g. `XTN2`, which writes the upper half of `dst` and keeps the lower.
+   *
+   * @copydetails emit_vector_instruction
+   */
+
+  /**
+   * @class emit_vector_load_store_instruction
+   *
+   * Accepts an `arm_mem` operand without an offset, or post-indexed by the
+   * number of bytes transferred.
+   *
+   * @return `*this`
+   * @throws std::bad_alloc if out of memory
+   * @throws std::invalid_argument if the instruction does not support the
+   *         arrangement or the addressing mode
+   * @throws std::out_of_range if the offset is not encodable
+   */
+
+  /**
+   * @class emit_branch_instruction
+   *
+   * @param target the label to branch to, which may be bound later
+   * @return `*this`
+   * @throws std::bad_alloc if out of memory
+   * @throws std::out_of_range if the label is bound beyond reach of a `B`
+   */
+
+  /**
+   * Emits an `ADD` (add) instruction with an immediate value.
+   *
+   * @copydetails emit_arithmetic_instruction
+   */
+  template <typename Reg>
+  arm_emitter& add(const Reg dst, const Reg src, const std::uint32_t imm) {
+    return emit_addsub_imm(0, 0, dst, src, imm);
   }
 
   /**
-   * Emits a `SEVL` instruction.
+   * Emits an `ADD` (add) instruction with a shifted register.
    *
-   * @copydetails emit_general_purpose_instruction
+   * @copydetails emit_arithmetic_instruction
    */
-  arm_emitter& sevl() {
-    return hint(5);
+  template <typename Reg>
+  arm_emitter& add(const Reg dst, const Reg src1, const Reg src2,
+                   const arm_shift shift = arm_shift::lsl, const unsigned amount = 0) {
+    return emit_addsub_shifted(0, 0, dst, src1, src2, shift, amount);
   }
 
   /**
-   * Emits a `WFE` instruction.
+   * Emits an `ADD` (add) instruction with an extended register.
    *
-   * @copydetails emit_general_purpose_instruction
+   * @copydetails emit_arithmetic_instruction
    */
-  arm_emitter& wfe() {
-    return hint(2);
+  template <typename Reg, typename Src>
+  arm_emitter& add(const Reg dst, const Reg src1, const Src src2,
+                   const arm_extend extend, const unsigned amount = 0) {
+    return emit_addsub_extended(0, 0, dst, src1, src2, extend, amount);
   }
 
   /**
-   * Emits a `WFI` instruction.
+   * Emits an `ADDS` (add, setting flags) instruction with an immediate value.
    *
-   * @copydetails emit_general_purpose_instruction
+   * @copydetails emit_arithmetic_instruction
    */
-  arm_emitter& wfi() {
-    return hint(3);
+  template <typename Reg>
+  arm_emitter& adds(const Reg dst, const Reg src, const std::uint32_t imm) {
+    return emit_addsub_imm(0, 1, dst, src, imm);
   }
 
   /**
-   * Emits a `YIELD` instruction.
+   * Emits an `ADDS` (add, setting flags) instruction with a shifted register.
+   *
+   * @copydetails emit_arithmetic_instruction
+   */
+  template <typename Reg>
+  arm_emitter& adds(const Reg dst, const Reg src1, const Reg src2,
+                    const arm_shift shift = arm_shift::lsl, const unsigned amount = 0) {
+    return emit_addsub_shifted(0, 1, dst, src1, src2, shift, amount);
+  }
+
+  /**
+   * Emits an `ADDS` (add, setting flags) instruction with an extended register.
+   *
+   * @copydetails emit_arithmetic_instruction
+   */
+  template <typename Reg, typename Src>
+  arm_emitter& adds(const Reg dst, const Reg src1, const Src src2,
+                    const arm_extend extend, const unsigned amount = 0) {
+    return emit_addsub_extended(0, 1, dst, src1, src2, extend, amount);
+  }
+
+  /**
+   * Emits an `AND` (bitwise AND) instruction with a bitmask immediate value.
+   *
+   * @copydetails emit_logical_instruction
+   */
+  template <typename Reg>
+  arm_emitter& and_(const Reg dst, const Reg src, const std::uint64_t imm) {
+    return emit_logical_imm(0, dst, src, imm);
+  }
+
+  /**
+   * Emits an `AND` (bitwise AND) instruction with a shifted register.
+   *
+   * @copydetails emit_logical_instruction
+   */
+  template <typename Reg>
+  arm_emitter& and_(const Reg dst, const Reg src1, const Reg src2,
+                    const arm_shift shift = arm_shift::lsl, const unsigned amount = 0) {
+    return emit_logical_shifted(0, 0, dst, src1, src2, shift, amount);
+  }
+
+  /**
+   * Emits an `ANDS` (bitwise AND, setting flags) instruction with a bitmask immediate value.
+   *
+   * @copydetails emit_logical_instruction
+   */
+  template <typename Reg>
+  arm_emitter& ands(const Reg dst, const Reg src, const std::uint64_t imm) {
+    return emit_logical_imm(3, dst, src, imm);
+  }
+
+  /**
+   * Emits an `ANDS` (bitwise AND, setting flags) instruction with a shifted register.
+   *
+   * @copydetails emit_logical_instruction
+   */
+  template <typename Reg>
+  arm_emitter& ands(const Reg dst, const Reg src1, const Reg src2,
+                    const arm_shift shift = arm_shift::lsl, const unsigned amount = 0) {
+    return emit_logical_shifted(3, 0, dst, src1, src2, shift, amount);
+  }
+
+  /**
+   * Emits an `ASR` (arithmetic shift right) instruction by a constant amount, an alias
+   * of `SBFM`.
    *
+   * @param dst    a 32- or 64-bit target register
+   * @param src    the source register of the same width
+   * @param amount the shift amount, less than the register width
    * @copydetails emit_general_purpose_instruction
+   * @throws std::out_of_range if `amount` is not less than the register width
    */
-  arm_emitter& yield() {
-    return hint(1);
+  template <typename Reg>
+  arm_emitter& asr(const Reg dst, const Reg src, const unsigned amount) {
+    check_shift(dst, amount);
+    return sbfm(dst, src, amount, width_of(dst) - 1);
   }
-};
+
+  /**
+   * Emits an `ASR` (arithmetic shift right) instruction by a register amount, an alias
+   * of `ASRV`.
+   *
+   * Only the low 5 or 6 bits of the amount are used, i.e. the amount is
+   * taken modulo the register width.
+   *
+   * @param dst    a 32- or 64-bit target register
+   * @param src    the source register of the same width
+   * @param amount the shift amount register of the same width
+   * @copydetails emit_general_purpose_instruction
+   */
+  template <typename Reg>
+  arm_emitter& asr(const Reg dst, const Reg src, const Reg amount) {
+    return emit_dp2(10, dst, src, amount);
+  }
+
+  /**
+   * Emits a `BFI` (bitfield insert, copying the low `width` bits of `src` to
+   * bit `lsb` of `dst`) instruction.
+   *
+   * @copydetails emit_bitfield_instruction
+   */
+  template <typename Reg>
+  arm_emitter& bfi(const Reg dst, const Reg src, const unsigned lsb, const unsigned width) {
+    check_bitfield(dst, lsb, width);
+    return bfm(dst, src, (width_of(dst) - lsb) % width_of(dst), width - 1);
+  }
+
+  /**
+   * Emits a `BFM` (bitfield move) instruction.
+   *
+   * This is the general form behind the bitfield and shift aliases, which
+   * are usually clearer.
+   *
+   * @param dst  a 32- or 64-bit target register
+   * @param src  the source register of the same width
+   * @param immr the right rotation amount
+   * @param imms the index of the most significant source bit to move
+   * @copydetails emit_general_purpose_instruction
+   * @throws std::out_of_range if `immr` or `imms` is not less than the
+   *         register width
+   */
+  template <typename Reg>
+  arm_emitter& bfm(const Reg dst, const Reg src, const unsigned immr, const unsigned imms) {
+    return emit_bitfield(1, dst, src, immr, imms);
+  }
+
+  /**
+   * Emits a `BFXIL` (bitfield extract and insert low, copying bits `lsb` and
+   * up of `src` to the low bits of `dst`) instruction.
+   *
+   * @copydetails emit_bitfield_instruction
+   */
+  template <typename Reg>
+  arm_emitter& bfxil(const Reg dst, const Reg src, const unsigned lsb, const unsigned width) {
+    check_bitfield(dst, lsb, width);
+    return bfm(dst, src, lsb, lsb + width - 1);
+  }
+
+  /**
+   * Emits a `BIC` (bitwise bit clear) instruction with a shifted register,
+   * which is inverted after shifting.
+   *
+   * @copydetails emit_logical_instruction
+   */
+  template <typename Reg>
+  arm_emitter& bic(const Reg dst, const Reg src1, const Reg src2,
+                   const arm_shift shift = arm_shift::lsl, const unsigned amount = 0) {
+    return emit_logical_shifted(0, 1, dst, src1, src2, shift, amount);
+  }
+
+  /**
+   * Emits a `BICS` (bitwise bit clear, setting flags) instruction with a shifted register,
+   * which is inverted after shifting.
+   *
+   * @copydetails emit_logical_instruction
+   */
+  template <typename Reg>
+  arm_emitter& bics(const Reg dst, const Reg src1, const Reg src2,
+                    const arm_shift shift = arm_shift::lsl, const unsigned amount = 0) {
+    return emit_logical_shifted(3, 1, dst, src1, src2, shift, amount);
+  }
+
+  /**
+   * Emits a `BIT` (bitwise insert if true) instruction.
+   *
+   * @copydetails emit_vector_instruction
+   */
+  arm_emitter& bit(const arm_vreg dst, const arm_vreg src1, const arm_vreg src2,
+                   const arm_arrangement arrangement) {
+    return emit_simd(0x2EA01C00, dst, src1, code_of(src2), arrangement, byte_lanes);
+  }
+
+  /**
+   * Emits a `BL` (branch with link) instruction to the given label.
+   *
+   * @copydetails emit_branch_instruction
+   */
+  arm_emitter& bl(const arm_label target) {
+    return branch_to(0x94000000, 26, target);
+  }
+
+  /**
+   * Emits a `BLR` (branch with link to register) instruction.
+   *
+   * @copydetails emit_general_purpose_instruction
+   */
+  arm_emitter& blr(const arm_xreg target) {
+    return emit(0xD63F0000 | (code_of(target) << 5));
+  }
+
+  /**
+   * Emits a `BR` (branch to register) instruction.
+   *
+   * @copydetails emit_general_purpose_instruction
+   */
+  arm_emitter& br(const arm_xreg target) {
+    return emit(0xD61F0000 | (code_of(target) << 5));
+  }
+
+  /**
+   * Emits a `BSL` (bitwise select) instruction.
+   *
+   * Selects each bit from `src1` where `dst` has a one, and from `src2`
+   * where it has a zero.
+   *
+   * @copydetails emit_vector_instruction
+   */
+  arm_emitter& bsl(const arm_vreg dst, const arm_vreg src1, const arm_vreg src2,
+                   const arm_arrangement arrangement) {
+    return emit_simd(0x2E601C00, dst, src1, code_of(src2), arrangement, byte_lanes);
+  }
+
+  /**
+   * Emits a `CAS` (compare and swap) instruction.
+   *
+   * Compares `cmp` with the memory at `[base]`, storing `src` there if they
+   * are equal, and loads the old memory contents into `cmp` either way.
+   *
+   * Requires the large system extensions (LSE) of ARMv8.1.
+   *
+   * @param cmp   the compared value, which receives the old value; a 32- or
+   *              64-bit register
+   * @param src   the new value, a register of the same width
+   * @param base  the 64-bit base address register, which may be `SP`
+   * @param order the memory ordering: `CAS`, `CASA`, `CASL`, or `CASAL`
+   * @copydetails emit_general_purpose_instruction
+   */
+  template <typename Reg>
+  arm_emitter& cas(const Reg cmp, const Reg src, const arm_xreg base,
+                   const arm_order order = arm_order::relaxed) {
+    return emit_ldst_ordered(0x08A07C00 | (acquire_of(order) << 22) | (release_of(order) << 15),
+      src, code_of(cmp), base);
+  }
+
+  /**
+   * Emits a `CBNZ` (compare and branch if nonzero) instruction to the
+   * given label.
+   *
+   * @copydetails emit_branch_instruction
+   */
+  template <typename Reg>
+  arm_emitter& cbnz(const Reg src, const arm_label target) {
+    return branch_to(0x35000000 | (sf_of(src) << 31) | code_of(src), 19, target);
+  }
+
+  /**
+   * Emits a `CBZ` (compare and branch if zero) instruction to the given
+   * label.
+   *
+   * @copydetails emit_branch_instruction
+   */
+  template <typename Reg>
+  arm_emitter& cbz(const Reg src, const arm_label target) {
+    return branch_to(0x34000000 | (sf_of(src) << 31) | code_of(src), 19, target);
+  }
+
+  /**
+   * Emits a `CINC` (conditional increment) instruction, an alias of
+   * `CSINC` with the inverted condition.
+   *
+   * @param dst a 32- or 64-bit target register
+   * @param src the source register of the same width
+   * @param cc  the condition, which must not be `AL` or `NV`
+   * @copydetails emit_general_purpose_instruction
+   */
+  template <typename Reg>
+  arm_emitter& cinc(const Reg dst, const Reg src, const arm_cc cc) {
+    return csinc(dst, src, src, invert(cc));
+  }
+
+  /**
+   * Emits a `CLREX` (clear exclusive monitor) instruction.
+   *
+   * @copydetails emit_general_purpose_instruction
+   */
+  arm_emitter& clrex() {
+    return emit(0xD5033F5F);
+  }
+
+  /**
+   * Emits a `CLS` (count leading sign bits) instruction.
+   *
+   * @param dst a 32- or 64-bit target register
+   * @param src the source register of the same width
+   * @copydetails emit_general_purpose_instruction
+   */
+  template <typename Reg>
+  arm_emitter& cls(const Reg dst, const Reg src) {
+    return emit_dp1(5, dst, src);
+  }
+
+  /**
+   * Emits a `CLZ` (count leading zeros) instruction.
+   *
+   * @param dst a 32- or 64-bit target register
+   * @param src the source register of the same width
+   * @copydetails emit_general_purpose_instruction
+   */
+  template <typename Reg>
+  arm_emitter& clz(const Reg dst, const Reg src) {
+    return emit_dp1(4, dst, src);
+  }
+
+  /**
+   * Emits a `CMEQ` (compare equal) instruction.
+   *
+   * Sets each lane of `dst` to all ones if the comparison holds, and to
+   * zero otherwise.
+   *
+   * @copydetails emit_vector_instruction
+   */
+  arm_emitter& cmeq(const arm_vreg dst, const arm_vreg src1, const arm_vreg src2,
+                    const arm_arrangement arrangement) {
+    return emit_simd(0x2E208C00, dst, src1, code_of(src2), arrangement, no_1d);
+  }
+
+  /**
+   * Emits a `CMEQ` (compare equal to zero) instruction.
+   *
+   * Compares each lane of `src` with zero, setting the lane of `dst` to all
+   * ones if the comparison holds, and to zero otherwise.
+   *
+   * @copydetails emit_vector_instruction
+   */
+  arm_emitter& cmeq(const arm_vreg dst, const arm_vreg src, const arm_arrangement arrangement) {
+    return emit_simd(0x0E209800, dst, src, 0, arrangement, no_1d);
+  }
+
+  /**
+   * Emits a `CMGE` (compare signed greater than or equal) instruction.
+   *
+   * Sets each lane of `dst` to all ones if the comparison holds, and to
+   * zero otherwise.
+   *
+   * @copydetails emit_vector_instruction
+   */
+  arm_emitter& cmge(const arm_vreg dst, const arm_vreg src1, const arm_vreg src2,
+                    const arm_arrangement arrangement) {
+    return emit_simd(0x0E203C00, dst, src1, code_of(src2), arrangement, no_1d);
+  }
+
+  /**
+   * Emits a `CMGE` (compare signed greater than or equal to zero) instruction.
+   *
+   * Compares each lane of `src` with zero, setting the lane of `dst` to all
+   * ones if the comparison holds, and to zero otherwise.
+   *
+   * @copydetails emit_vector_instruction
+   */
+  arm_emitter& cmge(const arm_vreg dst, const arm_vreg src, const arm_arrangement arrangement) {
+    return emit_simd(0x2E208800, dst, src, 0, arrangement, no_1d);
+  }
+
+  /**
+   * Emits a `CMGT` (compare signed greater than) instruction.
+   *
+   * Sets each lane of `dst` to all ones if the comparison holds, and to
+   * zero otherwise.
+   *
+   * @copydetails emit_vector_instruction
+   */
+  arm_emitter& cmgt(const arm_vreg dst, const arm_vreg src1, const arm_vreg src2,
+                    const arm_arrangement arrangement) {
+    return emit_simd(0x0E203400, dst, src1, code_of(src2), arrangement, no_1d);
+  }
+
+  /**
+   * Emits a `CMGT` (compare signed greater than zero) instruction.
+   *
+   * Compares each lane of `src` with zero, setting the lane of `dst` to all
+   * ones if the comparison holds, and to zero otherwise.
+   *
+   * @copydetails emit_vector_instruction
+   */
+  arm_emitter& cmgt(const arm_vreg dst, const arm_vreg src, const arm_arrangement arrangement) {
+    return emit_simd(0x0E208800, dst, src, 0, arrangement, no_1d);
+  }
+
+  /**
+   * Emits a `CMHI` (compare unsigned higher) instruction.
+   *
+   * Sets each lane of `dst` to all ones if the comparison holds, and to
+   * zero otherwise.
+   *
+   * @copydetails emit_vector_instruction
+   */
+  arm_emitter& cmhi(const arm_vreg dst, const arm_vreg src1, const arm_vreg src2,
+                    const arm_arrangement arrangement) {
+    return emit_simd(0x2E203400, dst, src1, code_of(src2), arrangement, no_1d);
+  }
+
+  /**
+   * Emits a `CMHS` (compare unsigned higher or same) instruction.
+   *
+   * Sets each lane of `dst` to all ones if the comparison holds, and to
+   * zero otherwise.
+   *
+   * @copydetails emit_vector_instruction
+   */
+  arm_emitter& cmhs(const arm_vreg dst, const arm_vreg src1, const arm_vreg src2,
+                    const arm_arrangement arrangement) {
+    return emit_simd(0x2E203C00, dst, src1, code_of(src2), arrangement, no_1d);
+  }
+
+  /**
+   * Emits a `CMLE` (compare signed less than or equal to zero) instruction.
+   *
+   * Compares each lane of `src` with zero, setting the lane of `dst` to all
+   * ones if the comparison holds, and to zero otherwise.
+   *
+   * @copydetails emit_vector_instruction
+   */
+  arm_emitter& cmle(const arm_vreg dst, const arm_vreg src, const arm_arrangement arrangement) {
+    return emit_simd(0x2E209800, dst, src, 0, arrangement, no_1d);
+  }
+
+  /**
+   * Emits a `CMLT` (compare signed less than zero) instruction.
+   *
+   * Compares each lane of `src` with zero, setting the lane of `dst` to all
+   * ones if the comparison holds, and to zero otherwise.
+   *
+   * @copydetails emit_vector_instruction
+   */
+  arm_emitter& cmlt(const arm_vreg dst, const arm_vreg src, const arm_arrangement arrangement) {
+    return emit_simd(0x0E20A800, dst, src, 0, arrangement, no_1d);
+  }
+
+  /**
+   * Emits a `CMN` (compare negative) instruction, an alias of `ADDS` with
+   * the zero register as the target.
+   *
+   * @param src the compared register
+   * @param imm the unsigned 12-bit immediate value, optionally shifted
+   *            left by 12 bits
+   * @copydetails emit_arithmetic_instruction
+   */
+  template <typename Reg>
+  arm_emitter& cmn(const Reg src, const std::uint32_t imm) {
+    return adds(static_cast<Reg>(31), src, imm);
+  }
+
+  /**
+   * Emits a `CMP` (compare) instruction, an alias of `SUBS` with the zero
+   * register as the target.
+   *
+   * @param src the compared register
+   * @param imm the unsigned 12-bit immediate value, optionally shifted
+   *            left by 12 bits
+   * @copydetails emit_arithmetic_instruction
+   */
+  template <typename Reg>
+  arm_emitter& cmp(const Reg src, const std::uint32_t imm) {
+    return subs(static_cast<Reg>(31), src, imm);
+  }
+
+  /**
+   * Emits a `CMP` (compare) instruction with a shifted register, an alias
+   * of `SUBS` with the zero register as the target.
+   *
+   * @copydetails emit_arithmetic_instruction
+   */
+  template <typename Reg>
+  arm_emitter& cmp(const Reg src1, const Reg src2,
+                   const arm_shift shift = arm_shift::lsl, const unsigned amount = 0) {
+    return subs(static_cast<Reg>(31), src1, src2, shift, amount);
+  }
+
+  /**
+   * Emits a `CMPEQ` (compare equal) instruction.
+   *
+   * Sets the lanes of `dst` that are active in `pg` and where the comparison
+   * holds, and clears the others. Also sets the condition flags from `dst`,
+   * so that `FIRST` (`MI`), `NONE` (`EQ`), and `LAST` (`CC`) can be tested.
+   *
+   * @copydetails emit_sve_instruction
+   */
+  arm_emitter& cmpeq(const arm_preg dst, const arm_preg pg, const arm_zreg src1,
+                     const arm_zreg src2, const arm_element element) {
+    return emit_sve(0x2400A000 | (code_of(src2) << 16) | (governing_of(pg) << 10) |
+      (code_of(src1) << 5) | code_of(dst), element, any_element);
+  }
+
+  /**
+   * Emits a `CMPGE` (compare signed greater than or equal) instruction.
+   *
+   * Sets the lanes of `dst` that are active in `pg` and where the comparison
+   * holds, and clears the others. Also sets the condition flags from `dst`,
+   * so that `FIRST` (`MI`), `NONE` (`EQ`), and `LAST` (`CC`) can be tested.
+   *
+   * @copydetails emit_sve_instruction
+   */
+  arm_emitter& cmpge(const arm_preg dst, const arm_preg pg, const arm_zreg src1,
+                     const arm_zreg src2, const arm_element element) {
+    return emit_sve(0x24008000 | (code_of(src2) << 16) | (governing_of(pg) << 10) |
+      (code_of(src1) << 5) | code_of(dst), element, any_element);
+  }
+
+  /**
+   * Emits a `CMPGT` (compare signed greater than) instruction.
+   *
+   * Sets the lanes of `dst` that are active in `pg` and where the comparison
+   * holds, and clears the others. Also sets the condition flags from `dst`,
+   * so that `FIRST` (`MI`), `NONE` (`EQ`), and `LAST` (`CC`) can be tested.
+   *
+   * @copydetails emit_sve_instruction
+   */
+  arm_emitter& cmpgt(const arm_preg dst, const arm_preg pg, const arm_zreg src1,
+                     const arm_zreg src2, const arm_element element) {
+    return emit_sve(0x24008010 | (code_of(src2) << 16) | (governing_of(pg) << 10) |
+      (code_of(src1) << 5) | code_of(dst), element, any_element);
+  }
+
+  /**
+   * Emits a `CMPHI` (compare unsigned higher) instruction.
+   *
+   * Sets the lanes of `dst` that are active in `pg` and where the comparison
+   * holds, and clears the others. Also sets the condition flags from `dst`,
+   * so that `FIRST` (`MI`), `NONE` (`EQ`), and `LAST` (`CC`) can be tested.
+   *
+   * @copydetails emit_sve_instruction
+   */
+  arm_emitter& cmphi(const arm_preg dst, const arm_preg pg, const arm_zreg src1,
+                     const arm_zreg src2, const arm_element element) {
+    return emit_sve(0x24000010 | (code_of(src2) << 16) | (governing_of(pg) << 10) |
+      (code_of(src1) << 5) | code_of(dst), element, any_element);
+  }
+
+  /**
+   * Emits a `CMPHS` (compare unsigned higher or same) instruction.
+   *
+   * Sets the lanes of `dst` that are active in `pg` and where the comparison
+   * holds, and clears the others. Also sets the condition flags from `dst`,
+   * so that `FIRST` (`MI`), `NONE` (`EQ`), and `LAST` (`CC`) can be tested.
+   *
+   * @copydetails emit_sve_instruction
+   */
+  arm_emitter& cmphs(const arm_preg dst, const arm_preg pg, const arm_zreg src1,
+                     const arm_zreg src2, const arm_element element) {
+    return emit_sve(0x24000000 | (code_of(src2) << 16) | (governing_of(pg) << 10) |
+      (code_of(src1) << 5) | code_of(dst), element, any_element);
+  }
+
+  /**
+   * Emits a `CMPNE` (compare not equal) instruction.
+   *
+   * Sets the lanes of `dst` that are active in `pg` and where the comparison
+   * holds, and clears the others. Also sets the condition flags from `dst`,
+   * so that `FIRST` (`MI`), `NONE` (`EQ`), and `LAST` (`CC`) can be tested.
+   *
+   * @copydetails emit_sve_instruction
+   */
+  arm_emitter& cmpne(const arm_preg dst, const arm_preg pg, const arm_zreg src1,
+                     const arm_zreg src2, const arm_element element) {
+    return emit_sve(0x2400A010 | (code_of(src2) << 16) | (governing_of(pg) << 10) |
+      (code_of(src1) << 5) | code_of(dst), element, any_element);
+  }
+
+  /**
+   * Emits a `CMTST` (compare bitwise test bits nonzero) instruction.
+   *
+   * Sets each lane of `dst` to all ones if the comparison holds, and to
+   * zero otherwise.
+   *
+   * @copydetails emit_vector_instruction
+   */
+  arm_emitter& cmtst(const arm_vreg dst, const arm_vreg src1, const arm_vreg src2,
+                     const arm_arrangement arrangement) {
+    return emit_simd(0x0E208C00, dst, src1, code_of(src2), arrangement, no_1d);
+  }
+
+  /**
+   * Emits a `CNEG` (conditional negate) instruction, an alias of `CSNEG`
+   * with the inverted condition.
+   *
+   * @param dst a 32- or 64-bit target register
+   * @param src the source register of the same width
+   * @param cc  the condition, which must not be `AL` or `NV`
+   * @copydetails emit_general_purpose_instruction
+   */
+  template <typename Reg>
+  arm_emitter& cneg(const Reg dst, const Reg src, const arm_cc cc) {
+    return csneg(dst, src, src, invert(cc));
+  }
+
+  /**
+   * Emits a `CNT` (population count) instruction.
+   *
+   * Requires the common short sequence compression (CSSC) extension of
+   * ARMv8.9.
+   *
+   * @param dst a 32- or 64-bit target register
+   * @param src the source register of the same width
+   * @copydetails emit_general_purpose_instruction
+   */
+  template <typename Reg>
+  arm_emitter& cnt(const Reg dst, const Reg src) {
+    return emit_dp1(7, dst, src);
+  }
+
+  /**
+   * Emits a `CNT` (vector population count) instruction.
+   *
+   * Counts the set bits in each byte lane.
+   *
+   * @copydetails emit_vector_instruction
+   */
+  arm_emitter& cnt(const arm_vreg dst, const arm_vreg src, const arm_arrangement arrangement) {
+    return emit_simd(0x0E205800, dst, src, 0, arrangement, byte_lanes);
+  }
+
+  /**
+   * Emits a `CNTB` (set to vector element count) instruction.
+   *
+   * Sets `dst` to the number of 8-bit lanes selected by `pattern`,
+   * multiplied by `mul`.
+   *
+   * @param mul the multiplier, in the range 1..16
+   * @copydetails emit_sve_instruction
+   */
+  arm_emitter& cntb(const arm_xreg dst, const arm_pattern pattern = arm_pattern::all,
+                    const unsigned mul = 1) {
+    return emit_sve_count(0x0420E000, dst, pattern, mul);
+  }
+
+  /**
+   * Emits a `CNTD` (set to vector element count) instruction.
+   *
+   * Sets `dst` to the number of 64-bit lanes selected by `pattern`,
+   * multiplied by `mul`.
+   *
+   * @param mul the multiplier, in the range 1..16
+   * @copydetails emit_sve_instruction
+   */
+  arm_emitter& cntd(const arm_xreg dst, const arm_pattern pattern = arm_pattern::all,
+                    const unsigned mul = 1) {
+    return emit_sve_count(0x04E0E000, dst, pattern, mul);
+  }
+
+  /**
+   * Emits a `CNTH` (set to vector element count) instruction.
+   *
+   * Sets `dst` to the number of 16-bit lanes selected by `pattern`,
+   * multiplied by `mul`.
+   *
+   * @param mul the multiplier, in the range 1..16
+   * @copydetails emit_sve_instruction
+   */
+  arm_emitter& cnth(const arm_xreg dst, const arm_pattern pattern = arm_pattern::all,
+                    const unsigned mul = 1) {
+    return emit_sve_count(0x0460E000, dst, pattern, mul);
+  }
+
+  /**
+   * Emits a `CNTW` (set to vector element count) instruction.
+   *
+   * Sets `dst` to the number of 32-bit lanes selected by `pattern`,
+   * multiplied by `mul`.
+   *
+   * @param mul the multiplier, in the range 1..16
+   * @copydetails emit_sve_instruction
+   */
+  arm_emitter& cntw(const arm_xreg dst, const arm_pattern pattern = arm_pattern::all,
+                    const unsigned mul = 1) {
+    return emit_sve_count(0x04A0E000, dst, pattern, mul);
+  }
+
+  /**
+   * Emits a `CSEL` (conditional select) instruction, which sets `dst` to `src1` if the
+   * condition holds and to `src2` otherwise.
+   *
+   * @param dst  a 32- or 64-bit target register
+   * @param src1 the register selected if the condition holds
+   * @param src2 the register used otherwise, of the same width
+   * @param cc   the condition
+   * @copydetails emit_general_purpose_instruction
+   */
+  template <typename Reg>
+  arm_emitter& csel(const Reg dst, const Reg src1, const Reg src2, const arm_cc cc) {
+    return emit_cond_select(0x1A800000 | (0 << 10), dst, src1, src2, cc);
+  }
+
+  /**
+   * Emits a `CSET` (conditional set) instruction, which sets `dst` to 1 if
+   * the condition holds and to 0 otherwise; an alias of `CSINC` from the
+   * zero register with the inverted condition.
+   *
+   * @param dst a 32- or 64-bit target register
+   * @param cc  the condition, which must not be `AL` or `NV`
+   * @copydetails emit_general_purpose_instruction
+   */
+  template <typename Reg>
+  arm_emitter& cset(const Reg dst, const arm_cc cc) {
+    return csinc(dst, static_cast<Reg>(31), static_cast<Reg>(31), invert(cc));
+  }
+
+  /**
+   * Emits a `CSETM` (conditional set mask) instruction, which sets `dst`
+   * to all ones if the condition holds and to 0 otherwise; an alias of
+   * `CSINV` from the zero register with the inverted condition.
+   *
+   * @param dst a 32- or 64-bit target register
+   * @param cc  the condition, which must not be `AL` or `NV`
+   * @copydetails emit_general_purpose_instruction
+   */
+  template <typename Reg>
+  arm_emitter& csetm(const Reg dst, const arm_cc cc) {
+    return csinv(dst, static_cast<Reg>(31), static_cast<Reg>(31), invert(cc));
+  }
+
+  /**
+   * Emits a `CSINC` (conditional select increment) instruction, which sets `dst` to `src1` if the
+   * condition holds and to `src2` plus one otherwise.
+   *
+   * @param dst  a 32- or 64-bit target register
+   * @param src1 the register selected if the condition holds
+   * @param src2 the register used otherwise, of the same width
+   * @param cc   the condition
+   * @copydetails emit_general_purpose_instruction
+   */
+  template <typename Reg>
+  arm_emitter& csinc(const Reg dst, const Reg src1, const Reg src2, const arm_cc cc) {
+    return emit_cond_select(0x1A800000 | (1 << 10), dst, src1, src2, cc);
+  }
+
+  /**
+   * Emits a `CSINV` (conditional select invert) instruction, which sets `dst` to `src1` if the
+   * condition holds and to the bitwise inverse of `src2` otherwise.
+   *
+   * @param dst  a 32- or 64-bit target register
+   * @param src1 the register selected if the condition holds
+   * @param src2 the register used otherwise, of the same width
+   * @param cc   the condition
+   * @copydetails emit_general_purpose_instruction
+   */
+  template <typename Reg>
+  arm_emitter& csinv(const Reg dst, const Reg src1, const Reg src2, const arm_cc cc) {
+    return emit_cond_select(0x5A800000 | (0 << 10), dst, src1, src2, cc);
+  }
+
+  /**
+   * Emits a `CSNEG` (conditional select negation) instruction, which sets `dst` to `src1` if the
+   * condition holds and to the negation of `src2` otherwise.
+   *
+   * @param dst  a 32- or 64-bit target register
+   * @param src1 the register selected if the condition holds
+   * @param src2 the register used otherwise, of the same width
+   * @param cc   the condition
+   * @copydetails emit_general_purpose_instruction
+   */
+  template <typename Reg>
+  arm_emitter& csneg(const Reg dst, const Reg src1, const Reg src2, const arm_cc cc) {
+    return emit_cond_select(0x5A800000 | (1 << 10), dst, src1, src2, cc);
+  }
+
+  /**
+   * Emits a `CTZ` (count trailing zeros) instruction.
+   *
+   * Requires the common short sequence compression (CSSC) extension of
+   * ARMv8.9.
+   *
+   * @param dst a 32- or 64-bit target register
+   * @param src the source register of the same width
+   * @copydetails emit_general_purpose_instruction
+   */
+  template <typename Reg>
+  arm_emitter& ctz(const Reg dst, const Reg src) {
+    return emit_dp1(6, dst, src);
+  }
+
+  /**
+   * Emits a `DECB` (decrement by vector element count) instruction.
+   *
+   * Subtracts the number of 8-bit lanes selected by `pattern`, multiplied by
+   * `mul`, from `dst`.
+   *
+   * @param mul the multiplier, in the range 1..16
+   * @copydetails emit_sve_instruction
+   */
+  arm_emitter& decb(const arm_xreg dst, const arm_pattern pattern = arm_pattern::all,
+                    const unsigned mul = 1) {
+    return emit_sve_count(0x0430E400, dst, pattern, mul);
+  }
+
+  /**
+   * Emits a `DECD` (decrement by vector element count) instruction.
+   *
+   * Subtracts the number of 64-bit lanes selected by `pattern`, multiplied
+   * by `mul`, from `dst`.
+   *
+   * @param mul the multiplier, in the range 1..16
+   * @copydetails emit_sve_instruction
+   */
+  arm_emitter& decd(const arm_xreg dst, const arm_pattern pattern = arm_pattern::all,
+                    const unsigned mul = 1) {
+    return emit_sve_count(0x04F0E400, dst, pattern, mul);
+  }
+
+  /**
+   * Emits a `DECH` (decrement by vector element count) instruction.
+   *
+   * Subtracts the number of 16-bit lanes selected by `pattern`, multiplied
+   * by `mul`, from `dst`.
+   *
+   * @param mul the multiplier, in the range 1..16
+   * @copydetails emit_sve_instruction
+   */
+  arm_emitter& dech(const arm_xreg dst, const arm_pattern pattern = arm_pattern::all,
+                    const unsigned mul = 1) {
+    return emit_sve_count(0x0470E400, dst, pattern, mul);
+  }
+
+  /**
+   * Emits a `DECW` (decrement by vector element count) instruction.
+   *
+   * Subtracts the number of 32-bit lanes selected by `pattern`, multiplied
+   * by `mul`, from `dst`.
+   *
+   * @param mul the multiplier, in the range 1..16
+   * @copydetails emit_sve_instruction
+   */
+  arm_emitter& decw(const arm_xreg dst, const arm_pattern pattern = arm_pattern::all,
+                    const unsigned mul = 1) {
+    return emit_sve_count(0x04B0E400, dst, pattern, mul);
+  }
+
+  /**
+   * Emits a `DMB` (data memory barrier) instruction.
+   *
+   * @param option the shareability domain and access types to order
+   * @copydetails emit_general_purpose_instruction
+   */
+  arm_emitter& dmb(const arm_barrier option = arm_barrier::ish) {
+    return emit(0xD50330BF | (static_cast<std::uint32_t>(option) << 8));
+  }
+
+  /**
+   * Emits a `DSB` (data synchronization barrier) instruction.
+   *
+   * @param option the shareability domain and access types to wait for
+   * @copydetails emit_general_purpose_instruction
+   */
+  arm_emitter& dsb(const arm_barrier option = arm_barrier::sy) {
+    return emit(0xD503309F | (static_cast<std::uint32_t>(option) << 8));
+  }
+
+  /**
+   * Emits a `DUP` (duplicate general-purpose register) instruction.
+   *
+   * Copies `src` into every lane of `dst`.
+   *
+   * @param src a 64-bit register for 64-bit lanes, a 32-bit one otherwise
+   * @copydetails emit_vector_instruction
+   */
+  template <typename Reg>
+  arm_emitter& dup(const arm_vreg dst, const Reg src, const arm_arrangement arrangement) {
+    check_arrangement(arrangement, no_1d);
+    check_lane_register(src, arrangement);
+    return emit(0x0E000C00 | (q_of(arrangement) << 30) | (element_of(arrangement, 0) << 16) |
+      (code_of(src) << 5) | code_of(dst));
+  }
+
+  /**
+   * Emits a `DUP` (duplicate vector element) instruction.
+   *
+   * Copies a lane of `src` into every lane of `dst`.
+   *
+   * @param index the lane of `src`, counted as in a 128-bit arrangement
+   * @copydetails emit_vector_instruction
+   */
+  arm_emitter& dup(const arm_vreg dst, const arm_vreg src, const unsigned index,
+                   const arm_arrangement arrangement) {
+    check_arrangement(arrangement, no_1d);
+    return emit(0x0E000400 | (q_of(arrangement) << 30) | (element_of(arrangement, index) << 16) |
+      (code_of(src) << 5) | code_of(dst));
+  }
+
+  /**
+   * Emits a `DUP` (broadcast general-purpose register) instruction.
+   *
+   * Copies `src` into every lane of `dst`.
+   *
+   * @param src a 64-bit register for 64-bit lanes, a 32-bit one otherwise
+   * @copydetails emit_sve_instruction
+   */
+  template <typename Reg>
+  arm_emitter& dup(const arm_zreg dst, const Reg src, const arm_element element) {
+    if (sf_of(src) != (element == arm_element::d)) {
+      throw std::invalid_argument("register width does not match the element size");
+    }
+    return emit_sve(0x05203800 | (code_of(src) << 5) | code_of(dst), element, any_element);
+  }
+
+  /**
+   * Emits an `EON` (bitwise exclusive OR NOT) instruction with a shifted register,
+   * which is inverted after shifting.
+   *
+   * @copydetails emit_logical_instruction
+   */
+  template <typename Reg>
+  arm_emitter& eon(const Reg dst, const Reg src1, const Reg src2,
+                   const arm_shift shift = arm_shift::lsl, const unsigned amount = 0) {
+    return emit_logical_shifted(2, 1, dst, src1, src2, shift, amount);
+  }
+
+  /**
+   * Emits an `EOR` (bitwise exclusive OR) instruction with a bitmask immediate value.
+   *
+   * @copydetails emit_logical_instruction
+   */
+  template <typename Reg>
+  arm_emitter& eor(const Reg dst, const Reg src, const std::uint64_t imm) {
+    return emit_logical_imm(2, dst, src, imm);
+  }
+
+  /**
+   * Emits an `EOR` (bitwise exclusive OR) instruction with a shifted register.
+   *
+   * @copydetails emit_logical_instruction
+   */
+  template <typename Reg>
+  arm_emitter& eor(const Reg dst, const Reg src1, const Reg src2,
+                   const arm_shift shift = arm_shift::lsl, const unsigned amount = 0) {
+    return emit_logical_shifted(2, 0, dst, src1, src2, shift, amount);
+  }
+
+  /**
+   * Emits an `EOR` (vector bitwise exclusive OR) instruction.
+   *
+   * @copydetails emit_vector_instruction
+   */
+  arm_emitter& eor(const arm_vreg dst, const arm_vreg src1, const arm_vreg src2,
+                   const arm_arrangement arrangement) {
+    return emit_simd(0x2E201C00, dst, src1, code_of(src2), arrangement, byte_lanes);
+  }
+
+  /**
+   * Emits an `EOR` (predicated bitwise exclusive OR) instruction.
+   *
+   * @copydetails emit_sve_predicated_instruction
+   */
+  arm_emitter& eor(const arm_zreg dst, const arm_preg pg, const arm_zreg src,
+                   const arm_element element) {
+    return emit_sve(0x04190000 | (governing_of(pg) << 10) | (code_of(src) << 5) | code_of(dst),
+                    element, any_element);
+  }
+
+  /**
+   * Emits an `EXT` (extract vector from pair of vectors) instruction.
+   *
+   * Concatenates the low bytes of `src2` above `src1`, and extracts the
+   * bytes starting at the given index.
+   *
+   * @param index the first byte to extract, less than the vector size
+   * @copydetails emit_vector_instruction
+   */
+  arm_emitter& ext(const arm_vreg dst, const arm_vreg src1, const arm_vreg src2,
+                   const unsigned index, const arm_arrangement arrangement) {
+    check_arrangement(arrangement, byte_lanes);
+    if (index >= (8U << q_of(arrangement))) {
+      throw std::out_of_range("index must be less than the vector size");
+    }
+    return emit(0x2E000000 | (q_of(arrangement) << 30) | (code_of(src2) << 16) | (index << 11) |
+      (code_of(src1) << 5) | code_of(dst));
+  }
+
+  /**
+   * Emits an `EXTR` (extract register) instruction, which extracts a
+   * register from the concatenation `src1:src2`, starting at bit `lsb`.
+   *
+   * @param dst  a 32- or 64-bit target register
+   * @param src1 the register providing the upper bits, of the same width
+   * @param src2 the register providing the lower bits, of the same width
+   * @param lsb  the least significant bit to extract from `src2`
+   * @copydetails emit_general_purpose_instruction
+   * @throws std::out_of_range if `lsb` is not less than the register width
+   */
+  template <typename Reg>
+  arm_emitter& extr(const Reg dst, const Reg src1, const Reg src2, const unsigned lsb) {
+    check_shift(dst, lsb);
+    return emit(0x13800000 | (sf_of(dst) << 31) | (sf_of(dst) << 22) | (code_of(src2) << 16) |
+      (lsb << 10) | (code_of(src1) << 5) | code_of(dst));
+  }
+
+  /**
+   * Emits an `FABS` (vector floating-point absolute value) instruction.
+   *
+   * @copydetails emit_vector_instruction
+   */
+  arm_emitter& fabs(const arm_vreg dst, const arm_vreg src, const arm_arrangement arrangement) {
+    return emit_simd_fp(0x0EA0F800, dst, src, 0, arrangement);
+  }
+
+  /**
+   * Emits an `FADD` (vector floating-point add) instruction.
+   *
+   * @copydetails emit_vector_instruction
+   */
+  arm_emitter& fadd(const arm_vreg dst, const arm_vreg src1, const arm_vreg src2,
+                    const arm_arrangement arrangement) {
+    return emit_simd_fp(0x0E20D400, dst, src1, code_of(src2), arrangement);
+  }
+
+  /**
+   * Emits an `FADD` (predicated floating-point add) instruction.
+   *
+   * @copydetails emit_sve_predicated_instruction
+   */
+  arm_emitter& fadd(const arm_zreg dst, const arm_preg pg, const arm_zreg src,
+                    const arm_element element) {
+    return emit_sve(0x65008000 | (governing_of(pg) << 10) | (code_of(src) << 5) | code_of(dst),
+                    element, fp_elements);
+  }
+
+  /**
+   * Emits a 16-byte far jump to an absolute address.
+   *
+   * This is an `LDR X16, #8` and `BR X16` followed by the 64-bit target, so
+   * it reaches any address and does not depend on where it is placed. It
+   * clobbers the intra-procedure-call scratch register `X16`.
+   *
+   * @param target the jump target
+   * @copydetails emit_general_purpose_instruction
+   */
+  arm_emitter& far_jump(const void* const target) {
+    std::uint8_t* const cursor = _buffer.extend(far_jump_size);
+    machinery::bits::store_le32(cursor + 0, 0x58000050); /* LDR X16, #8 */
+    machinery::bits::store_le32(cursor + 4, 0xD61F0200); /* BR X16 */
+    machinery::bits::store_le64(cursor + 8, reinterpret_cast<std::uintptr_t>(target));
+    return *this;
+  }
+
+  /**
+   * Emits an `FCMEQ` (floating-point compare equal) instruction.
+   *
+   * Sets each lane of `dst` to all ones if the comparison holds, and to
+   * zero otherwise.
+   *
+   * @copydetails emit_vector_instruction
+   */
+  arm_emitter& fcmeq(const arm_vreg dst, const arm_vreg src1, const arm_vreg src2,
+                     const arm_arrangement arrangement) {
+    return emit_simd_fp(0x0E20E400, dst, src1, code_of(src2), arrangement);
+  }
+
+  /**
+   * Emits an `FCMGE` (floating-point compare greater than or equal)
+   * instruction.
+   *
+   * Sets each lane of `dst` to all ones if the comparison holds, and to
+   * zero otherwise.
+   *
+   * @copydetails emit_vector_instruction
+   */
+  arm_emitter& fcmge(const arm_vreg dst, const arm_vreg src1, const arm_vreg src2,
+                     const arm_arrangement arrangement) {
+    return emit_simd_fp(0x2E20E400, dst, src1, code_of(src2), arrangement);
+  }
+
+  /**
+   * Emits an `FCMGT` (floating-point compare greater than) instruction.
+   *
+   * Sets each lane of `dst` to all ones if the comparison holds, and to
+   * zero otherwise.
+   *
+   * @copydetails emit_vector_instruction
+   */
+  arm_emitter& fcmgt(const arm_vreg dst, const arm_vreg src1, const arm_vreg src2,
+                     const arm_arrangement arrangement) {
+    return emit_simd_fp(0x2EA0E400, dst, src1, code_of(src2), arrangement);
+  }
+
+  /**
+   * Emits an `FCVTZS` (floating-point convert to signed integer) instruction.
+   *
+   * Converts each lane to an integer of the same size, rounding toward zero.
+   *
+   * @copydetails emit_vector_instruction
+   */
+  arm_emitter& fcvtzs(const arm_vreg dst, const arm_vreg src, const arm_arrangement arrangement) {
+    return emit_simd_fp(0x0EA1B800, dst, src, 0, arrangement);
+  }
+
+  /**
+   * Emits an `FCVTZU` (floating-point convert to unsigned integer)
+   * instruction.
+   *
+   * Converts each lane to an integer of the same size, rounding toward zero.
+   *
+   * @copydetails emit_vector_instruction
+   */
+  arm_emitter& fcvtzu(const arm_vreg dst, const arm_vreg src, const arm_arrangement arrangement) {
+    return emit_simd_fp(0x2EA1B800, dst, src, 0, arrangement);
+  }
+
+  /**
+   * Emits an `FDIV` (vector floating-point divide) instruction.
+   *
+   * @copydetails emit_vector_instruction
+   */
+  arm_emitter& fdiv(const arm_vreg dst, const arm_vreg src1, const arm_vreg src2,
+                    const arm_arrangement arrangement) {
+    return emit_simd_fp(0x2E20FC00, dst, src1, code_of(src2), arrangement);
+  }
+
+  /**
+   * Emits an `FDIV` (predicated floating-point divide) instruction.
+   *
+   * @copydetails emit_sve_predicated_instruction
+   */
+  arm_emitter& fdiv(const arm_zreg dst, const arm_preg pg, const arm_zreg src,
+                    const arm_element element) {
+    return emit_sve(0x650D8000 | (governing_of(pg) << 10) | (code_of(src) << 5) | code_of(dst),
+                    element, fp_elements);
+  }
+
+  /**
+   * Emits an `FMAX` (floating-point maximum) instruction.
+   *
+   * @copydetails emit_vector_instruction
+   */
+  arm_emitter& fmax(const arm_vreg dst, const arm_vreg src1, const arm_vreg src2,
+                    const arm_arrangement arrangement) {
+    return emit_simd_fp(0x0E20F400, dst, src1, code_of(src2), arrangement);
+  }
+
+  /**
+   * Emits an `FMAX` (predicated floating-point maximum) instruction.
+   *
+   * @copydetails emit_sve_predicated_instruction
+   */
+  arm_emitter& fmax(const arm_zreg dst, const arm_preg pg, const arm_zreg src,
+                    const arm_element element) {
+    return emit_sve(0x65068000 | (governing_of(pg) << 10) | (code_of(src) << 5) | code_of(dst),
+                    element, fp_elements);
+  }
+
+  /**
+   * Emits an `FMIN` (floating-point minimum) instruction.
+   *
+   * @copydetails emit_vector_instruction
+   */
+  arm_emitter& fmin(const arm_vreg dst, const arm_vreg src1, const arm_vreg src2,
+                    const arm_arrangement arrangement) {
+    return emit_simd_fp(0x0EA0F400, dst, src1, code_of(src2), arrangement);
+  }
+
+  /**
+   * Emits an `FMIN` (predicated floating-point minimum) instruction.
+   *
+   * @copydetails emit_sve_predicated_instruction
+   */
+  arm_emitter& fmin(const arm_zreg dst, const arm_preg pg, const arm_zreg src,
+                    const arm_element element) {
+    return emit_sve(0x65078000 | (governing_of(pg) << 10) | (code_of(src) << 5) | code_of(dst),
+                    element, fp_elements);
+  }
+
+  /**
+   * Emits an `FMLA` (floating-point fused multiply-add) instruction.
+   *
+   * @copydetails emit_vector_instruction
+   */
+  arm_emitter& fmla(const arm_vreg dst, const arm_vreg src1, const arm_vreg src2,
+                    const arm_arrangement arrangement) {
+    return emit_simd_fp(0x0E20CC00, dst, src1, code_of(src2), arrangement);
+  }
+
+  /**
+   * Emits an `FMLA` (predicated floating-point multiply-add) instruction.
+   *
+   * Adds the products of `src1` and `src2` to `dst`.
+   *
+   * @copydetails emit_sve_predicated_instruction
+   */
+  arm_emitter& fmla(const arm_zreg dst, const arm_preg pg, const arm_zreg src1,
+                    const arm_zreg src2, const arm_element element) {
+    return emit_sve(0x65200000 | (code_of(src2) << 16) | (governing_of(pg) << 10) |
+      (code_of(src1) << 5) | code_of(dst), element, fp_elements);
+  }
+
+  /**
+   * Emits an `FMLS` (floating-point fused multiply-subtract) instruction.
+   *
+   * @copydetails emit_vector_instruction
+   */
+  arm_emitter& fmls(const arm_vreg dst, const arm_vreg src1, const arm_vreg src2,
+                    const arm_arrangement arrangement) {
+    return emit_simd_fp(0x0EA0CC00, dst, src1, code_of(src2), arrangement);
+  }
+
+  /**
+   * Emits an `FMUL` (vector floating-point multiply) instruction.
+   *
+   * @copydetails emit_vector_instruction
+   */
+  arm_emitter& fmul(const arm_vreg dst, const arm_vreg src1, const arm_vreg src2,
+                    const arm_arrangement arrangement) {
+    return emit_simd_fp(0x2E20DC00, dst, src1, code_of(src2), arrangement);
+  }
+
+  /**
+   * Emits an `FMUL` (predicated floating-point multiply) instruction.
+   *
+   * @copydetails emit_sve_predicated_instruction
+   */
+  arm_emitter& fmul(const arm_zreg dst, const arm_preg pg, const arm_zreg src,
+                    const arm_element element) {
+    return emit_sve(0x65028000 | (governing_of(pg) << 10) | (code_of(src) << 5) | code_of(dst),
+                    element, fp_elements);
+  }
+
+  /**
+   * Emits an `FNEG` (vector floating-point negate) instruction.
+   *
+   * @copydetails emit_vector_instruction
+   */
+  arm_emitter& fneg(const arm_vreg dst, const arm_vreg src, const arm_arrangement arrangement) {
+    return emit_simd_fp(0x2EA0F800, dst, src, 0, arrangement);
+  }
+
+  /**
+   * Emits an `FSQRT` (vector floating-point square root) instruction.
+   *
+   * @copydetails emit_vector_instruction
+   */
+  arm_emitter& fsqrt(const arm_vreg dst, const arm_vreg src, const arm_arrangement arrangement) {
+    return emit_simd_fp(0x2EA1F800, dst, src, 0, arrangement);
+  }
+
+  /**
+   * Emits an `FSUB` (vector floating-point subtract) instruction.
+   *
+   * @copydetails emit_vector_instruction
+   */
+  arm_emitter& fsub(const arm_vreg dst, const arm_vreg src1, const arm_vreg src2,
+                    const arm_arrangement arrangement) {
+    return emit_simd_fp(0x0EA0D400, dst, src1, code_of(src2), arrangement);
+  }
+
+  /**
+   * Emits an `FSUB` (predicated floating-point subtract) instruction.
+   *
+   * @copydetails emit_sve_predicated_instruction
+   */
+  arm_emitter& fsub(const arm_zreg dst, const arm_preg pg, const arm_zreg src,
+                    const arm_element element) {
+    return emit_sve(0x65018000 | (governing_of(pg) << 10) | (code_of(src) << 5) | code_of(dst),
+                    element, fp_elements);
+  }
+
+  /**
+   * Emits a `HINT` instruction.
+   *
+   * @copydetails emit_general_purpose_instruction
+   */
+  arm_emitter& hint(const arm_imm7 imm = 0) {
+    return emit(0xD503201F | (imm.u8 << 5));
+  }
+
+  /**
+   * Emits an `INCB` (increment by vector element count) instruction.
+   *
+   * Adds the number of 8-bit lanes selected by `pattern`, multiplied by
+   * `mul`, to `dst`.
+   *
+   * @param mul the multiplier, in the range 1..16
+   * @copydetails emit_sve_instruction
+   */
+  arm_emitter& incb(const arm_xreg dst, const arm_pattern pattern = arm_pattern::all,
+                    const unsigned mul = 1) {
+    return emit_sve_count(0x0430E000, dst, pattern, mul);
+  }
+
+  /**
+   * Emits an `INCD` (increment by vector element count) instruction.
+   *
+   * Adds the number of 64-bit lanes selected by `pattern`, multiplied by
+   * `mul`, to `dst`.
+   *
+   * @param mul the multiplier, in the range 1..16
+   * @copydetails emit_sve_instruction
+   */
+  arm_emitter& incd(const arm_xreg dst, const arm_pattern pattern = arm_pattern::all,
+                    const unsigned mul = 1) {
+    return emit_sve_count(0x04F0E000, dst, pattern, mul);
+  }
+
+  /**
+   * Emits an `INCH` (increment by vector element count) instruction.
+   *
+   * Adds the number of 16-bit lanes selected by `pattern`, multiplied by
+   * `mul`, to `dst`.
+   *
+   * @param mul the multiplier, in the range 1..16
+   * @copydetails emit_sve_instruction
+   */
+  arm_emitter& inch(const arm_xreg dst, const arm_pattern pattern = arm_pattern::all,
+                    const unsigned mul = 1) {
+    return emit_sve_count(0x0470E000, dst, pattern, mul);
+  }
+
+  /**
+   * Emits an `INCW` (increment by vector element count) instruction.
+   *
+   * Adds the number of 32-bit lanes selected by `pattern`, multiplied by
+   * `mul`, to `dst`.
+   *
+   * @param mul the multiplier, in the range 1..16
+   * @copydetails emit_sve_instruction
+   */
+  arm_emitter& incw(const arm_xreg dst, const arm_pattern pattern = arm_pattern::all,
+                    const unsigned mul = 1) {
+    return emit_sve_count(0x04B0E000, dst, pattern, mul);
+  }
+
+  /**
+   * Emits an `INS` (insert vector element from general-purpose register)
+   * instruction.
+   *
+   * Copies `src` into one lane of `dst`, leaving the other lanes unchanged.
+   *
+   * @param index the lane of `dst`, counted as in a 128-bit arrangement
+   * @param src   a 64-bit register for 64-bit lanes, a 32-bit one otherwise
+   * @copydetails emit_vector_instruction
+   */
+  template <typename Reg>
+  arm_emitter& ins(const arm_vreg dst, const unsigned index, const Reg src,
+                   const arm_arrangement arrangement) {
+    check_lane_register(src, arrangement);
+    return emit(0x4E001C00 | (element_of(arrangement, index) << 16) | (code_of(src) << 5) | code_of(dst));
+  }
+
+  /**
+   * Emits an `ISB` (instruction synchronization barrier) instruction.
+   *
+   * @copydetails emit_general_purpose_instruction
+   */
+  arm_emitter& isb() {
+    return emit(0xD5033FDF);
+  }
+
+  /**
+   * Emits an `LD1` (load multiple single-element structures) instruction.
+   *
+   * Loads 1 to 4 consecutive registers starting at `dst`, without
+   * interleaving.
+   *
+   * @param count the number of registers
+   * @copydetails emit_vector_load_store_instruction
+   */
+  arm_emitter& ld1(const arm_vreg dst, const arm_mem& mem, const arm_arrangement arrangement,
+                   const unsigned count = 1) {
+    static const std::uint8_t opcodes[] = {0x7, 0xA, 0x6, 0x2};
+    check_list(count);
+    return emit_load_store_multiple(1, opcodes[count - 1], count, dst, mem, arrangement);
+  }
+
+  /**
+   * Emits an `LD1B` (load bytes) instruction.
+   *
+   * Loads consecutive bytes into the lanes of `dst` that are active in `pg`,
+   * and zeroes the others.
+   *
+   * @copydetails emit_sve_load_store_instruction
+   */
+  arm_emitter& ld1b(const arm_zreg dst, const arm_preg pg, const arm_mem& mem) {
+    return emit_sve_load_store(0xA4004000, 0xA400A000, 0, dst, pg, mem);
+  }
+
+  /**
+   * Emits an `LD1D` (load doublewords) instruction.
+   *
+   * Loads consecutive doublewords into the lanes of `dst` that are active in
+   * `pg`, and zeroes the others.
+   *
+   * @copydetails emit_sve_load_store_instruction
+   */
+  arm_emitter& ld1d(const arm_zreg dst, const arm_preg pg, const arm_mem& mem) {
+    return emit_sve_load_store(0xA5E04000, 0xA5E0A000, 3, dst, pg, mem);
+  }
+
+  /**
+   * Emits an `LD1D` (gather load doublewords to vector) instruction.
+   *
+   * Loads each lane of `dst` that is active in `pg` from `base` plus the
+   * lane of `index` times 8, and zeroes the others.
+   *
+   * @param index the 64-bit offsets, in doublewords
+   * @copydetails emit_sve_predicated_instruction
+   */
+  arm_emitter& ld1d(const arm_zreg dst, const arm_preg pg, const arm_xreg base,
+                    const arm_zreg index) {
+    return emit(0xC5E0C000 | (code_of(index) << 16) | (governing_of(pg) << 10) |
+      (code_of(base) << 5) | code_of(dst));
+  }
+
+  /**
+   * Emits an `LD1H` (load halfwords) instruction.
+   *
+   * Loads consecutive halfwords into the lanes of `dst` that are active in
+   * `pg`, and zeroes the others.
+   *
+   * @copydetails emit_sve_load_store_instruction
+   */
+  arm_emitter& ld1h(const arm_zreg dst, const arm_preg pg, const arm_mem& mem) {
+    return emit_sve_load_store(0xA4A04000, 0xA4A0A000, 1, dst, pg, mem);
+  }
+
+  /**
+   * Emits an `LD1W` (load words) instruction.
+   *
+   * Loads consecutive words into the lanes of `dst` that are active in `pg`,
+   * and zeroes the others.
+   *
+   * @copydetails emit_sve_load_store_instruction
+   */
+  arm_emitter& ld1w(const arm_zreg dst, const arm_preg pg, const arm_mem& mem) {
+    return emit_sve_load_store(0xA5404000, 0xA540A000, 2, dst, pg, mem);
+  }
+
+  /**
+   * Emits an `LD1W` (gather load words to vector) instruction.
+   *
+   * Loads each lane of `dst` that is active in `pg` from `base` plus the
+   * lane of `index` times 4, and zeroes the others.
+   *
+   * @param index  the 32-bit offsets, in words
+   * @param extend `UXTW` for unsigned offsets, or `SXTW` for signed ones
+   * @copydetails emit_sve_predicated_instruction
+   */
+  arm_emitter& ld1w(const arm_zreg dst, const arm_preg pg, const arm_xreg base,
+                    const arm_zreg index, const arm_extend extend) {
+    if (extend != arm_extend::uxtw && extend != arm_extend::sxtw) {
+      throw std::invalid_argument("32-bit offsets must be extended with UXTW or SXTW");
+    }
+    return emit(0x85204000 | ((extend == arm_extend::sxtw) << 22) | (code_of(index) << 16) |
+      (governing_of(pg) << 10) | (code_of(base) << 5) | code_of(dst));
+  }
+
+  /**
+   * Emits an `LD2` (load multiple 2-element structures) instruction.
+   *
+   * Loads 2 consecutive registers starting at `dst`, deinterleaving their
+   * lanes.
+   *
+   * @copydetails emit_vector_load_store_instruction
+   */
+  arm_emitter& ld2(const arm_vreg dst, const arm_mem& mem, const arm_arrangement arrangement) {
+    check_arrangement(arrangement, no_1d);
+    return emit_load_store_multiple(1, 0x8, 2, dst, mem, arrangement);
+  }
+
+  /**
+   * Emits an `LD3` (load multiple 3-element structures) instruction.
+   *
+   * Loads 3 consecutive registers starting at `dst`, deinterleaving their
+   * lanes.
+   *
+   * @copydetails emit_vector_load_store_instruction
+   */
+  arm_emitter& ld3(const arm_vreg dst, const arm_mem& mem, const arm_arrangement arrangement) {
+    check_arrangement(arrangement, no_1d);
+    return emit_load_store_multiple(1, 0x4, 3, dst, mem, arrangement);
+  }
+
+  /**
+   * Emits an `LD4` (load multiple 4-element structures) instruction.
+   *
+   * Loads 4 consecutive registers starting at `dst`, deinterleaving their
+   * lanes.
+   *
+   * @copydetails emit_vector_load_store_instruction
+   */
+  arm_emitter& ld4(const arm_vreg dst, const arm_mem& mem, const arm_arrangement arrangement) {
+    check_arrangement(arrangement, no_1d);
+    return emit_load_store_multiple(1, 0x0, 4, dst, mem, arrangement);
+  }
+
+  /**
+   * Emits an `LDADD` (atomic add) instruction.
+   *
+   * Atomically adds `src` to the memory at `[base]`, loading its old
+   * contents into `dst`.
+   *
+   * Requires the large system extensions (LSE) of ARMv8.1.
+   *
+   * @copydetails emit_atomic_instruction
+   */
+  template <typename Reg>
+  arm_emitter& ldadd(const Reg src, const Reg dst, const arm_xreg base,
+                     const arm_order order = arm_order::relaxed) {
+    return emit_atomic(0, src, dst, base, order);
+  }
+
+  /**
+   * Emits an `LDAR` (load-acquire register) instruction.
+   *
+   * @param dst  a 32- or 64-bit target register
+   * @param base the 64-bit base address register, which may be `SP`
+   * @copydetails emit_general_purpose_instruction
+   */
+  template <typename Reg>
+  arm_emitter& ldar(const Reg dst, const arm_xreg base) {
+    return emit_ldst_ordered(0x08DFFC00, dst, 31, base);
+  }
+
+  /**
+   * Emits an `LDAXR` (load-acquire exclusive register) instruction.
+   *
+   * @param dst  a 32- or 64-bit target register
+   * @param base the 64-bit base address register, which may be `SP`
+   * @copydetails emit_general_purpose_instruction
+   */
+  template <typename Reg>
+  arm_emitter& ldaxr(const Reg dst, const arm_xreg base) {
+    return emit_ldst_ordered(0x085FFC00, dst, 31, base);
+  }
+
+  /**
+   * Emits an `LDCLR` (atomic bit clear) instruction.
+   *
+   * Atomically clears the bits set in `src` in the memory at `[base]`,
+   * loading its old contents into `dst`.
+   *
+   * Requires the large system extensions (LSE) of ARMv8.1.
+   *
+   * @copydetails emit_atomic_instruction
+   */
+  template <typename Reg>
+  arm_emitter& ldclr(const Reg src, const Reg dst, const arm_xreg base,
+                     const arm_order order = arm_order::relaxed) {
+    return emit_atomic(1, src, dst, base, order);
+  }
+
+  /**
+   * Emits an `LDEOR` (atomic exclusive or) instruction.
+   *
+   * Atomically exclusive-ors `src` into the memory at `[base]`, loading its
+   * old contents into `dst`.
+   *
+   * Requires the large system extensions (LSE) of ARMv8.1.
+   *
+   * @copydetails emit_atomic_instruction
+   */
+  template <typename Reg>
+  arm_emitter& ldeor(const Reg src, const Reg dst, const arm_xreg base,
+                     const arm_order order = arm_order::relaxed) {
+    return emit_atomic(2, src, dst, base, order);
+  }
+
+  /**
+   * Emits an `LDFF1B` (first-fault load bytes) instruction.
+   *
+   * Loads like `LD1B`, except that only the first active lane may fault. If
+   * a later lane would fault, it and the lanes after it are cleared in the
+   * first-fault register (FFR) instead, which `RDFFR` then reads. Takes no
+   * immediate offset.
+   *
+   * @copydetails emit_sve_load_store_instruction
+   */
+  arm_emitter& ldff1b(const arm_zreg dst, const arm_preg pg, const arm_mem& mem) {
+    return emit_sve_load_store(0xA4006000, 0, 0, dst, pg, mem);
+  }
+
+  /**
+   * Emits an `LDFF1D` (first-fault load doublewords) instruction.
+   *
+   * Loads like `LD1D`, except that only the first active lane may fault. If
+   * a later lane would fault, it and the lanes after it are cleared in the
+   * first-fault register (FFR) instead, which `RDFFR` then reads. Takes no
+   * immediate offset.
+   *
+   * @copydetails emit_sve_load_store_instruction
+   */
+  arm_emitter& ldff1d(const arm_zreg dst, const arm_preg pg, const arm_mem& mem) {
+    return emit_sve_load_store(0xA5E06000, 0, 3, dst, pg, mem);
+  }
+
+  /**
+   * Emits an `LDFF1H` (first-fault load halfwords) instruction.
+   *
+   * Loads like `LD1H`, except that only the first active lane may fault. If
+   * a later lane would fault, it and the lanes after it are cleared in the
+   * first-fault register (FFR) instead, which `RDFFR` then reads. Takes no
+   * immediate offset.
+   *
+   * @copydetails emit_sve_load_store_instruction
+   */
+  arm_emitter& ldff1h(const arm_zreg dst, const arm_preg pg, const arm_mem& mem) {
+    return emit_sve_load_store(0xA4A06000, 0, 1, dst, pg, mem);
+  }
+
+  /**
+   * Emits an `LDFF1W` (first-fault load words) instruction.
+   *
+   * Loads like `LD1W`, except that only the first active lane may fault. If
+   * a later lane would fault, it and the lanes after it are cleared in the
+   * first-fault register (FFR) instead, which `RDFFR` then reads. Takes no
+   * immediate offset.
+   *
+   * @copydetails emit_sve_load_store_instruction
+   */
+  arm_emitter& ldff1w(const arm_zreg dst, const arm_preg pg, const arm_mem& mem) {
+    return emit_sve_load_store(0xA5406000, 0, 2, dst, pg, mem);
+  }
+
+  /**
+   * Emits an `LDP` (load pair of registers) instruction.
+   *
+   * @param dst1 a 32- or 64-bit target register
+   * @param dst2 the second target register of the same width
+   * @param mem  the memory operand
+   * @copydetails emit_load_store_pair_instruction
+   */
+  template <typename Reg>
+  arm_emitter& ldp(const Reg dst1, const Reg dst2, const arm_mem& mem) {
+    return emit_load_store_pair(sf_of(dst1) << 1, 1, 4 << sf_of(dst1), code_of(dst1), code_of(dst2), mem);
+  }
+
+  /**
+   * Emits an `LDPSW` (load pair of registers signed word) instruction.
+   *
+   * @param dst1 the first 64-bit target register
+   * @param dst2 the second 64-bit target register
+   * @param mem  the memory operand
+   * @copydetails emit_load_store_pair_instruction
+   */
+  arm_emitter& ldpsw(const arm_xreg dst1, const arm_xreg dst2, const arm_mem& mem) {
+    return emit_load_store_pair(1, 1, 4, code_of(dst1), code_of(dst2), mem);
+  }
+
+  /**
+   * Emits an `LDR` (load register) instruction.
+   *
+   * @param dst a 32- or 64-bit target register
+   * @param mem the memory operand
+   * @copydetails emit_load_store_instruction
+   */
+  template <typename Reg>
+  arm_emitter& ldr(const Reg dst, const arm_mem& mem) {
+    return emit_load_store(2 | sf_of(dst), 1, code_of(dst), mem);
+  }
+
+  /**
+   * Emits an `LDRB` (load register byte, zero-extending) instruction.
+   *
+   * @param dst the 32-bit target register
+   * @param mem the memory operand
+   * @copydetails emit_load_store_instruction
+   */
+  arm_emitter& ldrb(const arm_wreg dst, const arm_mem& mem) {
+    return emit_load_store(0, 1, code_of(dst), mem);
+  }
+
+  /**
+   * Emits an `LDRH` (load register halfword, zero-extending) instruction.
+   *
+   * @param dst the 32-bit target register
+   * @param mem the memory operand
+   * @copydetails emit_load_store_instruction
+   */
+  arm_emitter& ldrh(const arm_wreg dst, const arm_mem& mem) {
+    return emit_load_store(1, 1, code_of(dst), mem);
+  }
+
+  /**
+   * Emits an `LDRSB` (load register signed byte) instruction.
+   *
+   * @param dst a 32- or 64-bit target register
+   * @param mem the memory operand
+   * @copydetails emit_load_store_instruction
+   */
+  template <typename Reg>
+  arm_emitter& ldrsb(const Reg dst, const arm_mem& mem) {
+    return emit_load_store(0, sf_of(dst) ? 2 : 3, code_of(dst), mem);
+  }
+
+  /**
+   * Emits an `LDRSH` (load register signed halfword) instruction.
+   *
+   * @param dst a 32- or 64-bit target register
+   * @param mem the memory operand
+   * @copydetails emit_load_store_instruction
+   */
+  template <typename Reg>
+  arm_emitter& ldrsh(const Reg dst, const arm_mem& mem) {
+    return emit_load_store(1, sf_of(dst) ? 2 : 3, code_of(dst), mem);
+  }
+
+  /**
+   * Emits an `LDRSW` (load register signed word) instruction.
+   *
+   * @param dst the 64-bit target register
+   * @param mem the memory operand
+   * @copydetails emit_load_store_instruction
+   */
+  arm_emitter& ldrsw(const arm_xreg dst, const arm_mem& mem) {
+    return emit_load_store(2, 2, code_of(dst), mem);
+  }
+
+  /**
+   * Emits an `LDSET` (atomic bit set) instruction.
+   *
+   * Atomically sets the bits set in `src` in the memory at `[base]`, loading
+   * its old contents into `dst`.
+   *
+   * Requires the large system extensions (LSE) of ARMv8.1.
+   *
+   * @copydetails emit_atomic_instruction
+   */
+  template <typename Reg>
+  arm_emitter& ldset(const Reg src, const Reg dst, const arm_xreg base,
+                     const arm_order order = arm_order::relaxed) {
+    return emit_atomic(3, src, dst, base, order);
+  }
+
+  /**
+   * Emits an `LDSMAX` (atomic signed maximum) instruction.
+   *
+   * Atomically replaces the memory at `[base]` with the signed maximum of
+   * itself and `src`, loading its old contents into `dst`.
+   *
+   * Requires the large system extensions (LSE) of ARMv8.1.
+   *
+   * @copydetails emit_atomic_instruction
+   */
+  template <typename Reg>
+  arm_emitter& ldsmax(const Reg src, const Reg dst, const arm_xreg base,
+                      const arm_order order = arm_order::relaxed) {
+    return emit_atomic(4, src, dst, base, order);
+  }
+
+  /**
+   * Emits an `LDSMIN` (atomic signed minimum) instruction.
+   *
+   * Atomically replaces the memory at `[base]` with the signed minimum of
+   * itself and `src`, loading its old contents into `dst`.
+   *
+   * Requires the large system extensions (LSE) of ARMv8.1.
+   *
+   * @copydetails emit_atomic_instruction
+   */
+  template <typename Reg>
+  arm_emitter& ldsmin(const Reg src, const Reg dst, const arm_xreg base,
+                      const arm_order order = arm_order::relaxed) {
+    return emit_atomic(5, src, dst, base, order);
+  }
+
+  /**
+   * Emits an `LDUMAX` (atomic unsigned maximum) instruction.
+   *
+   * Atomically replaces the memory at `[base]` with the unsigned maximum
+   * of itself and `src`, loading its old contents into `dst`.
+   *
+   * Requires the large system extensions (LSE) of ARMv8.1.
+   *
+   * @copydetails emit_atomic_instruction
+   */
+  template <typename Reg>
+  arm_emitter& ldumax(const Reg src, const Reg dst, const arm_xreg base,
+                      const arm_order order = arm_order::relaxed) {
+    return emit_atomic(6, src, dst, base, order);
+  }
+
+  /**
+   * Emits an `LDUMIN` (atomic unsigned minimum) instruction.
+   *
+   * Atomically replaces the memory at `[base]` with the unsigned minimum
+   * of itself and `src`, loading its old contents into `dst`.
+   *
+   * Requires the large system extensions (LSE) of ARMv8.1.
+   *
+   * @copydetails emit_atomic_instruction
+   */
+  template <typename Reg>
+  arm_emitter& ldumin(const Reg src, const Reg dst, const arm_xreg base,
+                      const arm_order order = arm_order::relaxed) {
+    return emit_atomic(7, src, dst, base, order);
+  }
+
+  /**
+   * Emits an `LDUR` (load register (unscaled)) instruction.
+   *
+   * @param dst a 32- or 64-bit target register
+   * @param mem the memory operand
+   * @copydetails emit_load_store_unscaled_instruction
+   */
+  template <typename Reg>
+  arm_emitter& ldur(const Reg dst, const arm_mem& mem) {
+    if (mem.mode != arm_addressing::offset) {
+      throw std::invalid_argument("unscaled loads and stores take an immediate offset only");
+    }
+    return emit_load_store_imm9(0x38000000, 2 | sf_of(dst), 1, code_of(dst), mem);
+  }
+
+  /**
+   * Emits an `LDURB` (load register (unscaled) byte, zero-extending) instruction.
+   *
+   * @param dst the 32-bit target register
+   * @param mem the memory operand
+   * @copydetails emit_load_store_unscaled_instruction
+   */
+  arm_emitter& ldurb(const arm_wreg dst, const arm_mem& mem) {
+    if (mem.mode != arm_addressing::offset) {
+      throw std::invalid_argument("unscaled loads and stores take an immediate offset only");
+    }
+    return emit_load_store_imm9(0x38000000, 0, 1, code_of(dst), mem);
+  }
+
+  /**
+   * Emits an `LDURH` (load register (unscaled) halfword, zero-extending) instruction.
+   *
+   * @param dst the 32-bit target register
+   * @param mem the memory operand
+   * @copydetails emit_load_store_unscaled_instruction
+   */
+  arm_emitter& ldurh(const arm_wreg dst, const arm_mem& mem) {
+    if (mem.mode != arm_addressing::offset) {
+      throw std::invalid_argument("unscaled loads and stores take an immediate offset only");
+    }
+    return emit_load_store_imm9(0x38000000, 1, 1, code_of(dst), mem);
+  }
+
+  /**
+   * Emits an `LDURSB` (load register (unscaled) signed byte) instruction.
+   *
+   * @param dst a 32- or 64-bit target register
+   * @param mem the memory operand
+   * @copydetails emit_load_store_unscaled_instruction
+   */
+  template <typename Reg>
+  arm_emitter& ldursb(const Reg dst, const arm_mem& mem) {
+    if (mem.mode != arm_addressing::offset) {
+      throw std::invalid_argument("unscaled loads and stores take an immediate offset only");
+    }
+    return emit_load_store_imm9(0x38000000, 0, sf_of(dst) ? 2 : 3, code_of(dst), mem);
+  }
+
+  /**
+   * Emits an `LDURSH` (load register (unscaled) signed halfword) instruction.
+   *
+   * @param dst a 32- or 64-bit target register
+   * @param mem the memory operand
+   * @copydetails emit_load_store_unscaled_instruction
+   */
+  template <typename Reg>
+  arm_emitter& ldursh(const Reg dst, const arm_mem& mem) {
+    if (mem.mode != arm_addressing::offset) {
+      throw std::invalid_argument("unscaled loads and stores take an immediate offset only");
+    }
+    return emit_load_store_imm9(0x38000000, 1, sf_of(dst) ? 2 : 3, code_of(dst), mem);
+  }
+
+  /**
+   * Emits an `LDURSW` (load register (unscaled) signed word) instruction.
+   *
+   * @param dst the 64-bit target register
+   * @param mem the memory operand
+   * @copydetails emit_load_store_unscaled_instruction
+   */
+  arm_emitter& ldursw(const arm_xreg dst, const arm_mem& mem) {
+    if (mem.mode != arm_addressing::offset) {
+      throw std::invalid_argument("unscaled loads and stores take an immediate offset only");
+    }
+    return emit_load_store_imm9(0x38000000, 2, 2, code_of(dst), mem);
+  }
+
+  /**
+   * Emits an `LDXR` (load exclusive register) instruction.
+   *
+   * This marks the address for a subsequent `STXR` or `STLXR`, which fails
+   * if another core has written to it in the meantime.
+   *
+   * @param dst  a 32- or 64-bit target register
+   * @param base the 64-bit base address register, which may be `SP`
+   * @copydetails emit_general_purpose_instruction
+   */
+  template <typename Reg>
+  arm_emitter& ldxr(const Reg dst, const arm_xreg base) {
+    return emit_ldst_ordered(0x085F7C00, dst, 31, base);
+  }
+
+  /**
+   * Emits an `LSL` (logical shift left) instruction by a constant amount, an alias
+   * of `UBFM`.
+   *
+   * @param dst    a 32- or 64-bit target register
+   * @param src    the source register of the same width
+   * @param amount the shift amount, less than the register width
+   * @copydetails emit_general_purpose_instruction
+   * @throws std::out_of_range if `amount` is not less than the register width
+   */
+  template <typename Reg>
+  arm_emitter& lsl(const Reg dst, const Reg src, const unsigned amount) {
+    check_shift(dst, amount);
+    return ubfm(dst, src, (width_of(dst) - amount) % width_of(dst), width_of(dst) - 1 - amount);
+  }
+
+  /**
+   * Emits an `LSL` (logical shift left) instruction by a register amount, an alias
+   * of `LSLV`.
+   *
+   * Only the low 5 or 6 bits of the amount are used, i.e. the amount is
+   * taken modulo the register width.
+   *
+   * @param dst    a 32- or 64-bit target register
+   * @param src    the source register of the same width
+   * @param amount the shift amount register of the same width
+   * @copydetails emit_general_purpose_instruction
+   */
+  template <typename Reg>
+  arm_emitter& lsl(const Reg dst, const Reg src, const Reg amount) {
+    return emit_dp2(8, dst, src, amount);
+  }
+
+  /**
+   * Emits an `LSR` (logical shift right) instruction by a constant amount, an alias
+   * of `UBFM`.
+   *
+   * @param dst    a 32- or 64-bit target register
+   * @param src    the source register of the same width
+   * @param amount the shift amount, less than the register width
+   * @copydetails emit_general_purpose_instruction
+   * @throws std::out_of_range if `amount` is not less than the register width
+   */
+  template <typename Reg>
+  arm_emitter& lsr(const Reg dst, const Reg src, const unsigned amount) {
+    check_shift(dst, amount);
+    return ubfm(dst, src, amount, width_of(dst) - 1);
+  }
+
+  /**
+   * Emits an `LSR` (logical shift right) instruction by a register amount, an alias
+   * of `LSRV`.
+   *
+   * Only the low 5 or 6 bits of the amount are used, i.e. the amount is
+   * taken modulo the register width.
+   *
+   * @param dst    a 32- or 64-bit target register
+   * @param src    the source register of the same width
+   * @param amount the shift amount register of the same width
+   * @copydetails emit_general_purpose_instruction
+   */
+  template <typename Reg>
+  arm_emitter& lsr(const Reg dst, const Reg src, const Reg amount) {
+    return emit_dp2(9, dst, src, amount);
+  }
+
+  /**
+   * Emits an `MADD` (multiply-add) instruction, which adds the product of `src1` and `src2` to `addend`.
+   *
+   * @param dst    a 32- or 64-bit target register
+   * @param src1   the multiplicand register of the same width
+   * @param src2   the multiplier register of the same width
+   * @param addend the addend or minuend register of the same width
+   * @copydetails emit_general_purpose_instruction
+   */
+  template <typename Reg>
+  arm_emitter& madd(const Reg dst, const Reg src1, const Reg src2, const Reg addend) {
+    return emit_dp3(0, dst, src1, src2, addend);
+  }
+
+  /**
+   * Emits an `MLA` (multiply-add) instruction.
+   *
+   * @copydetails emit_vector_instruction
+   */
+  arm_emitter& mla(const arm_vreg dst, const arm_vreg src1, const arm_vreg src2,
+                   const arm_arrangement arrangement) {
+    return emit_simd(0x0E209400, dst, src1, code_of(src2), arrangement, no_64bit_lanes);
+  }
+
+  /**
+   * Emits an `MLA` (predicated multiply-add) instruction.
+   *
+   * Adds the products of `src1` and `src2` to `dst`.
+   *
+   * @copydetails emit_sve_predicated_instruction
+   */
+  arm_emitter& mla(const arm_zreg dst, const arm_preg pg, const arm_zreg src1,
+                   const arm_zreg src2, const arm_element element) {
+    return emit_sve(0x04004000 | (code_of(src2) << 16) | (governing_of(pg) << 10) |
+      (code_of(src1) << 5) | code_of(dst), element, any_element);
+  }
+
+  /**
+   * Emits an `MLS` (multiply-subtract) instruction.
+   *
+   * @copydetails emit_vector_instruction
+   */
+  arm_emitter& mls(const arm_vreg dst, const arm_vreg src1, const arm_vreg src2,
+                   const arm_arrangement arrangement) {
+    return emit_simd(0x2E209400, dst, src1, code_of(src2), arrangement, no_64bit_lanes);
+  }
+
+  /**
+   * Emits an `MNEG` (multiply-negate) instruction, an alias of `MSUB` from
+   * the zero register.
+   *
+   * @param dst  a 32- or 64-bit target register
+   * @param src1 the multiplicand register of the same width
+   * @param src2 the multiplier register of the same width
+   * @copydetails emit_general_purpose_instruction
+   */
+  template <typename Reg>
+  arm_emitter& mneg(const Reg dst, const Reg src1, const Reg src2) {
+    return msub(dst, src1, src2, static_cast<Reg>(31));
+  }
+
+  /**
+   * Emits a `MOV` (move register) instruction, an alias of `ORR` from the
+   * zero register.
+   *
+   * Register 31 denotes the zero register; copy to or from `SP` with
+   * `add(dst, src, 0)` instead.
+   *
+   * @param dst a 32- or 64-bit target register
+   * @param src the source register of the same width
+   * @copydetails emit_general_purpose_instruction
+   */
+  template <typename Reg>
+  arm_emitter& mov(const Reg dst, const Reg src) {
+    return orr(dst, static_cast<Reg>(31), src);
+  }
+
+  /**
+   * Emits the shortest sequence that loads an immediate value into a
+   * register.
+   *
+   * This is a single `MOVZ`, `MOVN`, or `ORR` (bitmask immediate) where
+   * one suffices, and otherwise a `MOVZ` or `MOVN` followed by a `MOVK`
+   * for each remaining 16-bit chunk, starting from whichever of all-zero
+   * or all-one chunks is more common.
+   *
+   * @param dst a 32- or 64-bit target register
+   * @param imm the immediate value, truncated to the register width
+   * @copydetails emit_general_purpose_instruction
+   */
+  template <typename Reg>
+  arm_emitter& mov(const Reg dst, const std::uint64_t imm) {
+    const unsigned width = width_of(dst);
+    const std::uint64_t value = (width == 32) ? (imm & 0xFFFFFFFF) : imm;
+    unsigned zeros = 0, ones = 0;
+    for (unsigned shift = 0; shift < width; shift += 16) {
+      const std::uint32_t chunk = (value >> shift) & 0xFFFF;
+      zeros += (chunk == 0x0000);
+      ones += (chunk == 0xFFFF);
+    }
+    const unsigned chunks = width / 16;
+    std::uint32_t bitmask;
+    if (zeros < chunks - 1 && ones < chunks - 1 && encode_bitmask(value, width, bitmask)) {
+      return orr(dst, static_cast<Reg>(31), value);
+    }
+    /* Start from the more common filler, then patch the other chunks: */
+    const bool inverted = ones > zeros;
+    const std::uint32_t filler = inverted ? 0xFFFF : 0x0000;
+    bool first = true;
+    for (unsigned shift = 0; shift < width; shift += 16) {
+      const std::uint32_t chunk = (value >> shift) & 0xFFFF;
+      if (chunk == filler) continue;
+      if (!first) {
+        movk(dst, chunk, shift);
+      }
+      else if (inverted) {
+        movn(dst, chunk ^ 0xFFFF, shift);
+      }
+      else {
+        movz(dst, chunk, shift);
+      }
+      first = false;
+    }
+    if (first) {
+      return inverted ? movn(dst, 0) : movz(dst, 0);
+    }
+    return *this;
+  }
+
+  /**
+   * Emits an `MOV` (vector move) instruction.
+   *
+   * This is an alias of `ORR` with both sources the same.
+   *
+   * @copydetails emit_vector_instruction
+   */
+  arm_emitter& mov(const arm_vreg dst, const arm_vreg src, const arm_arrangement arrangement) {
+    return orr(dst, src, src, arrangement);
+  }
+
+  /**
+   * Emits a `MOVK` (move wide with keep) instruction.
+   *
+   * @param dst   a 32- or 64-bit target register
+   * @param imm   the 16-bit immediate value
+   * @param shift the left shift of the value: 0 or 16, or also 32 or 48
+   *              for a 64-bit register
+   * @copydetails emit_general_purpose_instruction
+   * @throws std::out_of_range if the value or shift is not encodable
+   */
+  template <typename Reg>
+  arm_emitter& movk(const Reg dst, const std::uint32_t imm, const unsigned shift = 0) {
+    return emit_move_wide(3, dst, imm, shift);
+  }
+
+  /**
+   * Emits a `MOVN` (move wide with NOT) instruction.
+   *
+   * @param dst   a 32- or 64-bit target register
+   * @param imm   the 16-bit immediate value
+   * @param shift the left shift of the value: 0 or 16, or also 32 or 48
+   *              for a 64-bit register
+   * @copydetails emit_general_purpose_instruction
+   * @throws std::out_of_range if the value or shift is not encodable
+   */
+  template <typename Reg>
+  arm_emitter& movn(const Reg dst, const std::uint32_t imm, const unsigned shift = 0) {
+    return emit_move_wide(0, dst, imm, shift);
+  }
+
+  /**
+   * Emits a `MOVZ` (move wide with zero) instruction.
+   *
+   * @param dst   a 32- or 64-bit target register
+   * @param imm   the 16-bit immediate value
+   * @param shift the left shift of the value: 0 or 16, or also 32 or 48
+   *              for a 64-bit register
+   * @copydetails emit_general_purpose_instruction
+   * @throws std::out_of_range if the value or shift is not encodable
+   */
+  template <typename Reg>
+  arm_emitter& movz(const Reg dst, const std::uint32_t imm, const unsigned shift = 0) {
+    return emit_move_wide(2, dst, imm, shift);
+  }
+
+  /**
+   * Emits an `MSUB` (multiply-subtract) instruction, which subtracts the product of `src1` and `src2` from `addend`.
+   *
+   * @param dst    a 32- or 64-bit target register
+   * @param src1   the multiplicand register of the same width
+   * @param src2   the multiplier register of the same width
+   * @param addend the addend or minuend register of the same width
+   * @copydetails emit_general_purpose_instruction
+   */
+  template <typename Reg>
+  arm_emitter& msub(const Reg dst, const Reg src1, const Reg src2, const Reg addend) {
+    return emit_dp3(1, dst, src1, src2, addend);
+  }
+
+  /**
+   * Emits a `MUL` (multiply) instruction, an alias of `MADD` to the zero
+   * register.
+   *
+   * @param dst  a 32- or 64-bit target register
+   * @param src1 the multiplicand register of the same width
+   * @param src2 the multiplier register of the same width
+   * @copydetails emit_general_purpose_instruction
+   */
+  template <typename Reg>
+  arm_emitter& mul(const Reg dst, const Reg src1, const Reg src2) {
+    return madd(dst, src1, src2, static_cast<Reg>(31));
+  }
+
+  /**
+   * Emits a `MUL` (vector multiply) instruction.
+   *
+   * @copydetails emit_vector_instruction
+   */
+  arm_emitter& mul(const arm_vreg dst, const arm_vreg src1, const arm_vreg src2,
+                   const arm_arrangement arrangement) {
+    return emit_simd(0x0E209C00, dst, src1, code_of(src2), arrangement, no_64bit_lanes);
+  }
+
+  /**
+   * Emits a `MUL` (predicated multiply) instruction.
+   *
+   * @copydetails emit_sve_predicated_instruction
+   */
+  arm_emitter& mul(const arm_zreg dst, const arm_preg pg, const arm_zreg src,
+                   const arm_element element) {
+    return emit_sve(0x04100000 | (governing_of(pg) << 10) | (code_of(src) << 5) | code_of(dst),
+                    element, any_element);
+  }
+
+  /**
+   * Emits an `MVN` (bitwise NOT) instruction, an alias of `ORN` from the
+   * zero register.
+   *
+   * @copydetails emit_logical_instruction
+   */
+  template <typename Reg>
+  arm_emitter& mvn(const Reg dst, const Reg src,
+                   const arm_shift shift = arm_shift::lsl, const unsigned amount = 0) {
+    return orn(dst, static_cast<Reg>(31), src, shift, amount);
+  }
+
+  /**
+   * Emits a `NEG` (negate) instruction, an alias of `SUB` from the zero
+   * register.
+   *
+   * @copydetails emit_arithmetic_instruction
+   */
+  template <typename Reg>
+  arm_emitter& neg(const Reg dst, const Reg src,
+                   const arm_shift shift = arm_shift::lsl, const unsigned amount = 0) {
+    return sub(dst, static_cast<Reg>(31), src, shift, amount);
+  }
+
+  /**
+   * Emits an `NEG` (vector negate) instruction.
+   *
+   * @copydetails emit_vector_instruction
+   */
+  arm_emitter& neg(const arm_vreg dst, const arm_vreg src, const arm_arrangement arrangement) {
+    return emit_simd(0x2E20B800, dst, src, 0, arrangement, no_1d);
+  }
+
+  /**
+   * Emits a `NOP` instruction.
+   *
+   * @copydetails emit_general_purpose_instruction
+   */
+  arm_emitter& nop() {
+    return hint(0);
+  }
+
+  /**
+   * Emits an `NOT` (vector bitwise NOT) instruction.
+   *
+   * @copydetails emit_vector_instruction
+   */
+  arm_emitter& not_(const arm_vreg dst, const arm_vreg src, const arm_arrangement arrangement) {
+    return emit_simd(0x2E205800, dst, src, 0, arrangement, byte_lanes);
+  }
+
+  /**
+   * Emits an `ORN` (bitwise inclusive OR NOT) instruction with a shifted register,
+   * which is inverted after shifting.
+   *
+   * @copydetails emit_logical_instruction
+   */
+  template <typename Reg>
+  arm_emitter& orn(const Reg dst, const Reg src1, const Reg src2,
+                   const arm_shift shift = arm_shift::lsl, const unsigned amount = 0) {
+    return emit_logical_shifted(1, 1, dst, src1, src2, shift, amount);
+  }
+
+  /**
+   * Emits an `ORN` (vector bitwise OR NOT) instruction.
+   *
+   * @copydetails emit_vector_instruction
+   */
+  arm_emitter& orn(const arm_vreg dst, const arm_vreg src1, const arm_vreg src2,
+                   const arm_arrangement arrangement) {
+    return emit_simd(0x0EE01C00, dst, src1, code_of(src2), arrangement, byte_lanes);
+  }
+
+  /**
+   * Emits an `ORR` (bitwise inclusive OR) instruction with a bitmask immediate value.
+   *
+   * @copydetails emit_logical_instruction
+   */
+  template <typename Reg>
+  arm_emitter& orr(const Reg dst, const Reg src, const std::uint64_t imm) {
+    return emit_logical_imm(1, dst, src, imm);
+  }
+
+  /**
+   * Emits an `ORR` (bitwise inclusive OR) instruction with a shifted register.
+   *
+   * @copydetails emit_logical_instruction
+   */
+  template <typename Reg>
+  arm_emitter& orr(const Reg dst, const Reg src1, const Reg src2,
+                   const arm_shift shift = arm_shift::lsl, const unsigned amount = 0) {
+    return emit_logical_shifted(1, 0, dst, src1, src2, shift, amount);
+  }
+
+  /**
+   * Emits an `ORR` (vector bitwise OR) instruction.
+   *
+   * @copydetails emit_vector_instruction
+   */
+  arm_emitter& orr(const arm_vreg dst, const arm_vreg src1, const arm_vreg src2,
+                   const arm_arrangement arrangement) {
+    return emit_simd(0x0EA01C00, dst, src1, code_of(src2), arrangement, byte_lanes);
+  }
+
+  /**
+   * Emits an `ORR` (predicated bitwise OR) instruction.
+   *
+   * @copydetails emit_sve_predicated_instruction
+   */
+  arm_emitter& orr(const arm_zreg dst, const arm_preg pg, const arm_zreg src,
+                   const arm_element element) {
+    return emit_sve(0x04180000 | (governing_of(pg) << 10) | (code_of(src) << 5) | code_of(dst),
+                    element, any_element);
+  }
+
+  /**
+   * Emits a `PTRUE` (initialize predicate) instruction.
+   *
+   * Sets the lanes of `dst` selected by `pattern`, and clears the others.
+   *
+   * @copydetails emit_sve_instruction
+   */
+  arm_emitter& ptrue(const arm_preg dst, const arm_element element,
+                     const arm_pattern pattern = arm_pattern::all) {
+    return emit_sve(0x2518E000 | (static_cast<std::uint32_t>(pattern) << 5) | code_of(dst),
+                    element, any_element);
+  }
+
+  /**
+   * Emits a `RBIT` (reverse bits) instruction.
+   *
+   * @param dst a 32- or 64-bit target register
+   * @param src the source register of the same width
+   * @copydetails emit_general_purpose_instruction
+   */
+  template <typename Reg>
+  arm_emitter& rbit(const Reg dst, const Reg src) {
+    return emit_dp1(0, dst, src);
+  }
+
+  /**
+   * Emits a `RDFFR` (read the first-fault register) instruction.
+   *
+   * Copies the first-fault register (FFR) to `dst`, which then has the lanes
+   * that the first-fault loads since `SETFFR` did not clear.
+   *
+   * @copydetails emit_sve_instruction
+   */
+  arm_emitter& rdffr(const arm_preg dst) {
+    return emit(0x2519F000 | code_of(dst));
+  }
+
+  /**
+   * Emits a `RDFFR` (read the first-fault register, predicated) instruction.
+   *
+   * Copies the lanes of the first-fault register (FFR) that are active in
+   * `pg` to `dst`, and clears the others.
+   *
+   * @param pg any predicate register
+   * @copydetails emit_sve_instruction
+   */
+  arm_emitter& rdffr(const arm_preg dst, const arm_preg pg) {
+    return emit(0x2518F000 | (code_of(pg) << 5) | code_of(dst));
+  }
+
+  /**
+   * Emits a `RET` (return from subroutine) instruction.
+   *
+   * @param target the register holding the return address
+   * @copydetails emit_general_purpose_instruction
+   */
+  arm_emitter& ret(const arm_xreg target = arm_xreg::x30) {
+    return emit(0xD65F0000 | (code_of(target) << 5));
+  }
+
+  /**
+   * Emits a `REV` (reverse bytes) instruction.
+   *
+   * @param dst a 32- or 64-bit target register
+   * @param src the source register of the same width
+   * @copydetails emit_general_purpose_instruction
+   */
+  template <typename Reg>
+  arm_emitter& rev(const Reg dst, const Reg src) {
+    return emit_dp1(sf_of(dst) ? 3 : 2, dst, src);
+  }
+
+  /**
+   * Emits an `ROR` (rotate right) instruction by a constant amount, an alias
+   * of `EXTR`.
+   *
+   * @param dst    a 32- or 64-bit target register
+   * @param src    the source register of the same width
+   * @param amount the shift amount, less than the register width
+   * @copydetails emit_general_purpose_instruction
+   * @throws std::out_of_range if `amount` is not less than the register width
+   */
+  template <typename Reg>
+  arm_emitter& ror(const Reg dst, const Reg src, const unsigned amount) {
+    check_shift(dst, amount);
+    return extr(dst, src, src, amount);
+  }
+
+  /**
+   * Emits an `ROR` (rotate right) instruction by a register amount, an alias
+   * of `RORV`.
+   *
+   * Only the low 5 or 6 bits of the amount are used, i.e. the amount is
+   * taken modulo the register width.
+   *
+   * @param dst    a 32- or 64-bit target register
+   * @param src    the source register of the same width
+   * @param amount the shift amount register of the same width
+   * @copydetails emit_general_purpose_instruction
+   */
+  template <typename Reg>
+  arm_emitter& ror(const Reg dst, const Reg src, const Reg amount) {
+    return emit_dp2(11, dst, src, amount);
+  }
+
+  /**
+   * Emits an `SADDL` (signed add long) instruction.
+   *
+   * @copydetails emit_vector_widening_instruction
+   */
+  arm_emitter& saddl(const arm_vreg dst, const arm_vreg src1, const arm_vreg src2,
+                     const arm_arrangement arrangement) {
+    return emit_simd(0x0E200000, dst, src1, code_of(src2), arrangement, no_64bit_lanes);
+  }
+
+  /**
+   * Emits an `SADDLV` (signed add long across vector) instruction.
+   *
+   * Reduces the lanes of `src` into the lowest lane of `dst`, which is twice
+   * as wide, clearing the rest of it.
+   *
+   * @copydetails emit_vector_instruction
+   */
+  arm_emitter& saddlv(const arm_vreg dst, const arm_vreg src, const arm_arrangement arrangement) {
+    return emit_simd(0x0E303800, dst, src, 0, arrangement, across_lanes);
+  }
+
+  /**
+   * Emits an `SBFIZ` (signed bitfield insert in zeros) instruction.
+   *
+   * @copydetails emit_bitfield_instruction
+   */
+  template <typename Reg>
+  arm_emitter& sbfiz(const Reg dst, const Reg src, const unsigned lsb, const unsigned width) {
+    check_bitfield(dst, lsb, width);
+    return sbfm(dst, src, (width_of(dst) - lsb) % width_of(dst), width - 1);
+  }
+
+  /**
+   * Emits an `SBFM` (signed bitfield move) instruction.
+   *
+   * This is the general form behind the bitfield and shift aliases, which
+   * are usually clearer.
+   *
+   * @param dst  a 32- or 64-bit target register
+   * @param src  the source register of the same width
+   * @param immr the right rotation amount
+   * @param imms the index of the most significant source bit to move
+   * @copydetails emit_general_purpose_instruction
+   * @throws std::out_of_range if `immr` or `imms` is not less than the
+   *         register width
+   */
+  template <typename Reg>
+  arm_emitter& sbfm(const Reg dst, const Reg src, const unsigned immr, const unsigned imms) {
+    return emit_bitfield(0, dst, src, immr, imms);
+  }
+
+  /**
+   * Emits an `SBFX` (signed bitfield extract) instruction.
+   *
+   * @copydetails emit_bitfield_instruction
+   */
+  template <typename Reg>
+  arm_emitter& sbfx(const Reg dst, const Reg src, const unsigned lsb, const unsigned width) {
+    check_bitfield(dst, lsb, width);
+    return sbfm(dst, src, lsb, lsb + width - 1);
+  }
+
+  /**
+   * Emits an `SCVTF` (signed integer convert to floating-point) instruction.
+   *
+   * Converts each lane from an integer of the same size.
+   *
+   * @copydetails emit_vector_instruction
+   */
+  arm_emitter& scvtf(const arm_vreg dst, const arm_vreg src, const arm_arrangement arrangement) {
+    return emit_simd_fp(0x0E21D800, dst, src, 0, arrangement);
+  }
+
+  /**
+   * Emits an `SDIV` (signed divide) instruction.
+   *
+   * The quotient is rounded towards zero. Dividing by zero yields zero
+   * rather than trapping.
+   *
+   * @param dst  a 32- or 64-bit target register
+   * @param src1 the dividend register of the same width
+   * @param src2 the divisor register of the same width
+   * @copydetails emit_general_purpose_instruction
+   */
+  template <typename Reg>
+  arm_emitter& sdiv(const Reg dst, const Reg src1, const Reg src2) {
+    return emit_dp2(3, dst, src1, src2);
+  }
+
+  /**
+   * Emits an `SDIV` (predicated signed divide) instruction.
+   *
+   * @copydetails emit_sve_predicated_instruction
+   */
+  arm_emitter& sdiv(const arm_zreg dst, const arm_preg pg, const arm_zreg src,
+                    const arm_element element) {
+    return emit_sve(0x04140000 | (governing_of(pg) << 10) | (code_of(src) << 5) | code_of(dst),
+                    element, word_elements);
+  }
+
+  /**
+   * Emits a `SETFFR` (initialize the first-fault register) instruction.
+   *
+   * Sets every lane of the first-fault register (FFR), as first-fault loads
+   * expect beforehand.
+   *
+   * @copydetails emit_sve_instruction
+   */
+  arm_emitter& setffr() {
+    return emit(0x252C9000);
+  }
+
+  /**
+   * Emits a `SEV` instruction.
+   *
+   * @copydetails emit_general_purpose_instruction
+   */
+  arm_emitter& sev() {
+    return hint(4);
+  }
+
+  /**
+   * Emits a `SEVL` instruction.
+   *
+   * @copydetails emit_general_purpose_instruction
+   */
+  arm_emitter& sevl() {
+    return hint(5);
+  }
+
+  /**
+   * Emits an `SHL` (vector shift left) instruction.
+   *
+   * @param amount the shift amount, less than the lane size in bits
+   * @copydetails emit_vector_instruction
+   */
+  arm_emitter& shl(const arm_vreg dst, const arm_vreg src, const unsigned amount,
+                   const arm_arrangement arrangement) {
+    check_lane_shift(arrangement, amount, 0);
+    return emit_simd_shift(0x0F005400, dst, src, (8U << size_of(arrangement)) + amount, arrangement, no_1d);
+  }
+
+  /**
+   * Emits an `SHRN` (shift right narrow) instruction.
+   *
+   * @param amount the shift amount, from 1 up to the narrow lane size in bits
+   * @copydetails emit_vector_narrowing_instruction
+   */
+  arm_emitter& shrn(const arm_vreg dst, const arm_vreg src, const unsigned amount,
+                    const arm_arrangement arrangement) {
+    check_lane_shift(arrangement, amount, 1);
+    return emit_simd_shift(0x0F008400, dst, src, (16U << size_of(arrangement)) - amount, arrangement, no_64bit_lanes);
+  }
+
+  /**
+   * Emits an `SMAX` (signed maximum) instruction.
+   *
+   * @copydetails emit_vector_instruction
+   */
+  arm_emitter& smax(const arm_vreg dst, const arm_vreg src1, const arm_vreg src2,
+                    const arm_arrangement arrangement) {
+    return emit_simd(0x0E206400, dst, src1, code_of(src2), arrangement, no_64bit_lanes);
+  }
+
+  /**
+   * Emits an `SMAX` (predicated signed maximum) instruction.
+   *
+   * @copydetails emit_sve_predicated_instruction
+   */
+  arm_emitter& smax(const arm_zreg dst, const arm_preg pg, const arm_zreg src,
+                    const arm_element element) {
+    return emit_sve(0x04080000 | (governing_of(pg) << 10) | (code_of(src) << 5) | code_of(dst),
+                    element, any_element);
+  }
+
+  /**
+   * Emits an `SMAXV` (signed maximum across vector) instruction.
+   *
+   * Reduces the lanes of `src` into the lowest lane of `dst`, clearing the
+   * rest of it.
+   *
+   * @copydetails emit_vector_instruction
+   */
+  arm_emitter& smaxv(const arm_vreg dst, const arm_vreg src, const arm_arrangement arrangement) {
+    return emit_simd(0x0E30A800, dst, src, 0, arrangement, across_lanes);
+  }
+
+  /**
+   * Emits an `SMIN` (signed minimum) instruction.
+   *
+   * @copydetails emit_vector_instruction
+   */
+  arm_emitter& smin(const arm_vreg dst, const arm_vreg src1, const arm_vreg src2,
+                    const arm_arrangement arrangement) {
+    return emit_simd(0x0E206C00, dst, src1, code_of(src2), arrangement, no_64bit_lanes);
+  }
+
+  /**
+   * Emits an `SMIN` (predicated signed minimum) instruction.
+   *
+   * @copydetails emit_sve_predicated_instruction
+   */
+  arm_emitter& smin(const arm_zreg dst, const arm_preg pg, const arm_zreg src,
+                    const arm_element element) {
+    return emit_sve(0x040A0000 | (governing_of(pg) << 10) | (code_of(src) << 5) | code_of(dst),
+                    element, any_element);
+  }
+
+  /**
+   * Emits an `SMINV` (signed minimum across vector) instruction.
+   *
+   * Reduces the lanes of `src` into the lowest lane of `dst`, clearing the
+   * rest of it.
+   *
+   * @copydetails emit_vector_instruction
+   */
+  arm_emitter& sminv(const arm_vreg dst, const arm_vreg src, const arm_arrangement arrangement) {
+    return emit_simd(0x0E31A800, dst, src, 0, arrangement, across_lanes);
+  }
+
+  /**
+   * Emits an `SMLAL` (signed multiply-add long) instruction.
+   *
+   * @copydetails emit_vector_widening_instruction
+   */
+  arm_emitter& smlal(const arm_vreg dst, const arm_vreg src1, const arm_vreg src2,
+                     const arm_arrangement arrangement) {
+    return emit_simd(0x0E208000, dst, src1, code_of(src2), arrangement, no_64bit_lanes);
+  }
+
+  /**
+   * Emits an `SMOV` (signed move vector element to general-purpose register)
+   * instruction.
+   *
+   * Sign-extends one 8-, 16-, or 32-bit lane of `src` into `dst`.
+   *
+   * @param dst   a 32- or 64-bit register, or a 64-bit one for 32-bit lanes
+   * @param index the lane of `src`, counted as in a 128-bit arrangement
+   * @copydetails emit_vector_instruction
+   */
+  template <typename Reg>
+  arm_emitter& smov(const Reg dst, const arm_vreg src, const unsigned index,
+                    const arm_arrangement arrangement) {
+    if (size_of(arrangement) >= 2 + sf_of(dst)) {
+      throw std::invalid_argument("lane must be narrower than the target register");
+    }
+    return emit(0x0E002C00 | (sf_of(dst) << 30) | (element_of(arrangement, index) << 16) |
+      (code_of(src) << 5) | code_of(dst));
+  }
+
+  /**
+   * Emits an `SMULH` (signed multiply high) instruction, which computes the upper 64
+   * bits of the 128-bit product.
+   *
+   * @param dst  the 64-bit target register
+   * @param src1 the 64-bit multiplicand register
+   * @param src2 the 64-bit multiplier register
+   * @copydetails emit_general_purpose_instruction
+   */
+  arm_emitter& smulh(const arm_xreg dst, const arm_xreg src1, const arm_xreg src2) {
+    return emit(0x9B400000 | (code_of(src2) << 16) | (31 << 10) | (code_of(src1) << 5) | code_of(dst));
+  }
+
+  /**
+   * Emits an `SMULL` (signed multiply long) instruction, which computes the 64-bit
+   * product of two 32-bit registers.
+   *
+   * @param dst  the 64-bit target register
+   * @param src1 the 32-bit multiplicand register
+   * @param src2 the 32-bit multiplier register
+   * @copydetails emit_general_purpose_instruction
+   */
+  arm_emitter& smull(const arm_xreg dst, const arm_wreg src1, const arm_wreg src2) {
+    return emit(0x9B200000 | (code_of(src2) << 16) | (31 << 10) | (code_of(src1) << 5) | code_of(dst));
+  }
+
+  /**
+   * Emits an `SMULL` (signed multiply long) instruction.
+   *
+   * @copydetails emit_vector_widening_instruction
+   */
+  arm_emitter& smull(const arm_vreg dst, const arm_vreg src1, const arm_vreg src2,
+                     const arm_arrangement arrangement) {
+    return emit_simd(0x0E20C000, dst, src1, code_of(src2), arrangement, no_64bit_lanes);
+  }
+
+  /**
+   * Emits an `SQADD` (signed saturating add) instruction.
+   *
+   * @copydetails emit_vector_instruction
+   */
+  arm_emitter& sqadd(const arm_vreg dst, const arm_vreg src1, const arm_vreg src2,
+                     const arm_arrangement arrangement) {
+    return emit_simd(0x0E200C00, dst, src1, code_of(src2), arrangement, no_1d);
+  }
+
+  /**
+   * Emits an `SQSUB` (signed saturating subtract) instruction.
+   *
+   * @copydetails emit_vector_instruction
+   */
+  arm_emitter& sqsub(const arm_vreg dst, const arm_vreg src1, const arm_vreg src2,
+                     const arm_arrangement arrangement) {
+    return emit_simd(0x0E202C00, dst, src1, code_of(src2), arrangement, no_1d);
+  }
+
+  /**
+   * Emits an `SQXTN` (signed saturating extract narrow) instruction.
+   *
+   * @copydetails emit_vector_narrowing_instruction
+   */
+  arm_emitter& sqxtn(const arm_vreg dst, const arm_vreg src, const arm_arrangement arrangement) {
+    return emit_simd(0x0E214800, dst, src, 0, arrangement, no_64bit_lanes);
+  }
+
+  /**
+   * Emits an `SQXTUN` (signed saturating extract unsigned narrow) instruction.
+   *
+   * @copydetails emit_vector_narrowing_instruction
+   */
+  arm_emitter& sqxtun(const arm_vreg dst, const arm_vreg src, const arm_arrangement arrangement) {
+    return emit_simd(0x2E212800, dst, src, 0, arrangement, no_64bit_lanes);
+  }
+
+  /**
+   * Emits an `SSHLL` (signed shift left long) instruction.
+   *
+   * @param amount the shift amount, less than the narrow lane size in bits
+   * @copydetails emit_vector_widening_instruction
+   */
+  arm_emitter& sshll(const arm_vreg dst, const arm_vreg src, const unsigned amount,
+                     const arm_arrangement arrangement) {
+    check_lane_shift(arrangement, amount, 0);
+    return emit_simd_shift(0x0F00A400, dst, src, (8U << size_of(arrangement)) + amount, arrangement, no_64bit_lanes);
+  }
+
+  /**
+   * Emits an `SSHR` (signed shift right) instruction.
+   *
+   * @param amount the shift amount, from 1 up to the lane size in bits
+   * @copydetails emit_vector_instruction
+   */
+  arm_emitter& sshr(const arm_vreg dst, const arm_vreg src, const unsigned amount,
+                    const arm_arrangement arrangement) {
+    check_lane_shift(arrangement, amount, 1);
+    return emit_simd_shift(0x0F000400, dst, src, (16U << size_of(arrangement)) - amount, arrangement, no_1d);
+  }
+
+  /**
+   * Emits an `SSUBL` (signed subtract long) instruction.
+   *
+   * @copydetails emit_vector_widening_instruction
+   */
+  arm_emitter& ssubl(const arm_vreg dst, const arm_vreg src1, const arm_vreg src2,
+                     const arm_arrangement arrangement) {
+    return emit_simd(0x0E202000, dst, src1, code_of(src2), arrangement, no_64bit_lanes);
+  }
+
+  /**
+   * Emits an `ST1` (store multiple single-element structures) instruction.
+   *
+   * Stores 1 to 4 consecutive registers starting at `src`, without
+   * interleaving.
+   *
+   * @param count the number of registers
+   * @copydetails emit_vector_load_store_instruction
+   */
+  arm_emitter& st1(const arm_vreg src, const arm_mem& mem, const arm_arrangement arrangement,
+                   const unsigned count = 1) {
+    static const std::uint8_t opcodes[] = {0x7, 0xA, 0x6, 0x2};
+    check_list(count);
+    return emit_load_store_multiple(0, opcodes[count - 1], count, src, mem, arrangement);
+  }
+
+  /**
+   * Emits an `ST1B` (store bytes) instruction.
+   *
+   * Stores the lanes of `src` that are active in `pg` to consecutive bytes,
+   * leaving the memory of the others untouched.
+   *
+   * @copydetails emit_sve_load_store_instruction
+   */
+  arm_emitter& st1b(const arm_zreg src, const arm_preg pg, const arm_mem& mem) {
+    return emit_sve_load_store(0xE4004000, 0xE400E000, 0, src, pg, mem);
+  }
+
+  /**
+   * Emits an `ST1D` (store doublewords) instruction.
+   *
+   * Stores the lanes of `src` that are active in `pg` to consecutive
+   * doublewords, leaving the memory of the others untouched.
+   *
+   * @copydetails emit_sve_load_store_instruction
+   */
+  arm_emitter& st1d(const arm_zreg src, const arm_preg pg, const arm_mem& mem) {
+    return emit_sve_load_store(0xE5E04000, 0xE5E0E000, 3, src, pg, mem);
+  }
+
+  /**
+   * Emits an `ST1H` (store halfwords) instruction.
+   *
+   * Stores the lanes of `src` that are active in `pg` to consecutive
+   * halfwords, leaving the memory of the others untouched.
+   *
+   * @copydetails emit_sve_load_store_instruction
+   */
+  arm_emitter& st1h(const arm_zreg src, const arm_preg pg, const arm_mem& mem) {
+    return emit_sve_load_store(0xE4A04000, 0xE4A0E000, 1, src, pg, mem);
+  }
+
+  /**
+   * Emits an `ST1W` (store words) instruction.
+   *
+   * Stores the lanes of `src` that are active in `pg` to consecutive words,
+   * leaving the memory of the others untouched.
+   *
+   * @copydetails emit_sve_load_store_instruction
+   */
+  arm_emitter& st1w(const arm_zreg src, const arm_preg pg, const arm_mem& mem) {
+    return emit_sve_load_store(0xE5404000, 0xE540E000, 2, src, pg, mem);
+  }
+
+  /**
+   * Emits an `ST2` (store multiple 2-element structures) instruction.
+   *
+   * Stores 2 consecutive registers starting at `src`, interleaving their
+   * lanes.
+   *
+   * @copydetails emit_vector_load_store_instruction
+   */
+  arm_emitter& st2(const arm_vreg src, const arm_mem& mem, const arm_arrangement arrangement) {
+    check_arrangement(arrangement, no_1d);
+    return emit_load_store_multiple(0, 0x8, 2, src, mem, arrangement);
+  }
+
+  /**
+   * Emits an `ST3` (store multiple 3-element structures) instruction.
+   *
+   * Stores 3 consecutive registers starting at `src`, interleaving their
+   * lanes.
+   *
+   * @copydetails emit_vector_load_store_instruction
+   */
+  arm_emitter& st3(const arm_vreg src, const arm_mem& mem, const arm_arrangement arrangement) {
+    check_arrangement(arrangement, no_1d);
+    return emit_load_store_multiple(0, 0x4, 3, src, mem, arrangement);
+  }
+
+  /**
+   * Emits an `ST4` (store multiple 4-element structures) instruction.
+   *
+   * Stores 4 consecutive registers starting at `src`, interleaving their
+   * lanes.
+   *
+   * @copydetails emit_vector_load_store_instruction
+   */
+  arm_emitter& st4(const arm_vreg src, const arm_mem& mem, const arm_arrangement arrangement) {
+    check_arrangement(arrangement, no_1d);
+    return emit_load_store_multiple(0, 0x0, 4, src, mem, arrangement);
+  }
+
+  /**
+   * Emits an `STLR` (store-release register) instruction.
+   *
+   * @param src  a 32- or 64-bit source register
+   * @param base the 64-bit base address register, which may be `SP`
+   * @copydetails emit_general_purpose_instruction
+   */
+  template <typename Reg>
+  arm_emitter& stlr(const Reg src, const arm_xreg base) {
+    return emit_ldst_ordered(0x089FFC00, src, 31, base);
+  }
+
+  /**
+   * Emits an `STLXR` (store-release exclusive register) instruction.
+   *
+   * @param status the 32-bit status register, set to 0 on success and to 1
+   *               if the exclusive access failed
+   * @param src    a 32- or 64-bit source register
+   * @param base   the 64-bit base address register, which may be `SP`
+   * @copydetails emit_general_purpose_instruction
+   */
+  template <typename Reg>
+  arm_emitter& stlxr(const arm_wreg status, const Reg src, const arm_xreg base) {
+    return emit_ldst_ordered(0x0800FC00, src, code_of(status), base);
+  }
+
+  /**
+   * Emits an `STP` (store pair of registers) instruction.
+   *
+   * @param src1 a 32- or 64-bit source register
+   * @param src2 the second source register of the same width
+   * @param mem  the memory operand
+   * @copydetails emit_load_store_pair_instruction
+   */
+  template <typename Reg>
+  arm_emitter& stp(const Reg src1, const Reg src2, const arm_mem& mem) {
+    return emit_load_store_pair(sf_of(src1) << 1, 0, 4 << sf_of(src1), code_of(src1), code_of(src2), mem);
+  }
+
+  /**
+   * Emits an `STR` (store register) instruction.
+   *
+   * @param src a 32- or 64-bit source register
+   * @param mem the memory operand
+   * @copydetails emit_load_store_instruction
+   */
+  template <typename Reg>
+  arm_emitter& str(const Reg src, const arm_mem& mem) {
+    return emit_load_store(2 | sf_of(src), 0, code_of(src), mem);
+  }
+
+  /**
+   * Emits an `STRB` (store register byte) instruction.
+   *
+   * @param src the 32-bit source register
+   * @param mem the memory operand
+   * @copydetails emit_load_store_instruction
+   */
+  arm_emitter& strb(const arm_wreg src, const arm_mem& mem) {
+    return emit_load_store(0, 0, code_of(src), mem);
+  }
+
+  /**
+   * Emits an `STRH` (store register halfword) instruction.
+   *
+   * @param src the 32-bit source register
+   * @param mem the memory operand
+   * @copydetails emit_load_store_instruction
+   */
+  arm_emitter& strh(const arm_wreg src, const arm_mem& mem) {
+    return emit_load_store(1, 0, code_of(src), mem);
+  }
+
+  /**
+   * Emits an `STUR` (store register (unscaled)) instruction.
+   *
+   * @param src a 32- or 64-bit source register
+   * @param mem the memory operand
+   * @copydetails emit_load_store_unscaled_instruction
+   */
+  template <typename Reg>
+  arm_emitter& stur(const Reg src, const arm_mem& mem) {
+    if (mem.mode != arm_addressing::offset) {
+      throw std::invalid_argument("unscaled loads and stores take an immediate offset only");
+    }
+    return emit_load_store_imm9(0x38000000, 2 | sf_of(src), 0, code_of(src), mem);
+  }
+
+  /**
+   * Emits an `STURB` (store register (unscaled) byte) instruction.
+   *
+   * @param src the 32-bit source register
+   * @param mem the memory operand
+   * @copydetails emit_load_store_unscaled_instruction
+   */
+  arm_emitter& sturb(const arm_wreg src, const arm_mem& mem) {
+    if (mem.mode != arm_addressing::offset) {
+      throw std::invalid_argument("unscaled loads and stores take an immediate offset only");
+    }
+    return emit_load_store_imm9(0x38000000, 0, 0, code_of(src), mem);
+  }
+
+  /**
+   * Emits an `STURH` (store register (unscaled) halfword) instruction.
+   *
+   * @param src the 32-bit source register
+   * @param mem the memory operand
+   * @copydetails emit_load_store_unscaled_instruction
+   */
+  arm_emitter& sturh(const arm_wreg src, const arm_mem& mem) {
+    if (mem.mode != arm_addressing::offset) {
+      throw std::invalid_argument("unscaled loads and stores take an immediate offset only");
+    }
+    return emit_load_store_imm9(0x38000000, 1, 0, code_of(src), mem);
+  }
+
+  /**
+   * Emits an `STXR` (store exclusive register) instruction.
+   *
+   * @param status the 32-bit status register, set to 0 on success and to 1
+   *               if the exclusive access failed
+   * @param src    a 32- or 64-bit source register
+   * @param base   the 64-bit base address register, which may be `SP`
+   * @copydetails emit_general_purpose_instruction
+   */
+  template <typename Reg>
+  arm_emitter& stxr(const arm_wreg status, const Reg src, const arm_xreg base) {
+    return emit_ldst_ordered(0x08007C00, src, code_of(status), base);
+  }
+
+  /**
+   * Emits a `SUB` (subtract) instruction with an immediate value.
+   *
+   * @copydetails emit_arithmetic_instruction
+   */
+  template <typename Reg>
+  arm_emitter& sub(const Reg dst, const Reg src, const std::uint32_t imm) {
+    return emit_addsub_imm(1, 0, dst, src, imm);
+  }
+
+  /**
+   * Emits a `SUB` (subtract) instruction with a shifted register.
+   *
+   * @copydetails emit_arithmetic_instruction
+   */
+  template <typename Reg>
+  arm_emitter& sub(const Reg dst, const Reg src1, const Reg src2,
+                   const arm_shift shift = arm_shift::lsl, const unsigned amount = 0) {
+    return emit_addsub_shifted(1, 0, dst, src1, src2, shift, amount);
+  }
+
+  /**
+   * Emits a `SUB` (subtract) instruction with an extended register.
+   *
+   * @copydetails emit_arithmetic_instruction
+   */
+  template <typename Reg, typename Src>
+  arm_emitter& sub(const Reg dst, const Reg src1, const Src src2,
+                   const arm_extend extend, const unsigned amount = 0) {
+    return emit_addsub_extended(1, 0, dst, src1, src2, extend, amount);
+  }
+
+  /**
+   * Emits an `SUB` (vector subtract) instruction.
+   *
+   * @copydetails emit_vector_instruction
+   */
+  arm_emitter& sub(const arm_vreg dst, const arm_vreg src1, const arm_vreg src2,
+                   const arm_arrangement arrangement) {
+    return emit_simd(0x2E208400, dst, src1, code_of(src2), arrangement, no_1d);
+  }
+
+  /**
+   * Emits an `SUB` (predicated subtract) instruction.
+   *
+   * @copydetails emit_sve_predicated_instruction
+   */
+  arm_emitter& sub(const arm_zreg dst, const arm_preg pg, const arm_zreg src,
+                   const arm_element element) {
+    return emit_sve(0x04010000 | (governing_of(pg) << 10) | (code_of(src) << 5) | code_of(dst),
+                    element, any_element);
+  }
+
+  /**
+   * Emits an `SUB` (unpredicated subtract) instruction.
+   *
+   * @copydetails emit_sve_instruction
+   */
+  arm_emitter& sub(const arm_zreg dst, const arm_zreg src1, const arm_zreg src2,
+                   const arm_element element) {
+    return emit_sve(0x04200400 | (code_of(src2) << 16) | (code_of(src1) << 5) | code_of(dst),
+                    element, any_element);
+  }
+
+  /**
+   * Emits a `SUBS` (subtract, setting flags) instruction with an immediate value.
+   *
+   * @copydetails emit_arithmetic_instruction
+   */
+  template <typename Reg>
+  arm_emitter& subs(const Reg dst, const Reg src, const std::uint32_t imm) {
+    return emit_addsub_imm(1, 1, dst, src, imm);
+  }
+
+  /**
+   * Emits a `SUBS` (subtract, setting flags) instruction with a shifted register.
+   *
+   * @copydetails emit_arithmetic_instruction
+   */
+  template <typename Reg>
+  arm_emitter& subs(const Reg dst, const Reg src1, const Reg src2,
+                    const arm_shift shift = arm_shift::lsl, const unsigned amount = 0) {
+    return emit_addsub_shifted(1, 1, dst, src1, src2, shift, amount);
+  }
+
+  /**
+   * Emits a `SUBS` (subtract, setting flags) instruction with an extended register.
+   *
+   * @copydetails emit_arithmetic_instruction
+   */
+  template <typename Reg, typename Src>
+  arm_emitter& subs(const Reg dst, const Reg src1, const Src src2,
+                    const arm_extend extend, const unsigned amount = 0) {
+    return emit_addsub_extended(1, 1, dst, src1, src2, extend, amount);
+  }
+
+  /**
+   * Emits a `SWP` (atomic swap) instruction.
+   *
+   * Atomically stores `src` into the memory at `[base]`, loading its old
+   * contents into `dst`.
+   *
+   * Requires the large system extensions (LSE) of ARMv8.1.
+   *
+   * @copydetails emit_atomic_instruction
+   */
+  template <typename Reg>
+  arm_emitter& swp(const Reg src, const Reg dst, const arm_xreg base,
+                   const arm_order order = arm_order::relaxed) {
+    return emit_atomic(8, src, dst, base, order);
+  }
+
+  /**
+   * Emits an `SXTB` (sign-extend byte) instruction, an alias of `SBFM`.
+   *
+   * @param dst a 32- or 64-bit target register
+   * @param src the 32-bit source register
+   * @copydetails emit_general_purpose_instruction
+   */
+  template <typename Reg>
+  arm_emitter& sxtb(const Reg dst, const arm_wreg src) {
+    return sbfm(dst, static_cast<Reg>(src), 0, 7);
+  }
+
+  /**
+   * Emits an `SXTH` (sign-extend halfword) instruction, an alias of `SBFM`.
+   *
+   * @param dst a 32- or 64-bit target register
+   * @param src the 32-bit source register
+   * @copydetails emit_general_purpose_instruction
+   */
+  template <typename Reg>
+  arm_emitter& sxth(const Reg dst, const arm_wreg src) {
+    return sbfm(dst, static_cast<Reg>(src), 0, 15);
+  }
+
+  /**
+   * Emits an `SXTL` (signed extend long) instruction.
+   *
+   * This is an alias of `SSHLL` with a zero shift.
+   *
+   * @copydetails emit_vector_widening_instruction
+   */
+  arm_emitter& sxtl(const arm_vreg dst, const arm_vreg src, const arm_arrangement arrangement) {
+    return sshll(dst, src, 0, arrangement);
+  }
+
+  /**
+   * Emits an `SXTW` (sign-extend word) instruction, an alias of `SBFM`.
+   *
+   * @param dst the 64-bit target register
+   * @param src the 32-bit source register
+   * @copydetails emit_general_purpose_instruction
+   */
+  arm_emitter& sxtw(const arm_xreg dst, const arm_wreg src) {
+    return sbfm(dst, static_cast<arm_xreg>(src), 0, 31);
+  }
+
+  /**
+   * Emits a `TBL` (table vector lookup) instruction.
+   *
+   * Looks up each byte of `index` in a table of 1 to 4 consecutive 128-bit
+   * registers, starting at `table`. Out-of-range indices yield a zero byte.
+   *
+   * @param count the number of table registers
+   * @copydetails emit_vector_instruction
+   */
+  arm_emitter& tbl(const arm_vreg dst, const arm_vreg table, const arm_vreg index,
+                   const arm_arrangement arrangement, const unsigned count = 1) {
+    check_arrangement(arrangement, byte_lanes);
+    check_list(count);
+    return emit(0x0E000000 | (q_of(arrangement) << 30) | (code_of(index) << 16) | ((count - 1) << 13) |
+      (code_of(table) << 5) | code_of(dst));
+  }
+
+  /**
+   * Emits a `TBNZ` (test bit and branch if nonzero) instruction to the
+   * given label.
+   *
+   * @param src the register to test
+   * @param bit the bit number, less than the register width
+   * @copydetails emit_branch_instruction
+   */
+  template <typename Reg>
+  arm_emitter& tbnz(const Reg src, const unsigned bit, const arm_label target) {
+    return branch_to(0x37000000 | test_bit_of(src, bit), 14, target);
+  }
+
+  /**
+   * Emits a `TBX` (table vector lookup extension) instruction.
+   *
+   * Looks up each byte of `index` in a table of 1 to 4 consecutive 128-bit
+   * registers, starting at `table`. Out-of-range indices leave the byte of
+   * `dst` unchanged.
+   *
+   * @param count the number of table registers
+   * @copydetails emit_vector_instruction
+   */
+  arm_emitter& tbx(const arm_vreg dst, const arm_vreg table, const arm_vreg index,
+                   const arm_arrangement arrangement, const unsigned count = 1) {
+    check_arrangement(arrangement, byte_lanes);
+    check_list(count);
+    return emit(0x0E001000 | (q_of(arrangement) << 30) | (code_of(index) << 16) | ((count - 1) << 13) |
+      (code_of(table) << 5) | code_of(dst));
+  }
+
+  /**
+   * Emits a `TBZ` (test bit and branch if zero) instruction to the given
+   * label.
+   *
+   * @param src the register to test
+   * @param bit the bit number, less than the register width
+   * @copydetails emit_branch_instruction
+   */
+  template <typename Reg>
+  arm_emitter& tbz(const Reg src, const unsigned bit, const arm_label target) {
+    return branch_to(0x36000000 | test_bit_of(src, bit), 14, target);
+  }
+
+  /**
+   * Emits a `TRN1` (transpose vectors, primary) instruction.
+   *
+   * @copydetails emit_vector_instruction
+   */
+  arm_emitter& trn1(const arm_vreg dst, const arm_vreg src1, const arm_vreg src2,
+                    const arm_arrangement arrangement) {
+    return emit_simd(0x0E002800, dst, src1, code_of(src2), arrangement, no_1d);
+  }
+
+  /**
+   * Emits a `TRN2` (transpose vectors, secondary) instruction.
+   *
+   * @copydetails emit_vector_instruction
+   */
+  arm_emitter& trn2(const arm_vreg dst, const arm_vreg src1, const arm_vreg src2,
+                    const arm_arrangement arrangement) {
+    return emit_simd(0x0E006800, dst, src1, code_of(src2), arrangement, no_1d);
+  }
+
+  /**
+   * Emits a `TST` (test bits) instruction with a bitmask immediate value,
+   * an alias of `ANDS` with the zero register as the target.
+   *
+   * @param src the tested register
+   * @param imm the bitmask immediate value
+   * @copydetails emit_logical_instruction
+   */
+  template <typename Reg>
+  arm_emitter& tst(const Reg src, const std::uint64_t imm) {
+    return ands(static_cast<Reg>(31), src, imm);
+  }
+
+  /**
+   * Emits a `TST` (test bits) instruction with a shifted register, an
+   * alias of `ANDS` with the zero register as the target.
+   *
+   * @copydetails emit_logical_instruction
+   */
+  template <typename Reg>
+  arm_emitter& tst(const Reg src1, const Reg src2,
+                   const arm_shift shift = arm_shift::lsl, const unsigned amount = 0) {
+    return ands(static_cast<Reg>(31), src1, src2, shift, amount);
+  }
+
+  /**
+   * Emits a `UADDL` (unsigned add long) instruction.
+   *
+   * @copydetails emit_vector_widening_instruction
+   */
+  arm_emitter& uaddl(const arm_vreg dst, const arm_vreg src1, const arm_vreg src2,
+                     const arm_arrangement arrangement) {
+    return emit_simd(0x2E200000, dst, src1, code_of(src2), arrangement, no_64bit_lanes);
+  }
+
+  /**
+   * Emits a `UADDLV` (unsigned add long across vector) instruction.
+   *
+   * Reduces the lanes of `src` into the lowest lane of `dst`, which is twice
+   * as wide, clearing the rest of it.
+   *
+   * @copydetails emit_vector_instruction
+   */
+  arm_emitter& uaddlv(const arm_vreg dst, const arm_vreg src, const arm_arrangement arrangement) {
+    return emit_simd(0x2E303800, dst, src, 0, arrangement, across_lanes);
+  }
+
+  /**
+   * Emits a `UBFIZ` (unsigned bitfield insert in zeros) instruction.
+   *
+   * @copydetails emit_bitfield_instruction
+   */
+  template <typename Reg>
+  arm_emitter& ubfiz(const Reg dst, const Reg src, const unsigned lsb, const unsigned width) {
+    check_bitfield(dst, lsb, width);
+    return ubfm(dst, src, (width_of(dst) - lsb) % width_of(dst), width - 1);
+  }
+
+  /**
+   * Emits a `UBFM` (unsigned bitfield move) instruction.
+   *
+   * This is the general form behind the bitfield and shift aliases, which
+   * are usually clearer.
+   *
+   * @param dst  a 32- or 64-bit target register
+   * @param src  the source register of the same width
+   * @param immr the right rotation amount
+   * @param imms the index of the most significant source bit to move
+   * @copydetails emit_general_purpose_instruction
+   * @throws std::out_of_range if `immr` or `imms` is not less than the
+   *         register width
+   */
+  template <typename Reg>
+  arm_emitter& ubfm(const Reg dst, const Reg src, const unsigned immr, const unsigned imms) {
+    return emit_bitfield(2, dst, src, immr, imms);
+  }
+
+  /**
+   * Emits a `UBFX` (unsigned bitfield extract) instruction.
+   *
+   * @copydetails emit_bitfield_instruction
+   */
+  template <typename Reg>
+  arm_emitter& ubfx(const Reg dst, const Reg src, const unsigned lsb, const unsigned width) {
+    check_bitfield(dst, lsb, width);
+    return ubfm(dst, src, lsb, lsb + width - 1);
+  }
+
+  /**
+   * Emits a `UCVTF` (unsigned integer convert to floating-point) instruction.
+   *
+   * Converts each lane from an integer of the same size.
+   *
+   * @copydetails emit_vector_instruction
+   */
+  arm_emitter& ucvtf(const arm_vreg dst, const arm_vreg src, const arm_arrangement arrangement) {
+    return emit_simd_fp(0x2E21D800, dst, src, 0, arrangement);
+  }
+
+  /**
+   * Emits a `UDIV` (unsigned divide) instruction.
+   *
+   * The quotient is rounded towards zero. Dividing by zero yields zero
+   * rather than trapping.
+   *
+   * @param dst  a 32- or 64-bit target register
+   * @param src1 the dividend register of the same width
+   * @param src2 the divisor register of the same width
+   * @copydetails emit_general_purpose_instruction
+   */
+  template <typename Reg>
+  arm_emitter& udiv(const Reg dst, const Reg src1, const Reg src2) {
+    return emit_dp2(2, dst, src1, src2);
+  }
+
+  /**
+   * Emits a `UDIV` (predicated unsigned divide) instruction.
+   *
+   * @copydetails emit_sve_predicated_instruction
+   */
+  arm_emitter& udiv(const arm_zreg dst, const arm_preg pg, const arm_zreg src,
+                    const arm_element element) {
+    return emit_sve(0x04150000 | (governing_of(pg) << 10) | (code_of(src) << 5) | code_of(dst),
+                    element, word_elements);
+  }
+
+  /**
+   * Emits a `UMAX` (unsigned maximum) instruction.
+   *
+   * @copydetails emit_vector_instruction
+   */
+  arm_emitter& umax(const arm_vreg dst, const arm_vreg src1, const arm_vreg src2,
+                    const arm_arrangement arrangement) {
+    return emit_simd(0x2E206400, dst, src1, code_of(src2), arrangement, no_64bit_lanes);
+  }
+
+  /**
+   * Emits a `UMAX` (predicated unsigned maximum) instruction.
+   *
+   * @copydetails emit_sve_predicated_instruction
+   */
+  arm_emitter& umax(const arm_zreg dst, const arm_preg pg, const arm_zreg src,
+                    const arm_element element) {
+    return emit_sve(0x04090000 | (governing_of(pg) << 10) | (code_of(src) << 5) | code_of(dst),
+                    element, any_element);
+  }
+
+  /**
+   * Emits a `UMAXV` (unsigned maximum across vector) instruction.
+   *
+   * Reduces the lanes of `src` into the lowest lane of `dst`, clearing the
+   * rest of it.
+   *
+   * @copydetails emit_vector_instruction
+   */
+  arm_emitter& umaxv(const arm_vreg dst, const arm_vreg src, const arm_arrangement arrangement) {
+    return emit_simd(0x2E30A800, dst, src, 0, arrangement, across_lanes);
+  }
+
+  /**
+   * Emits a `UMIN` (unsigned minimum) instruction.
+   *
+   * @copydetails emit_vector_instruction
+   */
+  arm_emitter& umin(const arm_vreg dst, const arm_vreg src1, const arm_vreg src2,
+                    const arm_arrangement arrangement) {
+    return emit_simd(0x2E206C00, dst, src1, code_of(src2), arrangement, no_64bit_lanes);
+  }
+
+  /**
+   * Emits a `UMIN` (predicated unsigned minimum) instruction.
+   *
+   * @copydetails emit_sve_predicated_instruction
+   */
+  arm_emitter& umin(const arm_zreg dst, const arm_preg pg, const arm_zreg src,
+                    const arm_element element) {
+    return emit_sve(0x040B0000 | (governing_of(pg) << 10) | (code_of(src) << 5) | code_of(dst),
+                    element, any_element);
+  }
+
+  /**
+   * Emits a `UMINV` (unsigned minimum across vector) instruction.
+   *
+   * Reduces the lanes of `src` into the lowest lane of `dst`, clearing the
+   * rest of it.
+   *
+   * @copydetails emit_vector_instruction
+   */
+  arm_emitter& uminv(const arm_vreg dst, const arm_vreg src, const arm_arrangement arrangement) {
+    return emit_simd(0x2E31A800, dst, src, 0, arrangement, across_lanes);
+  }
+
+  /**
+   * Emits a `UMLAL` (unsigned multiply-add long) instruction.
+   *
+   * @copydetails emit_vector_widening_instruction
+   */
+  arm_emitter& umlal(const arm_vreg dst, const arm_vreg src1, const arm_vreg src2,
+                     const arm_arrangement arrangement) {
+    return emit_simd(0x2E208000, dst, src1, code_of(src2), arrangement, no_64bit_lanes);
+  }
+
+  /**
+   * Emits a `UMOV` (unsigned move vector element to general-purpose register)
+   * instruction.
+   *
+   * Zero-extends one lane of `src` into `dst`.
+   *
+   * @param dst   a 64-bit register for 64-bit lanes, a 32-bit one otherwise
+   * @param index the lane of `src`, counted as in a 128-bit arrangement
+   * @copydetails emit_vector_instruction
+   */
+  template <typename Reg>
+  arm_emitter& umov(const Reg dst, const arm_vreg src, const unsigned index,
+                    const arm_arrangement arrangement) {
+    check_lane_register(dst, arrangement);
+    return emit(0x0E003C00 | (sf_of(dst) << 30) | (element_of(arrangement, index) << 16) |
+      (code_of(src) << 5) | code_of(dst));
+  }
+
+  /**
+   * Emits a `UMULH` (unsigned multiply high) instruction, which computes the upper 64
+   * bits of the 128-bit product.
+   *
+   * @param dst  the 64-bit target register
+   * @param src1 the 64-bit multiplicand register
+   * @param src2 the 64-bit multiplier register
+   * @copydetails emit_general_purpose_instruction
+   */
+  arm_emitter& umulh(const arm_xreg dst, const arm_xreg src1, const arm_xreg src2) {
+    return emit(0x9BC00000 | (code_of(src2) << 16) | (31 << 10) | (code_of(src1) << 5) | code_of(dst));
+  }
+
+  /**
+   * Emits a `UMULL` (unsigned multiply long) instruction, which computes the 64-bit
+   * product of two 32-bit registers.
+   *
+   * @param dst  the 64-bit target register
+   * @param src1 the 32-bit multiplicand register
+   * @param src2 the 32-bit multiplier register
+   * @copydetails emit_general_purpose_instruction
+   */
+  arm_emitter& umull(const arm_xreg dst, const arm_wreg src1, const arm_wreg src2) {
+    return emit(0x9BA00000 | (code_of(src2) << 16) | (31 << 10) | (code_of(src1) << 5) | code_of(dst));
+  }
+
+  /**
+   * Emits a `UMULL` (unsigned multiply long) instruction.
+   *
+   * @copydetails emit_vector_widening_instruction
+   */
+  arm_emitter& umull(const arm_vreg dst, const arm_vreg src1, const arm_vreg src2,
+                     const arm_arrangement arrangement) {
+    return emit_simd(0x2E20C000, dst, src1, code_of(src2), arrangement, no_64bit_lanes);
+  }
+
+  /**
+   * Emits a `UQADD` (unsigned saturating add) instruction.
+   *
+   * @copydetails emit_vector_instruction
+   */
+  arm_emitter& uqadd(const arm_vreg dst, const arm_vreg src1, const arm_vreg src2,
+                     const arm_arrangement arrangement) {
+    return emit_simd(0x2E200C00, dst, src1, code_of(src2), arrangement, no_1d);
+  }
+
+  /**
+   * Emits a `UQSUB` (unsigned saturating subtract) instruction.
+   *
+   * @copydetails emit_vector_instruction
+   */
+  arm_emitter& uqsub(const arm_vreg dst, const arm_vreg src1, const arm_vreg src2,
+                     const arm_arrangement arrangement) {
+    return emit_simd(0x2E202C00, dst, src1, code_of(src2), arrangement, no_1d);
+  }
+
+  /**
+   * Emits a `UQXTN` (unsigned saturating extract narrow) instruction.
+   *
+   * @copydetails emit_vector_narrowing_instruction
+   */
+  arm_emitter& uqxtn(const arm_vreg dst, const arm_vreg src, const arm_arrangement arrangement) {
+    return emit_simd(0x2E214800, dst, src, 0, arrangement, no_64bit_lanes);
+  }
+
+  /**
+   * Emits a `USHLL` (unsigned shift left long) instruction.
+   *
+   * @param amount the shift amount, less than the narrow lane size in bits
+   * @copydetails emit_vector_widening_instruction
+   */
+  arm_emitter& ushll(const arm_vreg dst, const arm_vreg src, const unsigned amount,
+                     const arm_arrangement arrangement) {
+    check_lane_shift(arrangement, amount, 0);
+    return emit_simd_shift(0x2F00A400, dst, src, (8U << size_of(arrangement)) + amount, arrangement, no_64bit_lanes);
+  }
+
+  /**
+   * Emits a `USHR` (unsigned shift right) instruction.
+   *
+   * @param amount the shift amount, from 1 up to the lane size in bits
+   * @copydetails emit_vector_instruction
+   */
+  arm_emitter& ushr(const arm_vreg dst, const arm_vreg src, const unsigned amount,
+                    const arm_arrangement arrangement) {
+    check_lane_shift(arrangement, amount, 1);
+    return emit_simd_shift(0x2F000400, dst, src, (16U << size_of(arrangement)) - amount, arrangement, no_1d);
+  }
+
+  /**
+   * Emits a `USUBL` (unsigned subtract long) instruction.
+   *
+   * @copydetails emit_vector_widening_instruction
+   */
+  arm_emitter& usubl(const arm_vreg dst, const arm_vreg src1, const arm_vreg src2,
+                     const arm_arrangement arrangement) {
+    return emit_simd(0x2E202000, dst, src1, code_of(src2), arrangement, no_64bit_lanes);
+  }
+
+  /**
+   * Emits a `UXTB` (zero-extend byte) instruction, an alias of `UBFM`.
+   *
+   * Writing the 32-bit target register also clears the upper half of the
+   * corresponding 64-bit register.
+   *
+   * @param dst the 32-bit target register
+   * @param src the 32-bit source register
+   * @copydetails emit_general_purpose_instruction
+   */
+  arm_emitter& uxtb(const arm_wreg dst, const arm_wreg src) {
+    return ubfm(dst, src, 0, 7);
+  }
+
+  /**
+   * Emits a `UXTH` (zero-extend halfword) instruction, an alias of `UBFM`.
+   *
+   * Writing the 32-bit target register also clears the upper half of the
+   * corresponding 64-bit register.
+   *
+   * @param dst the 32-bit target register
+   * @param src the 32-bit source register
+   * @copydetails emit_general_purpose_instruction
+   */
+  arm_emitter& uxth(const arm_wreg dst, const arm_wreg src) {
+    return ubfm(dst, src, 0, 15);
+  }
+
+  /**
+   * Emits a `UXTL` (unsigned extend long) instruction.
+   *
+   * This is an alias of `USHLL` with a zero shift.
+   *
+   * @copydetails emit_vector_widening_instruction
+   */
+  arm_emitter& uxtl(const arm_vreg dst, const arm_vreg src, const arm_arrangement arrangement) {
+    return ushll(dst, src, 0, arrangement);
+  }
+
+  /**
+   * Emits a `UZP1` (unzip vectors, primary) instruction.
+   *
+   * @copydetails emit_vector_instruction
+   */
+  arm_emitter& uzp1(const arm_vreg dst, const arm_vreg src1, const arm_vreg src2,
+                    const arm_arrangement arrangement) {
+    return emit_simd(0x0E001800, dst, src1, code_of(src2), arrangement, no_1d);
+  }
+
+  /**
+   * Emits a `UZP2` (unzip vectors, secondary) instruction.
+   *
+   * @copydetails emit_vector_instruction
+   */
+  arm_emitter& uzp2(const arm_vreg dst, const arm_vreg src1, const arm_vreg src2,
+                    const arm_arrangement arrangement) {
+    return emit_simd(0x0E005800, dst, src1, code_of(src2), arrangement, no_1d);
+  }
+
+  /**
+   * Emits a `WFE` instruction.
+   *
+   * @copydetails emit_general_purpose_instruction
+   */
+  arm_emitter& wfe() {
+    return hint(2);
+  }
+
+  /**
+   * Emits a `WFI` instruction.
+   *
+   * @copydetails emit_general_purpose_instruction
+   */
+  arm_emitter& wfi() {
+    return hint(3);
+  }
+
+  /**
+   * Emits a `WHILEGE` (while greater than or equal) instruction.
+   *
+   * Sets the lanes of `dst` from the highest down for as long as `src1`
+   * minus the number of lanes above is greater than or equal to `src2`, and
+   * clears the rest. Also sets the condition flags from `dst`.
+   *
+   * Requires SVE2.
+   *
+   * @param src1 a 32- or 64-bit register, with a signed comparison
+   * @param src2 a register of the same width as `src1`
+   * @copydetails emit_sve_instruction
+   */
+  template <typename Reg>
+  arm_emitter& whilege(const arm_preg dst, const arm_element element, const Reg src1,
+                       const Reg src2) {
+    return emit_sve(0x25200000 | (code_of(src2) << 16) | (sf_of(src1) << 12) |
+      (code_of(src1) << 5) | code_of(dst), element, any_element);
+  }
+
+  /**
+   * Emits a `WHILEGT` (while greater than) instruction.
+   *
+   * Sets the lanes of `dst` from the highest down for as long as `src1`
+   * minus the number of lanes above is greater than `src2`, and clears the
+   * rest. Also sets the condition flags from `dst`.
+   *
+   * Requires SVE2.
+   *
+   * @param src1 a 32- or 64-bit register, with a signed comparison
+   * @param src2 a register of the same width as `src1`
+   * @copydetails emit_sve_instruction
+   */
+  template <typename Reg>
+  arm_emitter& whilegt(const arm_preg dst, const arm_element element, const Reg src1,
+                       const Reg src2) {
+    return emit_sve(0x25200010 | (code_of(src2) << 16) | (sf_of(src1) << 12) |
+      (code_of(src1) << 5) | code_of(dst), element, any_element);
+  }
+
+  /**
+   * Emits a `WHILEHI` (while higher) instruction.
+   *
+   * Sets the lanes of `dst` from the highest down for as long as `src1`
+   * minus the number of lanes above is higher than `src2`, and clears the
+   * rest. Also sets the condition flags from `dst`.
+   *
+   * Requires SVE2.
+   *
+   * @param src1 a 32- or 64-bit register, with an unsigned comparison
+   * @param src2 a register of the same width as `src1`
+   * @copydetails emit_sve_instruction
+   */
+  template <typename Reg>
+  arm_emitter& whilehi(const arm_preg dst, const arm_element element, const Reg src1,
+                       const Reg src2) {
+    return emit_sve(0x25200810 | (code_of(src2) << 16) | (sf_of(src1) << 12) |
+      (code_of(src1) << 5) | code_of(dst), element, any_element);
+  }
+
+  /**
+   * Emits a `WHILEHS` (while higher or same) instruction.
+   *
+   * Sets the lanes of `dst` from the highest down for as long as `src1`
+   * minus the number of lanes above is higher than or the same as `src2`,
+   * and clears the rest. Also sets the condition flags from `dst`.
+   *
+   * Requires SVE2.
+   *
+   * @param src1 a 32- or 64-bit register, with an unsigned comparison
+   * @param src2 a register of the same width as `src1`
+   * @copydetails emit_sve_instruction
+   */
+  template <typename Reg>
+  arm_emitter& whilehs(const arm_preg dst, const arm_element element, const Reg src1,
+                       const Reg src2) {
+    return emit_sve(0x25200800 | (code_of(src2) << 16) | (sf_of(src1) << 12) |
+      (code_of(src1) << 5) | code_of(dst), element, any_element);
+  }
+
+  /**
+   * Emits a `WHILELE` (while less than or equal) instruction.
+   *
+   * Sets the lanes of `dst` from the lowest up for as long as `src1` plus
+   * the number of lanes below is less than or equal to `src2`, and clears
+   * the rest. Also sets the condition flags from `dst`.
+   *
+   * @param src1 a 32- or 64-bit register, with a signed comparison
+   * @param src2 a register of the same width as `src1`
+   * @copydetails emit_sve_instruction
+   */
+  template <typename Reg>
+  arm_emitter& whilele(const arm_preg dst, const arm_element element, const Reg src1,
+                       const Reg src2) {
+    return emit_sve(0x25200410 | (code_of(src2) << 16) | (sf_of(src1) << 12) |
+      (code_of(src1) << 5) | code_of(dst), element, any_element);
+  }
+
+  /**
+   * Emits a `WHILELO` (while lower) instruction.
+   *
+   * Sets the lanes of `dst` from the lowest up for as long as `src1` plus
+   * the number of lanes below is lower than `src2`, and clears the rest.
+   * Also sets the condition flags from `dst`.
+   *
+   * @param src1 a 32- or 64-bit register, with an unsigned comparison
+   * @param src2 a register of the same width as `src1`
+   * @copydetails emit_sve_instruction
+   */
+  template <typename Reg>
+  arm_emitter& whilelo(const arm_preg dst, const arm_element element, const Reg src1,
+                       const Reg src2) {
+    return emit_sve(0x25200C00 | (code_of(src2) << 16) | (sf_of(src1) << 12) |
+      (code_of(src1) << 5) | code_of(dst), element, any_element);
+  }
+
+  /**
+   * Emits a `WHILELS` (while lower or same) instruction.
+   *
+   * Sets the lanes of `dst` from the lowest up for as long as `src1` plus
+   * the number of lanes below is lower than or the same as `src2`, and
+   * clears the rest. Also sets the condition flags from `dst`.
+   *
+   * @param src1 a 32- or 64-bit register, with an unsigned comparison
+   * @param src2 a register of the same width as `src1`
+   * @copydetails emit_sve_instruction
+   */
+  template <typename Reg>
+  arm_emitter& whilels(const arm_preg dst, const arm_element element, const Reg src1,
+                       const Reg src2) {
+    return emit_sve(0x25200C10 | (code_of(src2) << 16) | (sf_of(src1) << 12) |
+      (code_of(src1) << 5) | code_of(dst), element, any_element);
+  }
+
+  /**
+   * Emits a `WHILELT` (while less than) instruction.
+   *
+   * Sets the lanes of `dst` from the lowest up for as long as `src1` plus
+   * the number of lanes below is less than `src2`, and clears the rest. Also
+   * sets the condition flags from `dst`.
+   *
+   * @param src1 a 32- or 64-bit register, with a signed comparison
+   * @param src2 a register of the same width as `src1`
+   * @copydetails emit_sve_instruction
+   */
+  template <typename Reg>
+  arm_emitter& whilelt(const arm_preg dst, const arm_element element, const Reg src1,
+                       const Reg src2) {
+    return emit_sve(0x25200400 | (code_of(src2) << 16) | (sf_of(src1) << 12) |
+      (code_of(src1) << 5) | code_of(dst), element, any_element);
+  }
+
+  /**
+   * Emits a `WRFFR` (write the first-fault register) instruction.
+   *
+   * Copies `src` to the first-fault register (FFR).
+   *
+   * @copydetails emit_sve_instruction
+   */
+  arm_emitter& wrffr(const arm_preg src) {
+    return emit(0x25289000 | (code_of(src) << 5));
+  }
+
+  /**
+   * Emits an `XTN` (extract narrow) instruction.
+   *
+   * @copydetails emit_vector_narrowing_instruction
+   */
+  arm_emitter& xtn(const arm_vreg dst, const arm_vreg src, const arm_arrangement arrangement) {
+    return emit_simd(0x0E212800, dst, src, 0, arrangement, no_64bit_lanes);
+  }
+
+  /**
+   * Emits a `YIELD` instruction.
+   *
+   * @copydetails emit_general_purpose_instruction
+   */
+  arm_emitter& yield() {
+    return hint(1);
+  }
+  /**
+   * Emits a `ZIP1` (zip vectors, primary) instruction.
+   *
+   * @copydetails emit_vector_instruction
+   */
+  arm_emitter& zip1(const arm_vreg dst, const arm_vreg src1, const arm_vreg src2,
+                    const arm_arrangement arrangement) {
+    return emit_simd(0x0E003800, dst, src1, code_of(src2), arrangement, no_1d);
+  }
+
+  /**
+   * Emits a `ZIP2` (zip vectors, secondary) instruction.
+   *
+   * @copydetails emit_vector_instruction
+   */
+  arm_emitter& zip2(const arm_vreg dst, const arm_vreg src1, const arm_vreg src2,
+                    const arm_arrangement arrangement) {
+    return emit_simd(0x0E007800, dst, src1, code_of(src2), arrangement, no_1d);
+  }
+
+
+protected:
+  static constexpr std::uint32_t sf_of(arm_wreg) noexcept { return 0; }
+  static constexpr std::uint32_t sf_of(arm_xreg) noexcept { return 1; }
+
+  template <typename Reg>
+  static constexpr std::uint32_t code_of(const Reg reg) noexcept {
+    return static_cast<std::uint32_t>(reg);
+  }
+
+  template <typename Reg>
+  static constexpr unsigned width_of(const Reg reg) noexcept {
+    return sf_of(reg) ? 64 : 32;
+  }
+
+  static constexpr arm_cc invert(const arm_cc cc) noexcept {
+    return static_cast<arm_cc>(static_cast<std::uint8_t>(cc) ^ 1);
+  }
+
+  template <typename Reg>
+  static void check_shift(const Reg reg, const unsigned amount) {
+    if (amount >= width_of(reg)) {
+      throw std::out_of_range("shift amount must be less than the register width");
+    }
+  }
+
+  template <typename Reg>
+  static void check_bitfield(const Reg reg, const unsigned lsb, const unsigned width) {
+    if (width < 1 || lsb >= width_of(reg) || width > width_of(reg) - lsb) {
+      throw std::out_of_range("bitfield must fit in the register");
+    }
+  }
+
+  /**
+   * Returns the `b5:b40` and register fields of a `TBZ` or `TBNZ`.
+   *
+   * @throws std::out_of_range if the bit number is not in the register
+   */
+  template <typename Reg>
+  static std::uint32_t test_bit_of(const Reg src, const unsigned bit) {
+    if (bit >= width_of(src)) {
+      throw std::out_of_range("bit number must be less than the register width");
+    }
+    return ((bit >> 5) << 31) | ((bit & 0x1F) << 19) | code_of(src);
+  }
+
+  /* Bit masks of the arrangements that vector instructions support: */
+  static constexpr unsigned byte_lanes = 0x03;     /* 8B, 16B */
+  static constexpr unsigned across_lanes = 0x2F;   /* 8B, 16B, 4H, 8H, 4S */
+  static constexpr unsigned no_64bit_lanes = 0x3F; /* all but 1D, 2D */
+  static constexpr unsigned fp_lanes = 0xB0;       /* 2S, 4S, 2D */
+  static constexpr unsigned no_1d = 0xBF;          /* all but 1D */
+
+  static constexpr std::uint32_t q_of(const arm_arrangement arrangement) noexcept {
+    return static_cast<std::uint32_t>(arrangement) & 1;
+  }
+
+  static constexpr std::uint32_t size_of(const arm_arrangement arrangement) noexcept {
+    return static_cast<std::uint32_t>(arrangement) >> 1;
+  }
+
+  static void check_arrangement(const arm_arrangement arrangement, const unsigned allowed) {
+    if (!((allowed >> static_cast<unsigned>(arrangement)) & 1)) {
+      throw std::invalid_argument("arrangement is not supported by the instruction");
+    }
+  }
+
+  /**
+   * Checks a shift amount against the lane size, for left shifts from 0
+   * and right shifts from 1.
+   */
+  static void check_lane_shift(const arm_arrangement arrangement, const unsigned amount,
+                               const unsigned min) {
+    if (amount < min || amount >= (8U << size_of(arrangement)) + min) {
+      throw std::out_of_range("shift amount does not fit the lane size");
+    }
+  }
+
+  /**
+   * Checks that a general-purpose register has the width of the lanes,
+   * taking 32 bits for the lanes narrower than that.
+   */
+  template <typename Reg>
+  static void check_lane_register(const Reg reg, const arm_arrangement arrangement) {
+    if (sf_of(reg) != (size_of(arrangement) == 3)) {
+      throw std::invalid_argument("register width does not match the lane size");
+    }
+  }
+
+  static void check_list(const unsigned count) {
+    if (count < 1 || count > 4) {
+      throw std::out_of_range("register list must have 1 to 4 registers");
+    }
+  }
+
+  /**
+   * Returns the `imm5` field that selects a lane of the given size.
+   *
+   * @throws std::out_of_range if the index is not in a 128-bit register
+   */
+  static std::uint32_t element_of(const arm_arrangement arrangement, const unsigned index) {
+    const std::uint32_t size = size_of(arrangement);
+    if (index >= (16U >> size)) {
+      throw std::out_of_range("lane index must be within the register");
+    }
+    return ((index << 1) | 1) << size;
+  }
+
+  /* Bit masks of the element sizes that SVE instructions support: */
+  static constexpr unsigned any_element = 0x0F;   /* B, H, S, D */
+  static constexpr unsigned fp_elements = 0x0E;   /* H, S, D */
+  static constexpr unsigned word_elements = 0x0C; /* S, D */
+
+  static constexpr std::uint32_t size_of(const arm_element element) noexcept {
+    return static_cast<std::uint32_t>(element);
+  }
+
+  static void check_element(const arm_element element, const unsigned allowed) {
+    if (!((allowed >> static_cast<unsigned>(element)) & 1)) {
+      throw std::invalid_argument("element size is not supported by the instruction");
+    }
+  }
+
+  /**
+   * Returns the field of a governing predicate, which has room for `P0`
+   * through `P7` only.
+   */
+  static std::uint32_t governing_of(const arm_preg pg) {
+    if (code_of(pg) > 7) {
+      throw std::invalid_argument("governing predicate must be one of P0..P7");
+    }
+    return code_of(pg);
+  }
+
+  static constexpr std::uint32_t acquire_of(const arm_order order) noexcept {
+    return static_cast<std::uint32_t>(order) & 1;
+  }
+
+  static constexpr std::uint32_t release_of(const arm_order order) noexcept {
+    return static_cast<std::uint32_t>(order) >> 1;
+  }
+
+  /**
+   * Emits an atomic memory operation instruction, e.g. `LDADD`.
+   *
+   * @param opcode the `o3:opc` field in bits 15..12
+   */
+  template <typename Reg>
+  arm_emitter& emit_atomic(const std::uint32_t opcode, const Reg src, const Reg dst,
+                           const arm_xreg base, const arm_order order) {
+    return emit(0xB8200000 | (sf_of(dst) << 30) | (acquire_of(order) << 23) |
+      (release_of(order) << 22) | (code_of(src) << 16) | (opcode << 12) |
+      (code_of(base) << 5) | code_of(dst));
+  }
+
+  /**
+   * Emits a load/store exclusive or ordered instruction, e.g. `LDXR`.
+   *
+   * @param opcode the instruction, with the size and register fields clear
+   * @param rt     the transferred register, which determines the size
+   * @param rs     the status or compared register, or 31 if unused
+   */
+  template <typename Reg>
+  arm_emitter& emit_ldst_ordered(const std::uint32_t opcode, const Reg rt,
+                                 const std::uint32_t rs, const arm_xreg base) {
+    return emit(opcode | 0x80000000 | (sf_of(rt) << 30) | (rs << 16) |
+      (code_of(base) << 5) | code_of(rt));
+  }
+
+  /**
+   * Emits an add or subtract instruction with an immediate value.
+   */
+  template <typename Reg>
+  arm_emitter& emit_addsub_imm(const std::uint32_t op, const std::uint32_t s,
+                               const Reg dst, const Reg src, std::uint32_t imm) {
+    std::uint32_t shifted = 0;
+    if (imm > 0xFFF && !(imm & 0xFFF)) {
+      imm >>= 12;
+      shifted = 1;
+    }
+    if (imm > 0xFFF) {
+      throw std::out_of_range("immediate value must be a 12-bit value, optionally shifted by 12 bits");
+    }
+    return emit(0x11000000 | (sf_of(dst) << 31) | (op << 30) | (s << 29) | (shifted << 22) |
+      (imm << 10) | (code_of(src) << 5) | code_of(dst));
+  }
+
+  /**
+   * Emits an add or subtract instruction with a shifted register.
+   */
+  template <typename Reg>
+  arm_emitter& emit_addsub_shifted(const std::uint32_t op, const std::uint32_t s,
+                                   const Reg dst, const Reg src1, const Reg src2,
+                                   const arm_shift shift, const unsigned amount) {
+    if (shift == arm_shift::ror) {
+      throw std::invalid_argument("arithmetic instructions cannot rotate their operand");
+    }
+    check_shift(dst, amount);
+    return emit(0x0B000000 | (sf_of(dst) << 31) | (op << 30) | (s << 29) |
+      (static_cast<std::uint32_t>(shift) << 22) | (code_of(src2) << 16) | (amount << 10) |
+      (code_of(src1) << 5) | code_of(dst));
+  }
+
+  /**
+   * Emits an add or subtract instruction with an extended register.
+   */
+  template <typename Reg, typename Src>
+  arm_emitter& emit_addsub_extended(const std::uint32_t op, const std::uint32_t s,
+                                    const Reg dst, const Reg src1, const Src src2,
+                                    const arm_extend extend, const unsigned amount) {
+    if (amount > 4) {
+      throw std::out_of_range("extended register shift must be in the range 0..4");
+    }
+    return emit(0x0B200000 | (sf_of(dst) << 31) | (op << 30) | (s << 29) |
+      (code_of(src2) << 16) | (static_cast<std::uint32_t>(extend) << 13) | (amount << 10) |
+      (code_of(src1) << 5) | code_of(dst));
+  }
+
+  /**
+   * Emits a logical instruction with a bitmask immediate value.
+   */
+  template <typename Reg>
+  arm_emitter& emit_logical_imm(const std::uint32_t opc, const Reg dst, const Reg src,
+                                const std::uint64_t imm) {
+    std::uint32_t encoding;
+    if (!encode_bitmask(imm, width_of(dst), encoding)) {
+      throw std::invalid_argument("immediate value is not a valid bitmask immediate");
+    }
+    return emit(0x12000000 | (sf_of(dst) << 31) | (opc << 29) | (encoding << 10) |
+      (code_of(src) << 5) | code_of(dst));
+  }
+
+  /**
+   * Emits a logical instruction with a shifted, optionally inverted register.
+   */
+  template <typename Reg>
+  arm_emitter& emit_logical_shifted(const std::uint32_t opc, const std::uint32_t n,
+                                    const Reg dst, const Reg src1, const Reg src2,
+                                    const arm_shift shift, const unsigned amount) {
+    check_shift(dst, amount);
+    return emit(0x0A000000 | (sf_of(dst) << 31) | (opc << 29) |
+      (static_cast<std::uint32_t>(shift) << 22) | (n << 21) | (code_of(src2) << 16) |
+      (amount << 10) | (code_of(src1) << 5) | code_of(dst));
+  }
+
+  /**
+   * Emits a move wide instruction, e.g. `MOVZ`.
+   */
+  template <typename Reg>
+  arm_emitter& emit_move_wide(const std::uint32_t opc, const Reg dst,
+                              const std::uint32_t imm, const unsigned shift) {
+    if (imm > 0xFFFF) {
+      throw std::out_of_range("immediate value must be a 16-bit value");
+    }
+    if ((shift & 15) || shift >= width_of(dst)) {
+      throw std::out_of_range("shift must be a multiple of 16 less than the register width");
+    }
+    return emit(0x12800000 | (sf_of(dst) << 31) | (opc << 29) | ((shift / 16) << 21) |
+      (imm << 5) | code_of(dst));
+  }
+
+  /**
+   * Emits a bitfield move instruction, e.g. `UBFM`.
+   */
+  template <typename Reg>
+  arm_emitter& emit_bitfield(const std::uint32_t opc, const Reg dst, const Reg src,
+                             const unsigned immr, const unsigned imms) {
+    check_shift(dst, immr);
+    check_shift(dst, imms);
+    return emit(0x13000000 | (sf_of(dst) << 31) | (opc << 29) | (sf_of(dst) << 22) |
+      (immr << 16) | (imms << 10) | (code_of(src) << 5) | code_of(dst));
+  }
+
+  /**
+   * Emits a conditional select instruction, e.g. `CSEL`.
+   */
+  template <typename Reg>
+  arm_emitter& emit_cond_select(const std::uint32_t opcode, const Reg dst, const Reg src1,
+                                const Reg src2, const arm_cc cc) {
+    return emit(opcode | (sf_of(dst) << 31) | (code_of(src2) << 16) |
+      (static_cast<std::uint32_t>(cc) << 12) | (code_of(src1) << 5) | code_of(dst));
+  }
+
+  /**
+   * Emits a data-processing (2 source) instruction, e.g. `UDIV`.
+   */
+  template <typename Reg>
+  arm_emitter& emit_dp2(const std::uint32_t opcode, const Reg dst, const Reg src1, const Reg src2) {
+    return emit(0x1AC00000 | (sf_of(dst) << 31) | (code_of(src2) << 16) | (opcode << 10) |
+      (code_of(src1) << 5) | code_of(dst));
+  }
+
+  /**
+   * Emits a data-processing (3 source) instruction, e.g. `MADD`.
+   */
+  template <typename Reg>
+  arm_emitter& emit_dp3(const std::uint32_t o0, const Reg dst, const Reg src1, const Reg src2,
+                        const Reg addend) {
+    return emit(0x1B000000 | (sf_of(dst) << 31) | (code_of(src2) << 16) | (o0 << 15) |
+      (code_of(addend) << 10) | (code_of(src1) << 5) | code_of(dst));
+  }
+
+  /**
+   * Emits a load or store instruction, e.g. `LDR`.
+   *
+   * @param size the log2 of the access size
+   * @param opc  the `opc` field: 0 to store, 1 to load, and 2 or 3 to load
+   *             sign-extending to 64 or 32 bits
+   */
+  arm_emitter& emit_load_store(const std::uint32_t size, const std::uint32_t opc,
+                               const std::uint32_t rt, const arm_mem& mem) {
+    switch (mem.mode) {
+      case arm_addressing::offset:
+        if (mem.offset >= 0 && !(mem.offset & ((1 << size) - 1)) && (mem.offset >> size) <= 0xFFF) {
+          return emit(0x39000000 | (size << 30) | (opc << 22) |
+            (static_cast<std::uint32_t>(mem.offset >> size) << 10) | (mem.base << 5) | rt);
+        }
+        return emit_load_store_imm9(0x38000000, size, opc, rt, mem);
+      case arm_addressing::pre_index:
+        return emit_load_store_imm9(0x38000C00, size, opc, rt, mem);
+      case arm_addressing::post_index:
+        return emit_load_store_imm9(0x38000400, size, opc, rt, mem);
+      case arm_addressing::register_offset:
+        if (mem.shift != 0 && mem.shift != size) {
+          throw std::invalid_argument("index shift must be 0 or log2 of the access size");
+        }
+        return emit(0x38200800 | (size << 30) | (opc << 22) | (mem.index << 16) |
+          (static_cast<std::uint32_t>(mem.extend) << 13) | ((mem.shift != 0) << 12) |
+          (mem.base << 5) | rt);
+    }
+    return *this;
+  }
+
+  /**
+   * Emits a load or store instruction with a signed 9-bit offset, e.g.
+   * `LDUR`.
+   */
+  arm_emitter& emit_load_store_imm9(const std::uint32_t opcode, const std::uint32_t size,
+                                    const std::uint32_t opc, const std::uint32_t rt,
+                                    const arm_mem& mem) {
+    if (mem.offset < -256 || mem.offset > 255) {
+      throw std::out_of_range("offset must be in the range -256..255 unless scaled");
+    }
+    return emit(opcode | (size << 30) | (opc << 22) |
+      ((static_cast<std::uint32_t>(mem.offset) & 0x1FF) << 12) | (mem.base << 5) | rt);
+  }
+
+  /**
+   * Emits a load or store pair instruction, e.g. `LDP`.
+   *
+   * @param scale the byte size of each register
+   */
+  arm_emitter& emit_load_store_pair(const std::uint32_t opc, const std::uint32_t l,
+                                    const std::int32_t scale, const std::uint32_t rt1,
+                                    const std::uint32_t rt2, const arm_mem& mem) {
+    std::uint32_t mode;
+    switch (mem.mode) {
+      case arm_addressing::offset:     mode = 2; break;
+      case arm_addressing::pre_index:  mode = 3; break;
+      case arm_addressing::post_index: mode = 1; break;
+      default:
+        throw std::invalid_argument("pair loads and stores take an immediate offset only");
+    }
+    if ((mem.offset % scale) || mem.offset / scale < -64 || mem.offset / scale > 63) {
+      throw std::out_of_range("offset must be a multiple of the register size in the range -64..63 times that size");
+    }
+    return emit(0x28000000 | (opc << 30) | (mode << 23) | (l << 22) |
+      ((static_cast<std::uint32_t>(mem.offset / scale) & 0x7F) << 15) | (rt2 << 10) |
+      (mem.base << 5) | rt1);
+  }
+
+  /**
+   * Emits a data-processing (1 source) instruction, e.g. `CLZ`.
+   */
+  template <typename Reg>
+  arm_emitter& emit_dp1(const std::uint32_t opcode, const Reg dst, const Reg src) {
+    return emit(0x5AC00000 | (sf_of(dst) << 31) | (opcode << 10) | (code_of(src) << 5) | code_of(dst));
+  }
+
+  /**
+   * Emits an Advanced SIMD instruction, filling in the `Q` and `size`
+   * fields for the arrangement.
+   *
+   * @param insn the instruction, with those and the register fields clear
+   * @param rm   the second source register, if any
+   */
+  arm_emitter& emit_simd(const std::uint32_t insn, const arm_vreg dst, const arm_vreg src,
+                         const std::uint32_t rm, const arm_arrangement arrangement,
+                         const unsigned allowed) {
+    check_arrangement(arrangement, allowed);
+    return emit(insn | (q_of(arrangement) << 30) | (size_of(arrangement) << 22) | (rm << 16) |
+      (code_of(src) << 5) | code_of(dst));
+  }
+
+  /**
+   * Emits an Advanced SIMD floating-point instruction, filling in the `Q`
+   * and `sz` fields for the arrangement.
+   */
+  arm_emitter& emit_simd_fp(const std::uint32_t insn, const arm_vreg dst, const arm_vreg src,
+                            const std::uint32_t rm, const arm_arrangement arrangement) {
+    check_arrangement(arrangement, fp_lanes);
+    return emit(insn | (q_of(arrangement) << 30) | ((size_of(arrangement) & 1) << 22) |
+      (rm << 16) | (code_of(src) << 5) | code_of(dst));
+  }
+
+  /**
+   * Emits an Advanced SIMD shift by immediate instruction.
+   *
+   * @param immhb the `immh:immb` field, which encodes the lane size too
+   */
+  arm_emitter& emit_simd_shift(const std::uint32_t insn, const arm_vreg dst, const arm_vreg src,
+                               const std::uint32_t immhb, const arm_arrangement arrangement,
+                               const unsigned allowed) {
+    check_arrangement(arrangement, allowed);
+    return emit(insn | (q_of(arrangement) << 30) | (immhb << 16) | (code_of(src) << 5) | code_of(dst));
+  }
+
+  /**
+   * Emits an Advanced SIMD load/store multiple structures instruction.
+   *
+   * @param opcode the `opcode` field, which encodes the register count
+   * @param count  the number of registers transferred
+   */
+  arm_emitter& emit_load_store_multiple(const std::uint32_t l, const std::uint32_t opcode,
+                                        const unsigned count, const arm_vreg rt,
+                                        const arm_mem& mem, const arm_arrangement arrangement) {
+    std::uint32_t insn = 0x0C000000;
+    switch (mem.mode) {
+      case arm_addressing::offset:
+        if (mem.offset != 0) {
+          throw std::out_of_range("structure loads and stores take no offset");
+        }
+        break;
+      case arm_addressing::post_index:
+        if (mem.offset != static_cast<std::int32_t>(count << (3 + q_of(arrangement)))) {
+          throw std::out_of_range("post-index offset must be the number of bytes transferred");
+        }
+        insn = 0x0C9F0000;
+        break;
+      default:
+        throw std::invalid_argument("structure loads and stores take a base register only");
+    }
+    return emit(insn | (q_of(arrangement) << 30) | (l << 22) | (opcode << 12) |
+      (size_of(arrangement) << 10) | (code_of(mem.base) << 5) | code_of(rt));
+  }
+
+  /**
+   * Emits an SVE instruction, filling in the `size` field for the element
+   * size.
+   *
+   * @param insn the instruction, with that field clear
+   */
+  arm_emitter& emit_sve(const std::uint32_t insn, const arm_element element,
+                        const unsigned allowed) {
+    check_element(element, allowed);
+    return emit(insn | (size_of(element) << 22));
+  }
+
+  /**
+   * Emits an SVE element count instruction, e.g. `CNTW` or `INCW`.
+   */
+  arm_emitter& emit_sve_count(const std::uint32_t insn, const arm_xreg dst,
+                              const arm_pattern pattern, const unsigned mul) {
+    if (mul < 1 || mul > 16) {
+      throw std::out_of_range("multiplier must be in the range 1..16");
+    }
+    return emit(insn | ((mul - 1) << 16) | (static_cast<std::uint32_t>(pattern) << 5) |
+      code_of(dst));
+  }
+
+  /**
+   * Emits an SVE contiguous load or store instruction.
+   *
+   * @param insn     the scalar plus scalar form of the instruction
+   * @param imm_insn the scalar plus immediate form, or 0 if there is none
+   * @param scale    log2 of the access size
+   */
+  arm_emitter& emit_sve_load_store(const std::uint32_t insn, const std::uint32_t imm_insn,
+                                   const unsigned scale, const arm_zreg rt,
+                                   const arm_preg pg, const arm_mem& mem) {
+    const std::uint32_t fields = (governing_of(pg) << 10) | (code_of(mem.base) << 5) | code_of(rt);
+    switch (mem.mode) {
+      case arm_addressing::offset:
+        if (!imm_insn) {
+          if (mem.offset != 0) {
+            throw std::out_of_range("first-fault loads take no offset");
+          }
+          return emit(insn | (31U << 16) | fields); /* `[base, XZR]` */
+        }
+        if (mem.offset < -8 || mem.offset > 7) {
+          throw std::out_of_range("offset must be in the range -8..7 vectors");
+        }
+        return emit(imm_insn | ((static_cast<std::uint32_t>(mem.offset) & 0xF) << 16) | fields);
+      case arm_addressing::register_offset:
+        if (mem.extend != arm_extend::uxtx || mem.shift != scale) {
+          throw std::invalid_argument("index must be shifted by log2 of the access size");
+        }
+        if (mem.index == 31 && imm_insn) {
+          throw std::invalid_argument("index register must not be XZR");
+        }
+        return emit(insn | (static_cast<std::uint32_t>(mem.index) << 16) | fields);
+      default:
+        throw std::invalid_argument("SVE loads and stores take no pre- or post-index");
+    }
+  }
+
+  static constexpr std::size_t padding_size(const std::size_t offset,
+                                            const std::size_t boundary) noexcept {
+    return (boundary - (offset & (boundary - 1))) & (boundary - 1);
+  }
+
+  static void store_padding(std::uint8_t* const cursor,
+                            const std::size_t size,
+                            const arm_padding fill) noexcept {
+    const std::uint32_t insn = (fill == arm_padding::trap) ? 0xD4200000 : 0xD503201F;
+    for (std::size_t i = 0; i < size; i += 4) {
+      machinery::bits::store_le32(cursor + i, insn);
+    }
+  }
+
+  /**
+   * Returns the displacement from a branch to its target, as the code is
+   * laid out in memory.
+   */
+  std::int64_t distance(const std::size_t target,
+                        const std::size_t source) const noexcept {
+    return static_cast<std::int64_t>(location(_buffer, target, 0)) -
+      static_cast<std::int64_t>(location(_buffer, source, 0));
+  }
+
+  /* A buffer that maps its code in pieces, such as `segmented_buffer`,
+   * tells where each byte offset resides in memory. Other buffers are
+   * contiguous, so that offsets alone determine displacements: */
+  template <typename B>
+  static auto location(const B& buffer, const std::size_t offset, int) noexcept
+      -> decltype(buffer.address(offset), std::uintptr_t()) {
+    return reinterpret_cast<std::uintptr_t>(buffer.address(offset));
+  }
+
+  template <typename B>
+  static std::uintptr_t location(const B&, const std::size_t offset, long) noexcept {
+    return offset;
+  }
+
+  template <typename B>
+  static constexpr auto is_mapped(const B& buffer, int) noexcept
+      -> decltype(buffer.address(0), bool()) {
+    return true;
+  }
+
+  template <typename B>
+  static constexpr bool is_mapped(const B&, long) noexcept {
+    return false;
+  }
+
+  /**
+   * Returns whether the buffer can discard code for it to be re-emitted,
+   * that is, whether it implements `truncate()` itself.
+   */
+  static constexpr bool rewritable() noexcept {
+    return std::is_same<decltype(std::declval<Buffer&>().truncate(0)), Buffer&>::value;
+  }
+
+  /**
+   * Returns whether a displacement fits in a branch's scaled field of the
+   * given width.
+   */
+  static constexpr bool fits_branch(const unsigned bits, const std::int64_t disp) noexcept {
+    return disp >= -(std::int64_t{1} << (bits + 1)) && disp < (std::int64_t{1} << (bits + 1));
+  }
+
+  static constexpr std::size_t length_of(const branch& entry) noexcept {
+    return entry.veneer ? 8 : 4;
+  }
+
+  /**
+   * Returns whether a recorded branch reaches the given displacement.
+   */
+  static constexpr bool reaches(const branch& entry, const std::int64_t disp) noexcept {
+    return entry.veneer ? fits_branch(26, disp - 4) : fits_branch(entry.bits, disp);
+  }
+
+  /**
+   * Returns the given branch instruction with its displacement field set.
+   */
+  static constexpr std::uint32_t with_displacement(const std::uint32_t insn,
+                                                   const unsigned bits,
+                                                   const std::int64_t disp) noexcept {
+    return insn | ((static_cast<std::uint32_t>(disp >> 2) & ((std::uint32_t{1} << bits) - 1)) <<
+      ((bits == 26) ? 0 : 5));
+  }
+
+  /**
+   * Stores a recorded branch, along with its veneer if it has one.
+   */
+  static void store_branch(std::uint8_t* const cursor,
+                           const branch& entry,
+                           const std::int64_t disp) noexcept {
+    if (!entry.veneer) {
+      machinery::bits::store_le32(cursor, with_displacement(entry.insn, entry.bits, disp));
+      return;
+    }
+    /* Flip the condition of a B.cond, or the Z/NZ bit of the others: */
+    const std::uint32_t inverse = entry.insn ^ (((entry.insn >> 24) == 0x54) ? 0x00000001 : 0x01000000);
+    machinery::bits::store_le32(cursor, with_displacement(inverse, entry.bits, 8));
+    machinery::bits::store_le32(cursor + 4, with_displacement(0x14000000, 26, disp - 4));
+  }
+
+  /**
+   * Emits a branch to the given label, with a veneer if the label is
+   * already bound beyond reach, or if it is not yet bound and the buffer
+   * cannot make room for a veneer later.
+   */
+  arm_emitter& branch_to(const std::uint32_t insn, const unsigned bits,
+                         const arm_label target) {
+    const std::size_t position = _labels.at(target.id);
+    branch entry {0, target.id, insn, static_cast<std::uint8_t>(bits), false};
+    if (bits != 26 && position == unbound) {
+      entry.veneer = !rewritable();
+    }
+    else if (bits != 26) {
+      /* A segmented buffer may move the branch on to its next segment, so
+       * only go without a veneer if the branch stays right after the
+       * current code: */
+      const bool adjacent = !is_mapped(_buffer, 0) || _buffer.capacity() - _buffer.size() >= 4;
+      entry.veneer = !adjacent || !fits_branch(bits, distance(position, _buffer.size()));
+    }
+    std::uint8_t* const cursor = _buffer.extend(length_of(entry));
+    entry.offset = _buffer.size() - length_of(entry);
+    store_branch(cursor, entry, 0);
+    if (position != unbound) {
+      patch_branch(entry, position);
+    }
+    _branches.push_back(entry);
+    return *this;
+  }
+
+  /**
+   * Rewrites the displacement of a recorded branch.
+   *
+   * @throws std::out_of_range if the branch does not reach the target
+   */
+  void patch_branch(const branch& entry, const std::size_t target) {
+    const std::int64_t disp = distance(target, entry.offset);
+    if (!reaches(entry, disp)) {
+      throw std::out_of_range("branch target is out of range");
+    }
+    std::uint8_t bytes[8];
+    store_branch(bytes, entry, disp);
+    _buffer.patch(entry.offset, bytes, length_of(entry));
+  }
+
+  /**
+   * Gives a veneer to every conditional branch that does not reach its
+   * bound label, re-emitting the code that follows, until all do.
+   */
+  void add_veneers(std::true_type) {
+    for (;;) {
+      std::vector<branch> branches(_branches);
+      std::size_t first = branches.size();
+      for (auto i = 0UL; i < branches.size(); i++) {
+        auto& entry = branches[i];
+        const std::size_t position = _labels[entry.label];
+        if (entry.bits == 26 || entry.veneer || position == unbound ||
+            fits_branch(entry.bits, distance(position, entry.offset))) {
+          continue;
+        }
+        entry.veneer = true;
+        if (first == branches.size()) {
+          first = i;
+        }
+      }
+      if (first == branches.size()) {
+        return;
+      }
+      relayout(branches, first);
+    }
+  }
+
+  /**
+   * Does nothing, since a buffer that cannot re-emit code has had a veneer
+   * given to every conditional branch to a label not yet bound.
+   */
+  void add_veneers(std::false_type) noexcept {}
+
+  /**
+   * Re-emits the code from the given branch on with the lengths of the
+   * given branches, moving labels and alignment padding along with it.
+   */
+  void relayout(std::vector<branch>& branches, const std::size_t first) {
+    struct run {
+      std::size_t old_offset;
+      std::size_t new_offset;
+    };
+    std::vector<run> runs;
+    const std::size_t start = _branches[first].offset;
+    /* A buffer that keeps no bytes, such as `counting_buffer`, has no data: */
+    const std::uint8_t* const data = _buffer.data();
+    const std::vector<std::uint8_t> tail = data ?
+      std::vector<std::uint8_t>(data + start, data + _buffer.size()) :
+      std::vector<std::uint8_t>(_buffer.size() - start);
+    _buffer.truncate(start);
+    std::size_t cursor = start;
+    std::size_t next_alignment = 0;
+    while (next_alignment < _alignments.size() && _alignments[next_alignment].offset < start) {
+      next_alignment++;
+    }
+    std::size_t next_branch = first;
+    for (;;) {
+      const bool is_alignment = next_alignment < _alignments.size() &&
+        (next_branch == branches.size() || _alignments[next_alignment].offset <= _branches[next_branch].offset);
+      const std::size_t end = is_alignment ? _alignments[next_alignment].offset :
+        (next_branch < branches.size()) ? _branches[next_branch].offset : start + tail.size();
+      runs.push_back({cursor, _buffer.size()});
+      std::copy(tail.begin() + (cursor - start), tail.begin() + (end - start),
+        _buffer.extend(end - cursor));
+      if (is_alignment) {
+        auto& entry = _alignments[next_alignment++];
+        cursor = entry.offset + entry.size;
+        entry.offset = _buffer.size();
+        entry.size = padding_size(entry.offset, entry.boundary);
+        store_padding(_buffer.extend(entry.size), entry.size, entry.fill);
+      }
+      else if (next_branch < branches.size()) {
+        auto& entry = branches[next_branch];
+        cursor = _branches[next_branch].offset + length_of(_branches[next_branch]);
+        entry.offset = _buffer.size();
+        store_branch(_buffer.extend(length_of(entry)), entry, 0);
+        next_branch++;
+      }
+      else {
+        break;
+      }
+    }
+
+    /* Move each label along with the run of code that it points into: */
+    for (auto& position : _labels) {
+      if (position == unbound || position <= start) {
+        continue;
+      }
+      auto entry = std::upper_bound(runs.begin(), runs.end(), position,
+        [](const std::size_t offset, const run& other) { return offset < other.old_offset; });
+      --entry;
+      position = entry->new_offset + (position - entry->old_offset);
+    }
+
+    _branches.swap(branches);
+
+    for (const auto& entry : _branches) {
+      if (_labels[entry.label] != unbound) {
+        patch_branch(entry, _labels[entry.label]);
+      }
+    }
+  }
+};
+
+template <class Buffer>
+constexpr std::size_t machinery::arch::arm_emitter<Buffer>::far_jump_size;
+
+template <class Buffer>
+constexpr std::size_t machinery::arch::arm_emitter<Buffer>::unbound;
 
 #endif /* MACHINERY_ARCH_ARM_EMITTER_H */
@@ -9,15 +9,81 @@
  * ARMv8 A64 instruction encoding.
  */
 
-#include <cstdint> /* for std::uint*_t */
+#include <cstdint>   /* for std::int32_t, std::uint*_t */
+#include <stdexcept> /* for std::invalid_argument */
 
 namespace machinery {
   namespace arch {
+    enum class arm_addressing : std::uint8_t;
+    enum class arm_arrangement : std::uint8_t;
+    enum class arm_barrier : std::uint8_t;
     enum class arm_cc : std::uint8_t;
+    enum class arm_element : std::uint8_t;
+    enum class arm_extend : std::uint8_t;
+    enum class arm_order : std::uint8_t;
+    enum class arm_padding : std::uint8_t;
+    enum class arm_pattern : std::uint8_t;
+    enum class arm_shift : std::uint8_t;
     union arm_imm7;
+
+    using arm_reg = std::uint8_t;
+    enum class arm_wreg : arm_reg;
+    enum class arm_xreg : arm_reg;
+    enum class arm_vreg : arm_reg;
+    enum class arm_zreg : arm_reg;
+    enum class arm_preg : arm_reg;
+    class arm_mem;
   }
 }
 
+/**
+ * ARMv8 A64 addressing modes for loads and stores.
+ */
+enum class machinery::arch::arm_addressing : std::uint8_t {
+  offset,          /* `[base, #offset]` */
+  pre_index,       /* `[base, #offset]!`, updating the base first */
+  post_index,      /* `[base], #offset`, updating the base afterwards */
+  register_offset, /* `[base, index, extend #shift]` */
+};
+
+/**
+ * ARMv8 A64 vector arrangements, i.e. the lane size and count of an
+ * Advanced SIMD operand.
+ *
+ * The 64-bit arrangements use the lower half of a vector register.
+ */
+enum class machinery::arch::arm_arrangement : std::uint8_t {
+  b8  = 0, /* `.8B`: 8 lanes of 8 bits */
+  b16 = 1, /* `.16B`: 16 lanes of 8 bits */
+  h4  = 2, /* `.4H`: 4 lanes of 16 bits */
+  h8  = 3, /* `.8H`: 8 lanes of 16 bits */
+  s2  = 4, /* `.2S`: 2 lanes of 32 bits */
+  s4  = 5, /* `.4S`: 4 lanes of 32 bits */
+  d1  = 6, /* `.1D`: 1 lane of 64 bits */
+  d2  = 7, /* `.2D`: 2 lanes of 64 bits */
+};
+
+/**
+ * ARMv8 A64 barrier options, for `DMB` and `DSB`.
+ *
+ * The suffix `ld` limits the barrier to loads before it, and `st` to
+ * stores on both sides of it.
+ */
+enum class machinery::arch::arm_barrier : std::uint8_t {
+  oshld = 1,  /* 0b0001: outer shareable */
+  oshst = 2,  /* 0b0010 */
+  osh   = 3,  /* 0b0011 */
+  nshld = 5,  /* 0b0101: non-shareable */
+  nshst = 6,  /* 0b0110 */
+  nsh   = 7,  /* 0b0111 */
+  ishld = 9,  /* 0b1001: inner shareable, i.e. all the cores of a system */
+  ishst = 10, /* 0b1010 */
+  ish   = 11, /* 0b1011 */
+  ld    = 13, /* 0b1101: full system */
+  st    = 14, /* 0b1110 */
+  sy    = 15, /* 0b1111 */
+};
+
 /**
  * ARMv8 A64 condition codes.
  */
@@ -40,6 +106,272 @@ enum class machinery::arch::arm_cc : std::uint8_t {
   nv = 15, /* 0b1111 */
 };
 
+/**
+ * ARMv8 A64 SVE element sizes, i.e. the lane size of a scalable vector
+ * or predicate operand. The lane count depends on the vector length of
+ * the processor.
+ */
+enum class machinery::arch::arm_element : std::uint8_t {
+  b = 0, /* `.B`: lanes of 8 bits */
+  h = 1, /* `.H`: lanes of 16 bits */
+  s = 2, /* `.S`: lanes of 32 bits */
+  d = 3, /* `.D`: lanes of 64 bits */
+};
+
+/**
+ * ARMv8 A64 register extensions, for the extended-register forms of `ADD`
+ * and `SUB`.
+ */
+enum class machinery::arch::arm_extend : std::uint8_t {
+  uxtb = 0, /* 0b000: zero-extend the low byte */
+  uxth = 1, /* 0b001: zero-extend the low halfword */
+  uxtw = 2, /* 0b010: zero-extend the low word */
+  uxtx = 3, /* 0b011: the full doubleword */
+  sxtb = 4, /* 0b100: sign-extend the low byte */
+  sxth = 5, /* 0b101: sign-extend the low halfword */
+  sxtw = 6, /* 0b110: sign-extend the low word */
+  sxtx = 7, /* 0b111: the full doubleword */
+};
+
+/**
+ * The memory ordering of an atomic instruction.
+ *
+ * These correspond to the `std::memory_order` constants of the same names;
+ * sequential consistency is `acq_rel`, since acquire and release accesses
+ * are never reordered with each other.
+ */
+enum class machinery::arch::arm_order : std::uint8_t {
+  relaxed = 0, /* no ordering, as in `LDADD` */
+  acquire = 1, /* later accesses stay after it, as in `LDADDA` */
+  release = 2, /* earlier accesses stay before it, as in `LDADDL` */
+  acq_rel = 3, /* both, as in `LDADDAL` */
+};
+
+/**
+ * The filler for alignment padding.
+ */
+enum class machinery::arch::arm_padding : std::uint8_t {
+  nop,  /* `NOP` (`HINT #0`) instructions, for padding that is executed */
+  trap, /* `BRK #0` instructions, for padding that must never be executed */
+};
+
+/**
+ * ARMv8 A64 SVE predicate constraints, which select a number of lanes
+ * given the vector length, for `PTRUE` and the element count instructions.
+ *
+ * A constraint that asks for more lanes than the vector has selects none.
+ */
+enum class machinery::arch::arm_pattern : std::uint8_t {
+  pow2  = 0,  /* the largest power of two */
+  vl1   = 1,  /* exactly 1 lane */
+  vl2   = 2,  /* exactly 2 lanes */
+  vl3   = 3,  /* exactly 3 lanes */
+  vl4   = 4,  /* exactly 4 lanes */
+  vl5   = 5,  /* exactly 5 lanes */
+  vl6   = 6,  /* exactly 6 lanes */
+  vl7   = 7,  /* exactly 7 lanes */
+  vl8   = 8,  /* exactly 8 lanes */
+  vl16  = 9,  /* exactly 16 lanes */
+  vl32  = 10, /* exactly 32 lanes */
+  vl64  = 11, /* exactly 64 lanes */
+  vl128 = 12, /* exactly 128 lanes */
+  vl256 = 13, /* exactly 256 lanes */
+  mul4  = 29, /* the largest multiple of 4 */
+  mul3  = 30, /* the largest multiple of 3 */
+  all   = 31, /* all lanes */
+};
+
+/**
+ * ARMv8 A64 register shifts, for the shifted-register forms of arithmetic
+ * and logical instructions.
+ */
+enum class machinery::arch::arm_shift : std::uint8_t {
+  lsl = 0, /* 0b00: logical shift left */
+  lsr = 1, /* 0b01: logical shift right */
+  asr = 2, /* 0b10: arithmetic shift right */
+  ror = 3, /* 0b11: rotate right, for logical instructions only */
+};
+
+/**
+ * ARMv8 A64 general-purpose registers (32-bit)
+ */
+enum class machinery::arch::arm_wreg : machinery::arch::arm_reg {
+  w0  = 0,
+  w1  = 1,
+  w2  = 2,
+  w3  = 3,
+  w4  = 4,
+  w5  = 5,
+  w6  = 6,
+  w7  = 7,
+  w8  = 8,
+  w9  = 9,
+  w10 = 10,
+  w11 = 11,
+  w12 = 12,
+  w13 = 13,
+  w14 = 14,
+  w15 = 15,
+  w16 = 16,
+  w17 = 17,
+  w18 = 18,
+  w19 = 19,
+  w20 = 20,
+  w21 = 21,
+  w22 = 22,
+  w23 = 23,
+  w24 = 24,
+  w25 = 25,
+  w26 = 26,
+  w27 = 27,
+  w28 = 28,
+  w29 = 29,
+  w30 = 30,
+  wzr = 31,  /* the zero register, in most instructions */
+  wsp = 31,  /* the stack pointer, in the instructions that accept it */
+};
+
+/**
+ * ARMv8 A64 general-purpose registers (64-bit)
+ */
+enum class machinery::arch::arm_xreg : machinery::arch::arm_reg {
+  x0  = 0,
+  x1  = 1,
+  x2  = 2,
+  x3  = 3,
+  x4  = 4,
+  x5  = 5,
+  x6  = 6,
+  x7  = 7,
+  x8  = 8,
+  x9  = 9,
+  x10 = 10,
+  x11 = 11,
+  x12 = 12,
+  x13 = 13,
+  x14 = 14,
+  x15 = 15,
+  x16 = 16,
+  x17 = 17,
+  x18 = 18,
+  x19 = 19,
+  x20 = 20,
+  x21 = 21,
+  x22 = 22,
+  x23 = 23,
+  x24 = 24,
+  x25 = 25,
+  x26 = 26,
+  x27 = 27,
+  x28 = 28,
+  x29 = 29,
+  x30 = 30,
+  xzr = 31,  /* the zero register, in most instructions */
+  sp  = 31,  /* the stack pointer, in the instructions that accept it */
+};
+
+/**
+ * ARMv8 A64 vector registers (128-bit), for Advanced SIMD instructions
+ */
+enum class machinery::arch::arm_vreg : machinery::arch::arm_reg {
+  v0  = 0,
+  v1  = 1,
+  v2  = 2,
+  v3  = 3,
+  v4  = 4,
+  v5  = 5,
+  v6  = 6,
+  v7  = 7,
+  v8  = 8,
+  v9  = 9,
+  v10 = 10,
+  v11 = 11,
+  v12 = 12,
+  v13 = 13,
+  v14 = 14,
+  v15 = 15,
+  v16 = 16,
+  v17 = 17,
+  v18 = 18,
+  v19 = 19,
+  v20 = 20,
+  v21 = 21,
+  v22 = 22,
+  v23 = 23,
+  v24 = 24,
+  v25 = 25,
+  v26 = 26,
+  v27 = 27,
+  v28 = 28,
+  v29 = 29,
+  v30 = 30,
+  v31 = 31,
+};
+
+/**
+ * ARMv8 A64 scalable vector registers, for SVE instructions
+ *
+ * Their lower 128 bits are the vector registers `V0` through `V31`.
+ */
+enum class machinery::arch::arm_zreg : machinery::arch::arm_reg {
+  z0  = 0,
+  z1  = 1,
+  z2  = 2,
+  z3  = 3,
+  z4  = 4,
+  z5  = 5,
+  z6  = 6,
+  z7  = 7,
+  z8  = 8,
+  z9  = 9,
+  z10 = 10,
+  z11 = 11,
+  z12 = 12,
+  z13 = 13,
+  z14 = 14,
+  z15 = 15,
+  z16 = 16,
+  z17 = 17,
+  z18 = 18,
+  z19 = 19,
+  z20 = 20,
+  z21 = 21,
+  z22 = 22,
+  z23 = 23,
+  z24 = 24,
+  z25 = 25,
+  z26 = 26,
+  z27 = 27,
+  z28 = 28,
+  z29 = 29,
+  z30 = 30,
+  z31 = 31,
+};
+
+/**
+ * ARMv8 A64 scalable predicate registers, for SVE instructions
+ *
+ * Each has one bit per byte of a scalable vector register.
+ */
+enum class machinery::arch::arm_preg : machinery::arch::arm_reg {
+  p0  = 0,
+  p1  = 1,
+  p2  = 2,
+  p3  = 3,
+  p4  = 4,
+  p5  = 5,
+  p6  = 6,
+  p7  = 7,
+  p8  = 8,
+  p9  = 9,
+  p10 = 10,
+  p11 = 11,
+  p12 = 12,
+  p13 = 13,
+  p14 = 14,
+  p15 = 15,
+};
+
 /**
  * 7-bit unsigned immediate value, in the range 0..127.
  */
@@ -57,4 +389,94 @@ union machinery::arch::arm_imm7 final {
   }
 };
 
+/**
+ * ARMv8 A64 memory operand.
+ *
+ * The base register is a 64-bit register, where register 31 denotes `SP`.
+ * Whether an immediate offset is encodable depends on the instruction and
+ * the access size, so the emitter checks it.
+ */
+class machinery::arch::arm_mem final {
+public:
+  arm_reg base;
+  arm_addressing mode;
+  arm_reg index;       /* for a register offset */
+  arm_extend extend;   /* for a register offset: UXTW, UXTX (LSL), SXTW, or SXTX */
+  std::uint8_t shift;  /* for a register offset: 0, or log2 of the access size */
+  std::int32_t offset; /* for an immediate offset, in bytes */
+
+  /**
+   * Constructor for `[base, #offset]`.
+   *
+   * @param base   the base register
+   * @param offset the signed byte offset
+   */
+  explicit arm_mem(const arm_xreg base, const std::int32_t offset = 0) noexcept
+    : arm_mem(base, arm_addressing::offset, offset) {}
+
+  /**
+   * Constructor for `[base, index, LSL #shift]`.
+   *
+   * @param base  the base register
+   * @param index the 64-bit index register
+   * @param shift the left shift of the index: 0, or log2 of the access size
+   */
+  arm_mem(const arm_xreg base, const arm_xreg index, const unsigned shift = 0) noexcept
+    : arm_mem(base, static_cast<arm_reg>(index), arm_extend::uxtx, shift) {}
+
+  /**
+   * Constructor for `[base, index, extend #shift]`.
+   *
+   * @param base   the base register
+   * @param index  the 32-bit index register
+   * @param extend the extension of the index: `UXTW` or `SXTW`
+   * @param shift  the left shift of the index: 0, or log2 of the access size
+   * @throws std::invalid_argument if `extend` is invalid
+   */
+  arm_mem(const arm_xreg base, const arm_wreg index, const arm_extend extend,
+          const unsigned shift = 0)
+    : arm_mem(base, static_cast<arm_reg>(index), check_extend(extend), shift) {}
+
+  /**
+   * Returns the operand `[base, #offset]!`, which adds the offset to the
+   * base register before the access.
+   */
+  static arm_mem pre_index(const arm_xreg base, const std::int32_t offset) noexcept {
+    return arm_mem(base, arm_addressing::pre_index, offset);
+  }
+
+  /**
+   * Returns the operand `[base], #offset`, which adds the offset to the
+   * base register after the access.
+   */
+  static arm_mem post_index(const arm_xreg base, const std::int32_t offset) noexcept {
+    return arm_mem(base, arm_addressing::post_index, offset);
+  }
+
+private:
+  arm_mem(const arm_xreg base, const arm_addressing mode, const std::int32_t offset) noexcept
+    : base(static_cast<arm_reg>(base)),
+      mode(mode),
+      index(0),
+      extend(arm_extend::uxtx),
+      shift(0),
+      offset(offset) {}
+
+  arm_mem(const arm_xreg base, const arm_reg index, const arm_extend extend,
+          const unsigned shift) noexcept
+    : base(static_cast<arm_reg>(base)),
+      mode(arm_addressing::register_offset),
+      index(index),
+      extend(extend),
+      shift(static_cast<std::uint8_t>(shift)),
+      offset(0) {}
+
+  static arm_extend check_extend(const arm_extend extend) {
+    if (extend != arm_extend::uxtw && extend != arm_extend::sxtw) {
+      throw std::invalid_argument("a 32-bit index register must be extended with UXTW or SXTW");
+    }
+    return extend;
+  }
+};
+
 #endif /* MACHINERY_ARCH_ARM_ENCODING_H */
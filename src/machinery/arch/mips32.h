@@ -19,6 +19,8 @@ namespace machinery {
   namespace arch {
     namespace mips32 {
       using emitter = mips32_emitter<class Buffer>; // FIXME
+      using label   = mips32_label;
+      using padding = mips32_padding;
     }
   }
 }
@@ -7,12 +7,27 @@
 #include "emitter.h"
 #include "../../jit/compiler.h"
 
+#include <stdexcept> /* for std::logic_error */
+
 namespace {
 
 class compiler final : public machinery::jit::compiler {
   using emitter = machinery::arch::mips32_emitter<buffer>;
+  using label   = machinery::jit::label;
 
   emitter _emitter;
+  std::size_t _emitter_label_count {0};
+
+  /**
+   * Returns the emitter label for the given compiler label, creating
+   * emitter labels as needed so that their indices coincide.
+   */
+  machinery::arch::mips32_label resolve(const label target) {
+    for (; _emitter_label_count <= target.id; _emitter_label_count++) {
+      _emitter.new_label();
+    }
+    return machinery::arch::mips32_label(target.id);
+  }
 
 public:
   /**
@@ -31,8 +46,20 @@ public:
     return *this;
   }
 
-  virtual compiler& jmp(...) override {
-    // TODO
+  virtual compiler& bind(const label target) override {
+    _emitter.bind(resolve(target));
+    return *this;
+  }
+
+  virtual compiler& align(const std::size_t boundary,
+                          const machinery::jit::padding fill) override {
+    _emitter.align(boundary, (fill == machinery::jit::padding::trap) ?
+      machinery::arch::mips32_padding::trap : machinery::arch::mips32_padding::nop);
+    return *this;
+  }
+
+  virtual compiler& jmp(const label target) override {
+    _emitter.b(resolve(target));
     return *this;
   }
 
@@ -61,14 +88,15 @@ public:
     return *this;
   }
 
-  virtual compiler& clz(...) override {
+  virtual compiler& clz(machinery::jit::reg, machinery::jit::reg) override {
     // TODO
     return *this;
   }
 
-  virtual compiler& cmp(...) override {
-    // TODO
-    return *this;
+  virtual compiler& cmp(machinery::jit::condition, machinery::jit::reg,
+                        machinery::jit::reg, machinery::jit::reg) override {
+    /* The MIPS32 emitter has no general-purpose registers yet: */
+    throw std::logic_error("not implemented");
   }
 
   virtual compiler& dec(...) override {
@@ -107,7 +135,7 @@ public:
   }
 
   virtual compiler& nop() override {
-    // TODO
+    _emitter.nop();
     return *this;
   }
 
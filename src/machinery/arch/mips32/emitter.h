@@ -10,17 +10,40 @@
  */
 
 #include "encoding.h"
+#include "../../bits/endian.h"
 
 #include <cstddef>   /* for std::size_t */
-#include <cstdint>   /* for std::uint8_t */
-#include <stdexcept> /* for std::runtime_error */
+#include <cstdint>   /* for std::int64_t, std::uint8_t */
+#include <stdexcept> /* for std::invalid_argument, std::logic_error, std::out_of_range, std::runtime_error */
+#include <vector>    /* for std::vector */
 
 namespace machinery {
   namespace arch {
     template<class Buffer> class mips32_emitter;
+    class mips32_label;
   }
 }
 
+/**
+ * A branch target in code emitted by a `mips32_emitter`.
+ *
+ * Labels are created by `mips32_emitter::new_label()`, can be referenced
+ * by branches before or after they are bound, and are only meaningful to
+ * the emitter that created them.
+ */
+class machinery::arch::mips32_label final {
+public:
+  std::size_t id;
+
+  /**
+   * Constructor.
+   *
+   * @param id the label index within its emitter
+   */
+  explicit mips32_label(const std::size_t id) noexcept
+    : id(id) {}
+};
+
 /**
  * MIPS32 machine code emitter.
  *
@@ -28,8 +51,19 @@ namespace machinery {
  */
 template <class Buffer>
 class machinery::arch::mips32_emitter {
+  /* A branch to a label, as recorded for fixups: */
+  struct branch {
+    std::size_t offset;   /* buffer offset of the instruction */
+    std::size_t label;    /* target label index */
+    std::uint32_t insn;   /* the instruction, with a zero displacement */
+  };
+
+  static constexpr std::size_t unbound = static_cast<std::size_t>(-1);
+
   Buffer& _buffer;
   std::size_t _buffer_start;
+  std::vector<std::size_t> _labels;
+  std::vector<branch> _branches;
 
 public:
   /**
@@ -82,6 +116,196 @@ public:
   std::size_t offset() const noexcept {
     return _buffer.size() - _buffer_start;
   }
+
+  /**
+   * Emits a 32-bit instruction in little-endian byte order.
+   *
+   * @param insn the instruction word
+   * @return `*this`
+   * @throws std::bad_alloc if out of memory
+   */
+  inline mips32_emitter& emit(const std::uint32_t insn) {
+    machinery::bits::store_le32(_buffer.extend(4), insn);
+    return *this;
+  }
+
+  /**
+   * @name Labels
+   */
+
+  /**@{*/
+
+  /**
+   * Creates a new, unbound label.
+   */
+  mips32_label new_label() {
+    _labels.push_back(unbound);
+    return mips32_label(_labels.size() - 1);
+  }
+
+  /**
+   * Binds the given label to the current offset, and patches all branches
+   * emitted so far that refer to it.
+   *
+   * @param label the label to bind
+   * @return `*this`
+   * @throws std::logic_error if the label is already bound
+   * @throws std::out_of_range if a branch cannot reach it
+   */
+  mips32_emitter& bind(const mips32_label label) {
+    if (_labels.at(label.id) != unbound) {
+      throw std::logic_error("label already bound");
+    }
+    _labels[label.id] = _buffer.size();
+    for (const auto& entry : _branches) {
+      if (entry.label == label.id) {
+        patch_branch(entry, _labels[label.id]);
+      }
+    }
+    return *this;
+  }
+
+  /**
+   * Returns whether the given label has been bound.
+   */
+  bool bound(const mips32_label label) const {
+    return _labels.at(label.id) != unbound;
+  }
+
+  /**
+   * Returns the offset that the given label is bound to.
+   *
+   * @return a zero-based byte offset, as per `offset()`
+   * @throws std::logic_error if the label is unbound
+   */
+  std::size_t offset(const mips32_label label) const {
+    if (!bound(label)) {
+      throw std::logic_error("label not bound");
+    }
+    return _labels[label.id] - _buffer_start;
+  }
+
+  /**@}*/
+
+  /**
+   * Pads the code with `NOP` or `BREAK` instructions up to the next
+   * multiple of the given boundary.
+   *
+   * @param boundary a power of two of at least 4, e.g. 16 or 32
+   * @param fill     the filler for the padding
+   * @return `*this`
+   * @throws std::bad_alloc if out of memory
+   * @throws std::invalid_argument if `boundary` is not a power of two of at
+   *         least 4
+   * @throws std::logic_error if the buffer offset is not a multiple of 4
+   */
+  mips32_emitter& align(const std::size_t boundary,
+                        const mips32_padding fill = mips32_padding::nop) {
+    if (boundary < 4 || (boundary & (boundary - 1))) {
+      throw std::invalid_argument("alignment boundary must be a power of two of at least 4");
+    }
+    const std::size_t size = (boundary - (_buffer.size() & (boundary - 1))) & (boundary - 1);
+    if (size & 3) {
+      throw std::logic_error("code is not aligned to instruction boundaries");
+    }
+    const std::uint32_t insn = (fill == mips32_padding::trap) ? 0x0000000D : 0x00000000;
+    std::uint8_t* const cursor = _buffer.extend(size);
+    for (std::size_t i = 0; i < size; i += 4) {
+      machinery::bits::store_le32(cursor + i, insn);
+    }
+    return *this;
+  }
+
+  /**
+   * @name General-Purpose Instructions
+   */
+
+  /**@{*/
+
+  /**
+   * @class emit_general_purpose_instruction
+   *
+   * @return `*this`
+   * @throws std::bad_alloc if out of memory
+   */
+
+  /**
+   * Emits a `B` (unconditional branch) instruction to the given label,
+   * followed by a `NOP` in its delay slot.
+   *
+   * The branch is a `BEQ $zero, $zero`, which reaches 128 KiB either way.
+   *
+   * @return `*this`
+   * @throws std::bad_alloc if out of memory
+   * @throws std::out_of_range if the label is bound beyond reach
+   */
+  mips32_emitter& b(const mips32_label target) {
+    return branch_to(0x10000000, target);
+  }
+
+  /**
+   * Emits a `NOP` instruction.
+   *
+   * @copydetails emit_general_purpose_instruction
+   */
+  mips32_emitter& nop() {
+    return emit(0x00000000);
+  }
+
+  /**@}*/
+
+protected:
+  /**
+   * Returns the displacement from a branch's delay slot to its target.
+   */
+  static std::int64_t displacement(const std::size_t target,
+                                   const std::size_t source) noexcept {
+    return static_cast<std::int64_t>(target) - static_cast<std::int64_t>(source + 4);
+  }
+
+  /**
+   * Returns the given branch instruction with its 16-bit word offset set.
+   *
+   * @throws std::out_of_range if the displacement does not fit
+   */
+  static std::uint32_t with_displacement(const std::uint32_t insn,
+                                         const std::int64_t disp) {
+    if (disp < -(std::int64_t{1} << 17) || disp >= (std::int64_t{1} << 17)) {
+      throw std::out_of_range("branch target is out of range");
+    }
+    return insn | (static_cast<std::uint32_t>(disp >> 2) & 0xFFFF);
+  }
+
+  /**
+   * Emits a branch to the given label, followed by a `NOP` in its delay
+   * slot.
+   */
+  mips32_emitter& branch_to(const std::uint32_t insn, const mips32_label target) {
+    const std::size_t position = _labels.at(target.id);
+    const branch entry {_buffer.size(), target.id, insn};
+    const std::uint32_t word = (position == unbound) ? insn :
+      with_displacement(insn, displacement(position, entry.offset));
+    std::uint8_t* const cursor = _buffer.extend(8);
+    machinery::bits::store_le32(cursor, word);
+    machinery::bits::store_le32(cursor + 4, 0x00000000);
+    _branches.push_back(entry);
+    return *this;
+  }
+
+  /**
+   * Rewrites the displacement of a recorded branch.
+   *
+   * @throws std::out_of_range if the branch does not reach the target
+   */
+  void patch_branch(const branch& entry, const std::size_t target) {
+    std::uint8_t bytes[4];
+    machinery::bits::store_le32(bytes,
+      with_displacement(entry.insn, displacement(target, entry.offset)));
+    _buffer.patch(entry.offset, bytes, 4);
+  }
 };
 
+template <class Buffer>
+constexpr std::size_t machinery::arch::mips32_emitter<Buffer>::unbound;
+
 #endif /* MACHINERY_ARCH_MIPS32_EMITTER_H */
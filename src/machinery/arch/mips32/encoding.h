@@ -13,8 +13,16 @@
 
 namespace machinery {
   namespace arch {
-    // TODO
+    enum class mips32_padding : std::uint8_t;
   }
 }
 
+/**
+ * The filler for alignment padding.
+ */
+enum class machinery::arch::mips32_padding : std::uint8_t {
+  nop,  /* `NOP` instructions, for padding that is executed */
+  trap, /* `BREAK` instructions, for padding that must never be executed */
+};
+
 #endif /* MACHINERY_ARCH_MIPS32_ENCODING_H */
@@ -21,16 +21,26 @@ namespace machinery {
   namespace arch {
     namespace x86 {
       using emitter = x86_emitter<class Buffer>; // FIXME
+      using bcst    = x86_bcst;
+      using cc      = x86_cc;
       using imm8    = x86_imm8;
       using imm16   = x86_imm16;
       using imm32   = x86_imm32;
       using imm64   = x86_imm64;
+      using kreg    = x86_kreg;
+      using label   = x86_label;
+      using mask    = x86_mask;
+      using mem     = x86_mem;
       using opcode  = x86_opcode;
+      using padding = x86_padding;
       using reg     = x86_reg;
       using reg8    = x86_reg8;
       using reg16   = x86_reg16;
       using reg32   = x86_reg32;
       using reg64   = x86_reg64;
+      using xmm     = x86_xmm;
+      using ymm     = x86_ymm;
+      using zmm     = x86_zmm;
     }
   }
 }
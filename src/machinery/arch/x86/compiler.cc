@@ -10,10 +10,48 @@
 namespace {
 
 class compiler final : public machinery::jit::compiler {
-  using emitter = machinery::arch::x86_emitter<buffer>;
-  using reg64   = machinery::arch::x86_reg64;
+  using emitter   = machinery::arch::x86_emitter<buffer>;
+  using label     = machinery::jit::label;
+  using reg       = machinery::jit::reg;
+  using condition = machinery::jit::condition;
+  using cc        = machinery::arch::x86_cc;
+  using reg8      = machinery::arch::x86_reg8;
+  using reg32     = machinery::arch::x86_reg32;
+  using reg64     = machinery::arch::x86_reg64;
+  using imm32     = machinery::arch::x86_imm32;
+  using feature   = machinery::util::cpu_feature;
 
   emitter _emitter;
+  std::size_t _emitter_label_count {0};
+
+  /**
+   * Returns the emitter label for the given compiler label, creating
+   * emitter labels as needed so that their indices coincide.
+   */
+  machinery::arch::x86_label resolve(const label target) {
+    for (; _emitter_label_count <= target.id; _emitter_label_count++) {
+      _emitter.new_label();
+    }
+    return machinery::arch::x86_label(target.id);
+  }
+
+  /**
+   * Returns the x86 condition code for the given comparison condition.
+   */
+  static cc cc_of(const condition cond) noexcept {
+    static const cc codes[] = {
+      cc::e, cc::ne, cc::l, cc::le, cc::g, cc::ge, cc::b, cc::be, cc::a, cc::ae,
+    };
+    return codes[static_cast<std::size_t>(cond)];
+  }
+
+  /**
+   * Returns the low byte of the given register, using the REX-only
+   * encodings of SPL..DIL in place of AH..BH.
+   */
+  static reg8 low_byte_of(const reg r) noexcept {
+    return static_cast<reg8>((r.id >= 4 && r.id < 8) ? (0x10 | r.id) : r.id);
+  }
 
 public:
   /**
@@ -33,8 +71,25 @@ public:
     return *this;
   }
 
-  virtual compiler& jmp(...) override {
-    // TODO
+  virtual compiler& bind(const label target) override {
+    _emitter.bind(resolve(target));
+    return *this;
+  }
+
+  virtual compiler& jmp(const label target) override {
+    _emitter.jmp(resolve(target));
+    return *this;
+  }
+
+  virtual compiler& align(const std::size_t boundary,
+                          const machinery::jit::padding fill) override {
+    _emitter.align(boundary, (fill == machinery::jit::padding::trap) ?
+      machinery::arch::x86_padding::trap : machinery::arch::x86_padding::nop);
+    return *this;
+  }
+
+  virtual compiler& relax() override {
+    _emitter.relax();
     return *this;
   }
 
@@ -63,13 +118,39 @@ public:
     return *this;
   }
 
-  virtual compiler& clz(...) override {
-    // TODO
-    return *this;
-  }
-
-  virtual compiler& cmp(...) override {
-    // TODO
+  virtual compiler& clz(const reg dst, const reg src) override {
+    const reg32 dst32 = static_cast<reg32>(dst.id);
+    const reg64 dst64 = static_cast<reg64>(dst.id);
+    if (_features.has(feature::lzcnt)) {
+      _emitter.lzcnt(dst64, static_cast<reg64>(src.id));
+      return *this;
+    }
+    /* BSR yields the index of the highest set bit, and 63 - index = 63 ^ index;
+     * a zero source leaves the target undefined, so substitute 127 ^ 63 = 64: */
+    const auto nonzero = resolve(new_label());
+    _emitter.bsr(dst64, static_cast<reg64>(src.id));
+    _emitter.jcc(cc::ne, nonzero);
+    _emitter.mov(dst32, imm32(127));
+    _emitter.bind(nonzero);
+    _emitter.xor_(dst32, imm32(63));
+    return *this;
+  }
+
+  virtual compiler& cmp(const condition cond, const reg dst,
+                        const reg lhs, const reg rhs) override {
+    const reg8 dst8 = low_byte_of(dst);
+    const reg32 dst32 = static_cast<reg32>(dst.id);
+    if (dst.id != lhs.id && dst.id != rhs.id) {
+      /* Clear the target first, which must precede the flag-setting CMP: */
+      _emitter.xor_(dst32, dst32);
+      _emitter.cmp(static_cast<reg64>(lhs.id), static_cast<reg64>(rhs.id));
+      _emitter.setcc(cc_of(cond), dst8);
+    }
+    else {
+      _emitter.cmp(static_cast<reg64>(lhs.id), static_cast<reg64>(rhs.id));
+      _emitter.setcc(cc_of(cond), dst8);
+      _emitter.movzx(dst32, dst8);
+    }
     return *this;
   }
 
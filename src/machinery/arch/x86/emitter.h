@@ -10,17 +10,44 @@
  */
 
 #include "encoding.h"
+#include "../../bits/endian.h"
 
-#include <cstddef>   /* for std::size_t */
-#include <cstdint>   /* for std::uint8_t */
-#include <stdexcept> /* for std::runtime_error */
+#include <algorithm>        /* for std::copy(), std::fill(), std::upper_bound() */
+#include <cstddef>          /* for std::size_t */
+#include <cstdint>          /* for INT32_MAX, INT32_MIN, std::uint8_t, std::uintptr_t */
+#include <initializer_list> /* for std::initializer_list */
+#include <stdexcept>        /* for std::invalid_argument, std::logic_error, std::out_of_range, std::runtime_error */
+#include <type_traits>      /* for std::is_same */
+#include <utility>          /* for std::declval() */
+#include <vector>           /* for std::vector */
 
 namespace machinery {
   namespace arch {
     template<class Buffer> class x86_emitter;
+    class x86_label;
   }
 }
 
+/**
+ * A branch target in code emitted by an `x86_emitter`.
+ *
+ * Labels are created by `x86_emitter::new_label()`, can be referenced by
+ * branches before or after they are bound, and are only meaningful to the
+ * emitter that created them.
+ */
+class machinery::arch::x86_label final {
+public:
+  std::size_t id;
+
+  /**
+   * Constructor.
+   *
+   * @param id the label index within its emitter
+   */
+  explicit x86_label(const std::size_t id) noexcept
+    : id(id) {}
+};
+
 /**
  * x86 machine code emitter.
  *
@@ -28,8 +55,33 @@ namespace machinery {
  */
 template <class Buffer>
 class machinery::arch::x86_emitter {
+  /* A branch to a label, as recorded for fixups and relaxation: */
+  struct branch {
+    std::size_t offset;   /* buffer offset of the instruction */
+    std::size_t label;    /* target label index */
+    std::uint8_t kind;    /* a condition code, or jmp_kind or call_kind */
+    std::uint8_t length;  /* current instruction length */
+  };
+
+  /* An alignment directive, as recorded for relaxation: */
+  struct alignment {
+    std::size_t offset;   /* buffer offset of the padding */
+    std::size_t boundary; /* a power of two */
+    std::size_t size;     /* current byte size of the padding */
+    x86_padding fill;
+  };
+
+  static constexpr std::uint8_t jmp_kind = 0x10;
+  static constexpr std::uint8_t call_kind = 0x11;
+  static constexpr std::size_t unbound = static_cast<std::size_t>(-1);
+
   Buffer& _buffer;
   std::size_t _buffer_start;
+  std::vector<std::size_t> _labels;
+  std::vector<branch> _branches;
+  std::vector<alignment> _alignments;
+  bool _compact {true};
+  bool _lock {false};
 
 public:
   /**
@@ -71,6 +123,11 @@ public:
    */
   x86_emitter& operator=(x86_emitter&& other) noexcept = default;
 
+  /**
+   * The byte size of the sequence emitted by `far_jump()`.
+   */
+  static constexpr std::size_t far_jump_size = 14;
+
   /**
    * Returns the current buffer offset as a byte count.
    *
@@ -83,6 +140,30 @@ public:
     return _buffer.size() - _buffer_start;
   }
 
+  /**
+   * Returns whether immediate operands are given their shortest encoding.
+   */
+  bool compact_immediates() const noexcept {
+    return _compact;
+  }
+
+  /**
+   * Enables or disables the shortest encoding of immediate operands.
+   *
+   * When enabled, as by default, `MOV` and the ALU instructions choose the
+   * smallest correct form for each immediate value: a sign-extended `imm8`,
+   * an accumulator form, a zero-extending `MOV reg32, imm32`, or `XOR` for
+   * zero. Disable it to get the fixed-size forms that later patching of the
+   * immediate value relies on.
+   *
+   * @param enabled whether to choose the shortest encoding
+   * @return `*this`
+   */
+  x86_emitter& set_compact_immediates(const bool enabled) noexcept {
+    _compact = enabled;
+    return *this;
+  }
+
   /**
    * Emits a one-byte instruction.
    *
@@ -91,7 +172,7 @@ public:
    * @throws std::bad_alloc if out of memory
    */
   inline x86_emitter& emit(const x86_opcode opcode) {
-    _buffer.append(opcode);
+    *reserve(1) = opcode;
     return *this;
   }
 
@@ -105,7 +186,9 @@ public:
    */
   inline x86_emitter& emit(const x86_opcode opcode,
                            const x86_opcode opcode2) {
-    _buffer.append({opcode, opcode2});
+    std::uint8_t* const cursor = reserve(2);
+    cursor[0] = opcode;
+    cursor[1] = opcode2;
     return *this;
   }
 
@@ -121,7 +204,10 @@ public:
   inline x86_emitter& emit(const x86_opcode opcode,
                            const x86_opcode opcode2,
                            const x86_opcode opcode3) {
-    _buffer.append({opcode, opcode2, opcode3});
+    std::uint8_t* const cursor = reserve(3);
+    cursor[0] = opcode;
+    cursor[1] = opcode2;
+    cursor[2] = opcode3;
     return *this;
   }
 
@@ -139,7 +225,7 @@ public:
    * @copydetails emit_immediate_value
    */
   inline x86_emitter& emit(const x86_imm8 imm) {
-    _buffer.append(imm.u8);
+    *_buffer.extend(1) = imm.u8;
     return *this;
   }
 
@@ -148,11 +234,8 @@ public:
    *
    * @copydetails emit_immediate_value
    */
-  inline x86_emitter& emit(x86_imm16 imm) {
-    for (auto i = 0; i < 2; i++) {
-      _buffer.append(imm.u16 & 0xFF);
-      imm.u16 >>= 8;
-    }
+  inline x86_emitter& emit(const x86_imm16 imm) {
+    machinery::bits::store_le16(_buffer.extend(2), imm.u16);
     return *this;
   }
 
@@ -161,11 +244,8 @@ public:
    *
    * @copydetails emit_immediate_value
    */
-  inline x86_emitter& emit(x86_imm32 imm) {
-    for (auto i = 0; i < 4; i++) {
-      _buffer.append(imm.u32 & 0xFF);
-      imm.u32 >>= 8;
-    }
+  inline x86_emitter& emit(const x86_imm32 imm) {
+    machinery::bits::store_le32(_buffer.extend(4), imm.u32);
     return *this;
   }
 
@@ -174,14 +254,255 @@ public:
    *
    * @copydetails emit_immediate_value
    */
-  inline x86_emitter& emit(x86_imm64 imm) {
-    for (auto i = 0; i < 8; i++) {
-      _buffer.append(imm.u64 & 0xFF);
-      imm.u64 >>= 8;
+  inline x86_emitter& emit(const x86_imm64 imm) {
+    machinery::bits::store_le64(_buffer.extend(8), imm.u64);
+    return *this;
+  }
+
+  /**
+   * @name Labels
+   *
+   * Branches to labels initially use the short `rel8` form only for
+   * backward targets within reach; all other branches use the `rel32` form
+   * and are patched when their label is bound. A subsequent call to
+   * `relax()` shortens every branch whose displacement fits, and keeps the
+   * code aligned as per `align()`.
+   */
+
+  /**@{*/
+
+  /**
+   * Creates a new, unbound label.
+   */
+  x86_label new_label() {
+    _labels.push_back(unbound);
+    return x86_label(_labels.size() - 1);
+  }
+
+  /**
+   * Binds the given label to the current offset, and patches all branches
+   * emitted so far that refer to it.
+   *
+   * @param label the label to bind
+   * @return `*this`
+   * @throws std::logic_error if the label is already bound
+   */
+  x86_emitter& bind(const x86_label label) {
+    if (_labels.at(label.id) != unbound) {
+      throw std::logic_error("label already bound");
+    }
+    _labels[label.id] = _buffer.size();
+    for (const auto& entry : _branches) {
+      if (entry.label == label.id) {
+        patch_branch(entry, _labels[label.id]);
+      }
+    }
+    return *this;
+  }
+
+  /**
+   * Returns whether the given label has been bound.
+   */
+  bool bound(const x86_label label) const {
+    return _labels.at(label.id) != unbound;
+  }
+
+  /**
+   * Returns the offset that the given label is bound to.
+   *
+   * @return a zero-based byte offset, as per `offset()`
+   * @throws std::logic_error if the label is unbound
+   */
+  std::size_t offset(const x86_label label) const {
+    if (!bound(label)) {
+      throw std::logic_error("label not bound");
+    }
+    return _labels[label.id] - _buffer_start;
+  }
+
+  /**
+   * Shortens every `JMP` and `Jcc` to a label whose displacement fits in
+   * the `rel8` form, iterating until no more branches can be shortened.
+   * A short branch that alignment padding pushes out of reach is widened
+   * to the `rel32` form instead.
+   *
+   * Shortening moves the code that follows a branch, so this must be done
+   * before the code is executed or its addresses are taken. Only branches
+   * to labels are adjusted: the code must not contain other relative
+   * references across a shortened branch, such as RIP-relative operands.
+   *
+   * The code is re-emitted in place, so the buffer must implement
+   * `truncate()`, which a `segmented_buffer` or `persistent_buffer` does
+   * not. A `counting_buffer` yields the relaxed size.
+   *
+   * @return `*this`
+   * @throws std::bad_alloc if out of memory
+   */
+  x86_emitter& relax() {
+    static_assert(std::is_same<decltype(std::declval<Buffer&>().truncate(0)), Buffer&>::value,
+      "relax() requires a buffer that implements truncate()");
+    std::vector<branch> branches(_branches);
+    std::vector<std::size_t> labels(_labels);
+    std::vector<bool> pinned(branches.size());
+
+    /* Shrinking a branch only ever brings other targets closer, except that
+     * alignment padding in between may grow, by less than its boundary. So
+     * lay the code out anew after each round, and widen for good any short
+     * branch that no longer reaches, before shrinking any more: */
+    const std::size_t short_length = 2;
+    bool changed;
+    do {
+      plan_layout(branches, labels);
+      changed = false;
+      for (auto i = 0UL; i < branches.size(); i++) {
+        auto& entry = branches[i];
+        if (entry.length == short_length && labels[entry.label] != unbound &&
+            !fits_rel8(displacement(labels[entry.label], entry.offset + short_length))) {
+          entry.length = (entry.kind == jmp_kind) ? 5 : 6;
+          pinned[i] = changed = true;
+        }
+      }
+      if (changed) {
+        continue;
+      }
+      for (auto i = 0UL; i < branches.size(); i++) {
+        auto& entry = branches[i];
+        if (entry.kind == call_kind || entry.length == short_length || pinned[i] ||
+            labels[entry.label] == unbound) {
+          continue;
+        }
+        const std::size_t shrink = entry.length - short_length;
+        std::size_t target = labels[entry.label];
+        if (target > entry.offset) {
+          target -= shrink;
+        }
+        const std::int64_t disp = displacement(target, entry.offset + short_length);
+        const std::int64_t slack = alignment_slack(_branches[i].offset, _labels[entry.label]);
+        if (fits_rel8(disp < 0 ? disp - slack : disp + slack)) {
+          entry.length = short_length;
+          changed = true;
+        }
+      }
+    } while (changed);
+
+    /* Find the first branch that was resized: */
+    std::size_t first = 0;
+    while (first < branches.size() && branches[first].length == _branches[first].length) {
+      first++;
+    }
+    if (first == branches.size()) {
+      return *this;
+    }
+
+    /* Re-emit everything from there on with the new layout, recording
+     * where each run of unchanged code moved to: */
+    struct run {
+      std::size_t old_offset;
+      std::size_t new_offset;
+    };
+    std::vector<run> runs;
+    const std::size_t start = _branches[first].offset;
+    /* A buffer that keeps no bytes, such as `counting_buffer`, has no data: */
+    const std::uint8_t* const data = _buffer.data();
+    const std::vector<std::uint8_t> tail = data ?
+      std::vector<std::uint8_t>(data + start, data + _buffer.size()) :
+      std::vector<std::uint8_t>(_buffer.size() - start);
+    _buffer.truncate(start);
+    std::size_t cursor = start;
+    std::size_t next_alignment = 0;
+    while (next_alignment < _alignments.size() && _alignments[next_alignment].offset < start) {
+      next_alignment++;
+    }
+    std::size_t next_branch = first;
+    for (;;) {
+      const bool is_alignment = next_alignment < _alignments.size() &&
+        (next_branch == branches.size() || _alignments[next_alignment].offset <= _branches[next_branch].offset);
+      const std::size_t end = is_alignment ? _alignments[next_alignment].offset :
+        (next_branch < branches.size()) ? _branches[next_branch].offset : start + tail.size();
+      runs.push_back({cursor, _buffer.size()});
+      std::copy(tail.begin() + (cursor - start), tail.begin() + (end - start),
+        _buffer.extend(end - cursor));
+      if (is_alignment) {
+        auto& entry = _alignments[next_alignment++];
+        cursor = entry.offset + entry.size;
+        entry.offset = _buffer.size();
+        entry.size = padding_size(entry.offset, entry.boundary);
+        store_padding(_buffer.extend(entry.size), entry.size, entry.fill);
+      }
+      else if (next_branch < branches.size()) {
+        auto& entry = branches[next_branch];
+        cursor = _branches[next_branch].offset + _branches[next_branch].length;
+        entry.offset = _buffer.size();
+        store_branch(_buffer.extend(entry.length), entry, 0);
+        next_branch++;
+      }
+      else {
+        break;
+      }
+    }
+
+    /* Move each label along with the run of code that it points into: */
+    for (auto i = 0UL; i < labels.size(); i++) {
+      const std::size_t position = _labels[i];
+      labels[i] = position;
+      if (position == unbound || position <= start) {
+        continue;
+      }
+      auto entry = std::upper_bound(runs.begin(), runs.end(), position,
+        [](const std::size_t offset, const run& other) { return offset < other.old_offset; });
+      --entry;
+      labels[i] = entry->new_offset + (position - entry->old_offset);
+    }
+
+    _branches.swap(branches);
+    _labels.swap(labels);
+
+    for (const auto& entry : _branches) {
+      if (_labels[entry.label] != unbound) {
+        patch_branch(entry, _labels[entry.label]);
+      }
+    }
+    return *this;
+  }
+
+  /**@}*/
+
+  /**
+   * @name Alignment
+   */
+
+  /**@{*/
+
+  /**
+   * Pads the code with `NOP` or `INT3` instructions up to the next multiple
+   * of the given boundary.
+   *
+   * The boundary applies to the buffer offset, so the code is aligned in
+   * memory insofar as the buffer itself is. Executed padding uses as few
+   * multi-byte `NOP` instructions as possible.
+   *
+   * @param boundary a power of two, e.g. 16, 32, or 64
+   * @param fill     the filler for the padding
+   * @return `*this`
+   * @throws std::bad_alloc if out of memory
+   * @throws std::invalid_argument if `boundary` is not a power of two
+   */
+  x86_emitter& align(const std::size_t boundary,
+                     const x86_padding fill = x86_padding::nop) {
+    if (boundary == 0 || (boundary & (boundary - 1))) {
+      throw std::invalid_argument("alignment boundary must be a power of two");
+    }
+    const std::size_t offset = _buffer.size();
+    const std::size_t size = padding_size(offset, boundary);
+    store_padding(reserve(size), size, fill);
+    if (boundary > 1) {
+      _alignments.push_back({offset, boundary, size, fill});
     }
     return *this;
   }
 
+  /**@}*/
+
   /**
    * @name General-Purpose Instructions
    *
@@ -216,6 +537,52 @@ public:
     return emit(0x3F);
   }
 
+  /**
+   * @class emit_alu_instruction
+   *
+   * Accepts these operand combinations, where `reg` is an 8-, 16-, 32-, or
+   * 64-bit register and `mem` is an `x86_mem`:
+   *
+   * - `reg, reg` and `reg, mem` and `mem, reg`, with operands of the same
+   *   width;
+   * - `reg8, imm8`, `reg16, imm16`, `reg32, imm32`, and `reg64, imm32`
+   *   (sign-extended);
+   * - `mem, imm8`, `mem, imm16`, and `mem, imm32` for byte, word, and
+   *   doubleword memory, and `mem, imm64` for quadword memory with a
+   *   sign-extended 32-bit value.
+   *
+   * Unless disabled with `set_compact_immediates()`, an immediate value that
+   * fits in a sign-extended byte uses the shorter `imm8` form.
+   *
+   * @param dst the destination operand
+   * @param src the source operand
+   * @return `*this`
+   * @throws std::bad_alloc if out of memory
+   * @throws std::invalid_argument if `AH`, `CH`, `DH`, or `BH` is combined
+   *         with an operand that requires a REX prefix
+   * @throws std::out_of_range if an `x86_imm64` does not fit in 32 bits
+   */
+
+  /**
+   * Emits an `ADC` instruction.
+   *
+   * @copydetails emit_alu_instruction
+   */
+  template <typename Dst, typename Src>
+  x86_emitter& adc(const Dst& dst, const Src& src) {
+    return alu(2, dst, src);
+  }
+
+  /**
+   * Emits an `ADD` instruction.
+   *
+   * @copydetails emit_alu_instruction
+   */
+  template <typename Dst, typename Src>
+  x86_emitter& add(const Dst& dst, const Src& src) {
+    return alu(0, dst, src);
+  }
+
   /**
    * Emits a two-byte `ADD AL, imm8` instruction.
    *
@@ -223,7 +590,10 @@ public:
    * @copydetails emit_general_purpose_instruction
    */
   x86_emitter& add(const x86_imm8 imm) {
-    return emit(0x04).emit(imm);
+    std::uint8_t* const cursor = reserve(2);
+    cursor[0] = 0x04;
+    cursor[1] = imm.u8;
+    return *this;
   }
 
   /**
@@ -233,21 +603,34 @@ public:
    * @copydetails emit_general_purpose_instruction
    */
   x86_emitter& add(const x86_imm16 imm) {
-    return emit(0x66, 0x05).emit(imm);
+    std::uint8_t* const cursor = reserve(4);
+    cursor[0] = 0x66;
+    cursor[1] = 0x05;
+    machinery::bits::store_le16(cursor + 2, imm.u16);
+    return *this;
   }
 
   /**
-   * Emits a five-byte `ADD EAX, imm32` instruction.
+   * Emits a five-byte `ADD EAX, imm32` instruction, or a three-byte
+   * `ADD EAX, imm8` if the value fits and immediates are compact.
    *
    * @param imm the 32-bit immediate value operand
    * @copydetails emit_general_purpose_instruction
    */
   x86_emitter& add(const x86_imm32 imm) {
-    return emit(0x05).emit(imm);
+    if (_compact && fits_imm8(static_cast<std::int32_t>(imm.u32))) {
+      return encode_rm(size32, {0x83}, ext(0), code_of(x86_reg32::eax), 1, imm.u32);
+    }
+    std::uint8_t* const cursor = reserve(5);
+    cursor[0] = 0x05;
+    machinery::bits::store_le32(cursor + 1, imm.u32);
+    return *this;
   }
 
   /**
-   * Emits a six-byte `ADD RAX, imm64` instruction.
+   * Emits a six-byte `ADD RAX, imm32` instruction, sign-extending the value,
+   * or a four-byte `ADD RAX, imm8` if the value fits and immediates are
+   * compact.
    *
    * @param imm the 64-bit immediate value operand
    * @copydetails emit_general_purpose_instruction
@@ -255,7 +638,171 @@ public:
   x86_emitter& add(const x86_imm64 imm) {
     // TODO: synthesize ops if imm > INT32_MAX?
     const std::int32_t narrowed = imm.s64;
-    return emit(0x48, 0x05).emit(x86_imm32(narrowed));
+    if (_compact && fits_imm8(narrowed)) {
+      return encode_rm(size64, {0x83}, ext(0), code_of(x86_reg64::rax), 1, imm.u64);
+    }
+    std::uint8_t* const cursor = reserve(6);
+    cursor[0] = 0x48;
+    cursor[1] = 0x05;
+    machinery::bits::store_le32(cursor + 2, narrowed);
+    return *this;
+  }
+
+  /**
+   * Emits an `AND` instruction.
+   *
+   * @copydetails emit_alu_instruction
+   */
+  template <typename Dst, typename Src>
+  x86_emitter& and_(const Dst& dst, const Src& src) {
+    return alu(4, dst, src);
+  }
+
+  /**
+   * Emits a `ANDN` (bitwise AND NOT: `dst = ~src1 & src2`) instruction.
+   *
+   * Requires the BMI1 extension.
+   *
+   * @param dst  a 32- or 64-bit target register operand
+   * @param src1 the first source register operand, of the same width
+   * @param src2 the second source register or memory operand
+   * @copydetails emit_general_purpose_instruction
+   */
+  template <typename Reg, typename Src>
+  x86_emitter& andn(const Reg dst, const Reg src1, const Src& src2) {
+    return encode_vex(flags_of(dst), vex_none, map_0f38, 0xF2, code_of(dst), code_of(src1), rm_of(src2));
+  }
+
+  /**
+   * Emits a `BEXTR` (extract the bit field of `src` that `ctl` specifies) instruction.
+   *
+   * Requires the BMI1 extension.
+   *
+   * @param dst  a 32- or 64-bit target register operand
+   * @param src  the source register or memory operand, of the same width
+   * @param ctl  the control register operand, of the same width
+   * @copydetails emit_general_purpose_instruction
+   */
+  template <typename Reg, typename Src>
+  x86_emitter& bextr(const Reg dst, const Src& src, const Reg ctl) {
+    return encode_vex(flags_of(dst), vex_none, map_0f38, 0xF7, code_of(dst), code_of(ctl), rm_of(src));
+  }
+
+  /**
+   * Emits a `BLSI` (isolate the lowest set bit) instruction.
+   *
+   * Requires the BMI1 extension.
+   *
+   * @param dst a 32- or 64-bit target register operand
+   * @param src the source register or memory operand, of the same width
+   * @copydetails emit_general_purpose_instruction
+   */
+  template <typename Reg, typename Src>
+  x86_emitter& blsi(const Reg dst, const Src& src) {
+    return encode_vex(flags_of(dst), vex_none, map_0f38, 0xF3, ext(3), code_of(dst), rm_of(src));
+  }
+
+  /**
+   * Emits a `BLSMSK` (mask up to the lowest set bit) instruction.
+   *
+   * Requires the BMI1 extension.
+   *
+   * @param dst a 32- or 64-bit target register operand
+   * @param src the source register or memory operand, of the same width
+   * @copydetails emit_general_purpose_instruction
+   */
+  template <typename Reg, typename Src>
+  x86_emitter& blsmsk(const Reg dst, const Src& src) {
+    return encode_vex(flags_of(dst), vex_none, map_0f38, 0xF3, ext(2), code_of(dst), rm_of(src));
+  }
+
+  /**
+   * Emits a `BLSR` (reset the lowest set bit) instruction.
+   *
+   * Requires the BMI1 extension.
+   *
+   * @param dst a 32- or 64-bit target register operand
+   * @param src the source register or memory operand, of the same width
+   * @copydetails emit_general_purpose_instruction
+   */
+  template <typename Reg, typename Src>
+  x86_emitter& blsr(const Reg dst, const Src& src) {
+    return encode_vex(flags_of(dst), vex_none, map_0f38, 0xF3, ext(1), code_of(dst), rm_of(src));
+  }
+
+  /**
+   * Emits a `BSF reg, reg/mem` (bit scan forward) instruction.
+   *
+   * The target is undefined if the source is zero, which sets `ZF`.
+   *
+   * @param dst a 16-, 32-, or 64-bit target register operand
+   * @param src a source register or memory operand of the same width
+   * @copydetails emit_general_purpose_instruction
+   */
+  template <typename Reg, typename Src>
+  x86_emitter& bsf(const Reg dst,
+                   const Src& src) {
+    return encode_rm(flags_of(dst), {0x0F, 0xBC}, code_of(dst), rm_of(src));
+  }
+
+  /**
+   * Emits a `BSR reg, reg/mem` (bit scan reverse) instruction.
+   *
+   * The target is undefined if the source is zero, which sets `ZF`.
+   *
+   * @param dst a 16-, 32-, or 64-bit target register operand
+   * @param src a source register or memory operand of the same width
+   * @copydetails emit_general_purpose_instruction
+   */
+  template <typename Reg, typename Src>
+  x86_emitter& bsr(const Reg dst,
+                   const Src& src) {
+    return encode_rm(flags_of(dst), {0x0F, 0xBD}, code_of(dst), rm_of(src));
+  }
+
+  /**
+   * Emits a `BZHI` (zero the high bits of `src` from the bit index in `ctl`) instruction.
+   *
+   * Requires the BMI2 extension.
+   *
+   * @param dst  a 32- or 64-bit target register operand
+   * @param src  the source register or memory operand, of the same width
+   * @param ctl  the control register operand, of the same width
+   * @copydetails emit_general_purpose_instruction
+   */
+  template <typename Reg, typename Src>
+  x86_emitter& bzhi(const Reg dst, const Src& src, const Reg ctl) {
+    return encode_vex(flags_of(dst), vex_none, map_0f38, 0xF5, code_of(dst), code_of(ctl), rm_of(src));
+  }
+
+  /**
+   * Emits a five-byte `CALL rel32` instruction to the given label.
+   *
+   * @param target the call target
+   * @copydetails emit_general_purpose_instruction
+   */
+  x86_emitter& call(const x86_label target) {
+    return branch_to(call_kind, target);
+  }
+
+  /**
+   * Emits a `CALL reg64` instruction.
+   *
+   * @param target a 64-bit register operand holding the call target
+   * @copydetails emit_general_purpose_instruction
+   */
+  x86_emitter& call(const x86_reg64 target) {
+    return encode_rm(size32, {0xFF}, ext(2), code_of(target));
+  }
+
+  /**
+   * Emits a `CALL mem64` instruction.
+   *
+   * @param target a memory operand holding the call target
+   * @copydetails emit_general_purpose_instruction
+   */
+  x86_emitter& call(const x86_mem& target) {
+    return encode_rm(size32, {0xFF}, ext(2), target);
   }
 
   /**
@@ -339,6 +886,48 @@ public:
     return emit(0xF5);
   }
 
+  /**
+   * Emits a `CMOVcc reg, reg` (conditional move) instruction.
+   *
+   * @param cc  the condition code
+   * @param dst a 16-, 32-, or 64-bit target register operand
+   * @param src the source register operand of the same width
+   * @copydetails emit_general_purpose_instruction
+   */
+  template <typename Reg>
+  x86_emitter& cmovcc(const x86_cc cc,
+                      const Reg dst,
+                      const Reg src) {
+    return encode_rm(flags_of(dst), {0x0F, static_cast<x86_opcode>(0x40 | static_cast<std::uint8_t>(cc))},
+      code_of(dst), code_of(src));
+  }
+
+  /**
+   * Emits a `CMOVcc reg, mem` (conditional move) instruction.
+   *
+   * @param cc  the condition code
+   * @param dst a 16-, 32-, or 64-bit target register operand
+   * @param src the source memory operand
+   * @copydetails emit_general_purpose_instruction
+   */
+  template <typename Reg>
+  x86_emitter& cmovcc(const x86_cc cc,
+                      const Reg dst,
+                      const x86_mem& src) {
+    return encode_rm(flags_of(dst), {0x0F, static_cast<x86_opcode>(0x40 | static_cast<std::uint8_t>(cc))},
+      code_of(dst), src);
+  }
+
+  /**
+   * Emits a `CMP` instruction.
+   *
+   * @copydetails emit_alu_instruction
+   */
+  template <typename Dst, typename Src>
+  x86_emitter& cmp(const Dst& dst, const Src& src) {
+    return alu(7, dst, src);
+  }
+
   /**
    * Emits a one-byte `CMPSB` instruction.
    *
@@ -375,6 +964,52 @@ public:
     return emit(0xA7);
   }
 
+  /**
+   * Emits a `CMPXCHG reg/mem, reg` (compare and exchange) instruction.
+   *
+   * Compares the accumulator of the same width with `dst`, storing `src`
+   * into `dst` if they are equal and loading `dst` into the accumulator
+   * otherwise. Precede it with `lock()` for an atomic update of memory.
+   *
+   * @param dst the target register or memory operand
+   * @param src the source register operand
+   * @copydetails emit_general_purpose_instruction
+   */
+  template <typename Dst, typename Reg>
+  x86_emitter& cmpxchg(const Dst& dst,
+                       const Reg src) {
+    const unsigned flags = flags_of(src);
+    return encode_rm(flags, {0x0F, static_cast<x86_opcode>((flags & size8) ? 0xB0 : 0xB1)},
+      code_of(src), rm_of(dst));
+  }
+
+  /**
+   * Emits a `CMPXCHG8B mem64` (compare and exchange 8 bytes) instruction.
+   *
+   * Compares `EDX:EAX` with the operand, storing `ECX:EBX` into it if they
+   * are equal and loading it into `EDX:EAX` otherwise.
+   *
+   * @param dst the target memory operand
+   * @copydetails emit_general_purpose_instruction
+   */
+  x86_emitter& cmpxchg8b(const x86_mem& dst) {
+    return encode_rm(size32, {0x0F, 0xC7}, ext(1), dst);
+  }
+
+  /**
+   * Emits a `CMPXCHG16B mem128` (compare and exchange 16 bytes) instruction.
+   *
+   * Compares `RDX:RAX` with the operand, storing `RCX:RBX` into it if they
+   * are equal and loading it into `RDX:RAX` otherwise. The operand must be
+   * 16-byte aligned.
+   *
+   * @param dst the target memory operand
+   * @copydetails emit_general_purpose_instruction
+   */
+  x86_emitter& cmpxchg16b(const x86_mem& dst) {
+    return encode_rm(size64, {0x0F, 0xC7}, ext(1), dst);
+  }
+
   /**
    * Emits a one-byte `DAA` instruction.
    *
@@ -393,6 +1028,25 @@ public:
     return emit(0x2F);
   }
 
+  /**
+   * Emits a 14-byte far jump to an absolute address.
+   *
+   * This is a `JMP [RIP+0]` instruction followed by the 64-bit target, so it
+   * reaches any address, does not depend on where it is placed, and does
+   * not clobber any registers.
+   *
+   * @param target the jump target
+   * @copydetails emit_general_purpose_instruction
+   */
+  x86_emitter& far_jump(const void* const target) {
+    std::uint8_t* const cursor = reserve(far_jump_size);
+    cursor[0] = 0xFF;
+    cursor[1] = 0x25;
+    machinery::bits::store_le32(cursor + 2, 0);
+    machinery::bits::store_le64(cursor + 6, reinterpret_cast<std::uintptr_t>(target));
+    return *this;
+  }
+
   /**
    * Emits a one-byte `INSB` instruction.
    *
@@ -430,30 +1084,113 @@ public:
   }
 
   /**
-   * Emits a one-byte `LAHF` instruction.
+   * Emits a `Jcc` (conditional jump) instruction to the given label.
    *
+   * @param cc     the condition code
+   * @param target the jump target
    * @copydetails emit_general_purpose_instruction
    */
-  x86_emitter& lahf() {
-    return emit(0x9F);
+  x86_emitter& jcc(const x86_cc cc, const x86_label target) {
+    return branch_to(static_cast<std::uint8_t>(cc), target);
   }
 
   /**
-   * Emits a one-byte `LEAVE` instruction.
+   * Emits a `JMP` instruction to the given label.
    *
+   * @param target the jump target
    * @copydetails emit_general_purpose_instruction
    */
-  x86_emitter& leave() {
-    return emit(0xC9);
+  x86_emitter& jmp(const x86_label target) {
+    return branch_to(jmp_kind, target);
   }
 
   /**
-   * Emits a one-byte `LODSB` instruction.
+   * Emits a `JMP reg64` instruction.
    *
+   * @param target a 64-bit register operand holding the jump target
    * @copydetails emit_general_purpose_instruction
    */
-  x86_emitter& lodsb() {
-    return emit(0xAC);
+  x86_emitter& jmp(const x86_reg64 target) {
+    return encode_rm(size32, {0xFF}, ext(4), code_of(target));
+  }
+
+  /**
+   * Emits a `JMP mem64` instruction.
+   *
+   * @param target a memory operand holding the jump target
+   * @copydetails emit_general_purpose_instruction
+   */
+  x86_emitter& jmp(const x86_mem& target) {
+    return encode_rm(size32, {0xFF}, ext(4), target);
+  }
+
+  /**
+   * Emits a one-byte `LAHF` instruction.
+   *
+   * @copydetails emit_general_purpose_instruction
+   */
+  x86_emitter& lahf() {
+    return emit(0x9F);
+  }
+
+  /**
+   * Emits a `LEA reg, mem` instruction.
+   *
+   * @param reg a 16-, 32-, or 64-bit target register operand
+   * @param mem the memory operand whose effective address to load
+   * @copydetails emit_general_purpose_instruction
+   */
+  template <typename Reg>
+  x86_emitter& lea(const Reg reg,
+                   const x86_mem& mem) {
+    return encode_rm(flags_of(reg), {0x8D}, code_of(reg), mem);
+  }
+
+  /**
+   * Emits a one-byte `LEAVE` instruction.
+   *
+   * @copydetails emit_general_purpose_instruction
+   */
+  x86_emitter& leave() {
+    return emit(0xC9);
+  }
+
+  /**
+   * Emits a three-byte `LFENCE` (load fence) instruction.
+   *
+   * @copydetails emit_general_purpose_instruction
+   */
+  x86_emitter& lfence() {
+    return emit(0x0F, 0xAE, 0xE8);
+  }
+
+  /**
+   * Makes the next instruction atomic with a one-byte `LOCK` prefix.
+   *
+   * The next instruction must be one of `ADC`, `ADD`, `AND`, `CMPXCHG`,
+   * `CMPXCHG8B`, `CMPXCHG16B`, `OR`, `SBB`, `SUB`, `XADD`, or `XOR` with a
+   * memory target operand. A locked instruction is also a full memory
+   * barrier.
+   *
+   * The prefix is emitted together with that instruction, so that nothing
+   * can come between them, such as the link of a `segmented_buffer`.
+   *
+   * @return `*this`
+   * @note The next instruction throws `std::logic_error` if it has no
+   *       memory operand.
+   */
+  x86_emitter& lock() noexcept {
+    _lock = true;
+    return *this;
+  }
+
+  /**
+   * Emits a one-byte `LODSB` instruction.
+   *
+   * @copydetails emit_general_purpose_instruction
+   */
+  x86_emitter& lodsb() {
+    return emit(0xAC);
   }
 
   /**
@@ -483,6 +1220,33 @@ public:
     return emit(0xAD);
   }
 
+  /**
+   * Emits a `LZCNT reg, reg/mem` (count leading zeros) instruction.
+   *
+   * Requires the LZCNT (ABM) extension; elsewhere this decodes as `BSR`.
+   *
+   * @param dst a 16-, 32-, or 64-bit target register operand
+   * @param src a source register or memory operand of the same width
+   * @copydetails emit_general_purpose_instruction
+   */
+  template <typename Reg, typename Src>
+  x86_emitter& lzcnt(const Reg dst,
+                     const Src& src) {
+    return encode_rm(flags_of(dst) | prefix_f3, {0x0F, 0xBD}, code_of(dst), rm_of(src));
+  }
+
+  /**
+   * Emits a three-byte `MFENCE` (memory fence) instruction.
+   *
+   * Orders all earlier loads and stores before all later ones, which plain
+   * x86 stores and loads do not guarantee among themselves.
+   *
+   * @copydetails emit_general_purpose_instruction
+   */
+  x86_emitter& mfence() {
+    return emit(0x0F, 0xAE, 0xF0);
+  }
+
   /**
    * Emits a two-byte `MOV reg8, imm8` instruction.
    *
@@ -492,7 +1256,7 @@ public:
    */
   x86_emitter& mov(const x86_reg8 reg,
                    const x86_imm8 imm) {
-    return emit(0xB0 + static_cast<std::uint8_t>(reg)).emit(imm);
+    return encode_o(size8, 0xB0, code_of(reg), 1, imm.u8);
   }
 
   /**
@@ -504,11 +1268,14 @@ public:
    */
   x86_emitter& mov(const x86_reg16 reg,
                    const x86_imm16 imm) {
-    return emit(0x66, 0xB8 + static_cast<std::uint8_t>(reg)).emit(imm);
+    return encode_o(size16, 0xB8, code_of(reg), 2, imm.u16);
   }
 
   /**
-   * Emits a five-byte `MOV reg32, imm32` instruction.
+   * Emits a five- or six-byte `MOV reg32, imm32` instruction.
+   *
+   * If immediates are compact, a zero value is instead set with the
+   * shorter `XOR reg32, reg32`, which clobbers the flags.
    *
    * @param reg the 32-bit target register operand
    * @param imm the 32-bit immediate value operand
@@ -516,34 +1283,129 @@ public:
    */
   x86_emitter& mov(const x86_reg32 reg,
                    const x86_imm32 imm) {
-    return emit(0xB8 + static_cast<std::uint8_t>(reg)).emit(imm);
+    if (_compact && imm.u32 == 0) {
+      return alu(6, reg, reg);
+    }
+    return encode_o(size32, 0xB8, code_of(reg), 4, imm.u32);
   }
 
   /**
    * Emits a ten-byte `MOV reg64, imm64` instruction.
    *
+   * If immediates are compact, a value that fits in 32 bits is instead set
+   * with the shorter, zero-extending `MOV reg32, imm32` or sign-extending
+   * `MOV reg64, imm32`, and a zero value with `XOR reg32, reg32`, which
+   * clobbers the flags.
+   *
    * @param reg the 64-bit target register operand
    * @param imm the 64-bit immediate value operand
    * @copydetails emit_general_purpose_instruction
    */
   x86_emitter& mov(const x86_reg64 reg,
                    const x86_imm64 imm) {
-    //assert(reg < x86_reg64::r8); // FIXME
-    return emit(0x48, 0xB8 + static_cast<std::uint8_t>(reg)).emit(imm); // FIXME
+    if (_compact) {
+      if (imm.u64 <= UINT32_MAX) {
+        return mov(static_cast<x86_reg32>(reg), x86_imm32(static_cast<std::uint32_t>(imm.u64)));
+      }
+      if (imm.s64 < 0 && imm.s64 >= INT32_MIN) {
+        return encode_rm(size64, {0xC7}, ext(0), code_of(reg), 4, imm.u64);
+      }
+    }
+    return encode_o(size64, 0xB8, code_of(reg), 8, imm.u64);
+  }
+
+  /**
+   * Emits a `MOV reg, reg` instruction.
+   *
+   * @param dst the target register operand
+   * @param src the source register operand of the same width
+   * @copydetails emit_general_purpose_instruction
+   */
+  template <typename Reg>
+  x86_emitter& mov(const Reg dst,
+                   const Reg src) {
+    const unsigned flags = flags_of(dst);
+    return encode_rm(flags, {static_cast<x86_opcode>((flags & size8) ? 0x88 : 0x89)},
+      code_of(src), code_of(dst));
+  }
+
+  /**
+   * Emits a `MOV reg, mem` instruction.
+   *
+   * @param dst the target register operand
+   * @param src the source memory operand
+   * @copydetails emit_general_purpose_instruction
+   */
+  template <typename Reg>
+  x86_emitter& mov(const Reg dst,
+                   const x86_mem& src) {
+    const unsigned flags = flags_of(dst);
+    return encode_rm(flags, {static_cast<x86_opcode>((flags & size8) ? 0x8A : 0x8B)},
+      code_of(dst), src);
+  }
+
+  /**
+   * Emits a `MOV mem, reg` instruction.
+   *
+   * @param dst the target memory operand
+   * @param src the source register operand
+   * @copydetails emit_general_purpose_instruction
+   */
+  template <typename Reg>
+  x86_emitter& mov(const x86_mem& dst,
+                   const Reg src) {
+    const unsigned flags = flags_of(src);
+    return encode_rm(flags, {static_cast<x86_opcode>((flags & size8) ? 0x88 : 0x89)},
+      code_of(src), dst);
+  }
+
+  /**
+   * Emits a `MOV mem8, imm8` instruction.
+   *
+   * @param dst the target memory operand
+   * @param imm the 8-bit immediate value operand
+   * @copydetails emit_general_purpose_instruction
+   */
+  x86_emitter& mov(const x86_mem& dst,
+                   const x86_imm8 imm) {
+    return encode_rm(size8, {0xC6}, ext(0), dst, 1, imm.u8);
+  }
+
+  /**
+   * Emits a `MOV mem16, imm16` instruction.
+   *
+   * @param dst the target memory operand
+   * @param imm the 16-bit immediate value operand
+   * @copydetails emit_general_purpose_instruction
+   */
+  x86_emitter& mov(const x86_mem& dst,
+                   const x86_imm16 imm) {
+    return encode_rm(size16, {0xC7}, ext(0), dst, 2, imm.u16);
+  }
+
+  /**
+   * Emits a `MOV mem32, imm32` instruction.
+   *
+   * @param dst the target memory operand
+   * @param imm the 32-bit immediate value operand
+   * @copydetails emit_general_purpose_instruction
+   */
+  x86_emitter& mov(const x86_mem& dst,
+                   const x86_imm32 imm) {
+    return encode_rm(size32, {0xC7}, ext(0), dst, 4, imm.u32);
   }
 
   /**
-   * Emits a `MOV reg64, reg64` instruction.
+   * Emits a `MOV mem64, imm32` instruction, sign-extending the value.
    *
-   * @param reg1 the 64-bit target register operand
-   * @param reg2 the 64-bit source register operand
+   * @param dst the target memory operand
+   * @param imm the immediate value operand, which must fit in 32 bits
    * @copydetails emit_general_purpose_instruction
+   * @throws std::out_of_range if `imm` does not fit in 32 bits
    */
-  x86_emitter& mov(const x86_reg64 reg1,
-                   const x86_reg64 reg2) {
-    if (reg1 == x86_reg64::rbp && reg2 == x86_reg64::rsp)
-      return emit(0x48, 0x89, 0xE5);
-    throw std::runtime_error("not implemented yet"); // TODO
+  x86_emitter& mov(const x86_mem& dst,
+                   const x86_imm64 imm) {
+    return encode_rm(size64, {0xC7}, ext(0), dst, 4, sign_extended_imm32(imm));
   }
 
   /**
@@ -583,60 +1445,84 @@ public:
   }
 
   /**
-   * Emits a ?-byte `MUL reg8` instruction.
+   * Emits a `MOVZX reg, reg` (move with zero extension) instruction.
    *
-   * @param reg8 an 8-bit register operand
-   * @todo Implement this method.
+   * @param dst a 16-, 32-, or 64-bit target register operand
+   * @param src a narrower 8- or 16-bit source register operand
    * @copydetails emit_general_purpose_instruction
    */
-  x86_emitter& mul(const x86_reg8 reg) {
-    throw std::runtime_error("not implemented yet"); // TODO
-    return (void)reg, *this; // TODO
+  template <typename Dst, typename Src>
+  x86_emitter& movzx(const Dst dst,
+                     const Src src) {
+    const unsigned src_flags = flags_of(src);
+    return encode_rm(flags_of(dst) | (src_flags & size8),
+      {0x0F, static_cast<x86_opcode>((src_flags & size8) ? 0xB6 : 0xB7)},
+      wide(code_of(dst)), code_of(src));
   }
 
   /**
-   * Emits a ?-byte `MUL reg16` instruction.
+   * Emits a `MUL reg` instruction, multiplying the accumulator by `reg`.
    *
-   * @param reg a 16-bit register operand
-   * @todo Implement this method.
+   * @param reg an 8-, 16-, 32-, or 64-bit register operand
    * @copydetails emit_general_purpose_instruction
    */
-  x86_emitter& mul(const x86_reg16 reg) {
-    throw std::runtime_error("not implemented yet"); // TODO
-    return (void)reg, *this; // TODO
+  template <typename Reg>
+  x86_emitter& mul(const Reg reg) {
+    const unsigned flags = flags_of(reg);
+    return encode_rm(flags, {static_cast<x86_opcode>((flags & size8) ? 0xF6 : 0xF7)},
+      ext(4), code_of(reg));
   }
 
   /**
-   * Emits a ?-byte `MUL reg32` instruction.
+   * Emits a `MULX` (unsigned multiply of `EDX`/`RDX` without affecting flags) instruction.
    *
-   * @param reg a 32-bit register operand
-   * @todo Implement this method.
+   * Requires the BMI2 extension.
+   *
+   * @param hi  a 32- or 64-bit target register for the high half
+   * @param lo  a target register of the same width for the low half
+   * @param src the multiplier register or memory operand
    * @copydetails emit_general_purpose_instruction
    */
-  x86_emitter& mul(const x86_reg32 reg) {
-    throw std::runtime_error("not implemented yet"); // TODO
-    return (void)reg, *this; // TODO
+  template <typename Reg, typename Src>
+  x86_emitter& mulx(const Reg hi, const Reg lo, const Src& src) {
+    return encode_vex(flags_of(hi), vex_f2, map_0f38, 0xF6, code_of(hi), code_of(lo), rm_of(src));
   }
 
   /**
-   * Emits a ?-byte `MUL reg32` instruction.
+   * Emits a one-byte `NOP` instruction.
    *
-   * @param reg a 64-bit register operand
-   * @todo Implement this method.
    * @copydetails emit_general_purpose_instruction
    */
-  x86_emitter& mul(const x86_reg64 reg) {
-    throw std::runtime_error("not implemented yet"); // TODO
-    return (void)reg, *this; // TODO
+  x86_emitter& nop() {
+    return emit(0x90);
   }
 
   /**
-   * Emits a one-byte `NOP` instruction.
+   * Emits a single `NOP` instruction of the given byte size.
+   *
+   * These are the forms recommended by Intel, with `0x66` prefixes added
+   * beyond 10 bytes.
    *
+   * @param size the byte size, in the range 1..15
    * @copydetails emit_general_purpose_instruction
+   * @throws std::out_of_range if `size` is not in the range 1..15
    */
-  x86_emitter& nop() {
-    return emit(0x90);
+  x86_emitter& nop(const std::size_t size) {
+    if (size < 1 || size > max_nop_size) {
+      throw std::out_of_range("NOP size must be in the range 1..15");
+    }
+    store_nop(reserve(size), size);
+    return *this;
+  }
+
+  /**
+   * Emits an `OR` instruction.
+   *
+   * @copydetails emit_alu_instruction
+   */
+  template <typename Dst, typename Src>
+  x86_emitter& or_(const Dst& dst, const Src& src) {
+    return alu(1, dst, src);
   }
 
   /**
@@ -667,33 +1553,63 @@ public:
   }
 
   /**
-   * Emits a one-byte `POP reg16` instruction.
+   * Emits a `PDEP` (parallel bit deposit of `src1` under the mask `src2`) instruction.
+   *
+   * Requires the BMI2 extension.
+   *
+   * @param dst  a 32- or 64-bit target register operand
+   * @param src1 the first source register operand, of the same width
+   * @param src2 the second source register or memory operand
+   * @copydetails emit_general_purpose_instruction
+   */
+  template <typename Reg, typename Src>
+  x86_emitter& pdep(const Reg dst, const Reg src1, const Src& src2) {
+    return encode_vex(flags_of(dst), vex_f2, map_0f38, 0xF5, code_of(dst), code_of(src1), rm_of(src2));
+  }
+
+  /**
+   * Emits a `PEXT` (parallel bit extract of `src1` under the mask `src2`) instruction.
+   *
+   * Requires the BMI2 extension.
+   *
+   * @param dst  a 32- or 64-bit target register operand
+   * @param src1 the first source register operand, of the same width
+   * @param src2 the second source register or memory operand
+   * @copydetails emit_general_purpose_instruction
+   */
+  template <typename Reg, typename Src>
+  x86_emitter& pext(const Reg dst, const Reg src1, const Src& src2) {
+    return encode_vex(flags_of(dst), vex_f3, map_0f38, 0xF5, code_of(dst), code_of(src1), rm_of(src2));
+  }
+
+  /**
+   * Emits a `POP reg16` instruction.
    *
    * @param reg a 16-bit register operand
    * @copydetails emit_general_purpose_instruction
    */
   x86_emitter& pop(const x86_reg16 reg) {
-    return emit(0x58 + static_cast<std::uint8_t>(reg));
+    return encode_o(size16, 0x58, code_of(reg));
   }
 
   /**
-   * Emits a one-byte `POP reg32` instruction.
+   * Emits a `POP reg32` instruction.
    *
    * @param reg a 32-bit register operand
    * @copydetails emit_general_purpose_instruction
    */
   x86_emitter& pop(const x86_reg32 reg) {
-    return emit(0x58 + static_cast<std::uint8_t>(reg));
+    return encode_o(size32, 0x58, code_of(reg));
   }
 
   /**
-   * Emits a one-byte `POP reg64` instruction.
+   * Emits a `POP reg64` instruction.
    *
    * @param reg a 64-bit register operand
    * @copydetails emit_general_purpose_instruction
    */
   x86_emitter& pop(const x86_reg64 reg) {
-    return emit(0x58 + static_cast<std::uint8_t>(reg));
+    return encode_o(size32, 0x58, code_of(reg));
   }
 
   /**
@@ -742,33 +1658,48 @@ public:
   }
 
   /**
-   * Emits a one-byte `PUSH reg16` instruction.
+   * Emits a `POPCNT reg, reg/mem` (population count) instruction.
+   *
+   * Requires the POPCNT extension.
+   *
+   * @param dst a 16-, 32-, or 64-bit target register operand
+   * @param src a source register or memory operand of the same width
+   * @copydetails emit_general_purpose_instruction
+   */
+  template <typename Reg, typename Src>
+  x86_emitter& popcnt(const Reg dst,
+                      const Src& src) {
+    return encode_rm(flags_of(dst) | prefix_f3, {0x0F, 0xB8}, code_of(dst), rm_of(src));
+  }
+
+  /**
+   * Emits a `PUSH reg16` instruction.
    *
    * @param reg a 16-bit register operand
    * @copydetails emit_general_purpose_instruction
    */
   x86_emitter& push(const x86_reg16 reg) {
-    return emit(0x50 + static_cast<std::uint8_t>(reg));
+    return encode_o(size16, 0x50, code_of(reg));
   }
 
   /**
-   * Emits a one-byte `PUSH reg32` instruction.
+   * Emits a `PUSH reg32` instruction.
    *
    * @param reg a 32-bit register operand
    * @copydetails emit_general_purpose_instruction
    */
   x86_emitter& push(const x86_reg32 reg) {
-    return emit(0x50 + static_cast<std::uint8_t>(reg));
+    return encode_o(size32, 0x50, code_of(reg));
   }
 
   /**
-   * Emits a one-byte `PUSH reg64` instruction.
+   * Emits a `PUSH reg64` instruction.
    *
    * @param reg a 64-bit register operand
    * @copydetails emit_general_purpose_instruction
    */
   x86_emitter& push(const x86_reg64 reg) {
-    return emit(0x50 + static_cast<std::uint8_t>(reg));
+    return encode_o(size32, 0x50, code_of(reg));
   }
 
   /**
@@ -834,6 +1765,21 @@ public:
     return emit(0xCB);
   }
 
+  /**
+   * Emits a `RORX` (rotate right without affecting flags) instruction.
+   *
+   * Requires the BMI2 extension.
+   *
+   * @param dst a 32- or 64-bit target register operand
+   * @param src the source register or memory operand, of the same width
+   * @param imm the rotation count
+   * @copydetails emit_general_purpose_instruction
+   */
+  template <typename Reg, typename Src>
+  x86_emitter& rorx(const Reg dst, const Src& src, const x86_imm8 imm) {
+    return encode_vex(flags_of(dst), vex_f2, map_0f3a, 0xF0, code_of(dst), 0, rm_of(src), 1, imm.u8);
+  }
+
   /**
    * Emits a one-byte `SAHF` instruction.
    *
@@ -843,6 +1789,31 @@ public:
     return emit(0x9E);
   }
 
+  /**
+   * Emits a `SARX` (shift arithmetic right by `ctl` without affecting flags) instruction.
+   *
+   * Requires the BMI2 extension.
+   *
+   * @param dst  a 32- or 64-bit target register operand
+   * @param src  the source register or memory operand, of the same width
+   * @param ctl  the control register operand, of the same width
+   * @copydetails emit_general_purpose_instruction
+   */
+  template <typename Reg, typename Src>
+  x86_emitter& sarx(const Reg dst, const Src& src, const Reg ctl) {
+    return encode_vex(flags_of(dst), vex_f3, map_0f38, 0xF7, code_of(dst), code_of(ctl), rm_of(src));
+  }
+
+  /**
+   * Emits a `SBB` instruction.
+   *
+   * @copydetails emit_alu_instruction
+   */
+  template <typename Dst, typename Src>
+  x86_emitter& sbb(const Dst& dst, const Src& src) {
+    return alu(3, dst, src);
+  }
+
   /**
    * Emits a one-byte `SCASB` instruction.
    *
@@ -879,6 +1850,71 @@ public:
     return emit(0xAF);
   }
 
+  /**
+   * Emits a `SETcc reg8` (set byte on condition) instruction.
+   *
+   * @param cc  the condition code
+   * @param dst the 8-bit target register operand
+   * @copydetails emit_general_purpose_instruction
+   */
+  x86_emitter& setcc(const x86_cc cc,
+                     const x86_reg8 dst) {
+    return encode_rm(size8, {0x0F, static_cast<x86_opcode>(0x90 | static_cast<std::uint8_t>(cc))},
+      ext(0), code_of(dst));
+  }
+
+  /**
+   * Emits a `SETcc mem8` (set byte on condition) instruction.
+   *
+   * @param cc  the condition code
+   * @param dst the target memory operand
+   * @copydetails emit_general_purpose_instruction
+   */
+  x86_emitter& setcc(const x86_cc cc,
+                     const x86_mem& dst) {
+    return encode_rm(size8, {0x0F, static_cast<x86_opcode>(0x90 | static_cast<std::uint8_t>(cc))},
+      ext(0), dst);
+  }
+
+  /**
+   * Emits a three-byte `SFENCE` (store fence) instruction.
+   *
+   * @copydetails emit_general_purpose_instruction
+   */
+  x86_emitter& sfence() {
+    return emit(0x0F, 0xAE, 0xF8);
+  }
+
+  /**
+   * Emits a `SHLX` (shift left by `ctl` without affecting flags) instruction.
+   *
+   * Requires the BMI2 extension.
+   *
+   * @param dst  a 32- or 64-bit target register operand
+   * @param src  the source register or memory operand, of the same width
+   * @param ctl  the control register operand, of the same width
+   * @copydetails emit_general_purpose_instruction
+   */
+  template <typename Reg, typename Src>
+  x86_emitter& shlx(const Reg dst, const Src& src, const Reg ctl) {
+    return encode_vex(flags_of(dst), vex_66, map_0f38, 0xF7, code_of(dst), code_of(ctl), rm_of(src));
+  }
+
+  /**
+   * Emits a `SHRX` (shift logical right by `ctl` without affecting flags) instruction.
+   *
+   * Requires the BMI2 extension.
+   *
+   * @param dst  a 32- or 64-bit target register operand
+   * @param src  the source register or memory operand, of the same width
+   * @param ctl  the control register operand, of the same width
+   * @copydetails emit_general_purpose_instruction
+   */
+  template <typename Reg, typename Src>
+  x86_emitter& shrx(const Reg dst, const Src& src, const Reg ctl) {
+    return encode_vex(flags_of(dst), vex_f2, map_0f38, 0xF7, code_of(dst), code_of(ctl), rm_of(src));
+  }
+
   /**
    * Emits a one-byte `STC` instruction.
    *
@@ -934,127 +1970,347 @@ public:
   }
 
   /**
-   * Emits a one-byte `XLATB` instruction.
+   * Emits a `SUB` instruction.
    *
-   * @copydetails emit_general_purpose_instruction
+   * @copydetails emit_alu_instruction
    */
-  x86_emitter& xlatb() {
-    return emit(0xD7);
+  template <typename Dst, typename Src>
+  x86_emitter& sub(const Dst& dst, const Src& src) {
+    return alu(5, dst, src);
   }
 
   /**
-   * Emits a ?-byte `XOR reg8, reg8` instruction.
+   * Emits a two-byte `TEST AL, imm8` instruction.
    *
-   * @param reg1 an 8-bit register operand
-   * @param reg2 an 8-bit register operand
+   * @param imm the 8-bit immediate value operand
    * @copydetails emit_general_purpose_instruction
    */
-  x86_emitter& xor_(const x86_reg8 reg1,
-                    const x86_reg8 reg2) {
-    throw std::runtime_error("not implemented yet"); // TODO
-    return (void)reg1, (void)reg2, *this;
+  x86_emitter& test(const x86_imm8 imm) {
+    std::uint8_t* const cursor = reserve(2);
+    cursor[0] = 0xA8;
+    cursor[1] = imm.u8;
+    return *this;
   }
 
   /**
-   * Emits a ?-byte `XOR reg16, reg16` instruction.
+   * Emits a four-byte `TEST AX, imm16` instruction.
    *
-   * @param reg1 a 16-bit register operand
-   * @param reg2 a 16-bit register operand
+   * @param imm the 16-bit immediate value operand
    * @copydetails emit_general_purpose_instruction
    */
-  x86_emitter& xor_(const x86_reg16 reg1,
-                    const x86_reg16 reg2) {
-    throw std::runtime_error("not implemented yet"); // TODO
-    return (void)reg1, (void)reg2, *this;
+  x86_emitter& test(const x86_imm16 imm) {
+    std::uint8_t* const cursor = reserve(4);
+    cursor[0] = 0x66;
+    cursor[1] = 0xA9;
+    machinery::bits::store_le16(cursor + 2, imm.u16);
+    return *this;
   }
 
   /**
-   * Emits a ?-byte `XOR reg32, reg32` instruction.
+   * Emits a five-byte `TEST EAX, imm32` instruction.
    *
-   * @param reg1 a 32-bit register operand
-   * @param reg2 a 32-bit register operand
+   * @param imm the 32-bit immediate value operand
    * @copydetails emit_general_purpose_instruction
    */
-  x86_emitter& xor_(const x86_reg32 reg1,
-                    const x86_reg32 reg2) {
-    throw std::runtime_error("not implemented yet"); // TODO
-    return (void)reg1, (void)reg2, *this;
+  x86_emitter& test(const x86_imm32 imm) {
+    std::uint8_t* const cursor = reserve(5);
+    cursor[0] = 0xA9;
+    machinery::bits::store_le32(cursor + 1, imm.u32);
+    return *this;
   }
 
   /**
-   * Emits a ?-byte `XOR reg64, reg64` instruction.
+   * Emits a six-byte `TEST RAX, imm32` instruction, sign-extending the value.
    *
-   * @param reg1 a 64-bit register operand
-   * @param reg2 a 64-bit register operand
+   * @param imm the 64-bit immediate value operand
+   * @throws std::out_of_range if `imm` does not fit in 32 bits
    * @copydetails emit_general_purpose_instruction
    */
-  x86_emitter& xor_(const x86_reg64 reg1,
-                    const x86_reg64 reg2) {
-    throw std::runtime_error("not implemented yet"); // TODO
-    return (void)reg1, (void)reg2, *this;
+  x86_emitter& test(const x86_imm64 imm) {
+    const std::uint32_t narrowed = sign_extended_imm32(imm);
+    std::uint8_t* const cursor = reserve(6);
+    cursor[0] = 0x48;
+    cursor[1] = 0xA9;
+    machinery::bits::store_le32(cursor + 2, narrowed);
+    return *this;
   }
 
-  /**@}*/
-
   /**
-   * @name System Instructions
+   * Emits a `TEST reg, reg` instruction.
    *
-   * These instructions manipulate the processor operating mode, access
-   * processor resources, handle program and system errors, and manage
-   * system memory. Many of these instructions require privilege level 0 to
-   * execute.
+   * @param lhs the first register operand
+   * @param rhs the second register operand of the same width
+   * @copydetails emit_general_purpose_instruction
    */
-
-  /**@{*/
+  template <typename Reg>
+  x86_emitter& test(const Reg lhs,
+                    const Reg rhs) {
+    const unsigned flags = flags_of(lhs);
+    return encode_rm(flags, {static_cast<x86_opcode>((flags & size8) ? 0x84 : 0x85)},
+      code_of(rhs), code_of(lhs));
+  }
 
   /**
-   * @class emit_system_instruction
+   * Emits a `TEST mem, reg` instruction.
    *
-   * @return `*this`
-   * @throws std::bad_alloc if out of memory
-   * @note This is a system instruction.
+   * @param lhs the memory operand
+   * @param rhs the register operand
+   * @copydetails emit_general_purpose_instruction
    */
+  template <typename Reg>
+  x86_emitter& test(const x86_mem& lhs,
+                    const Reg rhs) {
+    const unsigned flags = flags_of(rhs);
+    return encode_rm(flags, {static_cast<x86_opcode>((flags & size8) ? 0x84 : 0x85)},
+      code_of(rhs), lhs);
+  }
 
   /**
-   * Emits a three-byte `CLGI` instruction.
+   * Emits a `TEST reg, mem` instruction, which is encoded as
+   * `TEST mem, reg`.
    *
-   * @copydetails emit_system_instruction
+   * @param lhs the register operand
+   * @param rhs the memory operand
+   * @copydetails emit_general_purpose_instruction
    */
-  x86_emitter& clgi() {
-    return emit(0x0F, 0x01, 0xDD);
+  template <typename Reg>
+  x86_emitter& test(const Reg lhs,
+                    const x86_mem& rhs) {
+    return test(rhs, lhs);
   }
 
   /**
-   * Emits a one-byte `CLI` instruction.
+   * Emits a `TEST reg8, imm8` instruction.
    *
-   * @copydetails emit_system_instruction
+   * @copydetails emit_general_purpose_instruction
    */
-  x86_emitter& cli() {
-    return emit(0xFA);
+  x86_emitter& test(const x86_reg8 lhs, const x86_imm8 imm) {
+    return encode_rm(size8, {0xF6}, ext(0), code_of(lhs), 1, imm.u8);
   }
 
   /**
-   * Emits a two-byte `CLTS` instruction.
+   * Emits a `TEST reg16, imm16` instruction.
    *
-   * @copydetails emit_system_instruction
+   * @copydetails emit_general_purpose_instruction
    */
-  x86_emitter& clts() {
-    return emit(0x0F, 0x06);
+  x86_emitter& test(const x86_reg16 lhs, const x86_imm16 imm) {
+    return encode_rm(size16, {0xF7}, ext(0), code_of(lhs), 2, imm.u16);
   }
 
   /**
-   * Emits a one-byte `HLT` instruction.
+   * Emits a `TEST reg32, imm32` instruction.
    *
-   * @copydetails emit_system_instruction
+   * @copydetails emit_general_purpose_instruction
    */
-  x86_emitter& hlt() {
-    return emit(0xF4);
+  x86_emitter& test(const x86_reg32 lhs, const x86_imm32 imm) {
+    return encode_rm(size32, {0xF7}, ext(0), code_of(lhs), 4, imm.u32);
   }
 
   /**
-   * Emits a one-byte `INT3` instruction.
+   * Emits a `TEST reg64, imm32` instruction, sign-extending the value.
    *
-   * @copydetails emit_system_instruction
+   * @copydetails emit_general_purpose_instruction
+   */
+  x86_emitter& test(const x86_reg64 lhs, const x86_imm32 imm) {
+    return encode_rm(size64, {0xF7}, ext(0), code_of(lhs), 4, imm.u32);
+  }
+
+  /**
+   * Emits a `TEST mem8, imm8` instruction.
+   *
+   * @copydetails emit_general_purpose_instruction
+   */
+  x86_emitter& test(const x86_mem& lhs, const x86_imm8 imm) {
+    return encode_rm(size8, {0xF6}, ext(0), lhs, 1, imm.u8);
+  }
+
+  /**
+   * Emits a `TEST mem16, imm16` instruction.
+   *
+   * @copydetails emit_general_purpose_instruction
+   */
+  x86_emitter& test(const x86_mem& lhs, const x86_imm16 imm) {
+    return encode_rm(size16, {0xF7}, ext(0), lhs, 2, imm.u16);
+  }
+
+  /**
+   * Emits a `TEST mem32, imm32` instruction.
+   *
+   * @copydetails emit_general_purpose_instruction
+   */
+  x86_emitter& test(const x86_mem& lhs, const x86_imm32 imm) {
+    return encode_rm(size32, {0xF7}, ext(0), lhs, 4, imm.u32);
+  }
+
+  /**
+   * Emits a `TEST mem64, imm32` instruction, sign-extending the value.
+   *
+   * @throws std::out_of_range if `imm` does not fit in 32 bits
+   * @copydetails emit_general_purpose_instruction
+   */
+  x86_emitter& test(const x86_mem& lhs, const x86_imm64 imm) {
+    return encode_rm(size64, {0xF7}, ext(0), lhs, 4, sign_extended_imm32(imm));
+  }
+
+  /**
+   * Emits a `TZCNT reg, reg/mem` (count trailing zeros) instruction.
+   *
+   * Requires the BMI1 extension; elsewhere this decodes as `BSF`.
+   *
+   * @param dst a 16-, 32-, or 64-bit target register operand
+   * @param src a source register or memory operand of the same width
+   * @copydetails emit_general_purpose_instruction
+   */
+  template <typename Reg, typename Src>
+  x86_emitter& tzcnt(const Reg dst,
+                     const Src& src) {
+    return encode_rm(flags_of(dst) | prefix_f3, {0x0F, 0xBC}, code_of(dst), rm_of(src));
+  }
+
+  /**
+   * Emits an `XADD reg/mem, reg` (exchange and add) instruction.
+   *
+   * Precede it with `lock()` for an atomic fetch-and-add on memory.
+   *
+   * @param dst the target register or memory operand
+   * @param src the source register operand, which receives the old target
+   * @copydetails emit_general_purpose_instruction
+   */
+  template <typename Dst, typename Reg>
+  x86_emitter& xadd(const Dst& dst,
+                    const Reg src) {
+    const unsigned flags = flags_of(src);
+    return encode_rm(flags, {0x0F, static_cast<x86_opcode>((flags & size8) ? 0xC0 : 0xC1)},
+      code_of(src), rm_of(dst));
+  }
+
+  /**
+   * Emits an `XCHG reg, reg` (exchange) instruction.
+   *
+   * @param dst a register operand
+   * @param src a register operand of the same width
+   * @copydetails emit_general_purpose_instruction
+   */
+  template <typename Reg>
+  x86_emitter& xchg(const Reg dst,
+                    const Reg src) {
+    const unsigned flags = flags_of(dst);
+    return encode_rm(flags, {static_cast<x86_opcode>((flags & size8) ? 0x86 : 0x87)},
+      code_of(src), code_of(dst));
+  }
+
+  /**
+   * Emits an `XCHG mem, reg` (exchange) instruction.
+   *
+   * Exchanging with memory is always atomic, without a `LOCK` prefix.
+   *
+   * @param dst the memory operand
+   * @param src the register operand
+   * @copydetails emit_general_purpose_instruction
+   */
+  template <typename Reg>
+  x86_emitter& xchg(const x86_mem& dst,
+                    const Reg src) {
+    const unsigned flags = flags_of(src);
+    return encode_rm(flags, {static_cast<x86_opcode>((flags & size8) ? 0x86 : 0x87)},
+      code_of(src), dst);
+  }
+
+  /**
+   * Emits an `XCHG reg, mem` (exchange) instruction.
+   *
+   * Exchanging with memory is always atomic, without a `LOCK` prefix.
+   *
+   * @param dst the register operand
+   * @param src the memory operand
+   * @copydetails emit_general_purpose_instruction
+   */
+  template <typename Reg>
+  x86_emitter& xchg(const Reg dst,
+                    const x86_mem& src) {
+    return xchg(src, dst);
+  }
+
+  /**
+   * Emits a one-byte `XLATB` instruction.
+   *
+   * @copydetails emit_general_purpose_instruction
+   */
+  x86_emitter& xlatb() {
+    return emit(0xD7);
+  }
+
+  /**
+   * Emits an `XOR` instruction.
+   *
+   * @copydetails emit_alu_instruction
+   */
+  template <typename Dst, typename Src>
+  x86_emitter& xor_(const Dst& dst, const Src& src) {
+    return alu(6, dst, src);
+  }
+
+  /**@}*/
+
+  /**
+   * @name System Instructions
+   *
+   * These instructions manipulate the processor operating mode, access
+   * processor resources, handle program and system errors, and manage
+   * system memory. Many of these instructions require privilege level 0 to
+   * execute.
+   */
+
+  /**@{*/
+
+  /**
+   * @class emit_system_instruction
+   *
+   * @return `*this`
+   * @throws std::bad_alloc if out of memory
+   * @note This is a system instruction.
+   */
+
+  /**
+   * Emits a three-byte `CLGI` instruction.
+   *
+   * @copydetails emit_system_instruction
+   */
+  x86_emitter& clgi() {
+    return emit(0x0F, 0x01, 0xDD);
+  }
+
+  /**
+   * Emits a one-byte `CLI` instruction.
+   *
+   * @copydetails emit_system_instruction
+   */
+  x86_emitter& cli() {
+    return emit(0xFA);
+  }
+
+  /**
+   * Emits a two-byte `CLTS` instruction.
+   *
+   * @copydetails emit_system_instruction
+   */
+  x86_emitter& clts() {
+    return emit(0x0F, 0x06);
+  }
+
+  /**
+   * Emits a one-byte `HLT` instruction.
+   *
+   * @copydetails emit_system_instruction
+   */
+  x86_emitter& hlt() {
+    return emit(0xF4);
+  }
+
+  /**
+   * Emits a one-byte `INT3` instruction.
+   *
+   * @copydetails emit_system_instruction
    */
   x86_emitter& int3() {
     return emit(0xCC);
@@ -1328,6 +2584,3163 @@ public:
   /**@{*/
 
   /**@}*/
-};
+
+  /**
+   * @name AVX Instructions
+   *
+   * These instructions operate on the XMM and YMM registers using the VEX
+   * encoding, which covers the AVX and AVX2 extensions as well as the
+   * SSE2 through SSE4.2 operations in their three-operand forms.
+   *
+   * Where AVX-512 defines an EVEX form of an instruction, the instruction
+   * also accepts `x86_zmm` operands, registers 16..31, a write mask, and an
+   * `x86_bcst` source, and is EVEX-encoded whenever one of them is used.
+   */
+
+  /**@{*/
+
+  /**
+   * @class emit_avx_instruction
+   *
+   * Vector operands are `x86_xmm` registers for the 128-bit form or
+   * `x86_ymm` registers for the 256-bit form, and the last source operand
+   * may instead be an `x86_mem`. Operations that exist only in a 256-bit
+   * form take `x86_ymm` operands.
+   *
+   * @return `*this`
+   * @throws std::bad_alloc if out of memory
+   * @throws std::invalid_argument if an operand requires an EVEX encoding
+   *         that the instruction lacks
+   */
+
+  /**
+   * Emits a `VADDPD` (add packed double-precision values) instruction.
+   *
+   * @copydetails emit_avx_instruction
+   */
+  template <typename Vec, typename Src>
+  x86_emitter& vaddpd(const Vec dst, const Vec src1, const Src& src2, const x86_mask mask = x86_mask()) {
+    return encode_avx({vex_66, map_0f, 0x58, 0, tuple_fv, 1}, flags_of(dst), code_of(dst), code_of(src1), rm_of(src2), mask);
+  }
+
+  /**
+   * Emits a `VADDPS` (add packed single-precision values) instruction.
+   *
+   * @copydetails emit_avx_instruction
+   */
+  template <typename Vec, typename Src>
+  x86_emitter& vaddps(const Vec dst, const Vec src1, const Src& src2, const x86_mask mask = x86_mask()) {
+    return encode_avx({vex_none, map_0f, 0x58, 0, tuple_fv, 0}, flags_of(dst), code_of(dst), code_of(src1), rm_of(src2), mask);
+  }
+
+  /**
+   * Emits a `VANDNPS` (bitwise AND NOT of packed single-precision values) instruction.
+   *
+   * @copydetails emit_avx_instruction
+   */
+  template <typename Vec, typename Src>
+  x86_emitter& vandnps(const Vec dst, const Vec src1, const Src& src2, const x86_mask mask = x86_mask()) {
+    return encode_avx({vex_none, map_0f, 0x55, 0, tuple_fv, 0}, flags_of(dst), code_of(dst), code_of(src1), rm_of(src2), mask);
+  }
+
+  /**
+   * Emits a `VANDPS` (bitwise AND of packed single-precision values) instruction.
+   *
+   * @copydetails emit_avx_instruction
+   */
+  template <typename Vec, typename Src>
+  x86_emitter& vandps(const Vec dst, const Vec src1, const Src& src2, const x86_mask mask = x86_mask()) {
+    return encode_avx({vex_none, map_0f, 0x54, 0, tuple_fv, 0}, flags_of(dst), code_of(dst), code_of(src1), rm_of(src2), mask);
+  }
+
+  /**
+   * Emits a `VBLENDPS` (blend packed single-precision values by an immediate mask) instruction.
+   *
+   * @copydetails emit_avx_instruction
+   */
+  template <typename Vec, typename Src>
+  x86_emitter& vblendps(const Vec dst, const Vec src1, const Src& src2, const x86_imm8 imm) {
+    return encode_vex(flags_of(dst), vex_66, map_0f3a, 0x0C, code_of(dst), code_of(src1), rm_of(src2), 1, imm.u8);
+  }
+
+  /**
+   * Emits a `VBLENDVPS` (blend packed single-precision values by a vector mask) instruction.
+   *
+   * @copydetails emit_avx_instruction
+   */
+  template <typename Vec, typename Src>
+  x86_emitter& vblendvps(const Vec dst, const Vec src1, const Src& src2, const Vec mask) {
+    return encode_vex(flags_of(dst), vex_66, map_0f3a, 0x4A, code_of(dst), code_of(src1), rm_of(src2), 1, code_of(mask) << 4);
+  }
+
+  /**
+   * Emits a `VBROADCASTSS` (broadcast a single-precision value) instruction.
+   *
+   * @copydetails emit_avx_instruction
+   */
+  template <typename Vec, typename Src>
+  x86_emitter& vbroadcastss(const Vec dst, const Src& src, const x86_mask mask = x86_mask()) {
+    return encode_avx({vex_66, map_0f38, 0x18, 0, tuple_t1s4, 0}, flags_of(dst), code_of(dst), 0, rm_of(src), mask);
+  }
+
+  /**
+   * Emits a `VCMPPD` (compare packed double-precision values) instruction.
+   *
+   * @copydetails emit_avx_instruction
+   */
+  template <typename Vec, typename Src>
+  x86_emitter& vcmppd(const Vec dst, const Vec src1, const Src& src2, const x86_imm8 imm) {
+    return encode_vex(flags_of(dst), vex_66, map_0f, 0xC2, code_of(dst), code_of(src1), rm_of(src2), 1, imm.u8);
+  }
+
+  /**
+   * Emits a `VCMPPS` (compare packed single-precision values) instruction.
+   *
+   * @copydetails emit_avx_instruction
+   */
+  template <typename Vec, typename Src>
+  x86_emitter& vcmpps(const Vec dst, const Vec src1, const Src& src2, const x86_imm8 imm) {
+    return encode_vex(flags_of(dst), vex_none, map_0f, 0xC2, code_of(dst), code_of(src1), rm_of(src2), 1, imm.u8);
+  }
+
+  /**
+   * Emits a `VCVTDQ2PS` (convert packed doublewords to single-precision values) instruction.
+   *
+   * @copydetails emit_avx_instruction
+   */
+  template <typename Vec, typename Src>
+  x86_emitter& vcvtdq2ps(const Vec dst, const Src& src, const x86_mask mask = x86_mask()) {
+    return encode_avx({vex_none, map_0f, 0x5B, 0, tuple_fv, 0}, flags_of(dst), code_of(dst), 0, rm_of(src), mask);
+  }
+
+  /**
+   * Emits a `VCVTTPS2DQ` (convert packed single-precision values to doublewords with truncation) instruction.
+   *
+   * @copydetails emit_avx_instruction
+   */
+  template <typename Vec, typename Src>
+  x86_emitter& vcvttps2dq(const Vec dst, const Src& src, const x86_mask mask = x86_mask()) {
+    return encode_avx({vex_f3, map_0f, 0x5B, 0, tuple_fv, 0}, flags_of(dst), code_of(dst), 0, rm_of(src), mask);
+  }
+
+  /**
+   * Emits a `VDIVPD` (divide packed double-precision values) instruction.
+   *
+   * @copydetails emit_avx_instruction
+   */
+  template <typename Vec, typename Src>
+  x86_emitter& vdivpd(const Vec dst, const Vec src1, const Src& src2, const x86_mask mask = x86_mask()) {
+    return encode_avx({vex_66, map_0f, 0x5E, 0, tuple_fv, 1}, flags_of(dst), code_of(dst), code_of(src1), rm_of(src2), mask);
+  }
+
+  /**
+   * Emits a `VDIVPS` (divide packed single-precision values) instruction.
+   *
+   * @copydetails emit_avx_instruction
+   */
+  template <typename Vec, typename Src>
+  x86_emitter& vdivps(const Vec dst, const Vec src1, const Src& src2, const x86_mask mask = x86_mask()) {
+    return encode_avx({vex_none, map_0f, 0x5E, 0, tuple_fv, 0}, flags_of(dst), code_of(dst), code_of(src1), rm_of(src2), mask);
+  }
+
+  /**
+   * Emits a `VEXTRACTI128` (extract a 128-bit lane) instruction.
+   *
+   * @copydetails emit_avx_instruction
+   */
+  template <typename Dst>
+  x86_emitter& vextracti128(const Dst& dst, const x86_ymm src, const x86_imm8 imm) {
+    return encode_vex(size256, vex_66, map_0f3a, 0x39, code_of(src), 0, rm_of(dst), 1, imm.u8);
+  }
+
+  /**
+   * Emits a `VFMADD231PD` (fused multiply-add of packed double-precision values) instruction.
+   *
+   * @copydetails emit_avx_instruction
+   */
+  template <typename Vec, typename Src>
+  x86_emitter& vfmadd231pd(const Vec dst, const Vec src1, const Src& src2, const x86_mask mask = x86_mask()) {
+    return encode_avx({vex_66, map_0f38, 0xB8, 1, tuple_fv, 1}, flags_of(dst), code_of(dst), code_of(src1), rm_of(src2), mask);
+  }
+
+  /**
+   * Emits a `VFMADD231PS` (fused multiply-add of packed single-precision values) instruction.
+   *
+   * @copydetails emit_avx_instruction
+   */
+  template <typename Vec, typename Src>
+  x86_emitter& vfmadd231ps(const Vec dst, const Vec src1, const Src& src2, const x86_mask mask = x86_mask()) {
+    return encode_avx({vex_66, map_0f38, 0xB8, 0, tuple_fv, 0}, flags_of(dst), code_of(dst), code_of(src1), rm_of(src2), mask);
+  }
+
+  /**
+   * Emits a `VHADDPS` (horizontally add packed single-precision values) instruction.
+   *
+   * @copydetails emit_avx_instruction
+   */
+  template <typename Vec, typename Src>
+  x86_emitter& vhaddps(const Vec dst, const Vec src1, const Src& src2) {
+    return encode_vex(flags_of(dst), vex_f2, map_0f, 0x7C, code_of(dst), code_of(src1), rm_of(src2));
+  }
+
+  /**
+   * Emits a `VINSERTI128` (insert a 128-bit lane) instruction.
+   *
+   * @copydetails emit_avx_instruction
+   */
+  template <typename Src>
+  x86_emitter& vinserti128(const x86_ymm dst, const x86_ymm src1, const Src& src2, const x86_imm8 imm) {
+    return encode_vex(size256, vex_66, map_0f3a, 0x38, code_of(dst), code_of(src1), rm_of(src2), 1, imm.u8);
+  }
+
+  /**
+   * Emits a `VMAXPD` (maximum of packed double-precision values) instruction.
+   *
+   * @copydetails emit_avx_instruction
+   */
+  template <typename Vec, typename Src>
+  x86_emitter& vmaxpd(const Vec dst, const Vec src1, const Src& src2, const x86_mask mask = x86_mask()) {
+    return encode_avx({vex_66, map_0f, 0x5F, 0, tuple_fv, 1}, flags_of(dst), code_of(dst), code_of(src1), rm_of(src2), mask);
+  }
+
+  /**
+   * Emits a `VMAXPS` (maximum of packed single-precision values) instruction.
+   *
+   * @copydetails emit_avx_instruction
+   */
+  template <typename Vec, typename Src>
+  x86_emitter& vmaxps(const Vec dst, const Vec src1, const Src& src2, const x86_mask mask = x86_mask()) {
+    return encode_avx({vex_none, map_0f, 0x5F, 0, tuple_fv, 0}, flags_of(dst), code_of(dst), code_of(src1), rm_of(src2), mask);
+  }
+
+  /**
+   * Emits a `VMINPD` (minimum of packed double-precision values) instruction.
+   *
+   * @copydetails emit_avx_instruction
+   */
+  template <typename Vec, typename Src>
+  x86_emitter& vminpd(const Vec dst, const Vec src1, const Src& src2, const x86_mask mask = x86_mask()) {
+    return encode_avx({vex_66, map_0f, 0x5D, 0, tuple_fv, 1}, flags_of(dst), code_of(dst), code_of(src1), rm_of(src2), mask);
+  }
+
+  /**
+   * Emits a `VMINPS` (minimum of packed single-precision values) instruction.
+   *
+   * @copydetails emit_avx_instruction
+   */
+  template <typename Vec, typename Src>
+  x86_emitter& vminps(const Vec dst, const Vec src1, const Src& src2, const x86_mask mask = x86_mask()) {
+    return encode_avx({vex_none, map_0f, 0x5D, 0, tuple_fv, 0}, flags_of(dst), code_of(dst), code_of(src1), rm_of(src2), mask);
+  }
+
+  /**
+   * Emits a `VMOVAPS` (move aligned packed single-precision values, loading) instruction.
+   *
+   * @copydetails emit_avx_instruction
+   */
+  template <typename Vec, typename Src>
+  x86_emitter& vmovaps(const Vec dst, const Src& src, const x86_mask mask = x86_mask()) {
+    return encode_avx({vex_none, map_0f, 0x28, 0, tuple_fvm, 0}, flags_of(dst), code_of(dst), 0, rm_of(src), mask);
+  }
+
+  /**
+   * Emits a `VMOVAPS` (move aligned packed single-precision values, storing) instruction.
+   *
+   * @copydetails emit_avx_instruction
+   */
+  template <typename Vec>
+  x86_emitter& vmovaps(const x86_mem& dst, const Vec src, const x86_mask mask = x86_mask()) {
+    return encode_avx({vex_none, map_0f, 0x29, 0, tuple_fvm, 0}, flags_of(src), code_of(src), 0, dst, store_mask(mask));
+  }
+
+  /**
+   * Emits a `VMOVD` (move a doubleword into the low element) instruction.
+   *
+   * @copydetails emit_avx_instruction
+   */
+  template <typename Src>
+  x86_emitter& vmovd(const x86_xmm dst, const Src& src) {
+    return encode_avx({vex_66, map_0f, 0x6E, 0, tuple_t1s4, 0}, size128, code_of(dst), 0, rm_of(src));
+  }
+
+  /**
+   * Emits a `VMOVD` (move the low doubleword out of a vector) instruction.
+   *
+   * @copydetails emit_avx_instruction
+   */
+  template <typename Dst>
+  x86_emitter& vmovd(const Dst& dst, const x86_xmm src) {
+    return encode_avx({vex_66, map_0f, 0x7E, 0, tuple_t1s4, 0}, size128, code_of(src), 0, rm_of(dst));
+  }
+
+  /**
+   * Emits a `VMOVDQA` (move aligned packed integer values, loading) instruction.
+   *
+   * @copydetails emit_avx_instruction
+   */
+  template <typename Vec, typename Src>
+  x86_emitter& vmovdqa(const Vec dst, const Src& src) {
+    return encode_vex(flags_of(dst), vex_66, map_0f, 0x6F, code_of(dst), 0, rm_of(src));
+  }
+
+  /**
+   * Emits a `VMOVDQA` (move aligned packed integer values, storing) instruction.
+   *
+   * @copydetails emit_avx_instruction
+   */
+  template <typename Vec>
+  x86_emitter& vmovdqa(const x86_mem& dst, const Vec src) {
+    return encode_vex(flags_of(src), vex_66, map_0f, 0x7F, code_of(src), 0, dst);
+  }
+
+  /**
+   * Emits a `VMOVDQU` (move unaligned packed integer values, loading) instruction.
+   *
+   * @copydetails emit_avx_instruction
+   */
+  template <typename Vec, typename Src>
+  x86_emitter& vmovdqu(const Vec dst, const Src& src) {
+    return encode_vex(flags_of(dst), vex_f3, map_0f, 0x6F, code_of(dst), 0, rm_of(src));
+  }
+
+  /**
+   * Emits a `VMOVDQU` (move unaligned packed integer values, storing) instruction.
+   *
+   * @copydetails emit_avx_instruction
+   */
+  template <typename Vec>
+  x86_emitter& vmovdqu(const x86_mem& dst, const Vec src) {
+    return encode_vex(flags_of(src), vex_f3, map_0f, 0x7F, code_of(src), 0, dst);
+  }
+
+  /**
+   * Emits a `VMOVMSKPS` (gather the sign bits of packed single-precision values into a mask) instruction.
+   *
+   * @copydetails emit_avx_instruction
+   */
+  template <typename Vec>
+  x86_emitter& vmovmskps(const x86_reg32 dst, const Vec src) {
+    return encode_vex(flags_of(src), vex_none, map_0f, 0x50, code_of(dst), 0, code_of(src));
+  }
+
+  /**
+   * Emits a `VMOVNTDQ` (store packed integers with a non-temporal hint) instruction.
+   *
+   * @copydetails emit_avx_instruction
+   */
+  template <typename Vec>
+  x86_emitter& vmovntdq(const x86_mem& dst, const Vec src) {
+    return encode_avx({vex_66, map_0f, 0xE7, 0, tuple_fvm, 0}, flags_of(src), code_of(src), 0, dst);
+  }
+
+  /**
+   * Emits a `VMOVQ` (move a quadword into the low element) instruction.
+   *
+   * @copydetails emit_avx_instruction
+   */
+  x86_emitter& vmovq(const x86_xmm dst, const x86_reg64 src) {
+    return encode_avx({vex_66, map_0f, 0x6E, 1, tuple_t1s8, 1}, size128, code_of(dst), 0, code_of(src));
+  }
+
+  /**
+   * Emits a `VMOVQ` (move the low quadword out of a vector) instruction.
+   *
+   * @copydetails emit_avx_instruction
+   */
+  x86_emitter& vmovq(const x86_reg64 dst, const x86_xmm src) {
+    return encode_avx({vex_66, map_0f, 0x7E, 1, tuple_t1s8, 1}, size128, code_of(src), 0, code_of(dst));
+  }
+
+  /**
+   * Emits a `VMOVUPS` (move unaligned packed single-precision values, loading) instruction.
+   *
+   * @copydetails emit_avx_instruction
+   */
+  template <typename Vec, typename Src>
+  x86_emitter& vmovups(const Vec dst, const Src& src, const x86_mask mask = x86_mask()) {
+    return encode_avx({vex_none, map_0f, 0x10, 0, tuple_fvm, 0}, flags_of(dst), code_of(dst), 0, rm_of(src), mask);
+  }
+
+  /**
+   * Emits a `VMOVUPS` (move unaligned packed single-precision values, storing) instruction.
+   *
+   * @copydetails emit_avx_instruction
+   */
+  template <typename Vec>
+  x86_emitter& vmovups(const x86_mem& dst, const Vec src, const x86_mask mask = x86_mask()) {
+    return encode_avx({vex_none, map_0f, 0x11, 0, tuple_fvm, 0}, flags_of(src), code_of(src), 0, dst, store_mask(mask));
+  }
+
+  /**
+   * Emits a `VMULPD` (multiply packed double-precision values) instruction.
+   *
+   * @copydetails emit_avx_instruction
+   */
+  template <typename Vec, typename Src>
+  x86_emitter& vmulpd(const Vec dst, const Vec src1, const Src& src2, const x86_mask mask = x86_mask()) {
+    return encode_avx({vex_66, map_0f, 0x59, 0, tuple_fv, 1}, flags_of(dst), code_of(dst), code_of(src1), rm_of(src2), mask);
+  }
+
+  /**
+   * Emits a `VMULPS` (multiply packed single-precision values) instruction.
+   *
+   * @copydetails emit_avx_instruction
+   */
+  template <typename Vec, typename Src>
+  x86_emitter& vmulps(const Vec dst, const Vec src1, const Src& src2, const x86_mask mask = x86_mask()) {
+    return encode_avx({vex_none, map_0f, 0x59, 0, tuple_fv, 0}, flags_of(dst), code_of(dst), code_of(src1), rm_of(src2), mask);
+  }
+
+  /**
+   * Emits a `VORPS` (bitwise OR of packed single-precision values) instruction.
+   *
+   * @copydetails emit_avx_instruction
+   */
+  template <typename Vec, typename Src>
+  x86_emitter& vorps(const Vec dst, const Vec src1, const Src& src2, const x86_mask mask = x86_mask()) {
+    return encode_avx({vex_none, map_0f, 0x56, 0, tuple_fv, 0}, flags_of(dst), code_of(dst), code_of(src1), rm_of(src2), mask);
+  }
+
+  /**
+   * Emits a `VPABSD` (absolute value of packed doublewords) instruction.
+   *
+   * @copydetails emit_avx_instruction
+   */
+  template <typename Vec, typename Src>
+  x86_emitter& vpabsd(const Vec dst, const Src& src, const x86_mask mask = x86_mask()) {
+    return encode_avx({vex_66, map_0f38, 0x1E, 0, tuple_fv, 0}, flags_of(dst), code_of(dst), 0, rm_of(src), mask);
+  }
+
+  /**
+   * Emits a `VPACKSSWB` (pack words into bytes with signed saturation) instruction.
+   *
+   * @copydetails emit_avx_instruction
+   */
+  template <typename Vec, typename Src>
+  x86_emitter& vpacksswb(const Vec dst, const Vec src1, const Src& src2, const x86_mask mask = x86_mask()) {
+    return encode_avx({vex_66, map_0f, 0x63, 0, tuple_fvm, 0}, flags_of(dst), code_of(dst), code_of(src1), rm_of(src2), mask);
+  }
+
+  /**
+   * Emits a `VPACKUSWB` (pack words into bytes with unsigned saturation) instruction.
+   *
+   * @copydetails emit_avx_instruction
+   */
+  template <typename Vec, typename Src>
+  x86_emitter& vpackuswb(const Vec dst, const Vec src1, const Src& src2, const x86_mask mask = x86_mask()) {
+    return encode_avx({vex_66, map_0f, 0x67, 0, tuple_fvm, 0}, flags_of(dst), code_of(dst), code_of(src1), rm_of(src2), mask);
+  }
+
+  /**
+   * Emits a `VPADDB` (add packed bytes) instruction.
+   *
+   * @copydetails emit_avx_instruction
+   */
+  template <typename Vec, typename Src>
+  x86_emitter& vpaddb(const Vec dst, const Vec src1, const Src& src2, const x86_mask mask = x86_mask()) {
+    return encode_avx({vex_66, map_0f, 0xFC, 0, tuple_fvm, 0}, flags_of(dst), code_of(dst), code_of(src1), rm_of(src2), mask);
+  }
+
+  /**
+   * Emits a `VPADDD` (add packed doublewords) instruction.
+   *
+   * @copydetails emit_avx_instruction
+   */
+  template <typename Vec, typename Src>
+  x86_emitter& vpaddd(const Vec dst, const Vec src1, const Src& src2, const x86_mask mask = x86_mask()) {
+    return encode_avx({vex_66, map_0f, 0xFE, 0, tuple_fv, 0}, flags_of(dst), code_of(dst), code_of(src1), rm_of(src2), mask);
+  }
+
+  /**
+   * Emits a `VPADDQ` (add packed quadwords) instruction.
+   *
+   * @copydetails emit_avx_instruction
+   */
+  template <typename Vec, typename Src>
+  x86_emitter& vpaddq(const Vec dst, const Vec src1, const Src& src2, const x86_mask mask = x86_mask()) {
+    return encode_avx({vex_66, map_0f, 0xD4, 0, tuple_fv, 1}, flags_of(dst), code_of(dst), code_of(src1), rm_of(src2), mask);
+  }
+
+  /**
+   * Emits a `VPADDUSB` (add packed unsigned bytes with saturation) instruction.
+   *
+   * @copydetails emit_avx_instruction
+   */
+  template <typename Vec, typename Src>
+  x86_emitter& vpaddusb(const Vec dst, const Vec src1, const Src& src2, const x86_mask mask = x86_mask()) {
+    return encode_avx({vex_66, map_0f, 0xDC, 0, tuple_fvm, 0}, flags_of(dst), code_of(dst), code_of(src1), rm_of(src2), mask);
+  }
+
+  /**
+   * Emits a `VPADDW` (add packed words) instruction.
+   *
+   * @copydetails emit_avx_instruction
+   */
+  template <typename Vec, typename Src>
+  x86_emitter& vpaddw(const Vec dst, const Vec src1, const Src& src2, const x86_mask mask = x86_mask()) {
+    return encode_avx({vex_66, map_0f, 0xFD, 0, tuple_fvm, 0}, flags_of(dst), code_of(dst), code_of(src1), rm_of(src2), mask);
+  }
+
+  /**
+   * Emits a `VPALIGNR` (concatenate and shift each 128-bit lane right by bytes) instruction.
+   *
+   * @copydetails emit_avx_instruction
+   */
+  template <typename Vec, typename Src>
+  x86_emitter& vpalignr(const Vec dst, const Vec src1, const Src& src2, const x86_imm8 imm, const x86_mask mask = x86_mask()) {
+    return encode_avx({vex_66, map_0f3a, 0x0F, 0, tuple_fvm, 0}, flags_of(dst), code_of(dst), code_of(src1), rm_of(src2), mask, 1, imm.u8);
+  }
+
+  /**
+   * Emits a `VPAND` (bitwise AND) instruction.
+   *
+   * @copydetails emit_avx_instruction
+   */
+  template <typename Vec, typename Src>
+  x86_emitter& vpand(const Vec dst, const Vec src1, const Src& src2) {
+    return encode_vex(flags_of(dst), vex_66, map_0f, 0xDB, code_of(dst), code_of(src1), rm_of(src2));
+  }
+
+  /**
+   * Emits a `VPANDN` (bitwise AND NOT) instruction.
+   *
+   * @copydetails emit_avx_instruction
+   */
+  template <typename Vec, typename Src>
+  x86_emitter& vpandn(const Vec dst, const Vec src1, const Src& src2) {
+    return encode_vex(flags_of(dst), vex_66, map_0f, 0xDF, code_of(dst), code_of(src1), rm_of(src2));
+  }
+
+  /**
+   * Emits a `VPAVGB` (average packed unsigned bytes) instruction.
+   *
+   * @copydetails emit_avx_instruction
+   */
+  template <typename Vec, typename Src>
+  x86_emitter& vpavgb(const Vec dst, const Vec src1, const Src& src2, const x86_mask mask = x86_mask()) {
+    return encode_avx({vex_66, map_0f, 0xE0, 0, tuple_fvm, 0}, flags_of(dst), code_of(dst), code_of(src1), rm_of(src2), mask);
+  }
+
+  /**
+   * Emits a `VPBLENDD` (blend packed doublewords by an immediate mask) instruction.
+   *
+   * @copydetails emit_avx_instruction
+   */
+  template <typename Vec, typename Src>
+  x86_emitter& vpblendd(const Vec dst, const Vec src1, const Src& src2, const x86_imm8 imm) {
+    return encode_vex(flags_of(dst), vex_66, map_0f3a, 0x02, code_of(dst), code_of(src1), rm_of(src2), 1, imm.u8);
+  }
+
+  /**
+   * Emits a `VPBLENDVB` (blend packed bytes by a vector mask) instruction.
+   *
+   * @copydetails emit_avx_instruction
+   */
+  template <typename Vec, typename Src>
+  x86_emitter& vpblendvb(const Vec dst, const Vec src1, const Src& src2, const Vec mask) {
+    return encode_vex(flags_of(dst), vex_66, map_0f3a, 0x4C, code_of(dst), code_of(src1), rm_of(src2), 1, code_of(mask) << 4);
+  }
+
+  /**
+   * Emits a `VPBROADCASTB` (broadcast a byte) instruction.
+   *
+   * @copydetails emit_avx_instruction
+   */
+  template <typename Vec, typename Src>
+  x86_emitter& vpbroadcastb(const Vec dst, const Src& src, const x86_mask mask = x86_mask()) {
+    return encode_avx({vex_66, map_0f38, 0x78, 0, tuple_t1s1, 0}, flags_of(dst), code_of(dst), 0, rm_of(src), mask);
+  }
+
+  /**
+   * Emits a `VPBROADCASTD` (broadcast a doubleword) instruction.
+   *
+   * @copydetails emit_avx_instruction
+   */
+  template <typename Vec, typename Src>
+  x86_emitter& vpbroadcastd(const Vec dst, const Src& src, const x86_mask mask = x86_mask()) {
+    return encode_avx({vex_66, map_0f38, 0x58, 0, tuple_t1s4, 0}, flags_of(dst), code_of(dst), 0, rm_of(src), mask);
+  }
+
+  /**
+   * Emits a `VPBROADCASTQ` (broadcast a quadword) instruction.
+   *
+   * @copydetails emit_avx_instruction
+   */
+  template <typename Vec, typename Src>
+  x86_emitter& vpbroadcastq(const Vec dst, const Src& src, const x86_mask mask = x86_mask()) {
+    return encode_avx({vex_66, map_0f38, 0x59, 0, tuple_t1s8, 1}, flags_of(dst), code_of(dst), 0, rm_of(src), mask);
+  }
+
+  /**
+   * Emits a `VPCMPEQB` (compare packed bytes for equality) instruction.
+   *
+   * @copydetails emit_avx_instruction
+   */
+  template <typename Vec, typename Src>
+  x86_emitter& vpcmpeqb(const Vec dst, const Vec src1, const Src& src2) {
+    return encode_vex(flags_of(dst), vex_66, map_0f, 0x74, code_of(dst), code_of(src1), rm_of(src2));
+  }
+
+  /**
+   * Emits a `VPCMPEQD` (compare packed doublewords for equality) instruction.
+   *
+   * @copydetails emit_avx_instruction
+   */
+  template <typename Vec, typename Src>
+  x86_emitter& vpcmpeqd(const Vec dst, const Vec src1, const Src& src2) {
+    return encode_vex(flags_of(dst), vex_66, map_0f, 0x76, code_of(dst), code_of(src1), rm_of(src2));
+  }
+
+  /**
+   * Emits a `VPCMPEQQ` (compare packed quadwords for equality) instruction.
+   *
+   * @copydetails emit_avx_instruction
+   */
+  template <typename Vec, typename Src>
+  x86_emitter& vpcmpeqq(const Vec dst, const Vec src1, const Src& src2) {
+    return encode_vex(flags_of(dst), vex_66, map_0f38, 0x29, code_of(dst), code_of(src1), rm_of(src2));
+  }
+
+  /**
+   * Emits a `VPCMPEQW` (compare packed words for equality) instruction.
+   *
+   * @copydetails emit_avx_instruction
+   */
+  template <typename Vec, typename Src>
+  x86_emitter& vpcmpeqw(const Vec dst, const Vec src1, const Src& src2) {
+    return encode_vex(flags_of(dst), vex_66, map_0f, 0x75, code_of(dst), code_of(src1), rm_of(src2));
+  }
+
+  /**
+   * Emits a `VPCMPGTB` (compare packed signed bytes for greater than) instruction.
+   *
+   * @copydetails emit_avx_instruction
+   */
+  template <typename Vec, typename Src>
+  x86_emitter& vpcmpgtb(const Vec dst, const Vec src1, const Src& src2) {
+    return encode_vex(flags_of(dst), vex_66, map_0f, 0x64, code_of(dst), code_of(src1), rm_of(src2));
+  }
+
+  /**
+   * Emits a `VPCMPGTD` (compare packed signed doublewords for greater than) instruction.
+   *
+   * @copydetails emit_avx_instruction
+   */
+  template <typename Vec, typename Src>
+  x86_emitter& vpcmpgtd(const Vec dst, const Vec src1, const Src& src2) {
+    return encode_vex(flags_of(dst), vex_66, map_0f, 0x66, code_of(dst), code_of(src1), rm_of(src2));
+  }
+
+  /**
+   * Emits a `VPCMPGTQ` (compare packed signed quadwords for greater than) instruction.
+   *
+   * @copydetails emit_avx_instruction
+   */
+  template <typename Vec, typename Src>
+  x86_emitter& vpcmpgtq(const Vec dst, const Vec src1, const Src& src2) {
+    return encode_vex(flags_of(dst), vex_66, map_0f38, 0x37, code_of(dst), code_of(src1), rm_of(src2));
+  }
+
+  /**
+   * Emits a `VPCMPGTW` (compare packed signed words for greater than) instruction.
+   *
+   * @copydetails emit_avx_instruction
+   */
+  template <typename Vec, typename Src>
+  x86_emitter& vpcmpgtw(const Vec dst, const Vec src1, const Src& src2) {
+    return encode_vex(flags_of(dst), vex_66, map_0f, 0x65, code_of(dst), code_of(src1), rm_of(src2));
+  }
+
+  /**
+   * Emits a `VPCMPISTRI` (compare implicit-length strings, returning an index in ECX) instruction.
+   *
+   * @copydetails emit_avx_instruction
+   */
+  template <typename Vec, typename Src>
+  x86_emitter& vpcmpistri(const Vec dst, const Src& src, const x86_imm8 imm) {
+    return encode_vex(flags_of(dst), vex_66, map_0f3a, 0x63, code_of(dst), 0, rm_of(src), 1, imm.u8);
+  }
+
+  /**
+   * Emits a `VPCMPISTRM` (compare implicit-length strings, returning a mask in XMM0) instruction.
+   *
+   * @copydetails emit_avx_instruction
+   */
+  template <typename Vec, typename Src>
+  x86_emitter& vpcmpistrm(const Vec dst, const Src& src, const x86_imm8 imm) {
+    return encode_vex(flags_of(dst), vex_66, map_0f3a, 0x62, code_of(dst), 0, rm_of(src), 1, imm.u8);
+  }
+
+  /**
+   * Emits a `VPERM2I128` (permute 128-bit lanes) instruction.
+   *
+   * @copydetails emit_avx_instruction
+   */
+  template <typename Src>
+  x86_emitter& vperm2i128(const x86_ymm dst, const x86_ymm src1, const Src& src2, const x86_imm8 imm) {
+    return encode_vex(size256, vex_66, map_0f3a, 0x46, code_of(dst), code_of(src1), rm_of(src2), 1, imm.u8);
+  }
+
+  /**
+   * Emits a `VPERMD` (permute doublewords across lanes by the indices in `src1`) instruction.
+   *
+   * @copydetails emit_avx_instruction
+   */
+  template <typename Vec, typename Src>
+  x86_emitter& vpermd(const Vec dst, const Vec src1, const Src& src2, const x86_mask mask = x86_mask()) {
+    return encode_avx({vex_66, map_0f38, 0x36, 0, tuple_fv, 0}, flags_of(dst), code_of(dst), code_of(src1), rm_of(src2), mask);
+  }
+
+  /**
+   * Emits a `VPERMQ` (permute quadwords across lanes by an immediate) instruction.
+   *
+   * @copydetails emit_avx_instruction
+   */
+  template <typename Vec, typename Src>
+  x86_emitter& vpermq(const Vec dst, const Src& src, const x86_imm8 imm, const x86_mask mask = x86_mask()) {
+    return encode_avx({vex_66, map_0f3a, 0x00, 1, tuple_fv, 1}, flags_of(dst), code_of(dst), 0, rm_of(src), mask, 1, imm.u8);
+  }
+
+  /**
+   * Emits a `VPMADDWD` (multiply and add packed words) instruction.
+   *
+   * @copydetails emit_avx_instruction
+   */
+  template <typename Vec, typename Src>
+  x86_emitter& vpmaddwd(const Vec dst, const Vec src1, const Src& src2, const x86_mask mask = x86_mask()) {
+    return encode_avx({vex_66, map_0f, 0xF5, 0, tuple_fvm, 0}, flags_of(dst), code_of(dst), code_of(src1), rm_of(src2), mask);
+  }
+
+  /**
+   * Emits a `VPMASKMOVD` (load packed doublewords under a vector mask) instruction.
+   *
+   * @copydetails emit_avx_instruction
+   */
+  template <typename Vec>
+  x86_emitter& vpmaskmovd(const Vec dst, const Vec mask, const x86_mem& src) {
+    return encode_vex(flags_of(dst), vex_66, map_0f38, 0x8C, code_of(dst), code_of(mask), src);
+  }
+
+  /**
+   * Emits a `VPMASKMOVD` (store packed doublewords under a vector mask) instruction.
+   *
+   * @copydetails emit_avx_instruction
+   */
+  template <typename Vec>
+  x86_emitter& vpmaskmovd(const x86_mem& dst, const Vec mask, const Vec src) {
+    return encode_vex(flags_of(src), vex_66, map_0f38, 0x8E, code_of(src), code_of(mask), dst);
+  }
+
+  /**
+   * Emits a `VPMAXSD` (maximum of packed signed doublewords) instruction.
+   *
+   * @copydetails emit_avx_instruction
+   */
+  template <typename Vec, typename Src>
+  x86_emitter& vpmaxsd(const Vec dst, const Vec src1, const Src& src2, const x86_mask mask = x86_mask()) {
+    return encode_avx({vex_66, map_0f38, 0x3D, 0, tuple_fv, 0}, flags_of(dst), code_of(dst), code_of(src1), rm_of(src2), mask);
+  }
+
+  /**
+   * Emits a `VPMAXUB` (maximum of packed unsigned bytes) instruction.
+   *
+   * @copydetails emit_avx_instruction
+   */
+  template <typename Vec, typename Src>
+  x86_emitter& vpmaxub(const Vec dst, const Vec src1, const Src& src2, const x86_mask mask = x86_mask()) {
+    return encode_avx({vex_66, map_0f, 0xDE, 0, tuple_fvm, 0}, flags_of(dst), code_of(dst), code_of(src1), rm_of(src2), mask);
+  }
+
+  /**
+   * Emits a `VPMAXUD` (maximum of packed unsigned doublewords) instruction.
+   *
+   * @copydetails emit_avx_instruction
+   */
+  template <typename Vec, typename Src>
+  x86_emitter& vpmaxud(const Vec dst, const Vec src1, const Src& src2, const x86_mask mask = x86_mask()) {
+    return encode_avx({vex_66, map_0f38, 0x3F, 0, tuple_fv, 0}, flags_of(dst), code_of(dst), code_of(src1), rm_of(src2), mask);
+  }
+
+  /**
+   * Emits a `VPMINSD` (minimum of packed signed doublewords) instruction.
+   *
+   * @copydetails emit_avx_instruction
+   */
+  template <typename Vec, typename Src>
+  x86_emitter& vpminsd(const Vec dst, const Vec src1, const Src& src2, const x86_mask mask = x86_mask()) {
+    return encode_avx({vex_66, map_0f38, 0x39, 0, tuple_fv, 0}, flags_of(dst), code_of(dst), code_of(src1), rm_of(src2), mask);
+  }
+
+  /**
+   * Emits a `VPMINUB` (minimum of packed unsigned bytes) instruction.
+   *
+   * @copydetails emit_avx_instruction
+   */
+  template <typename Vec, typename Src>
+  x86_emitter& vpminub(const Vec dst, const Vec src1, const Src& src2, const x86_mask mask = x86_mask()) {
+    return encode_avx({vex_66, map_0f, 0xDA, 0, tuple_fvm, 0}, flags_of(dst), code_of(dst), code_of(src1), rm_of(src2), mask);
+  }
+
+  /**
+   * Emits a `VPMINUD` (minimum of packed unsigned doublewords) instruction.
+   *
+   * @copydetails emit_avx_instruction
+   */
+  template <typename Vec, typename Src>
+  x86_emitter& vpminud(const Vec dst, const Vec src1, const Src& src2, const x86_mask mask = x86_mask()) {
+    return encode_avx({vex_66, map_0f38, 0x3B, 0, tuple_fv, 0}, flags_of(dst), code_of(dst), code_of(src1), rm_of(src2), mask);
+  }
+
+  /**
+   * Emits a `VPMOVMSKB` (gather the sign bits of packed bytes into a mask) instruction.
+   *
+   * @copydetails emit_avx_instruction
+   */
+  template <typename Vec>
+  x86_emitter& vpmovmskb(const x86_reg32 dst, const Vec src) {
+    return encode_vex(flags_of(src), vex_66, map_0f, 0xD7, code_of(dst), 0, code_of(src));
+  }
+
+  /**
+   * Emits a `VPMULLD` (multiply packed doublewords, keeping the low halves) instruction.
+   *
+   * @copydetails emit_avx_instruction
+   */
+  template <typename Vec, typename Src>
+  x86_emitter& vpmulld(const Vec dst, const Vec src1, const Src& src2, const x86_mask mask = x86_mask()) {
+    return encode_avx({vex_66, map_0f38, 0x40, 0, tuple_fv, 0}, flags_of(dst), code_of(dst), code_of(src1), rm_of(src2), mask);
+  }
+
+  /**
+   * Emits a `VPMULLW` (multiply packed words, keeping the low halves) instruction.
+   *
+   * @copydetails emit_avx_instruction
+   */
+  template <typename Vec, typename Src>
+  x86_emitter& vpmullw(const Vec dst, const Vec src1, const Src& src2, const x86_mask mask = x86_mask()) {
+    return encode_avx({vex_66, map_0f, 0xD5, 0, tuple_fvm, 0}, flags_of(dst), code_of(dst), code_of(src1), rm_of(src2), mask);
+  }
+
+  /**
+   * Emits a `VPMULUDQ` (multiply packed unsigned doublewords into quadwords) instruction.
+   *
+   * @copydetails emit_avx_instruction
+   */
+  template <typename Vec, typename Src>
+  x86_emitter& vpmuludq(const Vec dst, const Vec src1, const Src& src2, const x86_mask mask = x86_mask()) {
+    return encode_avx({vex_66, map_0f, 0xF4, 0, tuple_fv, 1}, flags_of(dst), code_of(dst), code_of(src1), rm_of(src2), mask);
+  }
+
+  /**
+   * Emits a `VPOR` (bitwise OR) instruction.
+   *
+   * @copydetails emit_avx_instruction
+   */
+  template <typename Vec, typename Src>
+  x86_emitter& vpor(const Vec dst, const Vec src1, const Src& src2) {
+    return encode_vex(flags_of(dst), vex_66, map_0f, 0xEB, code_of(dst), code_of(src1), rm_of(src2));
+  }
+
+  /**
+   * Emits a `VPSADBW` (compute sums of absolute byte differences) instruction.
+   *
+   * @copydetails emit_avx_instruction
+   */
+  template <typename Vec, typename Src>
+  x86_emitter& vpsadbw(const Vec dst, const Vec src1, const Src& src2, const x86_mask mask = x86_mask()) {
+    return encode_avx({vex_66, map_0f, 0xF6, 0, tuple_fvm, 0}, flags_of(dst), code_of(dst), code_of(src1), rm_of(src2), mask);
+  }
+
+  /**
+   * Emits a `VPSHUFB` (shuffle packed bytes) instruction.
+   *
+   * @copydetails emit_avx_instruction
+   */
+  template <typename Vec, typename Src>
+  x86_emitter& vpshufb(const Vec dst, const Vec src1, const Src& src2, const x86_mask mask = x86_mask()) {
+    return encode_avx({vex_66, map_0f38, 0x00, 0, tuple_fvm, 0}, flags_of(dst), code_of(dst), code_of(src1), rm_of(src2), mask);
+  }
+
+  /**
+   * Emits a `VPSHUFD` (shuffle packed doublewords) instruction.
+   *
+   * @copydetails emit_avx_instruction
+   */
+  template <typename Vec, typename Src>
+  x86_emitter& vpshufd(const Vec dst, const Src& src, const x86_imm8 imm, const x86_mask mask = x86_mask()) {
+    return encode_avx({vex_66, map_0f, 0x70, 0, tuple_fv, 0}, flags_of(dst), code_of(dst), 0, rm_of(src), mask, 1, imm.u8);
+  }
+
+  /**
+   * Emits a `VPSLLD` (shift packed doublewords left logical) instruction.
+   *
+   * @copydetails emit_avx_instruction
+   */
+  template <typename Vec>
+  x86_emitter& vpslld(const Vec dst, const Vec src, const x86_imm8 imm, const x86_mask mask = x86_mask()) {
+    return encode_avx({vex_66, map_0f, 0x72, 0, tuple_fv, 0}, flags_of(dst), ext(6), code_of(dst), code_of(src), mask, 1, imm.u8);
+  }
+
+  /**
+   * Emits a `VPSLLDQ` (shift each 128-bit lane left by bytes) instruction.
+   *
+   * @copydetails emit_avx_instruction
+   */
+  template <typename Vec>
+  x86_emitter& vpslldq(const Vec dst, const Vec src, const x86_imm8 imm, const x86_mask mask = x86_mask()) {
+    return encode_avx({vex_66, map_0f, 0x73, 0, tuple_fvm, 0}, flags_of(dst), ext(7), code_of(dst), code_of(src), mask, 1, imm.u8);
+  }
+
+  /**
+   * Emits a `VPSLLQ` (shift packed quadwords left logical) instruction.
+   *
+   * @copydetails emit_avx_instruction
+   */
+  template <typename Vec>
+  x86_emitter& vpsllq(const Vec dst, const Vec src, const x86_imm8 imm, const x86_mask mask = x86_mask()) {
+    return encode_avx({vex_66, map_0f, 0x73, 0, tuple_fv, 1}, flags_of(dst), ext(6), code_of(dst), code_of(src), mask, 1, imm.u8);
+  }
+
+  /**
+   * Emits a `VPSLLW` (shift packed words left logical) instruction.
+   *
+   * @copydetails emit_avx_instruction
+   */
+  template <typename Vec>
+  x86_emitter& vpsllw(const Vec dst, const Vec src, const x86_imm8 imm, const x86_mask mask = x86_mask()) {
+    return encode_avx({vex_66, map_0f, 0x71, 0, tuple_fvm, 0}, flags_of(dst), ext(6), code_of(dst), code_of(src), mask, 1, imm.u8);
+  }
+
+  /**
+   * Emits a `VPSRAD` (shift packed doublewords right arithmetic) instruction.
+   *
+   * @copydetails emit_avx_instruction
+   */
+  template <typename Vec>
+  x86_emitter& vpsrad(const Vec dst, const Vec src, const x86_imm8 imm, const x86_mask mask = x86_mask()) {
+    return encode_avx({vex_66, map_0f, 0x72, 0, tuple_fv, 0}, flags_of(dst), ext(4), code_of(dst), code_of(src), mask, 1, imm.u8);
+  }
+
+  /**
+   * Emits a `VPSRAW` (shift packed words right arithmetic) instruction.
+   *
+   * @copydetails emit_avx_instruction
+   */
+  template <typename Vec>
+  x86_emitter& vpsraw(const Vec dst, const Vec src, const x86_imm8 imm, const x86_mask mask = x86_mask()) {
+    return encode_avx({vex_66, map_0f, 0x71, 0, tuple_fvm, 0}, flags_of(dst), ext(4), code_of(dst), code_of(src), mask, 1, imm.u8);
+  }
+
+  /**
+   * Emits a `VPSRLD` (shift packed doublewords right logical) instruction.
+   *
+   * @copydetails emit_avx_instruction
+   */
+  template <typename Vec>
+  x86_emitter& vpsrld(const Vec dst, const Vec src, const x86_imm8 imm, const x86_mask mask = x86_mask()) {
+    return encode_avx({vex_66, map_0f, 0x72, 0, tuple_fv, 0}, flags_of(dst), ext(2), code_of(dst), code_of(src), mask, 1, imm.u8);
+  }
+
+  /**
+   * Emits a `VPSRLDQ` (shift each 128-bit lane right by bytes) instruction.
+   *
+   * @copydetails emit_avx_instruction
+   */
+  template <typename Vec>
+  x86_emitter& vpsrldq(const Vec dst, const Vec src, const x86_imm8 imm, const x86_mask mask = x86_mask()) {
+    return encode_avx({vex_66, map_0f, 0x73, 0, tuple_fvm, 0}, flags_of(dst), ext(3), code_of(dst), code_of(src), mask, 1, imm.u8);
+  }
+
+  /**
+   * Emits a `VPSRLQ` (shift packed quadwords right logical) instruction.
+   *
+   * @copydetails emit_avx_instruction
+   */
+  template <typename Vec>
+  x86_emitter& vpsrlq(const Vec dst, const Vec src, const x86_imm8 imm, const x86_mask mask = x86_mask()) {
+    return encode_avx({vex_66, map_0f, 0x73, 0, tuple_fv, 1}, flags_of(dst), ext(2), code_of(dst), code_of(src), mask, 1, imm.u8);
+  }
+
+  /**
+   * Emits a `VPSRLW` (shift packed words right logical) instruction.
+   *
+   * @copydetails emit_avx_instruction
+   */
+  template <typename Vec>
+  x86_emitter& vpsrlw(const Vec dst, const Vec src, const x86_imm8 imm, const x86_mask mask = x86_mask()) {
+    return encode_avx({vex_66, map_0f, 0x71, 0, tuple_fvm, 0}, flags_of(dst), ext(2), code_of(dst), code_of(src), mask, 1, imm.u8);
+  }
+
+  /**
+   * Emits a `VPSUBB` (subtract packed bytes) instruction.
+   *
+   * @copydetails emit_avx_instruction
+   */
+  template <typename Vec, typename Src>
+  x86_emitter& vpsubb(const Vec dst, const Vec src1, const Src& src2, const x86_mask mask = x86_mask()) {
+    return encode_avx({vex_66, map_0f, 0xF8, 0, tuple_fvm, 0}, flags_of(dst), code_of(dst), code_of(src1), rm_of(src2), mask);
+  }
+
+  /**
+   * Emits a `VPSUBD` (subtract packed doublewords) instruction.
+   *
+   * @copydetails emit_avx_instruction
+   */
+  template <typename Vec, typename Src>
+  x86_emitter& vpsubd(const Vec dst, const Vec src1, const Src& src2, const x86_mask mask = x86_mask()) {
+    return encode_avx({vex_66, map_0f, 0xFA, 0, tuple_fv, 0}, flags_of(dst), code_of(dst), code_of(src1), rm_of(src2), mask);
+  }
+
+  /**
+   * Emits a `VPSUBQ` (subtract packed quadwords) instruction.
+   *
+   * @copydetails emit_avx_instruction
+   */
+  template <typename Vec, typename Src>
+  x86_emitter& vpsubq(const Vec dst, const Vec src1, const Src& src2, const x86_mask mask = x86_mask()) {
+    return encode_avx({vex_66, map_0f, 0xFB, 0, tuple_fv, 1}, flags_of(dst), code_of(dst), code_of(src1), rm_of(src2), mask);
+  }
+
+  /**
+   * Emits a `VPSUBUSB` (subtract packed unsigned bytes with saturation) instruction.
+   *
+   * @copydetails emit_avx_instruction
+   */
+  template <typename Vec, typename Src>
+  x86_emitter& vpsubusb(const Vec dst, const Vec src1, const Src& src2, const x86_mask mask = x86_mask()) {
+    return encode_avx({vex_66, map_0f, 0xD8, 0, tuple_fvm, 0}, flags_of(dst), code_of(dst), code_of(src1), rm_of(src2), mask);
+  }
+
+  /**
+   * Emits a `VPSUBW` (subtract packed words) instruction.
+   *
+   * @copydetails emit_avx_instruction
+   */
+  template <typename Vec, typename Src>
+  x86_emitter& vpsubw(const Vec dst, const Vec src1, const Src& src2, const x86_mask mask = x86_mask()) {
+    return encode_avx({vex_66, map_0f, 0xF9, 0, tuple_fvm, 0}, flags_of(dst), code_of(dst), code_of(src1), rm_of(src2), mask);
+  }
+
+  /**
+   * Emits a `VPTEST` (logical compare, setting ZF and CF) instruction.
+   *
+   * @copydetails emit_avx_instruction
+   */
+  template <typename Vec, typename Src>
+  x86_emitter& vptest(const Vec dst, const Src& src) {
+    return encode_vex(flags_of(dst), vex_66, map_0f38, 0x17, code_of(dst), 0, rm_of(src));
+  }
+
+  /**
+   * Emits a `VPUNPCKHBW` (interleave high-order bytes) instruction.
+   *
+   * @copydetails emit_avx_instruction
+   */
+  template <typename Vec, typename Src>
+  x86_emitter& vpunpckhbw(const Vec dst, const Vec src1, const Src& src2, const x86_mask mask = x86_mask()) {
+    return encode_avx({vex_66, map_0f, 0x68, 0, tuple_fvm, 0}, flags_of(dst), code_of(dst), code_of(src1), rm_of(src2), mask);
+  }
+
+  /**
+   * Emits a `VPUNPCKLBW` (interleave low-order bytes) instruction.
+   *
+   * @copydetails emit_avx_instruction
+   */
+  template <typename Vec, typename Src>
+  x86_emitter& vpunpcklbw(const Vec dst, const Vec src1, const Src& src2, const x86_mask mask = x86_mask()) {
+    return encode_avx({vex_66, map_0f, 0x60, 0, tuple_fvm, 0}, flags_of(dst), code_of(dst), code_of(src1), rm_of(src2), mask);
+  }
+
+  /**
+   * Emits a `VPUNPCKLDQ` (interleave low-order doublewords) instruction.
+   *
+   * @copydetails emit_avx_instruction
+   */
+  template <typename Vec, typename Src>
+  x86_emitter& vpunpckldq(const Vec dst, const Vec src1, const Src& src2, const x86_mask mask = x86_mask()) {
+    return encode_avx({vex_66, map_0f, 0x62, 0, tuple_fv, 0}, flags_of(dst), code_of(dst), code_of(src1), rm_of(src2), mask);
+  }
+
+  /**
+   * Emits a `VPUNPCKLQDQ` (interleave low-order quadwords) instruction.
+   *
+   * @copydetails emit_avx_instruction
+   */
+  template <typename Vec, typename Src>
+  x86_emitter& vpunpcklqdq(const Vec dst, const Vec src1, const Src& src2, const x86_mask mask = x86_mask()) {
+    return encode_avx({vex_66, map_0f, 0x6C, 0, tuple_fv, 1}, flags_of(dst), code_of(dst), code_of(src1), rm_of(src2), mask);
+  }
+
+  /**
+   * Emits a `VPXOR` (bitwise exclusive OR) instruction.
+   *
+   * @copydetails emit_avx_instruction
+   */
+  template <typename Vec, typename Src>
+  x86_emitter& vpxor(const Vec dst, const Vec src1, const Src& src2) {
+    return encode_vex(flags_of(dst), vex_66, map_0f, 0xEF, code_of(dst), code_of(src1), rm_of(src2));
+  }
+
+  /**
+   * Emits a `VSHUFPS` (shuffle packed single-precision values) instruction.
+   *
+   * @copydetails emit_avx_instruction
+   */
+  template <typename Vec, typename Src>
+  x86_emitter& vshufps(const Vec dst, const Vec src1, const Src& src2, const x86_imm8 imm, const x86_mask mask = x86_mask()) {
+    return encode_avx({vex_none, map_0f, 0xC6, 0, tuple_fv, 0}, flags_of(dst), code_of(dst), code_of(src1), rm_of(src2), mask, 1, imm.u8);
+  }
+
+  /**
+   * Emits a `VSQRTPD` (square root of packed double-precision values) instruction.
+   *
+   * @copydetails emit_avx_instruction
+   */
+  template <typename Vec, typename Src>
+  x86_emitter& vsqrtpd(const Vec dst, const Src& src, const x86_mask mask = x86_mask()) {
+    return encode_avx({vex_66, map_0f, 0x51, 0, tuple_fv, 1}, flags_of(dst), code_of(dst), 0, rm_of(src), mask);
+  }
+
+  /**
+   * Emits a `VSQRTPS` (square root of packed single-precision values) instruction.
+   *
+   * @copydetails emit_avx_instruction
+   */
+  template <typename Vec, typename Src>
+  x86_emitter& vsqrtps(const Vec dst, const Src& src, const x86_mask mask = x86_mask()) {
+    return encode_avx({vex_none, map_0f, 0x51, 0, tuple_fv, 0}, flags_of(dst), code_of(dst), 0, rm_of(src), mask);
+  }
+
+  /**
+   * Emits a `VSUBPD` (subtract packed double-precision values) instruction.
+   *
+   * @copydetails emit_avx_instruction
+   */
+  template <typename Vec, typename Src>
+  x86_emitter& vsubpd(const Vec dst, const Vec src1, const Src& src2, const x86_mask mask = x86_mask()) {
+    return encode_avx({vex_66, map_0f, 0x5C, 0, tuple_fv, 1}, flags_of(dst), code_of(dst), code_of(src1), rm_of(src2), mask);
+  }
+
+  /**
+   * Emits a `VSUBPS` (subtract packed single-precision values) instruction.
+   *
+   * @copydetails emit_avx_instruction
+   */
+  template <typename Vec, typename Src>
+  x86_emitter& vsubps(const Vec dst, const Vec src1, const Src& src2, const x86_mask mask = x86_mask()) {
+    return encode_avx({vex_none, map_0f, 0x5C, 0, tuple_fv, 0}, flags_of(dst), code_of(dst), code_of(src1), rm_of(src2), mask);
+  }
+
+  /**
+   * Emits a `VXORPS` (bitwise exclusive OR of packed single-precision values) instruction.
+   *
+   * @copydetails emit_avx_instruction
+   */
+  template <typename Vec, typename Src>
+  x86_emitter& vxorps(const Vec dst, const Vec src1, const Src& src2, const x86_mask mask = x86_mask()) {
+    return encode_avx({vex_none, map_0f, 0x57, 0, tuple_fv, 0}, flags_of(dst), code_of(dst), code_of(src1), rm_of(src2), mask);
+  }
+
+  /**
+   * Emits a three-byte `VZEROUPPER` instruction, which avoids transition
+   * penalties before executing legacy SSE code.
+   *
+   * @copydetails emit_avx_instruction
+   */
+  x86_emitter& vzeroupper() {
+    return emit(0xC5, 0xF8, 0x77);
+  }
+
+  /**@}*/
+
+  /**
+   * @name AVX-512 Instructions
+   *
+   * These instructions exist only in the EVEX encoding of the AVX-512F,
+   * AVX-512BW, AVX-512DQ, and AVX-512VL extensions, or operate on the
+   * opmask registers.
+   */
+
+  /**@{*/
+
+  /**
+   * @class emit_avx512_instruction
+   *
+   * Vector operands are `x86_xmm`, `x86_ymm`, or `x86_zmm` registers of
+   * the same width, and the last source operand may instead be an
+   * `x86_mem`, or an `x86_bcst` for instructions with doubleword or
+   * quadword elements. The optional write mask selects the destination
+   * elements to update; stores only support merging.
+   *
+   * @return `*this`
+   * @throws std::bad_alloc if out of memory
+   * @throws std::invalid_argument if a write mask or broadcast is not
+   *         supported by the instruction
+   */
+
+  /**
+   * @class emit_opmask_instruction
+   *
+   * @return `*this`
+   * @throws std::bad_alloc if out of memory
+   */
+
+  /**
+   * Emits a `KANDNQ` (bitwise AND NOT of 64-bit opmasks) instruction.
+   *
+   * @copydetails emit_opmask_instruction
+   */
+  x86_emitter& kandnq(const x86_kreg dst, const x86_kreg src1, const x86_kreg src2) {
+    return encode_vex(size256 | size64, vex_none, map_0f, 0x42, code_of(dst), code_of(src1), code_of(src2));
+  }
+
+  /**
+   * Emits a `KANDNW` (bitwise AND NOT of 16-bit opmasks) instruction.
+   *
+   * @copydetails emit_opmask_instruction
+   */
+  x86_emitter& kandnw(const x86_kreg dst, const x86_kreg src1, const x86_kreg src2) {
+    return encode_vex(size256, vex_none, map_0f, 0x42, code_of(dst), code_of(src1), code_of(src2));
+  }
+
+  /**
+   * Emits a `KANDQ` (bitwise AND of 64-bit opmasks) instruction.
+   *
+   * @copydetails emit_opmask_instruction
+   */
+  x86_emitter& kandq(const x86_kreg dst, const x86_kreg src1, const x86_kreg src2) {
+    return encode_vex(size256 | size64, vex_none, map_0f, 0x41, code_of(dst), code_of(src1), code_of(src2));
+  }
+
+  /**
+   * Emits a `KANDW` (bitwise AND of 16-bit opmasks) instruction.
+   *
+   * @copydetails emit_opmask_instruction
+   */
+  x86_emitter& kandw(const x86_kreg dst, const x86_kreg src1, const x86_kreg src2) {
+    return encode_vex(size256, vex_none, map_0f, 0x41, code_of(dst), code_of(src1), code_of(src2));
+  }
+
+  /**
+   * Emits a `KMOVB` (move an 8-bit opmask) instruction.
+   *
+   * @copydetails emit_opmask_instruction
+   */
+  x86_emitter& kmovb(const x86_kreg dst, const x86_kreg src) {
+    return encode_vex(size128, vex_66, map_0f, 0x90, code_of(dst), 0, code_of(src));
+  }
+
+  /**
+   * Emits a `KMOVB` (load an 8-bit opmask) instruction.
+   *
+   * @copydetails emit_opmask_instruction
+   */
+  x86_emitter& kmovb(const x86_kreg dst, const x86_mem& src) {
+    return encode_vex(size128, vex_66, map_0f, 0x90, code_of(dst), 0, src);
+  }
+
+  /**
+   * Emits a `KMOVB` (store an 8-bit opmask) instruction.
+   *
+   * @copydetails emit_opmask_instruction
+   */
+  x86_emitter& kmovb(const x86_mem& dst, const x86_kreg src) {
+    return encode_vex(size128, vex_66, map_0f, 0x91, code_of(src), 0, dst);
+  }
+
+  /**
+   * Emits a `KMOVB` (move an 8-bit opmask from a general-purpose register) instruction.
+   *
+   * @copydetails emit_opmask_instruction
+   */
+  x86_emitter& kmovb(const x86_kreg dst, const x86_reg32 src) {
+    return encode_vex(size128, vex_66, map_0f, 0x92, code_of(dst), 0, code_of(src));
+  }
+
+  /**
+   * Emits a `KMOVB` (move an 8-bit opmask to a general-purpose register) instruction.
+   *
+   * @copydetails emit_opmask_instruction
+   */
+  x86_emitter& kmovb(const x86_reg32 dst, const x86_kreg src) {
+    return encode_vex(size128, vex_66, map_0f, 0x93, code_of(dst), 0, code_of(src));
+  }
+
+  /**
+   * Emits a `KMOVD` (move a 32-bit opmask) instruction.
+   *
+   * @copydetails emit_opmask_instruction
+   */
+  x86_emitter& kmovd(const x86_kreg dst, const x86_kreg src) {
+    return encode_vex(size64, vex_66, map_0f, 0x90, code_of(dst), 0, code_of(src));
+  }
+
+  /**
+   * Emits a `KMOVD` (load a 32-bit opmask) instruction.
+   *
+   * @copydetails emit_opmask_instruction
+   */
+  x86_emitter& kmovd(const x86_kreg dst, const x86_mem& src) {
+    return encode_vex(size64, vex_66, map_0f, 0x90, code_of(dst), 0, src);
+  }
+
+  /**
+   * Emits a `KMOVD` (store a 32-bit opmask) instruction.
+   *
+   * @copydetails emit_opmask_instruction
+   */
+  x86_emitter& kmovd(const x86_mem& dst, const x86_kreg src) {
+    return encode_vex(size64, vex_66, map_0f, 0x91, code_of(src), 0, dst);
+  }
+
+  /**
+   * Emits a `KMOVD` (move a 32-bit opmask from a general-purpose register) instruction.
+   *
+   * @copydetails emit_opmask_instruction
+   */
+  x86_emitter& kmovd(const x86_kreg dst, const x86_reg32 src) {
+    return encode_vex(size128, vex_f2, map_0f, 0x92, code_of(dst), 0, code_of(src));
+  }
+
+  /**
+   * Emits a `KMOVD` (move a 32-bit opmask to a general-purpose register) instruction.
+   *
+   * @copydetails emit_opmask_instruction
+   */
+  x86_emitter& kmovd(const x86_reg32 dst, const x86_kreg src) {
+    return encode_vex(size128, vex_f2, map_0f, 0x93, code_of(dst), 0, code_of(src));
+  }
+
+  /**
+   * Emits a `KMOVQ` (move a 64-bit opmask) instruction.
+   *
+   * @copydetails emit_opmask_instruction
+   */
+  x86_emitter& kmovq(const x86_kreg dst, const x86_kreg src) {
+    return encode_vex(size64, vex_none, map_0f, 0x90, code_of(dst), 0, code_of(src));
+  }
+
+  /**
+   * Emits a `KMOVQ` (load a 64-bit opmask) instruction.
+   *
+   * @copydetails emit_opmask_instruction
+   */
+  x86_emitter& kmovq(const x86_kreg dst, const x86_mem& src) {
+    return encode_vex(size64, vex_none, map_0f, 0x90, code_of(dst), 0, src);
+  }
+
+  /**
+   * Emits a `KMOVQ` (store a 64-bit opmask) instruction.
+   *
+   * @copydetails emit_opmask_instruction
+   */
+  x86_emitter& kmovq(const x86_mem& dst, const x86_kreg src) {
+    return encode_vex(size64, vex_none, map_0f, 0x91, code_of(src), 0, dst);
+  }
+
+  /**
+   * Emits a `KMOVQ` (move a 64-bit opmask from a general-purpose register) instruction.
+   *
+   * @copydetails emit_opmask_instruction
+   */
+  x86_emitter& kmovq(const x86_kreg dst, const x86_reg64 src) {
+    return encode_vex(size64, vex_f2, map_0f, 0x92, code_of(dst), 0, code_of(src));
+  }
+
+  /**
+   * Emits a `KMOVQ` (move a 64-bit opmask to a general-purpose register) instruction.
+   *
+   * @copydetails emit_opmask_instruction
+   */
+  x86_emitter& kmovq(const x86_reg64 dst, const x86_kreg src) {
+    return encode_vex(size64, vex_f2, map_0f, 0x93, code_of(dst), 0, code_of(src));
+  }
+
+  /**
+   * Emits a `KMOVW` (move a 16-bit opmask) instruction.
+   *
+   * @copydetails emit_opmask_instruction
+   */
+  x86_emitter& kmovw(const x86_kreg dst, const x86_kreg src) {
+    return encode_vex(size128, vex_none, map_0f, 0x90, code_of(dst), 0, code_of(src));
+  }
+
+  /**
+   * Emits a `KMOVW` (load a 16-bit opmask) instruction.
+   *
+   * @copydetails emit_opmask_instruction
+   */
+  x86_emitter& kmovw(const x86_kreg dst, const x86_mem& src) {
+    return encode_vex(size128, vex_none, map_0f, 0x90, code_of(dst), 0, src);
+  }
+
+  /**
+   * Emits a `KMOVW` (store a 16-bit opmask) instruction.
+   *
+   * @copydetails emit_opmask_instruction
+   */
+  x86_emitter& kmovw(const x86_mem& dst, const x86_kreg src) {
+    return encode_vex(size128, vex_none, map_0f, 0x91, code_of(src), 0, dst);
+  }
+
+  /**
+   * Emits a `KMOVW` (move a 16-bit opmask from a general-purpose register) instruction.
+   *
+   * @copydetails emit_opmask_instruction
+   */
+  x86_emitter& kmovw(const x86_kreg dst, const x86_reg32 src) {
+    return encode_vex(size128, vex_none, map_0f, 0x92, code_of(dst), 0, code_of(src));
+  }
+
+  /**
+   * Emits a `KMOVW` (move a 16-bit opmask to a general-purpose register) instruction.
+   *
+   * @copydetails emit_opmask_instruction
+   */
+  x86_emitter& kmovw(const x86_reg32 dst, const x86_kreg src) {
+    return encode_vex(size128, vex_none, map_0f, 0x93, code_of(dst), 0, code_of(src));
+  }
+
+  /**
+   * Emits a `KNOTQ` (bitwise NOT of a 64-bit opmask) instruction.
+   *
+   * @copydetails emit_opmask_instruction
+   */
+  x86_emitter& knotq(const x86_kreg dst, const x86_kreg src) {
+    return encode_vex(size64, vex_none, map_0f, 0x44, code_of(dst), 0, code_of(src));
+  }
+
+  /**
+   * Emits a `KNOTW` (bitwise NOT of a 16-bit opmask) instruction.
+   *
+   * @copydetails emit_opmask_instruction
+   */
+  x86_emitter& knotw(const x86_kreg dst, const x86_kreg src) {
+    return encode_vex(size128, vex_none, map_0f, 0x44, code_of(dst), 0, code_of(src));
+  }
+
+  /**
+   * Emits a `KORQ` (bitwise OR of 64-bit opmasks) instruction.
+   *
+   * @copydetails emit_opmask_instruction
+   */
+  x86_emitter& korq(const x86_kreg dst, const x86_kreg src1, const x86_kreg src2) {
+    return encode_vex(size256 | size64, vex_none, map_0f, 0x45, code_of(dst), code_of(src1), code_of(src2));
+  }
+
+  /**
+   * Emits a `KORTESTQ` (OR and test, setting ZF and CF from 64-bit opmasks) instruction.
+   *
+   * @copydetails emit_opmask_instruction
+   */
+  x86_emitter& kortestq(const x86_kreg dst, const x86_kreg src) {
+    return encode_vex(size64, vex_none, map_0f, 0x98, code_of(dst), 0, code_of(src));
+  }
+
+  /**
+   * Emits a `KORTESTW` (OR and test, setting ZF and CF from 16-bit opmasks) instruction.
+   *
+   * @copydetails emit_opmask_instruction
+   */
+  x86_emitter& kortestw(const x86_kreg dst, const x86_kreg src) {
+    return encode_vex(size128, vex_none, map_0f, 0x98, code_of(dst), 0, code_of(src));
+  }
+
+  /**
+   * Emits a `KORW` (bitwise OR of 16-bit opmasks) instruction.
+   *
+   * @copydetails emit_opmask_instruction
+   */
+  x86_emitter& korw(const x86_kreg dst, const x86_kreg src1, const x86_kreg src2) {
+    return encode_vex(size256, vex_none, map_0f, 0x45, code_of(dst), code_of(src1), code_of(src2));
+  }
+
+  /**
+   * Emits a `KXORQ` (bitwise exclusive OR of 64-bit opmasks) instruction.
+   *
+   * @copydetails emit_opmask_instruction
+   */
+  x86_emitter& kxorq(const x86_kreg dst, const x86_kreg src1, const x86_kreg src2) {
+    return encode_vex(size256 | size64, vex_none, map_0f, 0x47, code_of(dst), code_of(src1), code_of(src2));
+  }
+
+  /**
+   * Emits a `KXORW` (bitwise exclusive OR of 16-bit opmasks) instruction.
+   *
+   * @copydetails emit_opmask_instruction
+   */
+  x86_emitter& kxorw(const x86_kreg dst, const x86_kreg src1, const x86_kreg src2) {
+    return encode_vex(size256, vex_none, map_0f, 0x47, code_of(dst), code_of(src1), code_of(src2));
+  }
+
+  /**
+   * Emits a `VALIGND` (concatenate and shift right by doublewords) instruction.
+   *
+   * @copydetails emit_avx512_instruction
+   */
+  template <typename Vec, typename Src>
+  x86_emitter& valignd(const Vec dst, const Vec src1, const Src& src2, const x86_imm8 imm, const x86_mask mask = x86_mask()) {
+    return encode_evex({vex_66, map_0f3a, 0x03, 0, tuple_fv, 0}, flags_of(dst), code_of(dst), code_of(src1), rm_of(src2), mask, 1, imm.u8);
+  }
+
+  /**
+   * Emits a `VALIGNQ` (concatenate and shift right by quadwords) instruction.
+   *
+   * @copydetails emit_avx512_instruction
+   */
+  template <typename Vec, typename Src>
+  x86_emitter& valignq(const Vec dst, const Vec src1, const Src& src2, const x86_imm8 imm, const x86_mask mask = x86_mask()) {
+    return encode_evex({vex_66, map_0f3a, 0x03, 0, tuple_fv, 1}, flags_of(dst), code_of(dst), code_of(src1), rm_of(src2), mask, 1, imm.u8);
+  }
+
+  /**
+   * Emits a `VCMPPD` (compare packed double-precision values into an opmask) instruction.
+   *
+   * @copydetails emit_avx512_instruction
+   */
+  template <typename Vec, typename Src>
+  x86_emitter& vcmppd(const x86_kreg dst, const Vec src1, const Src& src2, const x86_imm8 imm, const x86_mask mask = x86_mask()) {
+    return encode_evex({vex_66, map_0f, 0xC2, 0, tuple_fv, 1}, flags_of(src1), code_of(dst), code_of(src1), rm_of(src2), mask, 1, imm.u8);
+  }
+
+  /**
+   * Emits a `VCMPPS` (compare packed single-precision values into an opmask) instruction.
+   *
+   * @copydetails emit_avx512_instruction
+   */
+  template <typename Vec, typename Src>
+  x86_emitter& vcmpps(const x86_kreg dst, const Vec src1, const Src& src2, const x86_imm8 imm, const x86_mask mask = x86_mask()) {
+    return encode_evex({vex_none, map_0f, 0xC2, 0, tuple_fv, 0}, flags_of(src1), code_of(dst), code_of(src1), rm_of(src2), mask, 1, imm.u8);
+  }
+
+  /**
+   * Emits a `VEXTRACTI32X4` (extract 128 bits of packed doublewords) instruction.
+   *
+   * @copydetails emit_avx512_instruction
+   */
+  template <typename Dst, typename Vec>
+  x86_emitter& vextracti32x4(const Dst& dst, const Vec src, const x86_imm8 imm, const x86_mask mask = x86_mask()) {
+    return encode_evex({vex_66, map_0f3a, 0x39, 0, tuple_t4, 0}, flags_of(src), code_of(src), 0, rm_of(dst), mask, 1, imm.u8);
+  }
+
+  /**
+   * Emits a `VEXTRACTI64X4` (extract 256 bits of packed quadwords) instruction.
+   *
+   * @copydetails emit_avx512_instruction
+   */
+  template <typename Dst, typename Vec>
+  x86_emitter& vextracti64x4(const Dst& dst, const Vec src, const x86_imm8 imm, const x86_mask mask = x86_mask()) {
+    return encode_evex({vex_66, map_0f3a, 0x3B, 0, tuple_t8, 1}, flags_of(src), code_of(src), 0, rm_of(dst), mask, 1, imm.u8);
+  }
+
+  /**
+   * Emits a `VINSERTI32X4` (insert 128 bits of packed doublewords) instruction.
+   *
+   * @copydetails emit_avx512_instruction
+   */
+  template <typename Vec, typename Src>
+  x86_emitter& vinserti32x4(const Vec dst, const Vec src1, const Src& src2, const x86_imm8 imm, const x86_mask mask = x86_mask()) {
+    return encode_evex({vex_66, map_0f3a, 0x38, 0, tuple_t4, 0}, flags_of(dst), code_of(dst), code_of(src1), rm_of(src2), mask, 1, imm.u8);
+  }
+
+  /**
+   * Emits a `VINSERTI64X4` (insert 256 bits of packed quadwords) instruction.
+   *
+   * @copydetails emit_avx512_instruction
+   */
+  template <typename Vec, typename Src>
+  x86_emitter& vinserti64x4(const Vec dst, const Vec src1, const Src& src2, const x86_imm8 imm, const x86_mask mask = x86_mask()) {
+    return encode_evex({vex_66, map_0f3a, 0x3A, 0, tuple_t8, 1}, flags_of(dst), code_of(dst), code_of(src1), rm_of(src2), mask, 1, imm.u8);
+  }
+
+  /**
+   * Emits a `VMOVDQA32` (move aligned packed doublewords, loading) instruction.
+   *
+   * @copydetails emit_avx512_instruction
+   */
+  template <typename Vec, typename Src>
+  x86_emitter& vmovdqa32(const Vec dst, const Src& src, const x86_mask mask = x86_mask()) {
+    return encode_evex({vex_66, map_0f, 0x6F, 0, tuple_fvm, 0}, flags_of(dst), code_of(dst), 0, rm_of(src), mask);
+  }
+
+  /**
+   * Emits a `VMOVDQA32` (move aligned packed doublewords, storing) instruction.
+   *
+   * @copydetails emit_avx512_instruction
+   */
+  template <typename Vec>
+  x86_emitter& vmovdqa32(const x86_mem& dst, const Vec src, const x86_mask mask = x86_mask()) {
+    return encode_evex({vex_66, map_0f, 0x7F, 0, tuple_fvm, 0}, flags_of(src), code_of(src), 0, dst, store_mask(mask));
+  }
+
+  /**
+   * Emits a `VMOVDQA64` (move aligned packed quadwords, loading) instruction.
+   *
+   * @copydetails emit_avx512_instruction
+   */
+  template <typename Vec, typename Src>
+  x86_emitter& vmovdqa64(const Vec dst, const Src& src, const x86_mask mask = x86_mask()) {
+    return encode_evex({vex_66, map_0f, 0x6F, 0, tuple_fvm, 1}, flags_of(dst), code_of(dst), 0, rm_of(src), mask);
+  }
+
+  /**
+   * Emits a `VMOVDQA64` (move aligned packed quadwords, storing) instruction.
+   *
+   * @copydetails emit_avx512_instruction
+   */
+  template <typename Vec>
+  x86_emitter& vmovdqa64(const x86_mem& dst, const Vec src, const x86_mask mask = x86_mask()) {
+    return encode_evex({vex_66, map_0f, 0x7F, 0, tuple_fvm, 1}, flags_of(src), code_of(src), 0, dst, store_mask(mask));
+  }
+
+  /**
+   * Emits a `VMOVDQU16` (move unaligned packed words, loading) instruction.
+   *
+   * @copydetails emit_avx512_instruction
+   */
+  template <typename Vec, typename Src>
+  x86_emitter& vmovdqu16(const Vec dst, const Src& src, const x86_mask mask = x86_mask()) {
+    return encode_evex({vex_f2, map_0f, 0x6F, 0, tuple_fvm, 1}, flags_of(dst), code_of(dst), 0, rm_of(src), mask);
+  }
+
+  /**
+   * Emits a `VMOVDQU16` (move unaligned packed words, storing) instruction.
+   *
+   * @copydetails emit_avx512_instruction
+   */
+  template <typename Vec>
+  x86_emitter& vmovdqu16(const x86_mem& dst, const Vec src, const x86_mask mask = x86_mask()) {
+    return encode_evex({vex_f2, map_0f, 0x7F, 0, tuple_fvm, 1}, flags_of(src), code_of(src), 0, dst, store_mask(mask));
+  }
+
+  /**
+   * Emits a `VMOVDQU32` (move unaligned packed doublewords, loading) instruction.
+   *
+   * @copydetails emit_avx512_instruction
+   */
+  template <typename Vec, typename Src>
+  x86_emitter& vmovdqu32(const Vec dst, const Src& src, const x86_mask mask = x86_mask()) {
+    return encode_evex({vex_f3, map_0f, 0x6F, 0, tuple_fvm, 0}, flags_of(dst), code_of(dst), 0, rm_of(src), mask);
+  }
+
+  /**
+   * Emits a `VMOVDQU32` (move unaligned packed doublewords, storing) instruction.
+   *
+   * @copydetails emit_avx512_instruction
+   */
+  template <typename Vec>
+  x86_emitter& vmovdqu32(const x86_mem& dst, const Vec src, const x86_mask mask = x86_mask()) {
+    return encode_evex({vex_f3, map_0f, 0x7F, 0, tuple_fvm, 0}, flags_of(src), code_of(src), 0, dst, store_mask(mask));
+  }
+
+  /**
+   * Emits a `VMOVDQU64` (move unaligned packed quadwords, loading) instruction.
+   *
+   * @copydetails emit_avx512_instruction
+   */
+  template <typename Vec, typename Src>
+  x86_emitter& vmovdqu64(const Vec dst, const Src& src, const x86_mask mask = x86_mask()) {
+    return encode_evex({vex_f3, map_0f, 0x6F, 0, tuple_fvm, 1}, flags_of(dst), code_of(dst), 0, rm_of(src), mask);
+  }
+
+  /**
+   * Emits a `VMOVDQU64` (move unaligned packed quadwords, storing) instruction.
+   *
+   * @copydetails emit_avx512_instruction
+   */
+  template <typename Vec>
+  x86_emitter& vmovdqu64(const x86_mem& dst, const Vec src, const x86_mask mask = x86_mask()) {
+    return encode_evex({vex_f3, map_0f, 0x7F, 0, tuple_fvm, 1}, flags_of(src), code_of(src), 0, dst, store_mask(mask));
+  }
+
+  /**
+   * Emits a `VMOVDQU8` (move unaligned packed bytes, loading) instruction.
+   *
+   * @copydetails emit_avx512_instruction
+   */
+  template <typename Vec, typename Src>
+  x86_emitter& vmovdqu8(const Vec dst, const Src& src, const x86_mask mask = x86_mask()) {
+    return encode_evex({vex_f2, map_0f, 0x6F, 0, tuple_fvm, 0}, flags_of(dst), code_of(dst), 0, rm_of(src), mask);
+  }
+
+  /**
+   * Emits a `VMOVDQU8` (move unaligned packed bytes, storing) instruction.
+   *
+   * @copydetails emit_avx512_instruction
+   */
+  template <typename Vec>
+  x86_emitter& vmovdqu8(const x86_mem& dst, const Vec src, const x86_mask mask = x86_mask()) {
+    return encode_evex({vex_f2, map_0f, 0x7F, 0, tuple_fvm, 0}, flags_of(src), code_of(src), 0, dst, store_mask(mask));
+  }
+
+  /**
+   * Emits a `VPABSQ` (absolute value of packed quadwords) instruction.
+   *
+   * @copydetails emit_avx512_instruction
+   */
+  template <typename Vec, typename Src>
+  x86_emitter& vpabsq(const Vec dst, const Src& src, const x86_mask mask = x86_mask()) {
+    return encode_evex({vex_66, map_0f38, 0x1F, 0, tuple_fv, 1}, flags_of(dst), code_of(dst), 0, rm_of(src), mask);
+  }
+
+  /**
+   * Emits a `VPANDD` (bitwise AND of packed doublewords) instruction.
+   *
+   * @copydetails emit_avx512_instruction
+   */
+  template <typename Vec, typename Src>
+  x86_emitter& vpandd(const Vec dst, const Vec src1, const Src& src2, const x86_mask mask = x86_mask()) {
+    return encode_evex({vex_66, map_0f, 0xDB, 0, tuple_fv, 0}, flags_of(dst), code_of(dst), code_of(src1), rm_of(src2), mask);
+  }
+
+  /**
+   * Emits a `VPANDND` (bitwise AND NOT of packed doublewords) instruction.
+   *
+   * @copydetails emit_avx512_instruction
+   */
+  template <typename Vec, typename Src>
+  x86_emitter& vpandnd(const Vec dst, const Vec src1, const Src& src2, const x86_mask mask = x86_mask()) {
+    return encode_evex({vex_66, map_0f, 0xDF, 0, tuple_fv, 0}, flags_of(dst), code_of(dst), code_of(src1), rm_of(src2), mask);
+  }
+
+  /**
+   * Emits a `VPANDNQ` (bitwise AND NOT of packed quadwords) instruction.
+   *
+   * @copydetails emit_avx512_instruction
+   */
+  template <typename Vec, typename Src>
+  x86_emitter& vpandnq(const Vec dst, const Vec src1, const Src& src2, const x86_mask mask = x86_mask()) {
+    return encode_evex({vex_66, map_0f, 0xDF, 0, tuple_fv, 1}, flags_of(dst), code_of(dst), code_of(src1), rm_of(src2), mask);
+  }
+
+  /**
+   * Emits a `VPANDQ` (bitwise AND of packed quadwords) instruction.
+   *
+   * @copydetails emit_avx512_instruction
+   */
+  template <typename Vec, typename Src>
+  x86_emitter& vpandq(const Vec dst, const Vec src1, const Src& src2, const x86_mask mask = x86_mask()) {
+    return encode_evex({vex_66, map_0f, 0xDB, 0, tuple_fv, 1}, flags_of(dst), code_of(dst), code_of(src1), rm_of(src2), mask);
+  }
+
+  /**
+   * Emits a `VPBLENDMD` (blend packed doublewords by an opmask) instruction.
+   *
+   * @copydetails emit_avx512_instruction
+   */
+  template <typename Vec, typename Src>
+  x86_emitter& vpblendmd(const Vec dst, const Vec src1, const Src& src2, const x86_mask mask = x86_mask()) {
+    return encode_evex({vex_66, map_0f38, 0x64, 0, tuple_fv, 0}, flags_of(dst), code_of(dst), code_of(src1), rm_of(src2), mask);
+  }
+
+  /**
+   * Emits a `VPBLENDMQ` (blend packed quadwords by an opmask) instruction.
+   *
+   * @copydetails emit_avx512_instruction
+   */
+  template <typename Vec, typename Src>
+  x86_emitter& vpblendmq(const Vec dst, const Vec src1, const Src& src2, const x86_mask mask = x86_mask()) {
+    return encode_evex({vex_66, map_0f38, 0x64, 0, tuple_fv, 1}, flags_of(dst), code_of(dst), code_of(src1), rm_of(src2), mask);
+  }
+
+  /**
+   * Emits a `VPCMPB` (compare packed signed bytes by a predicate into an opmask) instruction.
+   *
+   * @copydetails emit_avx512_instruction
+   */
+  template <typename Vec, typename Src>
+  x86_emitter& vpcmpb(const x86_kreg dst, const Vec src1, const Src& src2, const x86_imm8 imm, const x86_mask mask = x86_mask()) {
+    return encode_evex({vex_66, map_0f3a, 0x3F, 0, tuple_fvm, 0}, flags_of(src1), code_of(dst), code_of(src1), rm_of(src2), mask, 1, imm.u8);
+  }
+
+  /**
+   * Emits a `VPCMPD` (compare packed signed doublewords by a predicate into an opmask) instruction.
+   *
+   * @copydetails emit_avx512_instruction
+   */
+  template <typename Vec, typename Src>
+  x86_emitter& vpcmpd(const x86_kreg dst, const Vec src1, const Src& src2, const x86_imm8 imm, const x86_mask mask = x86_mask()) {
+    return encode_evex({vex_66, map_0f3a, 0x1F, 0, tuple_fv, 0}, flags_of(src1), code_of(dst), code_of(src1), rm_of(src2), mask, 1, imm.u8);
+  }
+
+  /**
+   * Emits a `VPCMPEQB` (compare packed bytes for equality into an opmask) instruction.
+   *
+   * @copydetails emit_avx512_instruction
+   */
+  template <typename Vec, typename Src>
+  x86_emitter& vpcmpeqb(const x86_kreg dst, const Vec src1, const Src& src2, const x86_mask mask = x86_mask()) {
+    return encode_evex({vex_66, map_0f, 0x74, 0, tuple_fvm, 0}, flags_of(src1), code_of(dst), code_of(src1), rm_of(src2), mask);
+  }
+
+  /**
+   * Emits a `VPCMPEQD` (compare packed doublewords for equality into an opmask) instruction.
+   *
+   * @copydetails emit_avx512_instruction
+   */
+  template <typename Vec, typename Src>
+  x86_emitter& vpcmpeqd(const x86_kreg dst, const Vec src1, const Src& src2, const x86_mask mask = x86_mask()) {
+    return encode_evex({vex_66, map_0f, 0x76, 0, tuple_fv, 0}, flags_of(src1), code_of(dst), code_of(src1), rm_of(src2), mask);
+  }
+
+  /**
+   * Emits a `VPCMPEQQ` (compare packed quadwords for equality into an opmask) instruction.
+   *
+   * @copydetails emit_avx512_instruction
+   */
+  template <typename Vec, typename Src>
+  x86_emitter& vpcmpeqq(const x86_kreg dst, const Vec src1, const Src& src2, const x86_mask mask = x86_mask()) {
+    return encode_evex({vex_66, map_0f38, 0x29, 0, tuple_fv, 1}, flags_of(src1), code_of(dst), code_of(src1), rm_of(src2), mask);
+  }
+
+  /**
+   * Emits a `VPCMPGTB` (compare packed signed bytes for greater than into an opmask) instruction.
+   *
+   * @copydetails emit_avx512_instruction
+   */
+  template <typename Vec, typename Src>
+  x86_emitter& vpcmpgtb(const x86_kreg dst, const Vec src1, const Src& src2, const x86_mask mask = x86_mask()) {
+    return encode_evex({vex_66, map_0f, 0x64, 0, tuple_fvm, 0}, flags_of(src1), code_of(dst), code_of(src1), rm_of(src2), mask);
+  }
+
+  /**
+   * Emits a `VPCMPGTD` (compare packed signed doublewords for greater than into an opmask) instruction.
+   *
+   * @copydetails emit_avx512_instruction
+   */
+  template <typename Vec, typename Src>
+  x86_emitter& vpcmpgtd(const x86_kreg dst, const Vec src1, const Src& src2, const x86_mask mask = x86_mask()) {
+    return encode_evex({vex_66, map_0f, 0x66, 0, tuple_fv, 0}, flags_of(src1), code_of(dst), code_of(src1), rm_of(src2), mask);
+  }
+
+  /**
+   * Emits a `VPCMPGTQ` (compare packed signed quadwords for greater than into an opmask) instruction.
+   *
+   * @copydetails emit_avx512_instruction
+   */
+  template <typename Vec, typename Src>
+  x86_emitter& vpcmpgtq(const x86_kreg dst, const Vec src1, const Src& src2, const x86_mask mask = x86_mask()) {
+    return encode_evex({vex_66, map_0f38, 0x37, 0, tuple_fv, 1}, flags_of(src1), code_of(dst), code_of(src1), rm_of(src2), mask);
+  }
+
+  /**
+   * Emits a `VPCMPQ` (compare packed signed quadwords by a predicate into an opmask) instruction.
+   *
+   * @copydetails emit_avx512_instruction
+   */
+  template <typename Vec, typename Src>
+  x86_emitter& vpcmpq(const x86_kreg dst, const Vec src1, const Src& src2, const x86_imm8 imm, const x86_mask mask = x86_mask()) {
+    return encode_evex({vex_66, map_0f3a, 0x1F, 0, tuple_fv, 1}, flags_of(src1), code_of(dst), code_of(src1), rm_of(src2), mask, 1, imm.u8);
+  }
+
+  /**
+   * Emits a `VPCMPUB` (compare packed unsigned bytes by a predicate into an opmask) instruction.
+   *
+   * @copydetails emit_avx512_instruction
+   */
+  template <typename Vec, typename Src>
+  x86_emitter& vpcmpub(const x86_kreg dst, const Vec src1, const Src& src2, const x86_imm8 imm, const x86_mask mask = x86_mask()) {
+    return encode_evex({vex_66, map_0f3a, 0x3E, 0, tuple_fvm, 0}, flags_of(src1), code_of(dst), code_of(src1), rm_of(src2), mask, 1, imm.u8);
+  }
+
+  /**
+   * Emits a `VPCMPUD` (compare packed unsigned doublewords by a predicate into an opmask) instruction.
+   *
+   * @copydetails emit_avx512_instruction
+   */
+  template <typename Vec, typename Src>
+  x86_emitter& vpcmpud(const x86_kreg dst, const Vec src1, const Src& src2, const x86_imm8 imm, const x86_mask mask = x86_mask()) {
+    return encode_evex({vex_66, map_0f3a, 0x1E, 0, tuple_fv, 0}, flags_of(src1), code_of(dst), code_of(src1), rm_of(src2), mask, 1, imm.u8);
+  }
+
+  /**
+   * Emits a `VPCMPUQ` (compare packed unsigned quadwords by a predicate into an opmask) instruction.
+   *
+   * @copydetails emit_avx512_instruction
+   */
+  template <typename Vec, typename Src>
+  x86_emitter& vpcmpuq(const x86_kreg dst, const Vec src1, const Src& src2, const x86_imm8 imm, const x86_mask mask = x86_mask()) {
+    return encode_evex({vex_66, map_0f3a, 0x1E, 0, tuple_fv, 1}, flags_of(src1), code_of(dst), code_of(src1), rm_of(src2), mask, 1, imm.u8);
+  }
+
+  /**
+   * Emits a `VPCOMPRESSD` (store the active doublewords contiguously) instruction.
+   *
+   * @copydetails emit_avx512_instruction
+   */
+  template <typename Dst, typename Vec>
+  x86_emitter& vpcompressd(const Dst& dst, const Vec src, const x86_mask mask = x86_mask()) {
+    return encode_evex({vex_66, map_0f38, 0x8B, 0, tuple_t1s4, 0}, flags_of(src), code_of(src), 0, rm_of(dst), mask);
+  }
+
+  /**
+   * Emits a `VPCOMPRESSQ` (store the active quadwords contiguously) instruction.
+   *
+   * @copydetails emit_avx512_instruction
+   */
+  template <typename Dst, typename Vec>
+  x86_emitter& vpcompressq(const Dst& dst, const Vec src, const x86_mask mask = x86_mask()) {
+    return encode_evex({vex_66, map_0f38, 0x8B, 0, tuple_t1s8, 1}, flags_of(src), code_of(src), 0, rm_of(dst), mask);
+  }
+
+  /**
+   * Emits a `VPERMT2D` (permute doublewords from two tables, overwriting the first) instruction.
+   *
+   * @copydetails emit_avx512_instruction
+   */
+  template <typename Vec, typename Src>
+  x86_emitter& vpermt2d(const Vec dst, const Vec src1, const Src& src2, const x86_mask mask = x86_mask()) {
+    return encode_evex({vex_66, map_0f38, 0x7E, 0, tuple_fv, 0}, flags_of(dst), code_of(dst), code_of(src1), rm_of(src2), mask);
+  }
+
+  /**
+   * Emits a `VPERMT2Q` (permute quadwords from two tables, overwriting the first) instruction.
+   *
+   * @copydetails emit_avx512_instruction
+   */
+  template <typename Vec, typename Src>
+  x86_emitter& vpermt2q(const Vec dst, const Vec src1, const Src& src2, const x86_mask mask = x86_mask()) {
+    return encode_evex({vex_66, map_0f38, 0x7E, 0, tuple_fv, 1}, flags_of(dst), code_of(dst), code_of(src1), rm_of(src2), mask);
+  }
+
+  /**
+   * Emits a `VPEXPANDD` (load contiguous doublewords into the active elements) instruction.
+   *
+   * @copydetails emit_avx512_instruction
+   */
+  template <typename Vec, typename Src>
+  x86_emitter& vpexpandd(const Vec dst, const Src& src, const x86_mask mask = x86_mask()) {
+    return encode_evex({vex_66, map_0f38, 0x89, 0, tuple_t1s4, 0}, flags_of(dst), code_of(dst), 0, rm_of(src), mask);
+  }
+
+  /**
+   * Emits a `VPEXPANDQ` (load contiguous quadwords into the active elements) instruction.
+   *
+   * @copydetails emit_avx512_instruction
+   */
+  template <typename Vec, typename Src>
+  x86_emitter& vpexpandq(const Vec dst, const Src& src, const x86_mask mask = x86_mask()) {
+    return encode_evex({vex_66, map_0f38, 0x89, 0, tuple_t1s8, 1}, flags_of(dst), code_of(dst), 0, rm_of(src), mask);
+  }
+
+  /**
+   * Emits a `VPMAXSQ` (maximum of packed signed quadwords) instruction.
+   *
+   * @copydetails emit_avx512_instruction
+   */
+  template <typename Vec, typename Src>
+  x86_emitter& vpmaxsq(const Vec dst, const Vec src1, const Src& src2, const x86_mask mask = x86_mask()) {
+    return encode_evex({vex_66, map_0f38, 0x3D, 0, tuple_fv, 1}, flags_of(dst), code_of(dst), code_of(src1), rm_of(src2), mask);
+  }
+
+  /**
+   * Emits a `VPMAXUQ` (maximum of packed unsigned quadwords) instruction.
+   *
+   * @copydetails emit_avx512_instruction
+   */
+  template <typename Vec, typename Src>
+  x86_emitter& vpmaxuq(const Vec dst, const Vec src1, const Src& src2, const x86_mask mask = x86_mask()) {
+    return encode_evex({vex_66, map_0f38, 0x3F, 0, tuple_fv, 1}, flags_of(dst), code_of(dst), code_of(src1), rm_of(src2), mask);
+  }
+
+  /**
+   * Emits a `VPMINSQ` (minimum of packed signed quadwords) instruction.
+   *
+   * @copydetails emit_avx512_instruction
+   */
+  template <typename Vec, typename Src>
+  x86_emitter& vpminsq(const Vec dst, const Vec src1, const Src& src2, const x86_mask mask = x86_mask()) {
+    return encode_evex({vex_66, map_0f38, 0x39, 0, tuple_fv, 1}, flags_of(dst), code_of(dst), code_of(src1), rm_of(src2), mask);
+  }
+
+  /**
+   * Emits a `VPMINUQ` (minimum of packed unsigned quadwords) instruction.
+   *
+   * @copydetails emit_avx512_instruction
+   */
+  template <typename Vec, typename Src>
+  x86_emitter& vpminuq(const Vec dst, const Vec src1, const Src& src2, const x86_mask mask = x86_mask()) {
+    return encode_evex({vex_66, map_0f38, 0x3B, 0, tuple_fv, 1}, flags_of(dst), code_of(dst), code_of(src1), rm_of(src2), mask);
+  }
+
+  /**
+   * Emits a `VPMOVB2M` (gather the sign bits of packed bytes into an opmask) instruction.
+   *
+   * @copydetails emit_avx512_instruction
+   */
+  template <typename Vec>
+  x86_emitter& vpmovb2m(const x86_kreg dst, const Vec src) {
+    return encode_evex({vex_f3, map_0f38, 0x29, 0, tuple_fvm, 0}, flags_of(src), code_of(dst), 0, code_of(src), x86_mask());
+  }
+
+  /**
+   * Emits a `VPMOVD2M` (gather the sign bits of packed doublewords into an opmask) instruction.
+   *
+   * @copydetails emit_avx512_instruction
+   */
+  template <typename Vec>
+  x86_emitter& vpmovd2m(const x86_kreg dst, const Vec src) {
+    return encode_evex({vex_f3, map_0f38, 0x39, 0, tuple_fvm, 0}, flags_of(src), code_of(dst), 0, code_of(src), x86_mask());
+  }
+
+  /**
+   * Emits a `VPMOVDB` (truncate packed doublewords to bytes) instruction.
+   *
+   * @copydetails emit_avx512_instruction
+   */
+  template <typename Dst, typename Vec>
+  x86_emitter& vpmovdb(const Dst& dst, const Vec src, const x86_mask mask = x86_mask()) {
+    return encode_evex({vex_f3, map_0f38, 0x31, 0, tuple_qvm, 0}, flags_of(src), code_of(src), 0, rm_of(dst), mask);
+  }
+
+  /**
+   * Emits a `VPMOVM2B` (expand an opmask into packed bytes) instruction.
+   *
+   * @copydetails emit_avx512_instruction
+   */
+  template <typename Vec>
+  x86_emitter& vpmovm2b(const Vec dst, const x86_kreg src) {
+    return encode_evex({vex_f3, map_0f38, 0x28, 0, tuple_fvm, 0}, flags_of(dst), code_of(dst), 0, code_of(src), x86_mask());
+  }
+
+  /**
+   * Emits a `VPMOVM2D` (expand an opmask into packed doublewords) instruction.
+   *
+   * @copydetails emit_avx512_instruction
+   */
+  template <typename Vec>
+  x86_emitter& vpmovm2d(const Vec dst, const x86_kreg src) {
+    return encode_evex({vex_f3, map_0f38, 0x38, 0, tuple_fvm, 0}, flags_of(dst), code_of(dst), 0, code_of(src), x86_mask());
+  }
+
+  /**
+   * Emits a `VPMOVQD` (truncate packed quadwords to doublewords) instruction.
+   *
+   * @copydetails emit_avx512_instruction
+   */
+  template <typename Dst, typename Vec>
+  x86_emitter& vpmovqd(const Dst& dst, const Vec src, const x86_mask mask = x86_mask()) {
+    return encode_evex({vex_f3, map_0f38, 0x35, 0, tuple_hvm, 0}, flags_of(src), code_of(src), 0, rm_of(dst), mask);
+  }
+
+  /**
+   * Emits a `VPMULLQ` (multiply packed quadwords, keeping the low halves) instruction.
+   *
+   * @copydetails emit_avx512_instruction
+   */
+  template <typename Vec, typename Src>
+  x86_emitter& vpmullq(const Vec dst, const Vec src1, const Src& src2, const x86_mask mask = x86_mask()) {
+    return encode_evex({vex_66, map_0f38, 0x40, 0, tuple_fv, 1}, flags_of(dst), code_of(dst), code_of(src1), rm_of(src2), mask);
+  }
+
+  /**
+   * Emits a `VPORD` (bitwise OR of packed doublewords) instruction.
+   *
+   * @copydetails emit_avx512_instruction
+   */
+  template <typename Vec, typename Src>
+  x86_emitter& vpord(const Vec dst, const Vec src1, const Src& src2, const x86_mask mask = x86_mask()) {
+    return encode_evex({vex_66, map_0f, 0xEB, 0, tuple_fv, 0}, flags_of(dst), code_of(dst), code_of(src1), rm_of(src2), mask);
+  }
+
+  /**
+   * Emits a `VPORQ` (bitwise OR of packed quadwords) instruction.
+   *
+   * @copydetails emit_avx512_instruction
+   */
+  template <typename Vec, typename Src>
+  x86_emitter& vporq(const Vec dst, const Vec src1, const Src& src2, const x86_mask mask = x86_mask()) {
+    return encode_evex({vex_66, map_0f, 0xEB, 0, tuple_fv, 1}, flags_of(dst), code_of(dst), code_of(src1), rm_of(src2), mask);
+  }
+
+  /**
+   * Emits a `VPTERNLOGD` (bitwise ternary logic on packed doublewords) instruction.
+   *
+   * @copydetails emit_avx512_instruction
+   */
+  template <typename Vec, typename Src>
+  x86_emitter& vpternlogd(const Vec dst, const Vec src1, const Src& src2, const x86_imm8 imm, const x86_mask mask = x86_mask()) {
+    return encode_evex({vex_66, map_0f3a, 0x25, 0, tuple_fv, 0}, flags_of(dst), code_of(dst), code_of(src1), rm_of(src2), mask, 1, imm.u8);
+  }
+
+  /**
+   * Emits a `VPTERNLOGQ` (bitwise ternary logic on packed quadwords) instruction.
+   *
+   * @copydetails emit_avx512_instruction
+   */
+  template <typename Vec, typename Src>
+  x86_emitter& vpternlogq(const Vec dst, const Vec src1, const Src& src2, const x86_imm8 imm, const x86_mask mask = x86_mask()) {
+    return encode_evex({vex_66, map_0f3a, 0x25, 0, tuple_fv, 1}, flags_of(dst), code_of(dst), code_of(src1), rm_of(src2), mask, 1, imm.u8);
+  }
+
+  /**
+   * Emits a `VPTESTMD` (set an opmask where the bitwise AND of doublewords is nonzero) instruction.
+   *
+   * @copydetails emit_avx512_instruction
+   */
+  template <typename Vec, typename Src>
+  x86_emitter& vptestmd(const x86_kreg dst, const Vec src1, const Src& src2, const x86_mask mask = x86_mask()) {
+    return encode_evex({vex_66, map_0f38, 0x27, 0, tuple_fv, 0}, flags_of(src1), code_of(dst), code_of(src1), rm_of(src2), mask);
+  }
+
+  /**
+   * Emits a `VPTESTNMD` (set an opmask where the bitwise AND of doublewords is zero) instruction.
+   *
+   * @copydetails emit_avx512_instruction
+   */
+  template <typename Vec, typename Src>
+  x86_emitter& vptestnmd(const x86_kreg dst, const Vec src1, const Src& src2, const x86_mask mask = x86_mask()) {
+    return encode_evex({vex_f3, map_0f38, 0x27, 0, tuple_fv, 0}, flags_of(src1), code_of(dst), code_of(src1), rm_of(src2), mask);
+  }
+
+  /**
+   * Emits a `VPXORD` (bitwise exclusive OR of packed doublewords) instruction.
+   *
+   * @copydetails emit_avx512_instruction
+   */
+  template <typename Vec, typename Src>
+  x86_emitter& vpxord(const Vec dst, const Vec src1, const Src& src2, const x86_mask mask = x86_mask()) {
+    return encode_evex({vex_66, map_0f, 0xEF, 0, tuple_fv, 0}, flags_of(dst), code_of(dst), code_of(src1), rm_of(src2), mask);
+  }
+
+  /**
+   * Emits a `VPXORQ` (bitwise exclusive OR of packed quadwords) instruction.
+   *
+   * @copydetails emit_avx512_instruction
+   */
+  template <typename Vec, typename Src>
+  x86_emitter& vpxorq(const Vec dst, const Vec src1, const Src& src2, const x86_mask mask = x86_mask()) {
+    return encode_evex({vex_66, map_0f, 0xEF, 0, tuple_fv, 1}, flags_of(dst), code_of(dst), code_of(src1), rm_of(src2), mask);
+  }
+
+  /**
+   * Emits a `VSHUFI32X4` (shuffle 128-bit lanes of packed doublewords) instruction.
+   *
+   * @copydetails emit_avx512_instruction
+   */
+  template <typename Vec, typename Src>
+  x86_emitter& vshufi32x4(const Vec dst, const Vec src1, const Src& src2, const x86_imm8 imm, const x86_mask mask = x86_mask()) {
+    return encode_evex({vex_66, map_0f3a, 0x43, 0, tuple_fv, 0}, flags_of(dst), code_of(dst), code_of(src1), rm_of(src2), mask, 1, imm.u8);
+  }
+
+  /**@}*/
+
+protected:
+  /**
+   * @name Operand Encoding
+   *
+   * An instruction is encoded as optional legacy and REX prefixes, the
+   * opcode bytes, a ModRM byte, an optional SIB byte, an optional
+   * displacement, and an optional immediate value. The helpers below
+   * reserve the whole instruction with a single `extend()`.
+   *
+   * Register codes are 4-bit register numbers; bit 4 marks the byte
+   * registers `SPL`, `BPL`, `SIL`, and `DIL`, which require a REX prefix,
+   * and bit 5 marks an opcode extension in place of a register.
+   */
+
+  /**@{*/
+
+  /** Flags describing the operand size and mandatory prefixes of an instruction. */
+  enum operand_flags : unsigned {
+    size8  = 0x01, /* 8-bit operands: codes 4..7 denote AH, CH, DH, BH */
+    size16 = 0x02, /* 16-bit operands: 0x66 prefix */
+    size32 = 0x00, /* 32-bit operands: the default */
+    size64 = 0x08, /* 64-bit operands: REX.W, or VEX.W */
+    size128 = 0x00, /* 128-bit vector operands: the default */
+    size256 = 0x10, /* 256-bit vector operands: VEX.L */
+    size512 = 0x20, /* 512-bit vector operands: EVEX.L'L */
+    prefix_f3 = 0x40, /* a mandatory 0xF3 prefix, as in `POPCNT` */
+    prefix_lock = 0x80, /* a 0xF0 prefix, as requested by `lock()` */
+  };
+
+  static constexpr unsigned flags_of(x86_reg8) noexcept { return size8; }
+  static constexpr unsigned flags_of(x86_reg16) noexcept { return size16; }
+  static constexpr unsigned flags_of(x86_reg32) noexcept { return size32; }
+  static constexpr unsigned flags_of(x86_reg64) noexcept { return size64; }
+  static constexpr unsigned flags_of(x86_xmm) noexcept { return size128; }
+  static constexpr unsigned flags_of(x86_ymm) noexcept { return size256; }
+  static constexpr unsigned flags_of(x86_zmm) noexcept { return size512; }
+
+  template <typename Reg>
+  static constexpr x86_reg code_of(const Reg reg) noexcept {
+    return static_cast<x86_reg>(reg);
+  }
+
+  /**
+   * Returns the ModRM.rm operand for a register or memory operand.
+   */
+  template <typename Reg>
+  static constexpr x86_reg rm_of(const Reg reg) noexcept {
+    return code_of(reg);
+  }
+
+  static constexpr const x86_mem& rm_of(const x86_mem& mem) noexcept {
+    return mem;
+  }
+
+  static constexpr const x86_bcst& rm_of(const x86_bcst& bcst) noexcept {
+    return bcst;
+  }
+
+  /**
+   * Returns the REX prefix for the given operand flags and register codes,
+   * or zero if none is needed.
+   *
+   * @throws std::invalid_argument if a high byte register would need a REX
+   *         prefix
+   */
+  static std::uint8_t rex_of(const unsigned flags,
+                             const x86_reg reg,
+                             const x86_reg index,
+                             const x86_reg base,
+                             const bool base_is_reg) {
+    std::uint8_t rex = (flags & size64) | ((reg & 8) >> 1) | ((index & 8) >> 2) | ((base & 8) >> 3);
+    if (rex || ((reg | (base_is_reg ? base : 0)) & 0x10)) {
+      if ((flags & size8) && (is_high_byte(reg) || (base_is_reg && is_high_byte(base)))) {
+        throw std::invalid_argument("AH, CH, DH, and BH cannot be encoded with a REX prefix");
+      }
+      rex |= 0x40;
+    }
+    return rex;
+  }
+
+  static constexpr bool is_high_byte(const x86_reg reg) noexcept {
+    return (reg & 0x3C) == 0x04;
+  }
+
+  /**
+   * Returns the ModRM.reg code for the given opcode extension (`/digit`).
+   */
+  static constexpr x86_reg ext(const std::uint8_t digit) noexcept {
+    return 0x20 | digit;
+  }
+
+  /**
+   * Returns the ModRM.reg code for a register operand that is wider than
+   * the byte-sized operand it is paired with, as in `MOVZX`.
+   */
+  static constexpr x86_reg wide(const x86_reg reg) noexcept {
+    return 0x20 | reg;
+  }
+
+  static constexpr std::size_t prefix_size(const unsigned flags) noexcept {
+    return !!(flags & prefix_lock) + !!(flags & size16) + !!(flags & prefix_f3);
+  }
+
+  static std::uint8_t* store_prefixes(std::uint8_t* cursor,
+                                      const unsigned flags,
+                                      const std::uint8_t rex,
+                                      const std::initializer_list<x86_opcode> opcode) noexcept {
+    if (flags & prefix_lock) {
+      *cursor++ = 0xF0;
+    }
+    if (flags & size16) {
+      *cursor++ = 0x66;
+    }
+    if (flags & prefix_f3) {
+      *cursor++ = 0xF3;
+    }
+    if (rex) {
+      *cursor++ = rex;
+    }
+    for (const auto byte : opcode) {
+      *cursor++ = byte;
+    }
+    return cursor;
+  }
+
+  /**
+   * Reserves the bytes of an instruction that cannot take a pending `LOCK`
+   * prefix.
+   *
+   * @throws std::logic_error if `lock()` was called
+   */
+  std::uint8_t* reserve(const std::size_t count) {
+    if (_lock) {
+      _lock = false;
+      throw std::logic_error("LOCK prefix requires an instruction with a memory operand");
+    }
+    return _buffer.extend(count);
+  }
+
+  /**
+   * Returns the given flags with `prefix_lock` added if `lock()` was
+   * called, consuming the request.
+   */
+  unsigned lock_flags(const unsigned flags) noexcept {
+    const unsigned result = _lock ? (flags | prefix_lock) : flags;
+    _lock = false;
+    return result;
+  }
+
+  static void store_imm(std::uint8_t* const cursor,
+                        const std::size_t imm_size,
+                        const std::uint64_t imm) noexcept {
+    switch (imm_size) {
+      case 1: *cursor = static_cast<std::uint8_t>(imm); break;
+      case 2: machinery::bits::store_le16(cursor, static_cast<std::uint16_t>(imm)); break;
+      case 4: machinery::bits::store_le32(cursor, static_cast<std::uint32_t>(imm)); break;
+      case 8: machinery::bits::store_le64(cursor, imm); break;
+    }
+  }
+
+  /**
+   * Emits an instruction with the register in the low opcode bits, e.g.
+   * `PUSH r64` or `MOV r32, imm32`.
+   */
+  x86_emitter& encode_o(const unsigned flags,
+                        const x86_opcode opcode,
+                        const x86_reg reg,
+                        const std::size_t imm_size = 0,
+                        const std::uint64_t imm = 0) {
+    const std::uint8_t rex = rex_of(flags, 0, 0, reg, true);
+    std::uint8_t* cursor = reserve(prefix_size(flags) + !!rex + 1 + imm_size);
+    cursor = store_prefixes(cursor, flags, rex, {static_cast<x86_opcode>(opcode + (reg & 7))});
+    store_imm(cursor, imm_size, imm);
+    return *this;
+  }
+
+  /**
+   * Emits an instruction with a register-direct ModRM operand.
+   *
+   * @param reg the ModRM.reg field: a register code or an opcode extension
+   * @param rm  the ModRM.rm register code
+   */
+  x86_emitter& encode_rm(const unsigned flags,
+                         const std::initializer_list<x86_opcode> opcode,
+                         const x86_reg reg,
+                         const x86_reg rm,
+                         const std::size_t imm_size = 0,
+                         const std::uint64_t imm = 0) {
+    const std::uint8_t rex = rex_of(flags, reg, 0, rm, true);
+    std::uint8_t* cursor = reserve(prefix_size(flags) + !!rex + opcode.size() + 1 + imm_size);
+    cursor = store_prefixes(cursor, flags, rex, opcode);
+    *cursor++ = 0xC0 | ((reg & 7) << 3) | (rm & 7);
+    store_imm(cursor, imm_size, imm);
+    return *this;
+  }
+
+  /* The ModRM, SIB, and displacement bytes of a memory operand: */
+  struct mem_layout {
+    std::uint8_t modrm;
+    std::uint8_t sib;
+    bool has_sib;
+    std::size_t disp_size;
+    std::int32_t disp;
+    x86_reg index;  /* the register code for REX.X, or zero */
+    x86_reg base;   /* the register code for REX.B, or zero */
+
+    std::size_t size() const noexcept {
+      return 1 + has_sib + disp_size;
+    }
+  };
+
+  /**
+   * Returns the encoding of the given memory operand, choosing the
+   * shortest displacement.
+   *
+   * @param reg   the ModRM.reg field: a register code or an opcode extension
+   * @param mem   the memory operand
+   * @param scale the EVEX disp8*N compression factor, or 1
+   */
+  static mem_layout layout_of(const x86_reg reg,
+                              const x86_mem& mem,
+                              const std::int32_t scale = 1) noexcept {
+    const bool has_base = (mem.base != x86_mem::none && mem.base != x86_mem::rip_base);
+    const bool has_index = (mem.index != x86_mem::none);
+
+    std::uint8_t mod = 0, rm;
+    mem_layout layout {0, 0, false, 0, mem.disp,
+      static_cast<x86_reg>(has_index ? mem.index : 0),
+      static_cast<x86_reg>(has_base ? mem.base : 0)};
+    if (mem.base == x86_mem::rip_base) {
+      rm = 0x5; /* [rip + disp32] */
+      layout.disp_size = 4;
+    }
+    else if (!has_base) {
+      rm = 0x4; /* SIB with no base: [index*scale + disp32] */
+      layout.has_sib = true;
+      layout.sib = (mem.scale << 6) | ((has_index ? mem.index & 7 : 0x4) << 3) | 0x5;
+      layout.disp_size = 4;
+    }
+    else {
+      if (mem.disp == 0 && (mem.base & 7) != 0x5) {
+        mod = 0x0;
+      }
+      else if (mem.disp % scale == 0 && mem.disp / scale >= -128 && mem.disp / scale <= 127) {
+        mod = 0x1;
+        layout.disp_size = 1;
+        layout.disp = mem.disp / scale;
+      }
+      else {
+        mod = 0x2;
+        layout.disp_size = 4;
+      }
+      if (has_index || (mem.base & 7) == 0x4) {
+        rm = 0x4;
+        layout.has_sib = true;
+        layout.sib = (mem.scale << 6) | ((has_index ? mem.index & 7 : 0x4) << 3) | (mem.base & 7);
+      }
+      else {
+        rm = mem.base & 7;
+      }
+    }
+    layout.modrm = (mod << 6) | ((reg & 7) << 3) | rm;
+    return layout;
+  }
+
+  static std::uint8_t* store_mem(std::uint8_t* cursor,
+                                 const mem_layout& layout) noexcept {
+    *cursor++ = layout.modrm;
+    if (layout.has_sib) {
+      *cursor++ = layout.sib;
+    }
+    store_imm(cursor, layout.disp_size, static_cast<std::uint32_t>(layout.disp));
+    return cursor + layout.disp_size;
+  }
+
+  /**
+   * Reserves room for an instruction with the given memory operand.
+   *
+   * The displacement of a RIP-relative operand counts buffer offsets. In a
+   * segmented buffer, it must refer to code already emitted, or be zero,
+   * and is translated to where the instruction ends up in memory.
+   *
+   * @param count the byte length of the instruction
+   * @throws std::out_of_range if the RIP-relative target can't be reached
+   */
+  std::uint8_t* reserve(const std::size_t count,
+                        mem_layout& layout,
+                        const x86_mem& mem) {
+    if (mem.base != x86_mem::rip_base || !is_mapped(_buffer, 0) || mem.disp == 0) {
+      return reserve(count);
+    }
+    const std::int64_t target = static_cast<std::int64_t>(_buffer.size() + count) + mem.disp;
+    if (target < 0 || target >= static_cast<std::int64_t>(_buffer.size())) {
+      throw std::out_of_range("RIP-relative operand must refer to code already emitted");
+    }
+    std::uint8_t* const cursor = reserve(count);
+    const std::int64_t disp = distance(static_cast<std::size_t>(target), _buffer.size());
+    if (disp < INT32_MIN || disp > INT32_MAX) {
+      throw std::out_of_range("RIP-relative displacement does not fit in 32 bits");
+    }
+    layout.disp = static_cast<std::int32_t>(disp);
+    return cursor;
+  }
+
+  /**
+   * Emits an instruction with a memory ModRM operand.
+   *
+   * Chooses the shortest displacement encoding. For RIP-relative operands,
+   * the displacement is relative to the end of the instruction, including
+   * any immediate value.
+   *
+   * @param reg the ModRM.reg field: a register code or an opcode extension
+   * @param mem the memory operand
+   */
+  x86_emitter& encode_rm(const unsigned flags,
+                         const std::initializer_list<x86_opcode> opcode,
+                         const x86_reg reg,
+                         const x86_mem& mem,
+                         const std::size_t imm_size = 0,
+                         const std::uint64_t imm = 0) {
+    const unsigned prefixes = lock_flags(flags);
+    mem_layout layout = layout_of(reg, mem);
+    const std::uint8_t rex = rex_of(flags, reg, layout.index, layout.base, false);
+    std::uint8_t* cursor = reserve(prefix_size(prefixes) + !!rex + opcode.size() +
+      layout.size() + imm_size, layout, mem);
+    cursor = store_prefixes(cursor, prefixes, rex, opcode);
+    cursor = store_mem(cursor, layout);
+    store_imm(cursor, imm_size, imm);
+    return *this;
+  }
+
+  /** VEX.pp: the implied legacy prefix. */
+  enum vex_prefix : std::uint8_t {
+    vex_none = 0,
+    vex_66   = 1,
+    vex_f3   = 2,
+    vex_f2   = 3,
+  };
+
+  /** VEX.mmmmm: the implied leading opcode bytes. */
+  enum vex_map : std::uint8_t {
+    map_0f   = 1,
+    map_0f38 = 2,
+    map_0f3a = 3,
+  };
+
+  /**
+   * Stores a two- or three-byte VEX prefix and the opcode byte.
+   *
+   * The two-byte form is used whenever it can express the prefix, i.e. for
+   * the `0F` map with VEX.W clear and without extended index or base
+   * registers.
+   */
+  static std::uint8_t* store_vex(std::uint8_t* cursor,
+                                 const unsigned flags,
+                                 const vex_prefix pp,
+                                 const vex_map map,
+                                 const x86_opcode opcode,
+                                 const x86_reg reg,
+                                 const x86_reg vvvv,
+                                 const x86_reg index,
+                                 const x86_reg base) noexcept {
+    /* The R, X, B, and vvvv fields are stored inverted: */
+    const std::uint8_t tail = ((~vvvv & 0xF) << 3) | ((flags & size256) ? 0x04 : 0x00) | pp;
+    const std::uint8_t r = (~reg & 8) << 4;
+    if (vex_size_of(flags, map, index, base) == 2) {
+      *cursor++ = 0xC5;
+      *cursor++ = r | tail;
+    }
+    else {
+      *cursor++ = 0xC4;
+      *cursor++ = r | ((~index & 8) << 3) | ((~base & 8) << 2) | map;
+      *cursor++ = ((flags & size64) ? 0x80 : 0x00) | tail;
+    }
+    *cursor++ = opcode;
+    return cursor;
+  }
+
+  /**
+   * @throws std::invalid_argument if the operands require EVEX
+   */
+  static void check_vex(const unsigned flags, const x86_reg regs) {
+    if ((flags & size512) || (regs & 0x10)) {
+      throw std::invalid_argument("ZMM registers and registers 16..31 require an EVEX encoding");
+    }
+  }
+
+  static constexpr std::size_t vex_size_of(const unsigned flags,
+                                           const vex_map map,
+                                           const x86_reg index,
+                                           const x86_reg base) noexcept {
+    return (map == map_0f && !(flags & size64) && !((index | base) & 8)) ? 2 : 3;
+  }
+
+  /**
+   * Emits a VEX-encoded instruction with a register-direct ModRM operand.
+   *
+   * @param reg  the ModRM.reg field: a register code or an opcode extension
+   * @param vvvv the VEX.vvvv register code, or zero if unused
+   * @param rm   the ModRM.rm register code
+   */
+  x86_emitter& encode_vex(const unsigned flags,
+                          const vex_prefix pp,
+                          const vex_map map,
+                          const x86_opcode opcode,
+                          const x86_reg reg,
+                          const x86_reg vvvv,
+                          const x86_reg rm,
+                          const std::size_t imm_size = 0,
+                          const std::uint64_t imm = 0) {
+    check_vex(flags, reg | vvvv | rm);
+    std::uint8_t* cursor = reserve(vex_size_of(flags, map, 0, rm) + 2 + imm_size);
+    cursor = store_vex(cursor, flags, pp, map, opcode, reg, vvvv, 0, rm);
+    *cursor++ = 0xC0 | ((reg & 7) << 3) | (rm & 7);
+    store_imm(cursor, imm_size, imm);
+    return *this;
+  }
+
+  /**
+   * Emits a VEX-encoded instruction with a memory ModRM operand.
+   *
+   * @param reg  the ModRM.reg field: a register code or an opcode extension
+   * @param vvvv the VEX.vvvv register code, or zero if unused
+   * @param mem  the memory operand
+   */
+  x86_emitter& encode_vex(const unsigned flags,
+                          const vex_prefix pp,
+                          const vex_map map,
+                          const x86_opcode opcode,
+                          const x86_reg reg,
+                          const x86_reg vvvv,
+                          const x86_mem& mem,
+                          const std::size_t imm_size = 0,
+                          const std::uint64_t imm = 0) {
+    check_vex(flags, reg | vvvv);
+    mem_layout layout = layout_of(reg, mem);
+    std::uint8_t* cursor = reserve(vex_size_of(flags, map, layout.index, layout.base) + 1 +
+      layout.size() + imm_size, layout, mem);
+    cursor = store_vex(cursor, flags, pp, map, opcode, reg, vvvv, layout.index, layout.base);
+    cursor = store_mem(cursor, layout);
+    store_imm(cursor, imm_size, imm);
+    return *this;
+  }
+
+  /** EVEX tuple types, which determine the disp8*N compression factor. */
+  enum evex_tuple : std::uint8_t {
+    tuple_fv,   /* full vector, or one element when broadcasting */
+    tuple_fvm,  /* full vector, without broadcasting */
+    tuple_hvm,  /* half vector */
+    tuple_qvm,  /* quarter vector */
+    tuple_t1s1, /* one 8-bit element */
+    tuple_t1s4, /* one 32-bit element */
+    tuple_t1s8, /* one 64-bit element */
+    tuple_t4,   /* four 32-bit elements */
+    tuple_t8,   /* four 64-bit elements */
+  };
+
+  /* The VEX and EVEX encodings of an AVX instruction: */
+  struct avx_op {
+    vex_prefix pp;
+    vex_map map;
+    x86_opcode opcode;
+    std::uint8_t vex_w;   /* VEX.W */
+    evex_tuple tuple;
+    std::uint8_t evex_w;  /* EVEX.W, which also selects the element size */
+  };
+
+  /**
+   * Returns the disp8*N compression factor for a memory operand.
+   */
+  static std::int32_t disp8_scale(const avx_op& op,
+                                  const unsigned flags,
+                                  const bool broadcast) noexcept {
+    const std::int32_t vector = (flags & size512) ? 64 : (flags & size256) ? 32 : 16;
+    switch (op.tuple) {
+      case tuple_fv:   return broadcast ? (4 << op.evex_w) : vector;
+      case tuple_fvm:  return vector;
+      case tuple_hvm:  return vector / 2;
+      case tuple_qvm:  return vector / 4;
+      case tuple_t1s1: return 1;
+      case tuple_t1s4: return 4;
+      case tuple_t1s8: return 8;
+      case tuple_t4:   return 16;
+      case tuple_t8:   return 32;
+    }
+    return 1;
+  }
+
+  /**
+   * Returns the given write mask, which must be merging as for a store.
+   *
+   * @throws std::invalid_argument if `mask` is zeroing
+   */
+  static x86_mask store_mask(const x86_mask mask) {
+    if (mask.zeroing) {
+      throw std::invalid_argument("stores to memory cannot use a zeroing write mask");
+    }
+    return mask;
+  }
+
+  static constexpr bool needs_evex(const unsigned flags,
+                                   const x86_reg regs,
+                                   const x86_mask mask) noexcept {
+    return (flags & size512) || (regs & 0x10) || mask.k != x86_kreg::k0;
+  }
+
+  /**
+   * Stores the four-byte EVEX prefix and the opcode byte.
+   *
+   * @param xb the inverted EVEX.X and EVEX.B bits, in place
+   */
+  static std::uint8_t* store_evex(std::uint8_t* cursor,
+                                  const avx_op& op,
+                                  const unsigned flags,
+                                  const x86_reg reg,
+                                  const x86_reg vvvv,
+                                  const std::uint8_t xb,
+                                  const x86_mask mask,
+                                  const bool broadcast) noexcept {
+    /* The R, X, B, R', V', and vvvv fields are stored inverted: */
+    const std::uint8_t length = (flags & size512) ? 0x40 : (flags & size256) ? 0x20 : 0x00;
+    *cursor++ = 0x62;
+    *cursor++ = ((~reg & 8) << 4) | xb | (~reg & 0x10) | op.map;
+    *cursor++ = (op.evex_w << 7) | ((~vvvv & 0xF) << 3) | 0x04 | op.pp;
+    *cursor++ = (mask.zeroing ? 0x80 : 0x00) | length | (broadcast ? 0x10 : 0x00) |
+      ((~vvvv & 0x10) >> 1) | static_cast<std::uint8_t>(mask.k);
+    *cursor++ = op.opcode;
+    return cursor;
+  }
+
+  /**
+   * Emits an EVEX-encoded instruction with a register-direct ModRM operand.
+   *
+   * @param reg  the ModRM.reg field: a register code or an opcode extension
+   * @param vvvv the EVEX.vvvv register code, or zero if unused
+   * @param rm   the ModRM.rm register code
+   * @param mask the write mask
+   */
+  x86_emitter& encode_evex(const avx_op& op,
+                           const unsigned flags,
+                           const x86_reg reg,
+                           const x86_reg vvvv,
+                           const x86_reg rm,
+                           const x86_mask mask,
+                           const std::size_t imm_size = 0,
+                           const std::uint64_t imm = 0) {
+    std::uint8_t* cursor = reserve(5 + 1 + imm_size);
+    cursor = store_evex(cursor, op, flags, reg, vvvv,
+      ((~rm & 0x10) << 2) | ((~rm & 8) << 2), mask, false);
+    *cursor++ = 0xC0 | ((reg & 7) << 3) | (rm & 7);
+    store_imm(cursor, imm_size, imm);
+    return *this;
+  }
+
+  /**
+   * Emits an EVEX-encoded instruction with a memory ModRM operand.
+   *
+   * @param reg  the ModRM.reg field: a register code or an opcode extension
+   * @param vvvv the EVEX.vvvv register code, or zero if unused
+   * @param mem  the memory operand
+   * @param mask the write mask
+   */
+  x86_emitter& encode_evex(const avx_op& op,
+                           const unsigned flags,
+                           const x86_reg reg,
+                           const x86_reg vvvv,
+                           const x86_mem& mem,
+                           const x86_mask mask,
+                           const std::size_t imm_size = 0,
+                           const std::uint64_t imm = 0) {
+    return encode_evex_mem(op, flags, reg, vvvv, mem, mask, false, imm_size, imm);
+  }
+
+  /**
+   * Emits an EVEX-encoded instruction with a broadcast memory operand.
+   *
+   * @throws std::invalid_argument if the instruction does not broadcast
+   */
+  x86_emitter& encode_evex(const avx_op& op,
+                           const unsigned flags,
+                           const x86_reg reg,
+                           const x86_reg vvvv,
+                           const x86_bcst& bcst,
+                           const x86_mask mask,
+                           const std::size_t imm_size = 0,
+                           const std::uint64_t imm = 0) {
+    if (op.tuple != tuple_fv) {
+      throw std::invalid_argument("instruction does not support embedded broadcast");
+    }
+    return encode_evex_mem(op, flags, reg, vvvv, bcst.mem, mask, true, imm_size, imm);
+  }
+
+  x86_emitter& encode_evex_mem(const avx_op& op,
+                               const unsigned flags,
+                               const x86_reg reg,
+                               const x86_reg vvvv,
+                               const x86_mem& mem,
+                               const x86_mask mask,
+                               const bool broadcast,
+                               const std::size_t imm_size,
+                               const std::uint64_t imm) {
+    mem_layout layout = layout_of(reg, mem, disp8_scale(op, flags, broadcast));
+    std::uint8_t* cursor = reserve(5 + layout.size() + imm_size, layout, mem);
+    cursor = store_evex(cursor, op, flags, reg, vvvv,
+      ((~layout.index & 8) << 3) | ((~layout.base & 8) << 2), mask, broadcast);
+    cursor = store_mem(cursor, layout);
+    store_imm(cursor, imm_size, imm);
+    return *this;
+  }
+
+  /**
+   * Emits an AVX instruction, preferring the shorter VEX encoding unless
+   * the operands or the write mask require EVEX.
+   */
+  template <typename Rm>
+  x86_emitter& encode_avx(const avx_op& op,
+                          const unsigned flags,
+                          const x86_reg reg,
+                          const x86_reg vvvv,
+                          const Rm& rm,
+                          const x86_mask mask = x86_mask(),
+                          const std::size_t imm_size = 0,
+                          const std::uint64_t imm = 0) {
+    if (needs_evex(flags, reg | vvvv | reg_bits(rm), mask)) {
+      return encode_evex(op, flags, reg, vvvv, rm, mask, imm_size, imm);
+    }
+    const unsigned w = op.vex_w ? static_cast<unsigned>(size64) : 0U;
+    return encode_vex(flags | w, op.pp, op.map, op.opcode, reg, vvvv, rm, imm_size, imm);
+  }
+
+  x86_emitter& encode_avx(const avx_op& op,
+                          const unsigned flags,
+                          const x86_reg reg,
+                          const x86_reg vvvv,
+                          const x86_bcst& bcst,
+                          const x86_mask mask = x86_mask(),
+                          const std::size_t imm_size = 0,
+                          const std::uint64_t imm = 0) {
+    return encode_evex(op, flags, reg, vvvv, bcst, mask, imm_size, imm);
+  }
+
+  /* The register code bits of a ModRM.rm operand, as relevant to EVEX: */
+  static constexpr x86_reg reg_bits(const x86_reg rm) noexcept {
+    return rm;
+  }
+
+  static constexpr x86_reg reg_bits(const x86_mem&) noexcept {
+    return 0;
+  }
+
+  /**
+   * Emits an ALU instruction (`ADD`, `OR`, `ADC`, `SBB`, `AND`, `SUB`,
+   * `XOR`, or `CMP`, numbered 0..7) in register, register form.
+   */
+  template <typename Reg>
+  x86_emitter& alu(const std::uint8_t op, const Reg dst, const Reg src) {
+    const unsigned flags = flags_of(dst);
+    return encode_rm(flags, {static_cast<x86_opcode>((op << 3) | ((flags & size8) ? 0x00 : 0x01))},
+      code_of(src), code_of(dst));
+  }
+
+  /**
+   * Emits an ALU instruction in register, memory form.
+   */
+  template <typename Reg>
+  x86_emitter& alu(const std::uint8_t op, const Reg dst, const x86_mem& src) {
+    const unsigned flags = flags_of(dst);
+    return encode_rm(flags, {static_cast<x86_opcode>((op << 3) | ((flags & size8) ? 0x02 : 0x03))},
+      code_of(dst), src);
+  }
+
+  /**
+   * Emits an ALU instruction in memory, register form.
+   */
+  template <typename Reg>
+  x86_emitter& alu(const std::uint8_t op, const x86_mem& dst, const Reg src) {
+    const unsigned flags = flags_of(src);
+    return encode_rm(flags, {static_cast<x86_opcode>((op << 3) | ((flags & size8) ? 0x00 : 0x01))},
+      code_of(src), dst);
+  }
+
+  x86_emitter& alu(const std::uint8_t op, const x86_reg8 dst, const x86_imm8 imm) {
+    if (_compact && code_of(dst) == 0) {
+      return encode_o(size8, (op << 3) | 0x04, 0, 1, imm.u8);
+    }
+    return encode_rm(size8, {0x80}, ext(op), code_of(dst), 1, imm.u8);
+  }
+
+  x86_emitter& alu(const std::uint8_t op, const x86_reg16 dst, const x86_imm16 imm) {
+    return alu_imm(op, size16, code_of(dst), static_cast<std::int16_t>(imm.u16), 2);
+  }
+
+  x86_emitter& alu(const std::uint8_t op, const x86_reg32 dst, const x86_imm32 imm) {
+    return alu_imm(op, size32, code_of(dst), static_cast<std::int32_t>(imm.u32), 4);
+  }
+
+  x86_emitter& alu(const std::uint8_t op, const x86_reg64 dst, const x86_imm32 imm) {
+    return alu_imm(op, size64, code_of(dst), static_cast<std::int32_t>(imm.u32), 4);
+  }
+
+  x86_emitter& alu(const std::uint8_t op, const x86_mem& dst, const x86_imm8 imm) {
+    return encode_rm(size8, {0x80}, ext(op), dst, 1, imm.u8);
+  }
+
+  x86_emitter& alu(const std::uint8_t op, const x86_mem& dst, const x86_imm16 imm) {
+    return alu_imm(op, size16, dst, static_cast<std::int16_t>(imm.u16), 2);
+  }
+
+  x86_emitter& alu(const std::uint8_t op, const x86_mem& dst, const x86_imm32 imm) {
+    return alu_imm(op, size32, dst, static_cast<std::int32_t>(imm.u32), 4);
+  }
+
+  x86_emitter& alu(const std::uint8_t op, const x86_mem& dst, const x86_imm64 imm) {
+    return alu_imm(op, size64, dst, static_cast<std::int32_t>(sign_extended_imm32(imm)), 4);
+  }
+
+  /**
+   * Emits a 16-, 32-, or 64-bit ALU instruction with an immediate value,
+   * choosing the sign-extended `imm8` form (`0x83`) or, for a register
+   * other than the accumulator, the full-width form (`0x81`).
+   */
+  x86_emitter& alu_imm(const std::uint8_t op,
+                       const unsigned flags,
+                       const x86_reg dst,
+                       const std::int32_t imm,
+                       const std::size_t imm_size) {
+    if (_compact && fits_imm8(imm)) {
+      return encode_rm(flags, {0x83}, ext(op), dst, 1, static_cast<std::uint32_t>(imm));
+    }
+    if (_compact && dst == 0) {
+      return encode_o(flags, (op << 3) | 0x05, 0, imm_size, static_cast<std::uint32_t>(imm));
+    }
+    return encode_rm(flags, {0x81}, ext(op), dst, imm_size, static_cast<std::uint32_t>(imm));
+  }
+
+  /**
+   * Emits a 16-, 32-, or 64-bit ALU instruction with a memory operand and
+   * an immediate value, choosing the sign-extended `imm8` form if possible.
+   */
+  x86_emitter& alu_imm(const std::uint8_t op,
+                       const unsigned flags,
+                       const x86_mem& dst,
+                       const std::int32_t imm,
+                       const std::size_t imm_size) {
+    if (_compact && fits_imm8(imm)) {
+      return encode_rm(flags, {0x83}, ext(op), dst, 1, static_cast<std::uint32_t>(imm));
+    }
+    return encode_rm(flags, {0x81}, ext(op), dst, imm_size, static_cast<std::uint32_t>(imm));
+  }
+
+  static constexpr bool fits_imm8(const std::int32_t imm) noexcept {
+    return imm >= -128 && imm <= 127;
+  }
+
+  /**
+   * Returns the displacement from the end of a branch to its target.
+   */
+  static std::int64_t displacement(const std::size_t target,
+                                   const std::size_t end) noexcept {
+    return static_cast<std::int64_t>(target) - static_cast<std::int64_t>(end);
+  }
+
+  static constexpr bool fits_rel8(const std::int64_t disp) noexcept {
+    return disp >= -128 && disp <= 127;
+  }
+
+  /**
+   * Returns the displacement from the end of an instruction to its target,
+   * as the code is laid out in memory.
+   */
+  std::int64_t distance(const std::size_t target,
+                        const std::size_t end) const noexcept {
+    return static_cast<std::int64_t>(location(_buffer, target, 0)) -
+      static_cast<std::int64_t>(location(_buffer, end, 0));
+  }
+
+  /* A buffer that maps its code in pieces, such as `segmented_buffer`,
+   * tells where each byte offset resides in memory. Other buffers are
+   * contiguous, so that offsets alone determine displacements: */
+  template <typename B>
+  static auto location(const B& buffer, const std::size_t offset, int) noexcept
+      -> decltype(buffer.address(offset), std::uintptr_t()) {
+    return reinterpret_cast<std::uintptr_t>(buffer.address(offset));
+  }
+
+  template <typename B>
+  static std::uintptr_t location(const B&, const std::size_t offset, long) noexcept {
+    return offset;
+  }
+
+  template <typename B>
+  static constexpr auto is_mapped(const B& buffer, int) noexcept
+      -> decltype(buffer.address(0), bool()) {
+    return true;
+  }
+
+  template <typename B>
+  static constexpr bool is_mapped(const B&, long) noexcept {
+    return false;
+  }
+
+  /**
+   * Computes where the recorded branches and labels move to if the branches
+   * take the lengths given in `branches`, recomputing the alignment padding
+   * along the way, just as `relax()` re-emits the code.
+   */
+  void plan_layout(std::vector<branch>& branches,
+                   std::vector<std::size_t>& labels) const {
+    /* The growth of the code so far, after the end of each directive: */
+    struct shift {
+      std::size_t old_end;
+      std::int64_t delta;
+    };
+    std::vector<shift> shifts;
+    std::int64_t delta = 0;
+    std::size_t next_alignment = 0;
+    std::size_t next_branch = 0;
+    for (;;) {
+      const bool is_alignment = next_alignment < _alignments.size() &&
+        (next_branch == branches.size() || _alignments[next_alignment].offset <= _branches[next_branch].offset);
+      if (is_alignment) {
+        const auto& entry = _alignments[next_alignment++];
+        const std::size_t size = padding_size(entry.offset + delta, entry.boundary);
+        delta += static_cast<std::int64_t>(size) - static_cast<std::int64_t>(entry.size);
+        shifts.push_back({entry.offset + entry.size, delta});
+      }
+      else if (next_branch < branches.size()) {
+        const auto& old = _branches[next_branch];
+        auto& entry = branches[next_branch++];
+        entry.offset = old.offset + delta;
+        delta += static_cast<std::int64_t>(entry.length) - static_cast<std::int64_t>(old.length);
+        shifts.push_back({old.offset + old.length, delta});
+      }
+      else {
+        break;
+      }
+    }
+
+    /* Move each label along with the code that it points into: */
+    for (auto i = 0UL; i < labels.size(); i++) {
+      const std::size_t position = _labels[i];
+      labels[i] = position;
+      if (position == unbound) {
+        continue;
+      }
+      auto entry = std::upper_bound(shifts.begin(), shifts.end(), position,
+        [](const std::size_t offset, const shift& other) { return offset < other.old_end; });
+      if (entry != shifts.begin()) {
+        labels[i] = position + (--entry)->delta;
+      }
+    }
+  }
+
+  /**
+   * Returns by how much the alignment padding between the given offsets
+   * could grow as the code around it moves.
+   */
+  std::int64_t alignment_slack(const std::size_t from,
+                               const std::size_t to) const noexcept {
+    const std::size_t low = (from < to) ? from : to;
+    const std::size_t high = (from < to) ? to : from;
+    std::int64_t slack = 0;
+    for (const auto& entry : _alignments) {
+      if (entry.offset >= low && entry.offset <= high) {
+        slack += entry.boundary - 1 - entry.size;
+      }
+    }
+    return slack;
+  }
+
+  static constexpr std::size_t max_nop_size = 15;
+
+  static constexpr std::size_t padding_size(const std::size_t offset,
+                                            const std::size_t boundary) noexcept {
+    return (boundary - (offset & (boundary - 1))) & (boundary - 1);
+  }
+
+  /**
+   * Stores a single `NOP` instruction of 1..15 bytes.
+   */
+  static void store_nop(std::uint8_t* cursor, std::size_t size) noexcept {
+    static const std::uint8_t forms[10][10] = {
+      {0x90},
+      {0x66, 0x90},
+      {0x0F, 0x1F, 0x00},
+      {0x0F, 0x1F, 0x40, 0x00},
+      {0x0F, 0x1F, 0x44, 0x00, 0x00},
+      {0x66, 0x0F, 0x1F, 0x44, 0x00, 0x00},
+      {0x0F, 0x1F, 0x80, 0x00, 0x00, 0x00, 0x00},
+      {0x0F, 0x1F, 0x84, 0x00, 0x00, 0x00, 0x00, 0x00},
+      {0x66, 0x0F, 0x1F, 0x84, 0x00, 0x00, 0x00, 0x00, 0x00},
+      {0x66, 0x2E, 0x0F, 0x1F, 0x84, 0x00, 0x00, 0x00, 0x00, 0x00},
+    };
+    for (; size > 10; size--) {
+      *cursor++ = 0x66;
+    }
+    std::copy(forms[size - 1], forms[size - 1] + size, cursor);
+  }
+
+  /**
+   * Stores alignment padding of the given byte size.
+   */
+  static void store_padding(std::uint8_t* cursor,
+                            std::size_t size,
+                            const x86_padding fill) noexcept {
+    if (fill == x86_padding::trap) {
+      std::fill(cursor, cursor + size, 0xCC);
+      return;
+    }
+    while (size) {
+      const std::size_t count = (size < max_nop_size) ? size : max_nop_size;
+      store_nop(cursor, count);
+      cursor += count;
+      size -= count;
+    }
+  }
+
+  /**
+   * Stores a branch instruction of the recorded kind and length.
+   */
+  static void store_branch(std::uint8_t* const cursor,
+                           const branch& entry,
+                           const std::int64_t disp) noexcept {
+    if (entry.length == 2) {
+      cursor[0] = (entry.kind == jmp_kind) ? 0xEB : (0x70 | entry.kind);
+      cursor[1] = static_cast<std::uint8_t>(disp);
+      return;
+    }
+    std::uint8_t* opcode = cursor;
+    switch (entry.kind) {
+      case jmp_kind:  *opcode++ = 0xE9; break;
+      case call_kind: *opcode++ = 0xE8; break;
+      default:        *opcode++ = 0x0F; *opcode++ = 0x80 | entry.kind; break;
+    }
+    machinery::bits::store_le32(opcode, static_cast<std::uint32_t>(disp));
+  }
+
+  /**
+   * Emits a branch to the given label, choosing the `rel8` form if the
+   * label is already bound within reach.
+   */
+  x86_emitter& branch_to(const std::uint8_t kind, const x86_label target) {
+    const std::size_t position = _labels.at(target.id);
+    branch entry {0, target.id, kind, 0};
+    /* A segmented buffer may move the branch on to its next segment, so
+     * only go short if the branch stays right after the current code: */
+    const bool adjacent = !is_mapped(_buffer, 0) || _buffer.capacity() - _buffer.size() >= 2;
+    if (kind != call_kind && position != unbound && adjacent &&
+        fits_rel8(distance(position, _buffer.size()) - 2)) {
+      entry.length = 2;
+    }
+    else {
+      entry.length = (kind == jmp_kind || kind == call_kind) ? 5 : 6;
+    }
+    std::uint8_t* const cursor = reserve(entry.length);
+    entry.offset = _buffer.size() - entry.length;
+    store_branch(cursor, entry, 0);
+    if (position != unbound) {
+      patch_branch(entry, position);
+    }
+    _branches.push_back(entry);
+    return *this;
+  }
+
+  /**
+   * Rewrites the displacement of a recorded branch.
+   *
+   * @throws std::out_of_range if the displacement does not fit
+   */
+  void patch_branch(const branch& entry, const std::size_t target) {
+    const std::int64_t disp = distance(target, entry.offset + entry.length);
+    std::uint8_t bytes[4];
+    if (entry.length == 2) {
+      if (!fits_rel8(disp)) {
+        throw std::out_of_range("branch displacement does not fit in 8 bits");
+      }
+      bytes[0] = static_cast<std::uint8_t>(disp);
+      _buffer.patch(entry.offset + 1, bytes, 1);
+    }
+    else {
+      if (disp < INT32_MIN || disp > INT32_MAX) {
+        throw std::out_of_range("branch displacement does not fit in 32 bits");
+      }
+      machinery::bits::store_le32(bytes, static_cast<std::uint32_t>(disp));
+      _buffer.patch(entry.offset + entry.length - 4, bytes, 4);
+    }
+  }
+
+  /**
+   * Returns the given immediate value as a sign-extended 32-bit value.
+   *
+   * @throws std::out_of_range if the value does not fit
+   */
+  static std::uint32_t sign_extended_imm32(const x86_imm64 imm) {
+    if (imm.s64 < INT32_MIN || imm.s64 > INT32_MAX) {
+      throw std::out_of_range("immediate value does not fit in a sign-extended 32 bits");
+    }
+    return static_cast<std::uint32_t>(imm.s64);
+  }
+
+  /**@}*/
+};
+
+template <class Buffer>
+constexpr std::size_t machinery::arch::x86_emitter<Buffer>::far_jump_size;
+
+template <class Buffer>
+constexpr std::size_t machinery::arch::x86_emitter<Buffer>::max_nop_size;
+
+template <class Buffer>
+constexpr std::uint8_t machinery::arch::x86_emitter<Buffer>::jmp_kind;
+
+template <class Buffer>
+constexpr std::uint8_t machinery::arch::x86_emitter<Buffer>::call_kind;
+
+template <class Buffer>
+constexpr std::size_t machinery::arch::x86_emitter<Buffer>::unbound;
 
 #endif /* MACHINERY_ARCH_X86_EMITTER_H */
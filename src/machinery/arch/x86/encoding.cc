@@ -19,3 +19,6 @@ static_assert(sizeof(x86_imm32) == 4,
 
 static_assert(sizeof(x86_imm64) == 8,
   "sizeof(machinery::arch::x86_imm64) != 8");
+
+constexpr x86_reg x86_mem::none;
+constexpr x86_reg x86_mem::rip_base;
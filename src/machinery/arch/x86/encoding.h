@@ -11,7 +11,8 @@
 
 #include "../../bits/word.h"
 
-#include <cstdint> /* for std::uint*_t */
+#include <cstdint>   /* for std::int32_t, std::uint*_t */
+#include <stdexcept> /* for std::invalid_argument */
 
 namespace machinery {
   namespace arch {
@@ -23,14 +24,69 @@ namespace machinery {
     /** x86 opcode byte */
     using x86_opcode = std::uint8_t;
 
+    enum class x86_cc : std::uint8_t;
+    enum class x86_padding : std::uint8_t;
+
     using x86_reg = std::uint8_t;
     enum class x86_reg8  : x86_reg;
     enum class x86_reg16 : x86_reg;
     enum class x86_reg32 : x86_reg;
     enum class x86_reg64 : x86_reg;
+    enum class x86_xmm   : x86_reg;
+    enum class x86_ymm   : x86_reg;
+    enum class x86_zmm   : x86_reg;
+    enum class x86_kreg  : x86_reg;
+    class x86_mask;
+    class x86_bcst;
+    class x86_mem;
   }
 }
 
+/**
+ * x86 condition codes, as encoded in the low nibble of `Jcc`, `SETcc`, and
+ * `CMOVcc` opcodes.
+ */
+enum class machinery::arch::x86_cc : std::uint8_t {
+  o   = 0,  /* 0b0000: overflow */
+  no  = 1,  /* 0b0001: not overflow */
+  b   = 2,  /* 0b0010: below (unsigned <) */
+  c   = 2,  /*         carry */
+  nae = 2,
+  ae  = 3,  /* 0b0011: above or equal (unsigned >=) */
+  nb  = 3,
+  nc  = 3,  /*         not carry */
+  e   = 4,  /* 0b0100: equal */
+  z   = 4,  /*         zero */
+  ne  = 5,  /* 0b0101: not equal */
+  nz  = 5,  /*         not zero */
+  be  = 6,  /* 0b0110: below or equal (unsigned <=) */
+  na  = 6,
+  a   = 7,  /* 0b0111: above (unsigned >) */
+  nbe = 7,
+  s   = 8,  /* 0b1000: sign */
+  ns  = 9,  /* 0b1001: not sign */
+  p   = 10, /* 0b1010: parity even */
+  pe  = 10,
+  np  = 11, /* 0b1011: parity odd */
+  po  = 11,
+  l   = 12, /* 0b1100: less (signed <) */
+  nge = 12,
+  ge  = 13, /* 0b1101: greater or equal (signed >=) */
+  nl  = 13,
+  le  = 14, /* 0b1110: less or equal (signed <=) */
+  ng  = 14,
+  g   = 15, /* 0b1111: greater (signed >) */
+  nle = 15,
+};
+
+/**
+ * The filler for alignment padding.
+ */
+enum class machinery::arch::x86_padding : std::uint8_t {
+  nop,  /* multi-byte `NOP` instructions, for padding that is executed */
+  trap, /* `INT3` instructions, for padding that must never be executed */
+};
+
 /**
  * x86 general-purpose registers (8-bit)
  */
@@ -43,6 +99,18 @@ enum class machinery::arch::x86_reg8 : machinery::arch::x86_reg {
   ch = 5,   /* 0b101 */
   dh = 6,   /* 0b110 */
   bh = 7,   /* 0b111 */
+  r8b  = 8,
+  r9b  = 9,
+  r10b = 10,
+  r11b = 11,
+  r12b = 12,
+  r13b = 13,
+  r14b = 14,
+  r15b = 15,
+  spl = 0x14, /* 0b100, requires REX */
+  bpl = 0x15, /* 0b101, requires REX */
+  sil = 0x16, /* 0b110, requires REX */
+  dil = 0x17, /* 0b111, requires REX */
 };
 
 /**
@@ -57,6 +125,14 @@ enum class machinery::arch::x86_reg16 : machinery::arch::x86_reg {
   bp = 5,   /* 0b101 */
   si = 6,   /* 0b110 */
   di = 7,   /* 0b111 */
+  r8w  = 8,
+  r9w  = 9,
+  r10w = 10,
+  r11w = 11,
+  r12w = 12,
+  r13w = 13,
+  r14w = 14,
+  r15w = 15,
 };
 
 /**
@@ -71,6 +147,14 @@ enum class machinery::arch::x86_reg32 : machinery::arch::x86_reg {
   ebp = 5,  /* 0b101 */
   esi = 6,  /* 0b110 */
   edi = 7,  /* 0b111 */
+  r8d  = 8,
+  r9d  = 9,
+  r10d = 10,
+  r11d = 11,
+  r12d = 12,
+  r13d = 13,
+  r14d = 14,
+  r15d = 15,
 };
 
 /**
@@ -95,4 +179,301 @@ enum class machinery::arch::x86_reg64 : machinery::arch::x86_reg {
   r15 = 15,
 };
 
+/**
+ * x86 SIMD registers (128-bit)
+ *
+ * Registers 16..31 are only accessible to EVEX-encoded instructions.
+ */
+enum class machinery::arch::x86_xmm : machinery::arch::x86_reg {
+  xmm0  = 0,
+  xmm1  = 1,
+  xmm2  = 2,
+  xmm3  = 3,
+  xmm4  = 4,
+  xmm5  = 5,
+  xmm6  = 6,
+  xmm7  = 7,
+  xmm8  = 8,
+  xmm9  = 9,
+  xmm10 = 10,
+  xmm11 = 11,
+  xmm12 = 12,
+  xmm13 = 13,
+  xmm14 = 14,
+  xmm15 = 15,
+  xmm16 = 16,
+  xmm17 = 17,
+  xmm18 = 18,
+  xmm19 = 19,
+  xmm20 = 20,
+  xmm21 = 21,
+  xmm22 = 22,
+  xmm23 = 23,
+  xmm24 = 24,
+  xmm25 = 25,
+  xmm26 = 26,
+  xmm27 = 27,
+  xmm28 = 28,
+  xmm29 = 29,
+  xmm30 = 30,
+  xmm31 = 31,
+};
+
+/**
+ * x86 SIMD registers (256-bit)
+ *
+ * Registers 16..31 are only accessible to EVEX-encoded instructions.
+ */
+enum class machinery::arch::x86_ymm : machinery::arch::x86_reg {
+  ymm0  = 0,
+  ymm1  = 1,
+  ymm2  = 2,
+  ymm3  = 3,
+  ymm4  = 4,
+  ymm5  = 5,
+  ymm6  = 6,
+  ymm7  = 7,
+  ymm8  = 8,
+  ymm9  = 9,
+  ymm10 = 10,
+  ymm11 = 11,
+  ymm12 = 12,
+  ymm13 = 13,
+  ymm14 = 14,
+  ymm15 = 15,
+  ymm16 = 16,
+  ymm17 = 17,
+  ymm18 = 18,
+  ymm19 = 19,
+  ymm20 = 20,
+  ymm21 = 21,
+  ymm22 = 22,
+  ymm23 = 23,
+  ymm24 = 24,
+  ymm25 = 25,
+  ymm26 = 26,
+  ymm27 = 27,
+  ymm28 = 28,
+  ymm29 = 29,
+  ymm30 = 30,
+  ymm31 = 31,
+};
+
+/**
+ * x86 SIMD registers (512-bit)
+ */
+enum class machinery::arch::x86_zmm : machinery::arch::x86_reg {
+  zmm0  = 0,
+  zmm1  = 1,
+  zmm2  = 2,
+  zmm3  = 3,
+  zmm4  = 4,
+  zmm5  = 5,
+  zmm6  = 6,
+  zmm7  = 7,
+  zmm8  = 8,
+  zmm9  = 9,
+  zmm10 = 10,
+  zmm11 = 11,
+  zmm12 = 12,
+  zmm13 = 13,
+  zmm14 = 14,
+  zmm15 = 15,
+  zmm16 = 16,
+  zmm17 = 17,
+  zmm18 = 18,
+  zmm19 = 19,
+  zmm20 = 20,
+  zmm21 = 21,
+  zmm22 = 22,
+  zmm23 = 23,
+  zmm24 = 24,
+  zmm25 = 25,
+  zmm26 = 26,
+  zmm27 = 27,
+  zmm28 = 28,
+  zmm29 = 29,
+  zmm30 = 30,
+  zmm31 = 31,
+};
+
+/**
+ * x86 opmask registers
+ */
+enum class machinery::arch::x86_kreg : machinery::arch::x86_reg {
+  k0 = 0,   /* as a write mask: no masking */
+  k1 = 1,
+  k2 = 2,
+  k3 = 3,
+  k4 = 4,
+  k5 = 5,
+  k6 = 6,
+  k7 = 7,
+};
+
+/**
+ * x86 write mask for an EVEX-encoded instruction: `{k}` or `{k}{z}`.
+ *
+ * Destination elements whose mask bit is clear are either left unchanged
+ * (merging) or cleared (zeroing).
+ */
+class machinery::arch::x86_mask final {
+public:
+  x86_kreg k;
+  bool zeroing;
+
+  /**
+   * Default constructor, denoting no masking.
+   */
+  constexpr x86_mask() noexcept
+    : k(x86_kreg::k0),
+      zeroing(false) {}
+
+  /**
+   * Returns a merging write mask.
+   *
+   * @param k the opmask register, where `k0` denotes no masking
+   */
+  static constexpr x86_mask merge(const x86_kreg k) noexcept {
+    return x86_mask(k, false);
+  }
+
+  /**
+   * Returns a zeroing write mask.
+   *
+   * @param k the opmask register, which cannot be `k0`
+   * @throws std::invalid_argument if `k` is `k0`
+   */
+  static x86_mask zero(const x86_kreg k) {
+    if (k == x86_kreg::k0) {
+      throw std::invalid_argument("k0 cannot be used as a zeroing write mask");
+    }
+    return x86_mask(k, true);
+  }
+
+private:
+  constexpr x86_mask(const x86_kreg k, const bool zeroing) noexcept
+    : k(k),
+      zeroing(zeroing) {}
+};
+
+/**
+ * x86 memory operand: `[base + index*scale + disp]`, or `[rip + disp]`.
+ *
+ * The base and index are 64-bit registers, and either may be absent.
+ * The operand width is implied by the other operand of an instruction.
+ */
+class machinery::arch::x86_mem final {
+public:
+  /** Register code denoting an absent base or index register. */
+  static constexpr x86_reg none = 0xFF;
+
+  /** Register code denoting RIP-relative addressing. */
+  static constexpr x86_reg rip_base = 0xFE;
+
+  x86_reg base;
+  x86_reg index;
+  std::uint8_t scale;  /* log2 of the index multiplier */
+  std::int32_t disp;
+
+  /**
+   * Constructor for `[base + disp]`.
+   *
+   * @param base the base register
+   * @param disp the signed displacement
+   */
+  explicit x86_mem(const x86_reg64 base, const std::int32_t disp = 0) noexcept
+    : x86_mem(static_cast<x86_reg>(base), none, 0, disp) {}
+
+  /**
+   * Constructor for `[base + index*scale + disp]`.
+   *
+   * @param base  the base register
+   * @param index the index register, which cannot be `rsp`
+   * @param scale the index multiplier: 1, 2, 4, or 8
+   * @param disp  the signed displacement
+   * @throws std::invalid_argument if `index` or `scale` is invalid
+   */
+  x86_mem(const x86_reg64 base, const x86_reg64 index,
+          const unsigned scale = 1, const std::int32_t disp = 0)
+    : x86_mem(static_cast<x86_reg>(base), check_index(index), check_scale(scale), disp) {}
+
+  /**
+   * Returns the operand `[rip + disp]`.
+   *
+   * In a `segmented_buffer`, a nonzero displacement must refer to code
+   * already emitted, and counts buffer offsets, as if the segments were
+   * contiguous.
+   *
+   * @param disp the signed displacement from the end of the instruction
+   */
+  static x86_mem rip(const std::int32_t disp) noexcept {
+    return x86_mem(rip_base, none, 0, disp);
+  }
+
+  /**
+   * Returns the operand `[index*scale + disp]`, without a base register.
+   *
+   * @throws std::invalid_argument if `index` or `scale` is invalid
+   */
+  static x86_mem indexed(const x86_reg64 index, const unsigned scale,
+                         const std::int32_t disp = 0) {
+    return x86_mem(none, check_index(index), check_scale(scale), disp);
+  }
+
+  /**
+   * Returns the operand `[disp]`, an absolute address sign-extended from
+   * 32 bits.
+   */
+  static x86_mem absolute(const std::int32_t disp) noexcept {
+    return x86_mem(none, none, 0, disp);
+  }
+
+private:
+  x86_mem(const x86_reg base, const x86_reg index,
+          const std::uint8_t scale, const std::int32_t disp) noexcept
+    : base(base),
+      index(index),
+      scale(scale),
+      disp(disp) {}
+
+  static x86_reg check_index(const x86_reg64 index) {
+    if (index == x86_reg64::rsp) {
+      throw std::invalid_argument("rsp cannot be an index register");
+    }
+    return static_cast<x86_reg>(index);
+  }
+
+  static std::uint8_t check_scale(const unsigned scale) {
+    switch (scale) {
+      case 1: return 0;
+      case 2: return 1;
+      case 4: return 2;
+      case 8: return 3;
+      default:
+        throw std::invalid_argument("scale must be 1, 2, 4, or 8");
+    }
+  }
+};
+
+/**
+ * x86 broadcast memory operand: `[...]{1toN}`.
+ *
+ * An EVEX-encoded instruction loads a single element from memory and
+ * replicates it to every element of the vector. The element size is that
+ * of the instruction.
+ */
+class machinery::arch::x86_bcst final {
+public:
+  x86_mem mem;
+
+  /**
+   * Constructor.
+   *
+   * @param mem the address of the element
+   */
+  explicit x86_bcst(const x86_mem& mem) noexcept
+    : mem(mem) {}
+};
+
 #endif /* MACHINERY_ARCH_X86_ENCODING_H */
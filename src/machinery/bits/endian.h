@@ -0,0 +1,71 @@
+/* This is free and unencumbered software released into the public domain. */
+
+#ifndef MACHINERY_BITS_ENDIAN_H
+#define MACHINERY_BITS_ENDIAN_H
+
+/**
+ * @file
+ *
+ * Little-endian stores to unaligned memory.
+ *
+ * @see http://en.wikipedia.org/wiki/Endianness
+ */
+
+#include <cstdint> /* for std::uint*_t */
+#include <cstring> /* for std::memcpy() */
+
+namespace machinery {
+  namespace bits {
+    inline void store_le16(std::uint8_t* dst, std::uint16_t value) noexcept;
+    inline void store_le32(std::uint8_t* dst, std::uint32_t value) noexcept;
+    inline void store_le64(std::uint8_t* dst, std::uint64_t value) noexcept;
+  }
+}
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+#define MACHINERY_BITS_LITTLE_ENDIAN 1
+#endif
+
+/**
+ * Stores a 16-bit value at the given address in little-endian byte order.
+ */
+inline void
+machinery::bits::store_le16(std::uint8_t* const dst,
+                            const std::uint16_t value) noexcept {
+#ifdef MACHINERY_BITS_LITTLE_ENDIAN
+  std::memcpy(dst, &value, sizeof(value));
+#else
+  dst[0] = static_cast<std::uint8_t>(value);
+  dst[1] = static_cast<std::uint8_t>(value >> 8);
+#endif
+}
+
+/**
+ * Stores a 32-bit value at the given address in little-endian byte order.
+ */
+inline void
+machinery::bits::store_le32(std::uint8_t* const dst,
+                            const std::uint32_t value) noexcept {
+#ifdef MACHINERY_BITS_LITTLE_ENDIAN
+  std::memcpy(dst, &value, sizeof(value));
+#else
+  store_le16(dst, static_cast<std::uint16_t>(value));
+  store_le16(dst + 2, static_cast<std::uint16_t>(value >> 16));
+#endif
+}
+
+/**
+ * Stores a 64-bit value at the given address in little-endian byte order.
+ */
+inline void
+machinery::bits::store_le64(std::uint8_t* const dst,
+                            const std::uint64_t value) noexcept {
+#ifdef MACHINERY_BITS_LITTLE_ENDIAN
+  std::memcpy(dst, &value, sizeof(value));
+#else
+  store_le32(dst, static_cast<std::uint32_t>(value));
+  store_le32(dst + 4, static_cast<std::uint32_t>(value >> 32));
+#endif
+}
+
+#endif /* MACHINERY_BITS_ENDIAN_H */
@@ -5,6 +5,8 @@
 #endif
 
 #include "extern.h"
+#include "feature.h"
+#include "util/cpu.h"
 
 #include <cassert> /* for assert() */
 
@@ -24,7 +26,21 @@ machinery_feature_exists(const char* const feature_name) {
   assert(feature_name != nullptr);
 
   if (feature_name != nullptr) {
-    // TODO
+    return machinery::feature_exists(feature_name);
+  }
+
+  return false; /* not found */
+}
+
+bool
+machinery_cpu_feature_exists(const char* const feature_name) {
+  assert(feature_name != nullptr);
+
+  if (feature_name != nullptr) {
+    using machinery::util::cpu_feature;
+    using machinery::util::cpu_features;
+    const cpu_feature feature = cpu_features::lookup(feature_name);
+    return feature != cpu_feature::count && cpu_features::host().has(feature);
   }
 
   return false; /* not found */
@@ -26,6 +26,18 @@ extern "C" {
  */
 bool machinery_feature_exists(const char* feature_name);
 
+/**
+ * Determines whether the host processor supports a given feature, e.g.
+ * "avx2", "bmi2", or "atomics".
+ *
+ * This reflects any override in effect for testing.
+ *
+ * @param feature_name the name of the processor feature to check for
+ * @pre `feature_name` must not be `NULL`
+ * @return `true` if the feature is supported, `false` otherwise
+ */
+bool machinery_cpu_feature_exists(const char* feature_name);
+
 /**
  * Determines whether libmachinery includes a given module.
  *
@@ -6,6 +6,9 @@
 
 #include "feature.h"
 
+#include <cassert> /* for assert() */
+#include <cstring> /* for std::strcmp() */
+
 static const char* const feature_names[] = {
   "ascii",
 #ifdef ENABLE_DEBUG
@@ -15,3 +18,16 @@ static const char* const feature_names[] = {
   "unicode",
 #endif
 };
+
+bool
+machinery::feature_exists(const char* const feature_name) noexcept {
+  assert(feature_name != nullptr);
+
+  for (const auto name : feature_names) {
+    if (std::strcmp(name, feature_name) == 0) {
+      return true;
+    }
+  }
+
+  return false; /* not found */
+}
@@ -9,4 +9,15 @@
  * Library feature metadata for Machinery.
  */
 
+namespace machinery {
+  /**
+   * Determines whether libmachinery was built with a given feature, e.g.
+   * "debug" or "unicode".
+   *
+   * @param feature_name the name of the feature to check for
+   * @pre `feature_name` must not be `NULL`
+   */
+  bool feature_exists(const char* feature_name) noexcept;
+}
+
 #endif /* MACHINERY_FEATURE_H */
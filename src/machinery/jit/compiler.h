@@ -10,13 +10,19 @@
  */
 
 #include "../util/buffer.h"
+#include "../util/cpu.h"
 
 #include <cstddef> /* for std::size_t */
+#include <cstdint> /* for std::uint8_t */
 #include <memory>  /* for std::unique_ptr */
 
 namespace machinery {
   namespace jit {
     class compiler;
+    class label;
+    class reg;
+    enum class condition : std::uint8_t;
+    enum class padding : std::uint8_t;
 
     /**
      * Returns a JIT compiler for the given target architecture.
@@ -43,6 +49,68 @@ namespace machinery {
   }
 }
 
+/**
+ * A branch target in code generated by a JIT compiler.
+ *
+ * Labels are created by `compiler::new_label()`, and are only meaningful
+ * to the compiler that created them.
+ */
+class machinery::jit::label final {
+public:
+  std::size_t id;
+
+  /**
+   * Constructor.
+   *
+   * @param id the label index within its compiler
+   */
+  explicit label(const std::size_t id) noexcept
+    : id(id) {}
+};
+
+/**
+ * A general-purpose register in code generated by a JIT compiler.
+ *
+ * Registers are numbered as the target architecture numbers its own
+ * general-purpose registers.
+ */
+class machinery::jit::reg final {
+public:
+  std::uint8_t id;
+
+  /**
+   * Constructor.
+   *
+   * @param id the target's register number
+   */
+  explicit constexpr reg(const std::uint8_t id) noexcept
+    : id(id) {}
+};
+
+/**
+ * A comparison condition for `compiler::cmp()`.
+ */
+enum class machinery::jit::condition : std::uint8_t {
+  eq,  /**< equal */
+  ne,  /**< not equal */
+  lt,  /**< signed less than */
+  le,  /**< signed less than or equal */
+  gt,  /**< signed greater than */
+  ge,  /**< signed greater than or equal */
+  ltu, /**< unsigned less than */
+  leu, /**< unsigned less than or equal */
+  gtu, /**< unsigned greater than */
+  geu, /**< unsigned greater than or equal */
+};
+
+/**
+ * The filler for alignment padding emitted by `compiler::align()`.
+ */
+enum class machinery::jit::padding : std::uint8_t {
+  nop,  /**< no-operation instructions, for padding that is executed */
+  trap, /**< breakpoint instructions, for padding that must never be executed */
+};
+
 /**
  * Base class for just-in-time (JIT) compiler implementations.
  *
@@ -53,6 +121,8 @@ protected:
   using buffer = machinery::util::appendable_buffer;
 
   buffer _buffer;
+  std::size_t _label_count {0};
+  machinery::util::cpu_features _features {machinery::util::cpu_features::host()};
 
   /**
    * Default constructor.
@@ -85,6 +155,55 @@ public:
    */
   compiler& operator=(compiler&& other) noexcept = delete;
 
+  /**
+   * Returns the buffer holding the generated code.
+   */
+  const buffer& output() const noexcept {
+    return _buffer;
+  }
+
+  /**
+   * Returns the processor features that this compiler may use.
+   *
+   * These are the host's features at construction time, as returned by
+   * `cpu_features::host()`.
+   */
+  const machinery::util::cpu_features& features() const noexcept {
+    return _features;
+  }
+
+  /**
+   * Creates a new, unbound label.
+   */
+  label new_label() noexcept {
+    return label(_label_count++);
+  }
+
+  /**
+   * Binds the given label to the current position in the generated code.
+   */
+  virtual compiler& bind(label target) = 0;
+
+  /**
+   * Pads the generated code up to the next multiple of the given boundary,
+   * e.g. to align a loop head.
+   *
+   * @param boundary a power of two, at least the target's instruction size
+   * @param fill     the filler for the padding
+   * @throws std::invalid_argument if `boundary` is not a valid alignment
+   */
+  virtual compiler& align(std::size_t boundary, padding fill = padding::nop) = 0;
+
+  /**
+   * Shortens branches in the generated code where the target permits it.
+   *
+   * This moves code, so it must be done before the code is executed. The
+   * default implementation does nothing.
+   */
+  virtual compiler& relax() {
+    return *this;
+  }
+
   /**
    * @name Control Instructions
    */
@@ -97,9 +216,9 @@ public:
   virtual compiler& enter() = 0;
 
   /**
-   * Emits a `JMP` (jump) instruction.
+   * Emits a `JMP` (jump) instruction to the given label.
    */
-  virtual compiler& jmp(...) = 0;
+  virtual compiler& jmp(label target) = 0;
 
   /**
    * Emits a `LEAVE` (leave stack frame) instruction.
@@ -135,14 +254,20 @@ public:
   virtual compiler& and_(...) = 0;
 
   /**
-   * Emits a `CLZ` (count leading zeroes) instruction.
+   * Emits a `CLZ` (count leading zeroes) instruction, setting `dst` to the
+   * number of leading zero bits in the 64-bit value of `src`.
+   *
+   * The result is 64 if `src` is zero.
    */
-  virtual compiler& clz(...) = 0;
+  virtual compiler& clz(reg dst, reg src) = 0;
 
   /**
-   * Emits a `CMP` (compare) instruction.
+   * Emits a `CMP` (compare) instruction, setting `dst` to 1 if `lhs` and
+   * `rhs` satisfy the given condition and to 0 otherwise.
+   *
+   * Implementations should produce the result without branching.
    */
-  virtual compiler& cmp(...) = 0;
+  virtual compiler& cmp(condition cond, reg dst, reg lhs, reg rhs) = 0;
 
   /**
    * Emits a `DEC` (decrement) instruction.
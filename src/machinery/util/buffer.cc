@@ -7,106 +7,232 @@
 #include "buffer.h"
 
 #include <algorithm>    /* for std::max() */
-#include <cassert>      /* for assert() */
 #include <cerrno>       /* for errno */
-#include <cstdio>       /* for std::fputc(), std::ftell() */
+#include <cstdio>       /* for std::fseek(), std::ftell(), std::fwrite() */
 #include <cstring>      /* for std::memcpy() */
-#include <stdexcept>    /* for std::bad_alloc, std::invalid_argument */
+#include <new>          /* for std::bad_alloc */
+#include <stdexcept>    /* for std::invalid_argument */
 #include <sys/mman.h>   /* for mmap(), munmap(), mremap() */
 #include <system_error> /* for std::system_error */
-#include <unistd.h>     /* for sysconf() */
+#include <unistd.h>     /* for ftruncate() */
+#include <utility>      /* for std::move(), std::swap() */
 
 using namespace machinery::util;
 
-static const int mmap_prot  = PROT_READ | PROT_WRITE | PROT_EXEC;
-static const int mmap_flags = MAP_PRIVATE | MAP_ANON;
-static const std::size_t mmap_size = sysconf(_SC_PAGESIZE);
-
 executable_buffer::executable_buffer()
-  : executable_buffer(mmap_size) {}
+  : executable_buffer(0) {}
 
-executable_buffer::executable_buffer(const std::size_t capacity)
-  : _data(nullptr),
-    _size(0),
-    _capacity(std::max(capacity, mmap_size)) {
+executable_buffer::executable_buffer(const std::size_t capacity,
+                                     const executable_mode mode,
+                                     const page_policy policy)
+  : _mapping(capacity, mode, policy) {}
 
-  void* const addr = ::mmap(nullptr, _capacity, mmap_prot, mmap_flags, -1, 0);
-  if (addr == MAP_FAILED) {
-    switch (errno) {
-      case ENOMEM: /* Cannot allocate memory in kernel */
-        throw std::bad_alloc();
-      default:
-        assert(errno != EBADF);
-        throw std::system_error(errno, std::system_category());
-    }
-  }
+executable_buffer::executable_buffer(const executable_buffer& buffer)
+  : executable_buffer(buffer.size(), buffer.mode(), buffer.policy()) {
+  std::memcpy(_mapping.data(), buffer.data(), buffer.size());
+  _size = buffer.size();
+}
 
-  _data = reinterpret_cast<std::uint8_t*>(addr);
+executable_buffer::executable_buffer(const appendable_buffer& buffer,
+                                     const executable_mode mode,
+                                     const page_policy policy)
+  : executable_buffer(buffer.size(), mode, policy) {
+  std::memcpy(_mapping.data(), buffer.data(), buffer.size());
+  _size = buffer.size();
 }
 
-executable_buffer::executable_buffer(const executable_buffer& buffer)
-  : executable_buffer(buffer.size()) {
-  std::memcpy(_data, buffer.data(), buffer.size());
+executable_buffer::executable_buffer(executable_buffer&& other) noexcept
+  : _mapping(std::move(other._mapping)),
+    _size(other._size) {
+  other._size = 0;
 }
 
-executable_buffer::executable_buffer(const appendable_buffer& buffer)
-  : executable_buffer(buffer.size()) {
-  std::memcpy(_data, buffer.data(), buffer.size());
+executable_buffer::~executable_buffer() noexcept = default;
+
+executable_buffer&
+executable_buffer::operator=(executable_buffer&& other) noexcept {
+  if (this != &other) {
+    _mapping = std::move(other._mapping);
+    _size = other._size;
+    other._size = 0;
+  }
+  return *this;
 }
 
-executable_buffer::~executable_buffer() noexcept {
-  if (_data) {
-    if (::munmap(reinterpret_cast<void*>(_data), _size) == -1) {
-      /* Ignore any errors from munmap(). */
-    }
-    _data = nullptr;
-    _size = _capacity = 0;
+executable_buffer&
+executable_buffer::reserve(const std::size_t capacity) {
+  if (capacity > _mapping.size()) {
+    _mapping.resize(capacity);
   }
+  return *this;
+}
+
+function_handle
+executable_buffer::finalize() {
+  _mapping.seal();
+  const std::size_t size = _size;
+  _size = 0;
+  return function_handle(std::move(_mapping), size);
 }
 
 void
-executable_buffer::grow() {
-#ifdef __linux__
-  // TODO: use mremap()
-#else
-  // TODO: use mmap()
-#endif
-  throw std::system_error(ENOSYS, std::system_category());
+executable_buffer::grow(const std::size_t min_capacity) {
+  _mapping.resize(std::max(min_capacity, _mapping.size() * 2));
 }
 
-persistent_buffer::persistent_buffer(FILE* const stream)
-  : _stream(stream),
-    _begin_offset(0) {
+constexpr std::size_t persistent_buffer::default_block_size;
+
+persistent_buffer::persistent_buffer(FILE* const stream,
+                                     const std::size_t block_size)
+  : _stream(stream) {
   if (!stream) {
     throw std::invalid_argument("stream cannot be nullptr");
   }
-  _begin_offset = offset();
+  long offset;
+  if ((offset = std::ftell(_stream)) == -1) {
+    throw std::system_error(errno, std::system_category());
+  }
+  _begin_offset = static_cast<std::size_t>(offset);
+  _block.reserve(std::max(block_size, std::size_t{1}));
 }
 
-persistent_buffer::~persistent_buffer() noexcept {
-  if (_stream) {
-    _stream = nullptr;
+persistent_buffer::persistent_buffer(const int fd,
+                                     const std::size_t capacity)
+  : _fd(fd) {
+  if (fd < 0) {
+    throw std::invalid_argument("fd cannot be negative");
   }
+  grow(std::max(capacity, std::size_t{1}));
 }
 
-std::size_t
-persistent_buffer::size() const {
-  return offset() - _begin_offset;
+persistent_buffer::persistent_buffer(persistent_buffer&& other) noexcept
+  : _stream(other._stream),
+    _fd(other._fd),
+    _begin_offset(other._begin_offset),
+    _size(other._size),
+    _block(std::move(other._block)),
+    _map(other._map),
+    _map_size(other._map_size) {
+  other._stream = nullptr;
+  other._fd = -1;
+  other._size = 0;
+  other._map = nullptr;
+  other._map_size = 0;
 }
 
-std::size_t
-persistent_buffer::offset() const {
-  long offset;
-  if ((offset = std::ftell(_stream)) == -1) {
-    throw std::system_error(errno, std::system_category());
+persistent_buffer::~persistent_buffer() noexcept {
+  close();
+}
+
+persistent_buffer&
+persistent_buffer::operator=(persistent_buffer&& other) noexcept {
+  if (this != &other) {
+    close();
+    std::swap(_stream, other._stream);
+    std::swap(_fd, other._fd);
+    std::swap(_begin_offset, other._begin_offset);
+    std::swap(_size, other._size);
+    std::swap(_block, other._block);
+    std::swap(_map, other._map);
+    std::swap(_map_size, other._map_size);
   }
-  return static_cast<std::size_t>(offset);
+  return *this;
 }
 
 persistent_buffer&
-persistent_buffer::append(const std::uint8_t byte) {
-  if (std::fputc(static_cast<int>(byte), _stream) == EOF) {
-    throw std::system_error(errno, std::system_category());
+persistent_buffer::patch(const std::size_t offset,
+                         const std::uint8_t* const bytes,
+                         std::size_t count) {
+  if (_map) {
+    std::memcpy(_map + offset, bytes, count);
+    return *this;
+  }
+
+  /* Patch whatever part of the range is still in the block: */
+  const std::size_t block_offset = _size - _block.size();
+  if (offset + count > block_offset) {
+    const std::size_t skip = (offset < block_offset) ? block_offset - offset : 0;
+    std::memcpy(_block.data() + (offset + skip - block_offset), bytes + skip, count - skip);
+    count = skip;
+  }
+
+  /* Patch whatever part of the range was already written out: */
+  if (count) {
+    if (std::fseek(_stream, static_cast<long>(_begin_offset + offset), SEEK_SET) == -1 ||
+        std::fwrite(bytes, 1, count, _stream) != count ||
+        std::fseek(_stream, static_cast<long>(_begin_offset + block_offset), SEEK_SET) == -1) {
+      throw std::system_error(errno, std::system_category());
+    }
+  }
+  return *this;
+}
+
+persistent_buffer&
+persistent_buffer::flush() {
+  if (_stream && !_block.empty()) {
+    if (std::fwrite(_block.data(), 1, _block.size(), _stream) != _block.size()) {
+      throw std::system_error(errno, std::system_category());
+    }
+    _block.clear();
   }
   return *this;
 }
+
+void
+persistent_buffer::grow(const std::size_t min_capacity) {
+  const std::size_t new_size = executable_mapping::round_to_pages(
+    std::max(min_capacity, _map_size * 2));
+
+  if (::ftruncate(_fd, static_cast<off_t>(new_size)) == -1) {
+    throw std::system_error(errno, std::system_category());
+  }
+
+  /* The contents live in the file, so remapping never copies anything: */
+  void* addr;
+#ifdef __linux__
+  if (_map) {
+    addr = ::mremap(reinterpret_cast<void*>(_map), _map_size, new_size, MREMAP_MAYMOVE);
+  }
+  else {
+    addr = ::mmap(nullptr, new_size, PROT_READ | PROT_WRITE, MAP_SHARED, _fd, 0);
+  }
+#else
+  addr = ::mmap(nullptr, new_size, PROT_READ | PROT_WRITE, MAP_SHARED, _fd, 0);
+  if (addr != MAP_FAILED && _map) {
+    ::munmap(reinterpret_cast<void*>(_map), _map_size);
+  }
+#endif
+  if (addr == MAP_FAILED) {
+    if (errno == ENOMEM) {
+      throw std::bad_alloc();
+    }
+    throw std::system_error(errno, std::system_category());
+  }
+
+  _map = reinterpret_cast<std::uint8_t*>(addr);
+  _map_size = new_size;
+}
+
+void
+persistent_buffer::close() noexcept {
+  if (_stream) {
+    try {
+      flush();
+    }
+    catch (const std::system_error&) {
+      /* Ignore any errors from flush(). */
+    }
+    _stream = nullptr;
+  }
+  if (_map) {
+    if (::munmap(reinterpret_cast<void*>(_map), _map_size) == -1) {
+      /* Ignore any errors from munmap(). */
+    }
+    if (::ftruncate(_fd, static_cast<off_t>(_size)) == -1) {
+      /* Ignore any errors from ftruncate(). */
+    }
+    _map = nullptr;
+    _map_size = 0;
+  }
+  _fd = -1;
+}
@@ -9,18 +9,29 @@
  * Buffer utilities.
  */
 
+#include "function.h"
+#include "mapping.h"
+
+#include <algorithm>        /* for std::max(), std::upper_bound() */
 #include <cstddef>          /* for std::size_t */
 #include <cstdint>          /* for std::uint8_t */
 #include <cstdio>           /* for FILE */
+#include <cstring>          /* for std::memcpy() */
 #include <initializer_list> /* for std::initializer_list */
-#include <stdexcept>        /* for std::logic_error */
+#include <memory>           /* for std::allocator */
+#include <new>              /* for placement new */
+#include <stdexcept>        /* for std::length_error, std::logic_error */
+#include <utility>          /* for std::forward(), std::move() */
 #include <vector>           /* for std::vector */
 
 namespace machinery {
   namespace util {
     class buffer;
     class appendable_buffer;
+    template <std::size_t N> class static_buffer;
+    class counting_buffer;
     class executable_buffer;
+    template <template <class> class Emitter> class segmented_buffer;
     class persistent_buffer;
   }
 }
@@ -53,6 +64,22 @@ public:
     throw std::logic_error("no data pointer available for this buffer type");
   }
 
+  /**
+   * Extends this buffer by the given number of bytes, returning a pointer
+   * for writing them.
+   *
+   * This lets an emitter check capacity once per instruction and then
+   * store its bytes directly.
+   *
+   * @param count the number of bytes to add
+   * @return a pointer to the first of the new bytes
+   * @pre  The caller must write all `count` bytes before any other
+   *       operation on this buffer.
+   * @post Invalidates any pointers previously returned by `data()`.
+   * @throws std::bad_alloc if out of memory
+   */
+  std::uint8_t* extend(std::size_t count);
+
   /**
    * Appends the given byte to the end of this buffer.
    *
@@ -66,13 +93,58 @@ public:
    * @throws std::bad_alloc if out of memory
    */
   buffer& append(const std::initializer_list<std::uint8_t> bytes);
+
+  /**
+   * Overwrites previously appended bytes, e.g. to fix up a branch
+   * displacement once its target is known.
+   *
+   * @param offset the byte offset to start writing at
+   * @param bytes  the replacement bytes
+   * @param count  the number of bytes to write
+   * @pre `offset + count <= size()`
+   */
+  buffer& patch(std::size_t offset, const std::uint8_t* bytes, std::size_t count);
+
+  /**
+   * Discards the bytes at and beyond the given offset, e.g. to re-emit
+   * code with a different layout.
+   *
+   * @param size the new byte size
+   * @pre `size <= size()`
+   */
+  buffer& truncate(std::size_t size);
 };
 
 /**
  * A buffer for code generation.
  */
 class machinery::util::appendable_buffer : public machinery::util::buffer {
-  std::vector<std::uint8_t> _bytes;
+  /* An allocator that leaves the bytes added by `resize()` uninitialized,
+   * since `extend()` callers overwrite them anyway: */
+  template <typename T>
+  struct uninitialized_allocator : std::allocator<T> {
+    template <typename U>
+    struct rebind {
+      using other = uninitialized_allocator<U>;
+    };
+
+    uninitialized_allocator() noexcept = default;
+
+    template <typename U>
+    uninitialized_allocator(const uninitialized_allocator<U>&) noexcept {}
+
+    template <typename U>
+    void construct(U* const pointer) noexcept {
+      ::new (static_cast<void*>(pointer)) U;
+    }
+
+    template <typename U, typename... Args>
+    void construct(U* const pointer, Args&&... args) {
+      ::new (static_cast<void*>(pointer)) U(std::forward<Args>(args)...);
+    }
+  };
+
+  std::vector<std::uint8_t, uninitialized_allocator<std::uint8_t>> _bytes;
 
 public:
   /**
@@ -126,6 +198,18 @@ public:
     return _bytes.data();
   }
 
+  /**
+   * Extends this buffer by the given number of bytes, returning a pointer
+   * for writing them.
+   *
+   * @copydetails buffer::extend
+   */
+  std::uint8_t* extend(const std::size_t count) {
+    const auto offset = _bytes.size();
+    _bytes.resize(offset + count);
+    return _bytes.data() + offset;
+  }
+
   /**
    * Appends the given byte to the end of this buffer.
    *
@@ -146,6 +230,28 @@ public:
     return *this;
   }
 
+  /**
+   * Overwrites previously appended bytes.
+   *
+   * @copydetails buffer::patch
+   */
+  appendable_buffer& patch(const std::size_t offset,
+                           const std::uint8_t* const bytes,
+                           const std::size_t count) noexcept {
+    std::memcpy(_bytes.data() + offset, bytes, count);
+    return *this;
+  }
+
+  /**
+   * Discards the bytes at and beyond the given offset.
+   *
+   * @copydetails buffer::truncate
+   */
+  appendable_buffer& truncate(const std::size_t size) noexcept {
+    _bytes.resize(size);
+    return *this;
+  }
+
   /**
    * Clears the contents of this buffer.
    *
@@ -157,15 +263,218 @@ public:
   }
 };
 
+/**
+ * A fixed-capacity buffer for code generation, with inline storage.
+ *
+ * Suitable for small stubs, such as trampolines or inline-cache entries,
+ * that should not cost a heap allocation.
+ *
+ * @tparam N the byte capacity
+ */
+template <std::size_t N>
+class machinery::util::static_buffer : public machinery::util::buffer {
+  std::size_t _size {0};
+  std::uint8_t _bytes[N];
+
+public:
+  /**
+   * Default constructor.
+   */
+  static_buffer() noexcept = default;
+
+  /**
+   * Returns the byte capacity of this buffer.
+   */
+  constexpr std::size_t capacity() const noexcept {
+    return N;
+  }
+
+  /**
+   * Returns the current byte size of this buffer.
+   */
+  std::size_t size() const noexcept {
+    return _size;
+  }
+
+  /**
+   * Returns a pointer to the byte data in this buffer.
+   */
+  const std::uint8_t* data() const noexcept {
+    return _bytes;
+  }
+
+  /**
+   * Extends this buffer by the given number of bytes, returning a pointer
+   * for writing them.
+   *
+   * @copydetails buffer::extend
+   * @throws std::length_error if the capacity would be exceeded
+   */
+  std::uint8_t* extend(const std::size_t count) {
+    if (count > N - _size) {
+      throw std::length_error("static_buffer capacity exceeded");
+    }
+    std::uint8_t* const cursor = _bytes + _size;
+    _size += count;
+    return cursor;
+  }
+
+  /**
+   * Appends the given byte to the end of this buffer.
+   *
+   * @throws std::length_error if the capacity would be exceeded
+   */
+  static_buffer& append(const std::uint8_t byte) {
+    *extend(1) = byte;
+    return *this;
+  }
+
+  /**
+   * Appends the given bytes to the end of this buffer.
+   *
+   * @throws std::length_error if the capacity would be exceeded
+   */
+  static_buffer& append(const std::initializer_list<std::uint8_t> bytes) {
+    std::memcpy(extend(bytes.size()), bytes.begin(), bytes.size());
+    return *this;
+  }
+
+  /**
+   * Overwrites previously appended bytes.
+   *
+   * @copydetails buffer::patch
+   */
+  static_buffer& patch(const std::size_t offset,
+                       const std::uint8_t* const bytes,
+                       const std::size_t count) noexcept {
+    std::memcpy(_bytes + offset, bytes, count);
+    return *this;
+  }
+
+  /**
+   * Discards the bytes at and beyond the given offset.
+   *
+   * @copydetails buffer::truncate
+   */
+  static_buffer& truncate(const std::size_t size) noexcept {
+    _size = size;
+    return *this;
+  }
+
+  /**
+   * Clears the contents of this buffer.
+   *
+   * @post `size()` is zero
+   */
+  static_buffer& clear() noexcept {
+    _size = 0;
+    return *this;
+  }
+};
+
+/**
+ * A buffer that discards its contents and only tracks its size.
+ *
+ * Running an emitter over this buffer as a dry run yields the exact byte
+ * size of the code, so that the real buffer can be allocated just once.
+ */
+class machinery::util::counting_buffer : public machinery::util::buffer {
+  std::size_t _size {0};
+  std::vector<std::uint8_t> _scratch;
+
+public:
+  /**
+   * Default constructor.
+   */
+  counting_buffer() noexcept = default;
+
+  /**
+   * Returns the current byte capacity of this buffer.
+   */
+  std::size_t capacity() const noexcept {
+    return _size;
+  }
+
+  /**
+   * Returns the current byte size of this buffer.
+   */
+  std::size_t size() const noexcept {
+    return _size;
+  }
+
+  /**
+   * Returns a null pointer, since this buffer keeps no byte data.
+   */
+  const std::uint8_t* data() const noexcept {
+    return nullptr;
+  }
+
+  /**
+   * Extends this buffer by the given number of bytes, returning a pointer
+   * to scratch memory that is overwritten by later calls.
+   *
+   * @copydetails buffer::extend
+   */
+  std::uint8_t* extend(const std::size_t count) {
+    if (count > _scratch.size()) {
+      _scratch.resize(count);
+    }
+    _size += count;
+    return _scratch.data();
+  }
+
+  /**
+   * Appends the given byte to the end of this buffer.
+   */
+  counting_buffer& append(std::uint8_t) noexcept {
+    _size++;
+    return *this;
+  }
+
+  /**
+   * Appends the given bytes to the end of this buffer.
+   */
+  counting_buffer& append(const std::initializer_list<std::uint8_t> bytes) noexcept {
+    _size += bytes.size();
+    return *this;
+  }
+
+  /**
+   * Overwrites previously appended bytes, which is a no-op.
+   */
+  counting_buffer& patch(std::size_t, const std::uint8_t*, std::size_t) noexcept {
+    return *this;
+  }
+
+  /**
+   * Discards the bytes at and beyond the given offset.
+   *
+   * @copydetails buffer::truncate
+   */
+  counting_buffer& truncate(const std::size_t size) noexcept {
+    _size = size;
+    return *this;
+  }
+
+  /**
+   * Clears the contents of this buffer.
+   *
+   * @post `size()` is zero
+   */
+  counting_buffer& clear() noexcept {
+    _size = 0;
+    return *this;
+  }
+};
+
 /**
  * A buffer for code generation and execution.
  *
  * @note Instances of this class are movable, but not copyable.
  */
 class machinery::util::executable_buffer : public machinery::util::buffer {
-  std::uint8_t* _data {nullptr};
+  executable_mapping _mapping;
   std::size_t _size {0};
-  std::size_t _capacity {0};
 
 public:
   /**
@@ -178,16 +487,26 @@ public:
   /**
    * Constructor.
    *
+   * @param capacity the initial byte capacity
+   * @param mode     the executable memory mapping strategy
+   * @param policy   the preferred page policy
    * @throws std::system_error in case of error
    */
-  executable_buffer(std::size_t capacity);
+  executable_buffer(std::size_t capacity,
+                    executable_mode mode = executable_mode::rwx,
+                    page_policy policy = page_policy::normal);
 
   /**
    * Copy constructor.
    *
+   * @param buffer the generated code to copy
+   * @param mode   the executable memory mapping strategy
+   * @param policy the preferred page policy
    * @throws std::system_error in case of error
    */
-  executable_buffer(const appendable_buffer& buffer);
+  executable_buffer(const appendable_buffer& buffer,
+                    executable_mode mode = executable_mode::rwx,
+                    page_policy policy = page_policy::normal);
 
   /**
    * Copy constructor.
@@ -199,7 +518,7 @@ public:
   /**
    * Move constructor.
    */
-  executable_buffer(executable_buffer&& other) noexcept = default;
+  executable_buffer(executable_buffer&& other) noexcept;
 
   /**
    * Destructor.
@@ -214,13 +533,27 @@ public:
   /**
    * Move assignment operator.
    */
-  executable_buffer& operator=(executable_buffer&& other) noexcept = default;
+  executable_buffer& operator=(executable_buffer&& other) noexcept;
+
+  /**
+   * Returns the executable memory mapping strategy of this buffer.
+   */
+  executable_mode mode() const noexcept {
+    return _mapping.mode();
+  }
+
+  /**
+   * Returns the page policy that took effect for this buffer.
+   */
+  page_policy policy() const noexcept {
+    return _mapping.policy();
+  }
 
   /**
    * Returns the current byte capacity of this buffer.
    */
   std::size_t capacity() const noexcept {
-    return _capacity;
+    return _mapping.size();
   }
 
   /**
@@ -234,7 +567,46 @@ public:
    * Returns a pointer to the byte data in this buffer.
    */
   const std::uint8_t* data() const noexcept {
-    return _data;
+    return _mapping.data();
+  }
+
+  /**
+   * Returns a pointer to the executable code in this buffer.
+   *
+   * For a dual-mapped buffer, this is a different address than `data()`.
+   */
+  const std::uint8_t* code() const noexcept {
+    return _mapping.code();
+  }
+
+  /**
+   * Ensures that this buffer can hold at least `capacity` bytes without
+   * needing to grow again.
+   *
+   * Callers that know the size of the generated code up front should use
+   * this to avoid relocating the buffer during code generation.
+   *
+   * @param capacity the requested minimum byte capacity
+   * @post Invalidates any pointers previously returned by `data()` in case
+   *       the capacity was increased.
+   * @throws std::bad_alloc if out of memory
+   * @throws std::system_error in case of another error
+   */
+  executable_buffer& reserve(std::size_t capacity);
+
+  /**
+   * Extends this buffer by the given number of bytes, returning a pointer
+   * for writing them.
+   *
+   * @copydetails buffer::extend
+   */
+  std::uint8_t* extend(const std::size_t count) {
+    if (count > _mapping.size() - _size) {
+      grow(_size + count);
+    }
+    std::uint8_t* const cursor = _mapping.data() + _size;
+    _size += count;
+    return cursor;
   }
 
   /**
@@ -244,10 +616,10 @@ public:
    * @throws std::bad_alloc if out of memory
    */
   executable_buffer& append(const std::uint8_t byte) {
-    if (_size == _capacity) {
-      grow();
+    if (_size == _mapping.size()) {
+      grow(_size + 1);
     }
-    _data[_size++] = byte;
+    _mapping.data()[_size++] = byte;
     return *this;
   }
 
@@ -258,12 +630,57 @@ public:
    * @throws std::bad_alloc if out of memory
    */
   executable_buffer& append(const std::initializer_list<std::uint8_t> bytes) {
-    for (const auto byte : bytes) {
-      append(byte);
-    }
+    std::memcpy(extend(bytes.size()), bytes.begin(), bytes.size());
+    return *this;
+  }
+
+  /**
+   * Overwrites previously appended bytes.
+   *
+   * @copydetails buffer::patch
+   */
+  executable_buffer& patch(const std::size_t offset,
+                           const std::uint8_t* const bytes,
+                           const std::size_t count) noexcept {
+    std::memcpy(_mapping.data() + offset, bytes, count);
+    return *this;
+  }
+
+  /**
+   * Discards the bytes at and beyond the given offset.
+   *
+   * @copydetails buffer::truncate
+   */
+  executable_buffer& truncate(const std::size_t size) noexcept {
+    _size = size;
     return *this;
   }
 
+  /**
+   * Seals the code in this buffer and hands over its memory to a function
+   * handle, without copying it.
+   *
+   * @post This buffer is empty, and must not be used again except to be
+   *       destroyed or assigned to.
+   * @throws std::system_error in case of error
+   * @see executable_mapping::seal()
+   */
+  function_handle finalize();
+
+  /**
+   * Seals the code in this buffer and hands over its memory to a typed,
+   * callable function handle, without copying it.
+   *
+   * @tparam Signature the function type, e.g. `int(const char*, int)`
+   * @post This buffer is empty, and must not be used again except to be
+   *       destroyed or assigned to.
+   * @throws std::system_error in case of error
+   */
+  template <typename Signature>
+  jit_function<Signature> finalize() {
+    return jit_function<Signature>(finalize());
+  }
+
   /**
    * Executes the code in this buffer.
    *
@@ -271,7 +688,7 @@ public:
    * @post Processor registers may be clobbered.
    */
   void execute() const {
-    reinterpret_cast<void (*)()>(_data)();
+    reinterpret_cast<void (*)()>(code())();
   }
 
   /**
@@ -286,41 +703,316 @@ public:
    */
   template <typename T>
   T execute() const {
-    return reinterpret_cast<T (*)()>(_data)();
+    return reinterpret_cast<T (*)()>(code())();
   }
 
 protected:
   /**
-   * Grows the size of this buffer.
+   * Grows the capacity of this buffer to hold at least `min_capacity` bytes.
    *
+   * The capacity is at least doubled on each call, so that appending to the
+   * buffer takes amortized constant time.
+   *
+   * @param min_capacity the required minimum byte capacity
    * @throws std::bad_alloc if out of memory
    * @throws std::system_error in case of another error
    */
-  void grow();
+  void grow(std::size_t min_capacity);
 };
 
 /**
- * A buffer for code generation into a file stream.
+ * A buffer for code generation and execution that never relocates.
+ *
+ * Grows by mapping additional fixed-size segments instead of moving its
+ * contents, so that code addresses stay valid for the lifetime of the
+ * buffer. When an instruction does not fit into the current segment, a
+ * far jump to the next segment is emitted at the end of the current one
+ * using `Emitter::far_jump()`. An instruction never straddles segments.
+ *
+ * Byte offsets are logical: they count every emitted byte, including the
+ * segment links, as if the segments were contiguous.
+ *
+ * @tparam Emitter the emitter template for the target architecture,
+ *                 e.g. `machinery::arch::x86_emitter`
+ * @note Instances of this class are movable, but not copyable.
+ */
+template <template <class> class Emitter>
+class machinery::util::segmented_buffer : public machinery::util::buffer {
+  using link_buffer = static_buffer<64>;
+
+  std::size_t _segment_size;
+  executable_mode _mode;
+  page_policy _policy;
+  std::vector<executable_mapping> _segments;
+  std::vector<std::size_t> _offsets;
+  std::uint8_t* _cursor {nullptr};
+  std::uint8_t* _limit {nullptr};
+  std::size_t _size {0};
+
+public:
+  /**
+   * The byte size of the far jump that links two segments.
+   */
+  static constexpr std::size_t link_size = Emitter<link_buffer>::far_jump_size;
+
+  /**
+   * The default byte size of each segment.
+   */
+  static constexpr std::size_t default_segment_size = 64 * 1024;
+
+  /**
+   * Constructor.
+   *
+   * @param segment_size the byte size of each segment
+   * @param mode         the executable memory mapping strategy
+   * @param policy       the preferred page policy
+   * @throws std::bad_alloc if out of memory
+   * @throws std::system_error in case of another error
+   */
+  explicit segmented_buffer(const std::size_t segment_size = default_segment_size,
+                            const executable_mode mode = executable_mode::rwx,
+                            const page_policy policy = page_policy::normal)
+    : _segment_size(segment_size),
+      _mode(mode),
+      _policy(policy) {
+    add_segment(0);
+  }
+
+  /**
+   * Copy constructor.
+   */
+  segmented_buffer(const segmented_buffer& other) = delete;
+
+  /**
+   * Move constructor.
+   */
+  segmented_buffer(segmented_buffer&& other) noexcept = default;
+
+  /**
+   * Destructor.
+   */
+  ~segmented_buffer() noexcept = default;
+
+  /**
+   * Copy assignment operator.
+   */
+  segmented_buffer& operator=(const segmented_buffer& other) = delete;
+
+  /**
+   * Move assignment operator.
+   */
+  segmented_buffer& operator=(segmented_buffer&& other) noexcept = default;
+
+  /**
+   * Returns the number of segments mapped by this buffer.
+   */
+  std::size_t segment_count() const noexcept {
+    return _segments.size();
+  }
+
+  /**
+   * Returns the current byte capacity of this buffer.
+   */
+  std::size_t capacity() const noexcept {
+    return _size + (_limit - _cursor);
+  }
+
+  /**
+   * Returns the current byte size of this buffer.
+   */
+  std::size_t size() const noexcept {
+    return _size;
+  }
+
+  /**
+   * Returns a pointer to the executable code at the given byte offset.
+   *
+   * The pointer stays valid for the lifetime of this buffer. At `size()`,
+   * it points to where the next instruction goes, unless that instruction
+   * doesn't fit, in which case a link to it will be emitted there.
+   *
+   * @pre `offset <= size()`
+   */
+  const std::uint8_t* address(const std::size_t offset) const noexcept {
+    const std::size_t index = segment_index(offset);
+    return _segments[index].code() + (offset - _offsets[index]);
+  }
+
+  /**
+   * Returns a pointer to the executable code in this buffer.
+   */
+  const std::uint8_t* code() const noexcept {
+    return _segments.front().code();
+  }
+
+  /**
+   * Extends this buffer by the given number of bytes, returning a pointer
+   * for writing them.
+   *
+   * @copydetails buffer::extend
+   * @note Unlike other buffers, this never invalidates earlier pointers.
+   * @throws std::system_error in case of another error
+   */
+  std::uint8_t* extend(const std::size_t count) {
+    if (count > static_cast<std::size_t>(_limit - _cursor)) {
+      add_segment(count);
+    }
+    std::uint8_t* const cursor = _cursor;
+    _cursor += count;
+    _size += count;
+    return cursor;
+  }
+
+  /**
+   * Appends the given byte to the end of this buffer.
+   *
+   * @throws std::bad_alloc if out of memory
+   * @throws std::system_error in case of another error
+   */
+  segmented_buffer& append(const std::uint8_t byte) {
+    *extend(1) = byte;
+    return *this;
+  }
+
+  /**
+   * Appends the given bytes to the end of this buffer.
+   *
+   * @throws std::bad_alloc if out of memory
+   * @throws std::system_error in case of another error
+   */
+  segmented_buffer& append(const std::initializer_list<std::uint8_t> bytes) {
+    std::memcpy(extend(bytes.size()), bytes.begin(), bytes.size());
+    return *this;
+  }
+
+  /**
+   * Overwrites previously appended bytes.
+   *
+   * @copydetails buffer::patch
+   * @pre The bytes must lie within a single segment, which holds for any
+   *      range within one instruction.
+   */
+  segmented_buffer& patch(const std::size_t offset,
+                          const std::uint8_t* const bytes,
+                          const std::size_t count) noexcept {
+    const std::size_t index = segment_index(offset);
+    std::memcpy(_segments[index].data() + (offset - _offsets[index]), bytes, count);
+    return *this;
+  }
+
+  /**
+   * Executes the code in this buffer.
+   *
+   * @pre  The generated code must include a return instruction.
+   * @post Processor registers may be clobbered.
+   */
+  void execute() const {
+    reinterpret_cast<void (*)()>(code())();
+  }
+
+  /**
+   * Executes the code in this buffer, returning a value of type `T`.
+   *
+   * @return a value of type `T`
+   * @pre  The generated code must include a return instruction.
+   * @post Processor registers may be clobbered.
+   */
+  template <typename T>
+  T execute() const {
+    return reinterpret_cast<T (*)()>(code())();
+  }
+
+protected:
+  std::size_t segment_index(const std::size_t offset) const noexcept {
+    return (std::upper_bound(_offsets.begin(), _offsets.end(), offset) - _offsets.begin()) - 1;
+  }
+
+  /**
+   * Maps a new segment with room for at least `count` bytes, and links the
+   * current segment to it.
+   */
+  void add_segment(const std::size_t count) {
+    executable_mapping segment(std::max(_segment_size, count + link_size), _mode, _policy);
+
+    if (_cursor) {
+      link_buffer link;
+      Emitter<link_buffer>(link).far_jump(segment.code());
+      std::memcpy(_cursor, link.data(), link.size());
+      _size += link.size();
+    }
+
+    _offsets.push_back(_size);
+    _segments.push_back(std::move(segment));
+    _cursor = _segments.back().data();
+    _limit = _cursor + _segments.back().size() - link_size;
+  }
+};
+
+template <template <class> class Emitter>
+constexpr std::size_t machinery::util::segmented_buffer<Emitter>::link_size;
+
+template <template <class> class Emitter>
+constexpr std::size_t machinery::util::segmented_buffer<Emitter>::default_segment_size;
+
+/**
+ * A buffer for code generation into a file.
+ *
+ * In stream mode, bytes are collected into a block that is written to the
+ * stream whenever it fills up. In mapped mode, bytes are written directly
+ * into a shared memory mapping of a file, which is extended as needed and
+ * truncated to the final size on destruction.
+ *
+ * Either way, the size is tracked without system calls, and earlier
+ * offsets can be back-patched.
  *
  * @note Instances of this class are movable, but not copyable.
  */
 class machinery::util::persistent_buffer : public machinery::util::buffer {
-  FILE* _stream;
-  std::size_t _begin_offset;
+  FILE* _stream {nullptr};
+  int _fd {-1};
+  std::size_t _begin_offset {0};
+  std::size_t _size {0};
+  std::vector<std::uint8_t> _block;
+  std::uint8_t* _map {nullptr};
+  std::size_t _map_size {0};
 
 public:
+  /**
+   * The default byte size of a stream-mode block.
+   */
+  static constexpr std::size_t default_block_size = 64 * 1024;
+
   /**
    * Default constructor.
    */
   persistent_buffer() noexcept = delete;
 
   /**
-   * Default constructor.
+   * Constructor for stream mode.
    *
+   * Output begins at the current offset of the stream.
+   *
+   * @param stream     the output stream
+   * @param block_size the byte size of the write block
    * @throws std::invalid_argument if `stream` is `nullptr`
    * @throws std::system_error in case of error
    */
-  persistent_buffer(FILE* stream);
+  persistent_buffer(FILE* stream,
+                    std::size_t block_size = default_block_size);
+
+  /**
+   * Constructor for mapped mode.
+   *
+   * Output begins at offset zero of the file, which is resized to
+   * `capacity` bytes up front.
+   *
+   * @param fd       a file descriptor open for reading and writing
+   * @param capacity the initial byte capacity
+   * @throws std::invalid_argument if `fd` is negative
+   * @throws std::bad_alloc if out of memory
+   * @throws std::system_error in case of error
+   */
+  persistent_buffer(int fd, std::size_t capacity);
 
   /**
    * Copy constructor.
@@ -330,10 +1022,12 @@ public:
   /**
    * Move constructor.
    */
-  persistent_buffer(persistent_buffer&& other) noexcept = default;
+  persistent_buffer(persistent_buffer&& other) noexcept;
 
   /**
    * Destructor.
+   *
+   * Flushes any buffered bytes, ignoring errors.
    */
   ~persistent_buffer() noexcept;
 
@@ -345,37 +1039,65 @@ public:
   /**
    * Move assignment operator.
    */
-  persistent_buffer& operator=(persistent_buffer&& other) noexcept = default;
+  persistent_buffer& operator=(persistent_buffer&& other) noexcept;
 
   /**
    * Returns the current byte capacity of this buffer.
-   *
-   * @throws std::system_error in case of error
    */
-  std::size_t capacity() const {
-    return size();
+  std::size_t capacity() const noexcept {
+    return _map ? _map_size : (_size - _block.size() + _block.capacity());
   }
 
   /**
    * Returns the current byte size of this buffer.
-   *
-   * @throws std::system_error in case of error
    */
-  std::size_t size() const;
+  std::size_t size() const noexcept {
+    return _size;
+  }
 
   /**
    * Returns the current file offset.
+   */
+  std::size_t offset() const noexcept {
+    return _begin_offset + _size;
+  }
+
+  /**
+   * Extends this buffer by the given number of bytes, returning a pointer
+   * for writing them.
    *
+   * @copydetails buffer::extend
    * @throws std::system_error in case of error
    */
-  std::size_t offset() const;
+  std::uint8_t* extend(const std::size_t count) {
+    std::uint8_t* cursor;
+    if (_map) {
+      if (count > _map_size - _size) {
+        grow(_size + count);
+      }
+      cursor = _map + _size;
+    }
+    else {
+      if (count > _block.capacity() - _block.size()) {
+        flush();
+      }
+      const auto offset = _block.size();
+      _block.resize(offset + count);
+      cursor = _block.data() + offset;
+    }
+    _size += count;
+    return cursor;
+  }
 
   /**
    * Appends the given byte to the end of this buffer.
    *
    * @throws std::system_error in case of error
    */
-  persistent_buffer& append(const std::uint8_t byte);
+  persistent_buffer& append(const std::uint8_t byte) {
+    *extend(1) = byte;
+    return *this;
+  }
 
   /**
    * Appends the given bytes to the end of this buffer.
@@ -383,11 +1105,42 @@ public:
    * @throws std::system_error in case of error
    */
   persistent_buffer& append(const std::initializer_list<std::uint8_t> bytes) {
-    for (const auto byte : bytes) {
-      append(byte);
-    }
+    std::memcpy(extend(bytes.size()), bytes.begin(), bytes.size());
     return *this;
   }
+
+  /**
+   * Overwrites previously appended bytes.
+   *
+   * In stream mode, bytes that were already written out are patched by
+   * seeking the stream.
+   *
+   * @copydetails buffer::patch
+   * @throws std::system_error in case of error
+   */
+  persistent_buffer& patch(std::size_t offset,
+                           const std::uint8_t* bytes,
+                           std::size_t count);
+
+  /**
+   * Writes any buffered bytes to the stream.
+   *
+   * This is a no-op in mapped mode.
+   *
+   * @throws std::system_error in case of error
+   */
+  persistent_buffer& flush();
+
+protected:
+  /**
+   * Extends the mapped file to hold at least `min_capacity` bytes.
+   *
+   * @throws std::bad_alloc if out of memory
+   * @throws std::system_error in case of another error
+   */
+  void grow(std::size_t min_capacity);
+
+  void close() noexcept;
 };
 
 #endif /* MACHINERY_UTIL_BUFFER_H */
@@ -0,0 +1,177 @@
+/* This is free and unencumbered software released into the public domain. */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include "code_heap.h"
+
+#include <algorithm> /* for std::max(), std::min() */
+#include <cstring>   /* for std::memcpy() */
+#include <new>       /* for std::bad_alloc */
+#include <stdexcept> /* for std::invalid_argument, std::logic_error */
+#include <utility>   /* for std::move(), std::swap() */
+
+using namespace machinery::util;
+
+constexpr std::size_t code_heap::default_region_size;
+constexpr std::size_t code_heap::default_alignment;
+
+code_heap::code_heap(const std::size_t region_size,
+                     const std::size_t alignment,
+                     const executable_mode mode,
+                     const page_policy policy)
+  : _region_size(executable_mapping::round_to_pages(region_size)),
+    _alignment(alignment),
+    _mode(mode),
+    _policy(policy),
+    _free_lists(sizeof(std::size_t) * 8) {
+  if (alignment == 0 || (alignment & (alignment - 1)) != 0) {
+    throw std::invalid_argument("alignment must be a power of two");
+  }
+}
+
+code_heap::~code_heap() noexcept = default;
+
+page_policy
+code_heap::policy() const noexcept {
+  page_policy result = _policy;
+  for (const auto& region : _regions) {
+    result = std::min(result, region.policy());
+  }
+  return result;
+}
+
+code_heap_buffer
+code_heap::allocate(std::size_t capacity) {
+  const slot entry = allocate_slot(capacity);
+  return code_heap_buffer(this, entry.data, entry.code, capacity);
+}
+
+std::size_t
+code_heap::size_class(const std::size_t capacity) const noexcept {
+  std::size_t index = 0;
+  while ((_alignment << index) < capacity) {
+    index++;
+  }
+  return index;
+}
+
+code_heap::slot
+code_heap::allocate_slot(std::size_t& capacity) {
+  const std::size_t index = size_class(std::max(capacity, std::size_t{1}));
+  const std::size_t slot_size = _alignment << index;
+
+  if (!_free_lists[index].empty()) {
+    const slot entry = _free_lists[index].back();
+    _free_lists[index].pop_back();
+    _free_size -= slot_size;
+    _allocated_size += slot_size;
+    capacity = slot_size;
+    return entry;
+  }
+
+  if (_next == nullptr || static_cast<std::size_t>(_limit - _next) < slot_size) {
+    reserve_region(slot_size);
+  }
+
+  const auto& region = _regions.back();
+  const slot entry {_next, region.code() + (_next - region.data())};
+  _next += slot_size;
+  _allocated_size += slot_size;
+  capacity = slot_size;
+  return entry;
+}
+
+void
+code_heap::release_slot(const slot& entry,
+                        const std::size_t capacity) noexcept {
+  _allocated_size -= capacity;
+  try {
+    _free_lists[size_class(capacity)].push_back(entry);
+    _free_size += capacity;
+  }
+  catch (const std::bad_alloc&) {
+    /* Leak the slot rather than fail; it is reclaimed with the heap. */
+  }
+}
+
+void
+code_heap::reserve_region(const std::size_t size) {
+  /* Carve the unused tail of the current region into free-list slots: */
+  while (_next != nullptr && static_cast<std::size_t>(_limit - _next) >= _alignment) {
+    std::size_t index = size_class(_limit - _next);
+    if ((_alignment << index) > static_cast<std::size_t>(_limit - _next)) {
+      index--;
+    }
+    const std::size_t slot_size = _alignment << index;
+    const auto& region = _regions.back();
+    _allocated_size += slot_size;
+    release_slot({_next, region.code() + (_next - region.data())}, slot_size);
+    _next += slot_size;
+  }
+
+  executable_mapping region(std::max(_region_size, size), _mode, _policy);
+  _regions.push_back(std::move(region));
+
+  _next = _regions.back().data();
+  _limit = _next + _regions.back().size();
+  _reserved_size += _regions.back().size();
+}
+
+code_heap_buffer::code_heap_buffer(code_heap_buffer&& other) noexcept
+  : _heap(other._heap),
+    _data(other._data),
+    _code(other._code),
+    _size(other._size),
+    _capacity(other._capacity) {
+  other._heap = nullptr;
+  other._data = other._code = nullptr;
+  other._size = other._capacity = 0;
+}
+
+code_heap_buffer::~code_heap_buffer() noexcept {
+  release();
+}
+
+code_heap_buffer&
+code_heap_buffer::operator=(code_heap_buffer&& other) noexcept {
+  if (this != &other) {
+    release();
+    std::swap(_heap, other._heap);
+    std::swap(_data, other._data);
+    std::swap(_code, other._code);
+    std::swap(_size, other._size);
+    std::swap(_capacity, other._capacity);
+  }
+  return *this;
+}
+
+void
+code_heap_buffer::release() noexcept {
+  if (_data) {
+    _heap->release_slot({_data, _code}, _capacity);
+    _data = _code = nullptr;
+    _size = _capacity = 0;
+  }
+}
+
+void
+code_heap_buffer::grow(const std::size_t min_capacity) {
+  if (_heap == nullptr) {
+    throw std::logic_error("buffer is not attached to a code heap");
+  }
+
+  std::size_t new_capacity = std::max(min_capacity, _capacity * 2);
+  const auto slot = _heap->allocate_slot(new_capacity);
+  if (_size) {
+    std::memcpy(slot.data, _data, _size);
+  }
+  if (_data) {
+    _heap->release_slot({_data, _code}, _capacity);
+  }
+
+  _data = slot.data;
+  _code = slot.code;
+  _capacity = new_capacity;
+}
@@ -0,0 +1,381 @@
+/* This is free and unencumbered software released into the public domain. */
+
+#ifndef MACHINERY_UTIL_CODE_HEAP_H
+#define MACHINERY_UTIL_CODE_HEAP_H
+
+/**
+ * @file
+ *
+ * Shared executable memory for many small functions.
+ */
+
+#include "buffer.h"
+#include "mapping.h"
+
+#include <cstddef>          /* for std::size_t */
+#include <cstdint>          /* for std::uint8_t */
+#include <cstring>          /* for std::memcpy() */
+#include <initializer_list> /* for std::initializer_list */
+#include <vector>           /* for std::vector */
+
+namespace machinery {
+  namespace util {
+    class code_heap;
+    class code_heap_buffer;
+  }
+}
+
+/**
+ * A heap of executable memory.
+ *
+ * Reserves large executable regions up front and sub-allocates aligned
+ * function slots from them, using a bump pointer for fresh memory and
+ * per-size-class free lists for released slots. Slot sizes are rounded up
+ * to a power-of-two multiple of the alignment.
+ *
+ * @note Instances of this class are not movable or copyable.
+ * @note Instances of this class are not thread-safe.
+ * @note The heap must outlive every buffer allocated from it.
+ */
+class machinery::util::code_heap {
+  friend class code_heap_buffer;
+
+  struct slot {
+    std::uint8_t* data;
+    std::uint8_t* code;
+  };
+
+  std::size_t _region_size;
+  std::size_t _alignment;
+  executable_mode _mode;
+  page_policy _policy;
+  std::vector<executable_mapping> _regions;
+  std::vector<std::vector<slot>> _free_lists;
+  std::uint8_t* _next {nullptr};
+  std::uint8_t* _limit {nullptr};
+  std::size_t _reserved_size {0};
+  std::size_t _allocated_size {0};
+  std::size_t _free_size {0};
+
+public:
+  /**
+   * The default byte size of each reserved region.
+   */
+  static constexpr std::size_t default_region_size = 2 * 1024 * 1024;
+
+  /**
+   * The default byte alignment of each function slot.
+   */
+  static constexpr std::size_t default_alignment = 16;
+
+  /**
+   * Constructor.
+   *
+   * @param region_size the byte size of each reserved region
+   * @param alignment   the byte alignment of each function slot
+   * @param mode        the executable memory mapping strategy
+   * @param policy      the preferred page policy for regions
+   * @throws std::invalid_argument if `alignment` is not a power of two
+   */
+  explicit code_heap(std::size_t region_size = default_region_size,
+                     std::size_t alignment = default_alignment,
+                     executable_mode mode = executable_mode::rwx,
+                     page_policy policy = page_policy::normal);
+
+  /**
+   * Copy constructor.
+   */
+  code_heap(const code_heap& other) = delete;
+
+  /**
+   * Move constructor.
+   */
+  code_heap(code_heap&& other) = delete;
+
+  /**
+   * Destructor.
+   */
+  ~code_heap() noexcept;
+
+  /**
+   * Copy assignment operator.
+   */
+  code_heap& operator=(const code_heap& other) = delete;
+
+  /**
+   * Move assignment operator.
+   */
+  code_heap& operator=(code_heap&& other) = delete;
+
+  /**
+   * Allocates a function slot from this heap.
+   *
+   * @param capacity the initial byte capacity of the slot
+   * @throws std::bad_alloc if out of memory
+   * @throws std::system_error in case of another error
+   */
+  code_heap_buffer allocate(std::size_t capacity = default_alignment);
+
+  /**
+   * Returns the executable memory mapping strategy of this heap.
+   */
+  executable_mode mode() const noexcept {
+    return _mode;
+  }
+
+  /**
+   * Returns the page policy that took effect for this heap's regions.
+   *
+   * If the regions ended up with different policies, this is the weakest
+   * of them. Before any region is reserved, this is the preferred policy.
+   */
+  page_policy policy() const noexcept;
+
+  /**
+   * Returns the number of regions reserved by this heap.
+   */
+  std::size_t region_count() const noexcept {
+    return _regions.size();
+  }
+
+  /**
+   * Returns the total byte size of the regions reserved by this heap.
+   */
+  std::size_t reserved_size() const noexcept {
+    return _reserved_size;
+  }
+
+  /**
+   * Returns the total byte size of the slots currently in use.
+   */
+  std::size_t allocated_size() const noexcept {
+    return _allocated_size;
+  }
+
+  /**
+   * Returns the total byte size of the released slots held in free lists.
+   */
+  std::size_t free_size() const noexcept {
+    return _free_size;
+  }
+
+  /**
+   * Returns the fraction of reserved memory occupied by slots in use.
+   *
+   * @return a ratio in the range 0.0..1.0
+   */
+  double occupancy() const noexcept {
+    return _reserved_size ? double(_allocated_size) / _reserved_size : 0.0;
+  }
+
+  /**
+   * Returns the fraction of carved-out memory that sits in free lists.
+   *
+   * A high value means that released slots are not being reused, e.g.
+   * because their size classes do not match new requests.
+   *
+   * @return a ratio in the range 0.0..1.0
+   */
+  double fragmentation() const noexcept {
+    const std::size_t carved = _allocated_size + _free_size;
+    return carved ? double(_free_size) / carved : 0.0;
+  }
+
+protected:
+  slot allocate_slot(std::size_t& capacity);
+
+  void release_slot(const slot& entry, std::size_t capacity) noexcept;
+
+  std::size_t size_class(std::size_t capacity) const noexcept;
+
+  void reserve_region(std::size_t size);
+};
+
+/**
+ * A buffer for code generation and execution, backed by a slot in a
+ * `code_heap`.
+ *
+ * When the slot fills up, the contents are moved to a larger slot.
+ *
+ * @note Instances of this class are movable, but not copyable.
+ */
+class machinery::util::code_heap_buffer : public machinery::util::buffer {
+  friend class code_heap;
+
+  code_heap* _heap {nullptr};
+  std::uint8_t* _data {nullptr};
+  std::uint8_t* _code {nullptr};
+  std::size_t _size {0};
+  std::size_t _capacity {0};
+
+  code_heap_buffer(code_heap* heap, std::uint8_t* data, std::uint8_t* code,
+                   std::size_t capacity) noexcept
+    : _heap(heap),
+      _data(data),
+      _code(code),
+      _capacity(capacity) {}
+
+  /**
+   * Returns the slot of this buffer, if any, to the heap.
+   */
+  void release() noexcept;
+
+public:
+  /**
+   * Default constructor.
+   */
+  code_heap_buffer() noexcept = default;
+
+  /**
+   * Copy constructor.
+   */
+  code_heap_buffer(const code_heap_buffer& other) = delete;
+
+  /**
+   * Move constructor.
+   */
+  code_heap_buffer(code_heap_buffer&& other) noexcept;
+
+  /**
+   * Destructor.
+   *
+   * Releases the slot back to the heap.
+   */
+  ~code_heap_buffer() noexcept;
+
+  /**
+   * Copy assignment operator.
+   */
+  code_heap_buffer& operator=(const code_heap_buffer& other) = delete;
+
+  /**
+   * Move assignment operator.
+   */
+  code_heap_buffer& operator=(code_heap_buffer&& other) noexcept;
+
+  /**
+   * Returns the current byte capacity of this buffer.
+   */
+  std::size_t capacity() const noexcept {
+    return _capacity;
+  }
+
+  /**
+   * Returns the current byte size of this buffer.
+   */
+  std::size_t size() const noexcept {
+    return _size;
+  }
+
+  /**
+   * Returns a pointer to the byte data in this buffer.
+   */
+  const std::uint8_t* data() const noexcept {
+    return _data;
+  }
+
+  /**
+   * Returns a pointer to the executable code in this buffer.
+   *
+   * For a dual-mapped heap, this is a different address than `data()`.
+   */
+  const std::uint8_t* code() const noexcept {
+    return _code;
+  }
+
+  /**
+   * Extends this buffer by the given number of bytes, returning a pointer
+   * for writing them.
+   *
+   * @copydetails buffer::extend
+   */
+  std::uint8_t* extend(const std::size_t count) {
+    if (count > _capacity - _size) {
+      grow(_size + count);
+    }
+    std::uint8_t* const cursor = _data + _size;
+    _size += count;
+    return cursor;
+  }
+
+  /**
+   * Appends the given byte to the end of this buffer.
+   *
+   * @post Invalidates any pointers previously returned by `data()`.
+   * @throws std::bad_alloc if out of memory
+   */
+  code_heap_buffer& append(const std::uint8_t byte) {
+    if (_size == _capacity) {
+      grow(_size + 1);
+    }
+    _data[_size++] = byte;
+    return *this;
+  }
+
+  /**
+   * Appends the given bytes to the end of this buffer.
+   *
+   * @post Invalidates any pointers previously returned by `data()`.
+   * @throws std::bad_alloc if out of memory
+   */
+  code_heap_buffer& append(const std::initializer_list<std::uint8_t> bytes) {
+    std::memcpy(extend(bytes.size()), bytes.begin(), bytes.size());
+    return *this;
+  }
+
+  /**
+   * Overwrites previously appended bytes.
+   *
+   * @copydetails buffer::patch
+   */
+  code_heap_buffer& patch(const std::size_t offset,
+                          const std::uint8_t* const bytes,
+                          const std::size_t count) noexcept {
+    std::memcpy(_data + offset, bytes, count);
+    return *this;
+  }
+
+  /**
+   * Discards the bytes at and beyond the given offset.
+   *
+   * @copydetails buffer::truncate
+   */
+  code_heap_buffer& truncate(const std::size_t size) noexcept {
+    _size = size;
+    return *this;
+  }
+
+  /**
+   * Executes the code in this buffer.
+   *
+   * @pre  The generated code must include a return instruction.
+   * @post Processor registers may be clobbered.
+   */
+  void execute() const {
+    reinterpret_cast<void (*)()>(_code)();
+  }
+
+  /**
+   * Executes the code in this buffer, returning a value of type `T`.
+   *
+   * @return a value of type `T`
+   * @pre  The generated code must include a return instruction.
+   * @post Processor registers may be clobbered.
+   */
+  template <typename T>
+  T execute() const {
+    return reinterpret_cast<T (*)()>(_code)();
+  }
+
+protected:
+  /**
+   * Moves the contents of this buffer into a slot holding at least
+   * `min_capacity` bytes.
+   *
+   * @throws std::bad_alloc if out of memory
+   * @throws std::system_error in case of another error
+   */
+  void grow(std::size_t min_capacity);
+};
+
+#endif /* MACHINERY_UTIL_CODE_HEAP_H */
@@ -0,0 +1,170 @@
+/* This is free and unencumbered software released into the public domain. */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include "cpu.h"
+
+#include <atomic>  /* for std::atomic */
+#include <cassert> /* for assert() */
+#include <cstddef> /* for std::size_t */
+#include <cstring> /* for std::strcmp() */
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h> /* for __get_cpuid(), __get_cpuid_count() */
+#endif
+
+#if defined(__aarch64__) && defined(__linux__)
+#include <sys/auxv.h> /* for getauxval() */
+#endif
+
+using namespace machinery::util;
+
+static const char* const feature_names[] = {
+  "sse2",
+  "sse3",
+  "ssse3",
+  "sse41",
+  "sse42",
+  "popcnt",
+  "lzcnt",
+  "bmi1",
+  "bmi2",
+  "avx",
+  "avx2",
+  "fma",
+  "avx512f",
+  "avx512cd",
+  "avx512dq",
+  "avx512bw",
+  "avx512vl",
+  "asimd",
+  "crc32",
+  "atomics",
+  "dotprod",
+  "sve",
+  "sve2",
+  "cssc",
+};
+
+static_assert(sizeof(feature_names) / sizeof(feature_names[0]) ==
+              static_cast<std::size_t>(cpu_feature::count),
+              "feature_names must name every cpu_feature");
+
+/* The override, if any, with the top bit marking it as present: */
+static const std::uint64_t override_flag = std::uint64_t{1} << 63;
+static std::atomic<std::uint64_t> host_override {0};
+
+#if defined(__x86_64__) || defined(__i386__)
+static std::uint64_t
+read_xcr0() noexcept {
+  std::uint32_t eax, edx;
+  __asm__ volatile ("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+  return (std::uint64_t{edx} << 32) | eax;
+}
+
+static void
+detect_x86(cpu_features& features) noexcept {
+  unsigned int eax, ebx, ecx, edx;
+  if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx)) {
+    return;
+  }
+  if (edx & bit_SSE2)   features.set(cpu_feature::sse2);
+  if (ecx & bit_SSE3)   features.set(cpu_feature::sse3);
+  if (ecx & bit_SSSE3)  features.set(cpu_feature::ssse3);
+  if (ecx & bit_SSE4_1) features.set(cpu_feature::sse41);
+  if (ecx & bit_SSE4_2) features.set(cpu_feature::sse42);
+  if (ecx & bit_POPCNT) features.set(cpu_feature::popcnt);
+
+  /* AVX state must be enabled by the operating system in XCR0: */
+  const std::uint64_t xcr0 = (ecx & bit_OSXSAVE) ? read_xcr0() : 0;
+  const bool avx_state = (xcr0 & 0x06) == 0x06;       /* XMM, YMM */
+  const bool avx512_state = (xcr0 & 0xE6) == 0xE6;    /* and opmask, ZMM */
+  if (avx_state && (ecx & bit_AVX)) features.set(cpu_feature::avx);
+  if (avx_state && (ecx & bit_FMA)) features.set(cpu_feature::fma);
+
+  if (__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx)) {
+    if (ebx & bit_BMI)  features.set(cpu_feature::bmi1);
+    if (ebx & bit_BMI2) features.set(cpu_feature::bmi2);
+    if (avx_state && (ebx & bit_AVX2)) features.set(cpu_feature::avx2);
+    if (avx512_state && (ebx & bit_AVX512F)) {
+      features.set(cpu_feature::avx512f);
+      if (ebx & bit_AVX512CD) features.set(cpu_feature::avx512cd);
+      if (ebx & bit_AVX512DQ) features.set(cpu_feature::avx512dq);
+      if (ebx & bit_AVX512BW) features.set(cpu_feature::avx512bw);
+      if (ebx & bit_AVX512VL) features.set(cpu_feature::avx512vl);
+    }
+  }
+
+  if (__get_cpuid(0x80000001, &eax, &ebx, &ecx, &edx)) {
+    if (ecx & bit_LZCNT) features.set(cpu_feature::lzcnt);
+  }
+}
+#endif
+
+#if defined(__aarch64__) && defined(__linux__)
+static void
+detect_aarch64(cpu_features& features) noexcept {
+  /* The bits of AT_HWCAP and AT_HWCAP2, per <asm/hwcap.h>: */
+  const unsigned long hwcap = getauxval(AT_HWCAP);
+  const unsigned long hwcap2 = getauxval(AT_HWCAP2);
+  if (hwcap & (1UL << 1))   features.set(cpu_feature::asimd);
+  if (hwcap & (1UL << 7))   features.set(cpu_feature::crc32);
+  if (hwcap & (1UL << 8))   features.set(cpu_feature::atomics);
+  if (hwcap & (1UL << 20))  features.set(cpu_feature::dotprod);
+  if (hwcap & (1UL << 22))  features.set(cpu_feature::sve);
+  if (hwcap2 & (1UL << 1))  features.set(cpu_feature::sve2);
+  if (hwcap2 & (1UL << 34)) features.set(cpu_feature::cssc);
+}
+#endif
+
+cpu_features
+cpu_features::detect() noexcept {
+  cpu_features features;
+#if defined(__x86_64__) || defined(__i386__)
+  detect_x86(features);
+#endif
+#if defined(__aarch64__) && defined(__linux__)
+  detect_aarch64(features);
+#endif
+  return features;
+}
+
+cpu_features
+cpu_features::host() noexcept {
+  const std::uint64_t bits = host_override.load(std::memory_order_acquire);
+  if (bits & override_flag) {
+    return cpu_features(bits & ~override_flag);
+  }
+  static const cpu_features detected = detect();
+  return detected;
+}
+
+void
+cpu_features::override_host(const cpu_features features) noexcept {
+  host_override.store(features._bits | override_flag, std::memory_order_release);
+}
+
+void
+cpu_features::reset_host() noexcept {
+  host_override.store(0, std::memory_order_release);
+}
+
+cpu_feature
+cpu_features::lookup(const char* const name) noexcept {
+  assert(name != nullptr);
+
+  for (std::size_t i = 0; i < static_cast<std::size_t>(cpu_feature::count); i++) {
+    if (std::strcmp(name, feature_names[i]) == 0) {
+      return static_cast<cpu_feature>(i);
+    }
+  }
+  return cpu_feature::count; /* not found */
+}
+
+const char*
+cpu_features::name_of(const cpu_feature feature) noexcept {
+  assert(feature < cpu_feature::count);
+  return feature_names[static_cast<std::size_t>(feature)];
+}
@@ -0,0 +1,160 @@
+/* This is free and unencumbered software released into the public domain. */
+
+#ifndef MACHINERY_UTIL_CPU_H
+#define MACHINERY_UTIL_CPU_H
+
+/**
+ * @file
+ *
+ * Runtime detection of host processor features.
+ */
+
+#include <cstdint> /* for std::uint64_t */
+
+namespace machinery {
+  namespace util {
+    enum class cpu_feature : std::uint8_t;
+    class cpu_features;
+  }
+}
+
+/**
+ * Optional processor features that affect instruction selection.
+ */
+enum class machinery::util::cpu_feature : std::uint8_t {
+  /* x86 and x86-64: */
+  sse2,      /**< SSE2 */
+  sse3,      /**< SSE3 */
+  ssse3,     /**< supplemental SSE3 */
+  sse41,     /**< SSE4.1 */
+  sse42,     /**< SSE4.2 */
+  popcnt,    /**< the `POPCNT` instruction */
+  lzcnt,     /**< the `LZCNT` instruction */
+  bmi1,      /**< bit manipulation instructions, set 1 */
+  bmi2,      /**< bit manipulation instructions, set 2 */
+  avx,       /**< AVX, including operating system support */
+  avx2,      /**< AVX2 */
+  fma,       /**< fused multiply-add */
+  avx512f,   /**< AVX-512 foundation, including operating system support */
+  avx512cd,  /**< AVX-512 conflict detection */
+  avx512dq,  /**< AVX-512 doubleword and quadword instructions */
+  avx512bw,  /**< AVX-512 byte and word instructions */
+  avx512vl,  /**< AVX-512 vector length extensions */
+
+  /* ARMv8 AArch64: */
+  asimd,     /**< Advanced SIMD (NEON) */
+  crc32,     /**< CRC32 instructions */
+  atomics,   /**< large system extensions (LSE) atomics */
+  dotprod,   /**< Advanced SIMD dot product instructions */
+  sve,       /**< the scalable vector extension */
+  sve2,      /**< the scalable vector extension, version 2 */
+  cssc,      /**< common short sequence compression instructions */
+
+  count      /**< the number of features; not a feature */
+};
+
+/**
+ * A set of processor features.
+ *
+ * The features of the host processor are probed once, using `CPUID` on
+ * x86 and the auxiliary vector's hardware capabilities on AArch64 Linux.
+ * JIT compilers consult `host()` to choose among encodings, so limiting it
+ * with `override_host()` exercises the lower tiers on capable hardware.
+ */
+class machinery::util::cpu_features {
+  std::uint64_t _bits {0};
+
+public:
+  /**
+   * Returns the features of the host processor, or the features set by
+   * `override_host()` if any.
+   */
+  static cpu_features host() noexcept;
+
+  /**
+   * Probes the features of the host processor, ignoring any override.
+   */
+  static cpu_features detect() noexcept;
+
+  /**
+   * Makes `host()` return the given features instead of the detected ones.
+   *
+   * This affects compilers constructed afterwards. It is meant for testing
+   * code paths that the host processor would otherwise not take.
+   */
+  static void override_host(cpu_features features) noexcept;
+
+  /**
+   * Makes `host()` return the detected features again.
+   */
+  static void reset_host() noexcept;
+
+  /**
+   * Returns the feature with the given name, e.g. "avx2".
+   *
+   * @param name the lowercase name of the feature
+   * @pre `name` must not be `NULL`
+   * @return `cpu_feature::count` if the name is unknown
+   */
+  static cpu_feature lookup(const char* name) noexcept;
+
+  /**
+   * Returns the lowercase name of the given feature.
+   */
+  static const char* name_of(cpu_feature feature) noexcept;
+
+  /**
+   * Default constructor, for the empty set.
+   */
+  constexpr cpu_features() noexcept = default;
+
+  /**
+   * Returns whether this set contains the given feature.
+   */
+  constexpr bool has(const cpu_feature feature) const noexcept {
+    return (_bits >> static_cast<unsigned>(feature)) & 1;
+  }
+
+  /**
+   * Adds the given feature to this set.
+   */
+  cpu_features& set(const cpu_feature feature) noexcept {
+    _bits |= std::uint64_t{1} << static_cast<unsigned>(feature);
+    return *this;
+  }
+
+  /**
+   * Removes the given feature from this set.
+   */
+  cpu_features& reset(const cpu_feature feature) noexcept {
+    _bits &= ~(std::uint64_t{1} << static_cast<unsigned>(feature));
+    return *this;
+  }
+
+  /**
+   * Returns the features contained in both sets.
+   */
+  constexpr cpu_features operator&(const cpu_features& other) const noexcept {
+    return cpu_features(_bits & other._bits);
+  }
+
+  /**
+   * Returns whether both sets contain the same features.
+   */
+  constexpr bool operator==(const cpu_features& other) const noexcept {
+    return _bits == other._bits;
+  }
+
+  /**
+   * Returns whether the sets differ.
+   */
+  constexpr bool operator!=(const cpu_features& other) const noexcept {
+    return _bits != other._bits;
+  }
+
+private:
+  explicit constexpr cpu_features(const std::uint64_t bits) noexcept
+    : _bits(bits) {}
+};
+
+#endif /* MACHINERY_UTIL_CPU_H */
@@ -0,0 +1,241 @@
+/* This is free and unencumbered software released into the public domain. */
+
+#ifndef MACHINERY_UTIL_FUNCTION_H
+#define MACHINERY_UTIL_FUNCTION_H
+
+/**
+ * @file
+ *
+ * Handles to generated functions.
+ */
+
+#include "mapping.h"
+
+#include <cstddef> /* for std::size_t */
+#include <cstdint> /* for std::uint8_t */
+#include <utility> /* for std::forward(), std::move() */
+
+namespace machinery {
+  namespace util {
+    class function_handle;
+    template <typename Signature> class jit_function;
+    template <typename R, typename... Args> class jit_function<R(Args...)>;
+  }
+}
+
+/**
+ * An owning handle to generated code in sealed executable memory.
+ *
+ * Obtained by finalizing a buffer, which hands over its memory without
+ * copying it. The code is unmapped when the handle is destroyed.
+ *
+ * @note Instances of this class are movable, but not copyable.
+ */
+class machinery::util::function_handle {
+  executable_mapping _mapping;
+  std::size_t _size {0};
+
+public:
+  /**
+   * Default constructor.
+   */
+  function_handle() noexcept = default;
+
+  /**
+   * Constructor.
+   *
+   * @param mapping the sealed mapping holding the code
+   * @param size    the byte size of the code
+   */
+  function_handle(executable_mapping&& mapping, const std::size_t size) noexcept
+    : _mapping(std::move(mapping)),
+      _size(size) {}
+
+  /**
+   * Copy constructor.
+   */
+  function_handle(const function_handle& other) = delete;
+
+  /**
+   * Move constructor.
+   */
+  function_handle(function_handle&& other) noexcept
+    : _mapping(std::move(other._mapping)),
+      _size(other._size) {
+    other._size = 0;
+  }
+
+  /**
+   * Destructor.
+   */
+  ~function_handle() noexcept = default;
+
+  /**
+   * Copy assignment operator.
+   */
+  function_handle& operator=(const function_handle& other) = delete;
+
+  /**
+   * Move assignment operator.
+   */
+  function_handle& operator=(function_handle&& other) noexcept {
+    if (this != &other) {
+      _mapping = std::move(other._mapping);
+      _size = other._size;
+      other._size = 0;
+    }
+    return *this;
+  }
+
+  /**
+   * Returns whether this handle refers to any code.
+   */
+  explicit operator bool() const noexcept {
+    return _mapping.code() != nullptr;
+  }
+
+  /**
+   * Returns the byte size of the code.
+   */
+  std::size_t size() const noexcept {
+    return _size;
+  }
+
+  /**
+   * Returns a pointer to the executable code.
+   */
+  const std::uint8_t* code() const noexcept {
+    return _mapping.code();
+  }
+
+  /**
+   * Executes the code.
+   *
+   * @pre  The generated code must include a return instruction.
+   * @post Processor registers may be clobbered.
+   */
+  void execute() const {
+    reinterpret_cast<void (*)()>(_mapping.code())();
+  }
+
+  /**
+   * Executes the code, returning a value of type `T`.
+   *
+   * @return a value of type `T`
+   * @pre  The generated code must include a return instruction.
+   * @post Processor registers may be clobbered.
+   */
+  template <typename T>
+  T execute() const {
+    return reinterpret_cast<T (*)()>(_mapping.code())();
+  }
+};
+
+/**
+ * A typed, callable handle to a generated function.
+ *
+ * Calling it costs one indirect call through a cached function pointer.
+ *
+ * @tparam R    the return type
+ * @tparam Args the parameter types
+ * @note The generated code must follow the platform's C calling convention
+ *       for the given signature.
+ * @note Instances of this class are movable, but not copyable.
+ */
+template <typename R, typename... Args>
+class machinery::util::jit_function<R(Args...)> {
+public:
+  /**
+   * The function pointer type.
+   */
+  using pointer = R (*)(Args...);
+
+private:
+  function_handle _handle;
+  pointer _pointer {nullptr};
+
+public:
+  /**
+   * Default constructor.
+   */
+  jit_function() noexcept = default;
+
+  /**
+   * Constructor.
+   *
+   * @param handle the handle to the generated code
+   */
+  explicit jit_function(function_handle&& handle) noexcept
+    : _handle(std::move(handle)),
+      _pointer(reinterpret_cast<pointer>(_handle.code())) {}
+
+  /**
+   * Copy constructor.
+   */
+  jit_function(const jit_function& other) = delete;
+
+  /**
+   * Move constructor.
+   */
+  jit_function(jit_function&& other) noexcept
+    : _handle(std::move(other._handle)),
+      _pointer(other._pointer) {
+    other._pointer = nullptr;
+  }
+
+  /**
+   * Destructor.
+   */
+  ~jit_function() noexcept = default;
+
+  /**
+   * Copy assignment operator.
+   */
+  jit_function& operator=(const jit_function& other) = delete;
+
+  /**
+   * Move assignment operator.
+   */
+  jit_function& operator=(jit_function&& other) noexcept {
+    if (this != &other) {
+      _handle = std::move(other._handle);
+      _pointer = other._pointer;
+      other._pointer = nullptr;
+    }
+    return *this;
+  }
+
+  /**
+   * Returns whether this handle refers to any code.
+   */
+  explicit operator bool() const noexcept {
+    return _pointer != nullptr;
+  }
+
+  /**
+   * Returns the raw function pointer.
+   *
+   * The pointer is valid only as long as this handle owns the code.
+   */
+  pointer get() const noexcept {
+    return _pointer;
+  }
+
+  /**
+   * Returns the underlying untyped handle.
+   */
+  const function_handle& handle() const noexcept {
+    return _handle;
+  }
+
+  /**
+   * Calls the generated function.
+   *
+   * @pre `*this` must refer to code.
+   */
+  R operator()(Args... args) const {
+    return _pointer(std::forward<Args>(args)...);
+  }
+};
+
+#endif /* MACHINERY_UTIL_FUNCTION_H */
@@ -0,0 +1,358 @@
+/* This is free and unencumbered software released into the public domain. */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include "mapping.h"
+
+#include <algorithm>    /* for std::max() */
+#include <cassert>      /* for assert() */
+#include <cerrno>       /* for errno */
+#include <cstdio>       /* for std::fopen(), std::fread() */
+#include <cstring>      /* for std::memcpy(), std::strstr() */
+#include <new>          /* for std::bad_alloc */
+#include <stdexcept>    /* for std::logic_error */
+#include <sys/mman.h>   /* for madvise(), memfd_create(), mmap(), mprotect(), munmap(), mremap() */
+#include <system_error> /* for std::system_error */
+#include <unistd.h>     /* for close(), ftruncate(), sysconf() */
+#include <utility>      /* for std::move(), std::swap() */
+
+using namespace machinery::util;
+
+static const int mmap_prot  = PROT_READ | PROT_WRITE | PROT_EXEC;
+static const int mmap_flags = MAP_PRIVATE | MAP_ANON;
+static const std::size_t mmap_size = sysconf(_SC_PAGESIZE);
+
+[[noreturn]] static void
+throw_mmap_error(const int error) {
+  switch (error) {
+    case ENOMEM: /* Cannot allocate memory in kernel */
+      throw std::bad_alloc();
+    default:
+      assert(error != EBADF);
+      throw std::system_error(error, std::system_category());
+  }
+}
+
+constexpr std::size_t executable_mapping::huge_page_size;
+
+static std::size_t
+round_to_huge_pages(const std::size_t size) {
+  const std::size_t huge_size = executable_mapping::huge_page_size;
+  return (size + huge_size - 1) / huge_size * huge_size;
+}
+
+#ifdef MADV_HUGEPAGE
+static bool
+thp_enabled(const executable_mode mode) {
+  /* Check whether the kernel honors MADV_HUGEPAGE for this memory type: */
+  const char* const path = (mode == executable_mode::rwx) ?
+    "/sys/kernel/mm/transparent_hugepage/enabled" :
+    "/sys/kernel/mm/transparent_hugepage/shmem_enabled";
+  FILE* const stream = std::fopen(path, "r");
+  if (!stream) {
+    return false;
+  }
+  char setting[256];
+  const std::size_t length = std::fread(setting, 1, sizeof(setting) - 1, stream);
+  std::fclose(stream);
+  setting[length] = '\0';
+  return !std::strstr(setting, "[never]") && !std::strstr(setting, "[deny]");
+}
+#endif
+
+static void*
+map_aligned(const std::size_t size,
+            const int prot,
+            const int flags,
+            const int fd,
+            const std::size_t alignment) {
+  if (alignment <= mmap_size) {
+    return ::mmap(nullptr, size, prot, flags, fd, 0);
+  }
+
+  /* Over-allocate, then trim the excess on both sides of the aligned span: */
+  const std::size_t padded_size = size + alignment - mmap_size;
+  void* const addr = ::mmap(nullptr, padded_size, prot, flags, fd, 0);
+  if (addr == MAP_FAILED) {
+    return MAP_FAILED;
+  }
+  const std::uintptr_t start = reinterpret_cast<std::uintptr_t>(addr);
+  const std::uintptr_t aligned = (start + alignment - 1) & ~(alignment - 1);
+  if (aligned > start) {
+    ::munmap(addr, aligned - start);
+  }
+  if (start + padded_size > aligned + size) {
+    ::munmap(reinterpret_cast<void*>(aligned + size), start + padded_size - (aligned + size));
+  }
+  return reinterpret_cast<void*>(aligned);
+}
+
+std::size_t
+executable_mapping::page_size() noexcept {
+  return mmap_size;
+}
+
+std::size_t
+executable_mapping::round_to_pages(const std::size_t size) noexcept {
+  return (size + mmap_size - 1) / mmap_size * mmap_size;
+}
+
+executable_mapping::executable_mapping(const std::size_t size,
+                                       const executable_mode mode,
+                                       const page_policy policy) {
+  static const page_policy fallbacks[] = {
+    page_policy::huge,
+    page_policy::transparent_huge,
+    page_policy::normal,
+  };
+
+  int error = 0;
+  for (const auto fallback : fallbacks) {
+    if (fallback <= policy && try_map(size, mode, fallback, error)) {
+      _policy = fallback;
+      return;
+    }
+  }
+  throw_mmap_error(error);
+}
+
+executable_mapping::executable_mapping(executable_mapping&& other) noexcept
+  : _data(other._data),
+    _code(other._code),
+    _size(other._size),
+    _fd(other._fd),
+    _policy(other._policy),
+    _sealed(other._sealed) {
+  other._data = other._code = nullptr;
+  other._size = 0;
+  other._fd = -1;
+  other._policy = page_policy::normal;
+  other._sealed = false;
+}
+
+executable_mapping::~executable_mapping() noexcept {
+  unmap();
+}
+
+executable_mapping&
+executable_mapping::operator=(executable_mapping&& other) noexcept {
+  if (this != &other) {
+    unmap();
+    std::swap(_data, other._data);
+    std::swap(_code, other._code);
+    std::swap(_size, other._size);
+    std::swap(_fd, other._fd);
+    std::swap(_policy, other._policy);
+    std::swap(_sealed, other._sealed);
+  }
+  return *this;
+}
+
+void
+executable_mapping::resize(std::size_t size) {
+  if (size <= _size) return;
+
+  if (_sealed) {
+    throw std::logic_error("cannot resize a sealed mapping");
+  }
+
+  if (_policy != page_policy::normal) {
+    executable_mapping mapping(size, mode(), _policy);
+    std::memcpy(mapping._data, _data, _size);
+    *this = std::move(mapping);
+    return;
+  }
+
+  size = round_to_pages(size);
+
+#ifdef __linux__
+  if (_fd != -1 && ::ftruncate(_fd, size) == -1) {
+    throw_mmap_error(errno);
+  }
+
+  void* const data = ::mremap(reinterpret_cast<void*>(_data), _size, size, MREMAP_MAYMOVE);
+  if (data == MAP_FAILED) {
+    throw_mmap_error(errno);
+  }
+
+  if (_fd == -1) {
+    _data = _code = reinterpret_cast<std::uint8_t*>(data);
+  }
+  else {
+    /* The views now differ in size until the executable one catches up: */
+    _data = reinterpret_cast<std::uint8_t*>(data);
+    void* const code = ::mremap(reinterpret_cast<void*>(_code), _size, size, MREMAP_MAYMOVE);
+    if (code == MAP_FAILED) {
+      const int error = errno;
+      ::mremap(data, size, _size, 0);
+      throw_mmap_error(error);
+    }
+    _code = reinterpret_cast<std::uint8_t*>(code);
+  }
+#else
+  if (_fd != -1) {
+    throw std::system_error(ENOSYS, std::system_category());
+  }
+
+  void* const addr = ::mmap(nullptr, size, mmap_prot, mmap_flags, -1, 0);
+  if (addr == MAP_FAILED) {
+    throw_mmap_error(errno);
+  }
+  std::memcpy(addr, _data, _size);
+  if (::munmap(reinterpret_cast<void*>(_data), _size) == -1) {
+    /* Ignore any errors from munmap(). */
+  }
+  _data = _code = reinterpret_cast<std::uint8_t*>(addr);
+#endif
+
+  _size = size;
+}
+
+void
+executable_mapping::seal() {
+  if (_sealed || !_code) return;
+
+#ifdef __GNUC__
+  __builtin___clear_cache(reinterpret_cast<char*>(_code), reinterpret_cast<char*>(_code + _size));
+#endif
+
+  /* The executable view of a dual mapping was never writable, so the
+   * writable view is merely withheld rather than unmapped, which would cost
+   * a TLB shootdown across all CPUs. It is unmapped along with the rest: */
+  if (_code == _data) {
+    if (::mprotect(reinterpret_cast<void*>(_code), _size, PROT_READ | PROT_EXEC) == -1) {
+      throw std::system_error(errno, std::system_category());
+    }
+  }
+
+  _sealed = true;
+}
+
+bool
+executable_mapping::try_map(const std::size_t size,
+                            const executable_mode mode,
+                            const page_policy policy,
+                            int& error) noexcept {
+  const bool huge = (policy != page_policy::normal);
+  _size = huge ? round_to_huge_pages(std::max(size, std::size_t{1}))
+               : round_to_pages(std::max(size, mmap_size));
+
+  int flags = (mode == executable_mode::rwx) ? mmap_flags : MAP_SHARED;
+  if (policy == page_policy::huge) {
+#ifdef MAP_HUGETLB
+    flags |= MAP_HUGETLB;
+#else
+    error = ENOSYS;
+    return false;
+#endif
+  }
+  if (policy == page_policy::transparent_huge) {
+#ifdef MADV_HUGEPAGE
+    if (!thp_enabled(mode)) {
+      error = ENOTSUP;
+      return false;
+    }
+#else
+    error = ENOSYS;
+    return false;
+#endif
+  }
+  const std::size_t alignment =
+    (policy == page_policy::transparent_huge) ? huge_page_size : mmap_size;
+
+  switch (mode) {
+    case executable_mode::rwx: {
+      void* const addr = map_aligned(_size, mmap_prot, flags, -1, alignment);
+      if (addr == MAP_FAILED) {
+        error = errno;
+        unmap();
+        return false;
+      }
+      _data = _code = reinterpret_cast<std::uint8_t*>(addr);
+      break;
+    }
+
+    case executable_mode::dual_mapped: {
+#ifdef MFD_CLOEXEC
+      unsigned int fd_flags = MFD_CLOEXEC;
+      if (policy == page_policy::huge) {
+#ifdef MFD_HUGETLB
+        fd_flags |= MFD_HUGETLB;
+#else
+        error = ENOSYS;
+        unmap();
+        return false;
+#endif
+      }
+      if ((_fd = ::memfd_create("machinery", fd_flags)) == -1) {
+        error = errno;
+        unmap();
+        return false;
+      }
+      if (::ftruncate(_fd, _size) == -1) {
+        error = errno;
+        unmap();
+        return false;
+      }
+      void* const data = map_aligned(_size, PROT_READ | PROT_WRITE, flags, _fd, alignment);
+      if (data == MAP_FAILED) {
+        error = errno;
+        unmap();
+        return false;
+      }
+      _data = reinterpret_cast<std::uint8_t*>(data);
+      void* const code = map_aligned(_size, PROT_READ | PROT_EXEC, flags, _fd, alignment);
+      if (code == MAP_FAILED) {
+        error = errno;
+        unmap();
+        return false;
+      }
+      _code = reinterpret_cast<std::uint8_t*>(code);
+      break;
+#else
+      error = ENOSYS;
+      unmap();
+      return false;
+#endif
+    }
+  }
+
+#ifdef MADV_HUGEPAGE
+  if (policy == page_policy::transparent_huge) {
+    if (::madvise(reinterpret_cast<void*>(_data), _size, MADV_HUGEPAGE) == -1 ||
+        (_code != _data && ::madvise(reinterpret_cast<void*>(_code), _size, MADV_HUGEPAGE) == -1)) {
+      error = errno;
+      unmap();
+      return false;
+    }
+  }
+#endif
+
+  return true;
+}
+
+void
+executable_mapping::unmap() noexcept {
+  if (_data) {
+    if (::munmap(reinterpret_cast<void*>(_data), _size) == -1) {
+      /* Ignore any errors from munmap(). */
+    }
+  }
+  if (_code && _code != _data) {
+    if (::munmap(reinterpret_cast<void*>(_code), _size) == -1) {
+      /* Ignore any errors from munmap(). */
+    }
+  }
+  if (_fd != -1) {
+    if (::close(_fd) == -1) {
+      /* Ignore any errors from close(). */
+    }
+  }
+  _data = _code = nullptr;
+  _size = 0;
+  _fd = -1;
+  _policy = page_policy::normal;
+  _sealed = false;
+}
@@ -0,0 +1,224 @@
+/* This is free and unencumbered software released into the public domain. */
+
+#ifndef MACHINERY_UTIL_MAPPING_H
+#define MACHINERY_UTIL_MAPPING_H
+
+/**
+ * @file
+ *
+ * Executable memory mappings.
+ */
+
+#include <cstddef> /* for std::size_t */
+#include <cstdint> /* for std::uint8_t */
+
+namespace machinery {
+  namespace util {
+    enum class executable_mode : std::uint8_t;
+    enum class page_policy : std::uint8_t;
+    class executable_mapping;
+  }
+}
+
+/**
+ * Strategies for mapping executable memory.
+ */
+enum class machinery::util::executable_mode : std::uint8_t {
+  /**
+   * A single mapping that is readable, writable, and executable.
+   */
+  rwx = 0,
+
+  /**
+   * Two mappings of one shared memory object: a read-write view for code
+   * generation and a read-execute view for execution.
+   *
+   * No memory is ever both writable and executable, so this works on
+   * kernels that enforce W^X, and emitting code never requires changing
+   * page permissions.
+   */
+  dual_mapped = 1,
+};
+
+/**
+ * Page sizes for backing executable memory.
+ *
+ * Larger pages reduce instruction TLB misses for large amounts of
+ * generated code. The policies are ordered from weakest to strongest.
+ */
+enum class machinery::util::page_policy : std::uint8_t {
+  /**
+   * Base pages (usually 4 KiB).
+   */
+  normal = 0,
+
+  /**
+   * Transparent huge pages, requested with `madvise(MADV_HUGEPAGE)` on a
+   * region aligned to the huge page size.
+   */
+  transparent_huge = 1,
+
+  /**
+   * Explicit huge pages from the kernel's reserved pool, allocated with
+   * `MAP_HUGETLB` (or `MFD_HUGETLB` for dual-mapped memory).
+   */
+  huge = 2,
+};
+
+/**
+ * A page-granular mapping of executable memory.
+ *
+ * @note Instances of this class are movable, but not copyable.
+ */
+class machinery::util::executable_mapping {
+  std::uint8_t* _data {nullptr};
+  std::uint8_t* _code {nullptr};
+  std::size_t _size {0};
+  int _fd {-1};
+  page_policy _policy {page_policy::normal};
+  bool _sealed {false};
+
+public:
+  /**
+   * The byte size of a huge page.
+   */
+  static constexpr std::size_t huge_page_size = 2 * 1024 * 1024;
+
+  /**
+   * Returns the system page size.
+   */
+  static std::size_t page_size() noexcept;
+
+  /**
+   * Rounds the given byte size up to a multiple of the page size.
+   */
+  static std::size_t round_to_pages(std::size_t size) noexcept;
+
+  /**
+   * Default constructor.
+   */
+  executable_mapping() noexcept = default;
+
+  /**
+   * Constructor.
+   *
+   * If the requested page policy is unavailable, the next weaker one is
+   * tried in turn; `policy()` reports the one that actually took effect.
+   *
+   * @param size   the minimum byte size of the mapping
+   * @param mode   the mapping strategy
+   * @param policy the preferred page policy
+   * @throws std::bad_alloc if out of memory
+   * @throws std::system_error in case of another error
+   */
+  executable_mapping(std::size_t size, executable_mode mode,
+                     page_policy policy = page_policy::normal);
+
+  /**
+   * Copy constructor.
+   */
+  executable_mapping(const executable_mapping& other) = delete;
+
+  /**
+   * Move constructor.
+   */
+  executable_mapping(executable_mapping&& other) noexcept;
+
+  /**
+   * Destructor.
+   */
+  ~executable_mapping() noexcept;
+
+  /**
+   * Copy assignment operator.
+   */
+  executable_mapping& operator=(const executable_mapping& other) = delete;
+
+  /**
+   * Move assignment operator.
+   */
+  executable_mapping& operator=(executable_mapping&& other) noexcept;
+
+  /**
+   * Returns the mapping strategy in effect.
+   */
+  executable_mode mode() const noexcept {
+    return (_fd == -1) ? executable_mode::rwx : executable_mode::dual_mapped;
+  }
+
+  /**
+   * Returns the page policy in effect.
+   */
+  page_policy policy() const noexcept {
+    return _policy;
+  }
+
+  /**
+   * Returns the byte size of this mapping.
+   */
+  std::size_t size() const noexcept {
+    return _size;
+  }
+
+  /**
+   * Returns whether this mapping has been sealed.
+   */
+  bool sealed() const noexcept {
+    return _sealed;
+  }
+
+  /**
+   * Returns a pointer to the writable view of this mapping.
+   *
+   * This is `nullptr` once the mapping has been sealed.
+   */
+  std::uint8_t* data() const noexcept {
+    return _sealed ? nullptr : _data;
+  }
+
+  /**
+   * Returns a pointer to the executable view of this mapping.
+   *
+   * This is the same as `data()` unless the mapping is dual-mapped.
+   */
+  std::uint8_t* code() const noexcept {
+    return _code;
+  }
+
+  /**
+   * Grows this mapping to hold at least `size` bytes.
+   *
+   * Huge-page mappings are grown by copying into a new mapping, since
+   * `mremap()` can neither extend them nor preserve their alignment.
+   *
+   * @post Both views may have moved to new addresses.
+   * @throws std::logic_error if the mapping has been sealed
+   * @throws std::bad_alloc if out of memory
+   * @throws std::system_error in case of another error
+   */
+  void resize(std::size_t size);
+
+  /**
+   * Makes this mapping executable-only, publishing the code written to it.
+   *
+   * Synchronizes the instruction cache, then removes write access: a
+   * single mapping is protected read-execute, and the writable view of a
+   * dual mapping is withheld. The executable view stays at its address.
+   *
+   * Sealing a dual mapping changes no page tables, so that it costs no
+   * TLB shootdown. In exchange, its writable view stays mapped, and thus
+   * reachable by a stray write, until this mapping is destroyed.
+   *
+   * @post `sealed()` is true and `data()` is `nullptr`.
+   * @throws std::system_error in case of error
+   */
+  void seal();
+
+protected:
+  bool try_map(std::size_t size, executable_mode mode, page_policy policy,
+               int& error) noexcept;
+
+  void unmap() noexcept;
+};
+
+#endif /* MACHINERY_UTIL_MAPPING_H */
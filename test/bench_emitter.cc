@@ -0,0 +1,148 @@
+/* This is free and unencumbered software released into the public domain. */
+
+/**
+ * @file
+ *
+ * Measures machine code emission throughput in instructions per second.
+ *
+ * Compares the emitters, which reserve each instruction's bytes at once via
+ * `extend()`, against a baseline that appends the same bytes one at a time.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <machinery/util/buffer.h>
+
+#ifndef DISABLE_ARM
+#include <machinery/arch/arm.h>
+#endif
+#ifndef DISABLE_X86
+#include <machinery/arch/x86.h>
+#endif
+
+#include <chrono>  /* for std::chrono::steady_clock */
+#include <cstdint> /* for std::uint32_t */
+#include <cstdio>  /* for std::printf() */
+#include <cstdlib> /* for EXIT_SUCCESS */
+
+using namespace machinery::arch;
+using namespace machinery::util;
+
+static const unsigned long iterations = 1000000;
+
+static volatile std::uint8_t sink;
+
+template <typename Function>
+static double
+measure(Function function) {
+  const auto start = std::chrono::steady_clock::now();
+  const unsigned long count = function();
+  const auto stop = std::chrono::steady_clock::now();
+  const std::chrono::duration<double> elapsed = stop - start;
+  return count / elapsed.count();
+}
+
+static void
+report(const char* const name, const double baseline, const double emitter) {
+  std::printf("%-32s %12.0f %12.0f %6.2fx\n", name, baseline, emitter,
+    emitter / baseline);
+}
+
+template <class Buffer>
+static void
+append_le32(Buffer& buffer, std::uint32_t value) {
+  for (auto i = 0; i < 4; i++) {
+    buffer.append(value & 0xFF);
+    value >>= 8;
+  }
+}
+
+template <class Buffer>
+static void
+append_le64(Buffer& buffer, std::uint64_t value) {
+  for (auto i = 0; i < 8; i++) {
+    buffer.append(value & 0xFF);
+    value >>= 8;
+  }
+}
+
+#ifndef DISABLE_X86
+template <class Buffer>
+static void
+bench_x86(const char* const name) {
+  const double baseline = measure([]() {
+    Buffer buffer;
+    for (auto i = 0UL; i < iterations; i++) {
+      buffer.append(0xB8);                       /* MOV EAX, imm32 */
+      append_le32(buffer, i);
+      buffer.append(0x05);                       /* ADD EAX, imm32 */
+      append_le32(buffer, i);
+      buffer.append({0x48, 0xB9});               /* MOV RCX, imm64 */
+      append_le64(buffer, i);
+      buffer.append(0x90);                       /* NOP */
+    }
+    sink = buffer.data()[buffer.size() - 1];
+    return iterations * 4;
+  });
+
+  const double emitter = measure([]() {
+    Buffer buffer;
+    x86_emitter<Buffer> emit(buffer);
+    emit.set_compact_immediates(false);  /* emit the baseline's exact bytes */
+    for (auto i = 0UL; i < iterations; i++) {
+      emit.mov(x86_reg32::eax, x86_imm32(i));
+      emit.add(x86_imm32(i));
+      emit.mov(x86_reg64::rcx, x86_imm64(i));
+      emit.nop();
+    }
+    sink = buffer.data()[buffer.size() - 1];
+    return iterations * 4;
+  });
+
+  report(name, baseline, emitter);
+}
+#endif
+
+#ifndef DISABLE_ARM
+template <class Buffer>
+static void
+bench_arm(const char* const name) {
+  const double baseline = measure([]() {
+    Buffer buffer;
+    for (auto i = 0UL; i < iterations * 4; i++) {
+      append_le32(buffer, 0xD503201F);           /* NOP */
+    }
+    sink = buffer.data()[buffer.size() - 1];
+    return iterations * 4;
+  });
+
+  const double emitter = measure([]() {
+    Buffer buffer;
+    arm_emitter<Buffer> emit(buffer);
+    for (auto i = 0UL; i < iterations * 4; i++) {
+      emit.nop();
+    }
+    sink = buffer.data()[buffer.size() - 1];
+    return iterations * 4;
+  });
+
+  report(name, baseline, emitter);
+}
+#endif
+
+int
+main() {
+  std::printf("%-32s %12s %12s %7s\n", "instructions/second", "per-byte",
+    "extend()", "gain");
+#ifndef DISABLE_X86
+  bench_x86<appendable_buffer>("x86-64, appendable_buffer");
+  bench_x86<executable_buffer>("x86-64, executable_buffer");
+#endif
+#ifndef DISABLE_ARM
+  bench_arm<appendable_buffer>("armv8-aarch64, appendable_buffer");
+  bench_arm<executable_buffer>("armv8-aarch64, executable_buffer");
+#endif
+  return EXIT_SUCCESS;
+}
@@ -10,8 +10,9 @@
 #include <machinery/arch/arm.h>
 #include <machinery/util/buffer.h>
 
-#include <cstdio> /* for std::sprintf() */
-#include <string> /* for std::string */
+#include <cstdint> /* for std::uint32_t */
+#include <cstdio>  /* for std::sprintf() */
+#include <string>  /* for std::string */
 
 using namespace machinery::arch;
 using namespace machinery::arch::arm;
@@ -34,6 +35,625 @@ s(const arm_emitter<decltype(_buffer)>&) {
   return std::string{string};
 }
 
+static std::uint32_t
+word(const std::uint8_t* const data) {
+  return data[0] | (data[1] << 8) | (data[2] << 16) | (std::uint32_t{data[3]} << 24);
+}
+
+static std::uint32_t
+word(const std::size_t offset) {
+  return word(_buffer.data() + offset);
+}
+
+TEST_CASE("align") {
+  REQUIRE(s(emit().nop().align(16)) == "1F2003D51F2003D51F2003D51F2003D5");
+  REQUIRE(s(emit().nop().align(8, padding::trap)) == "1F2003D5000020D4");
+  REQUIRE(s(emit().nop().align(4)) == "1F2003D5");
+  REQUIRE_THROWS_AS(emit().align(2), std::invalid_argument);
+  REQUIRE_THROWS_AS(emit().align(12), std::invalid_argument);
+}
+
+TEST_CASE("arithmetic") {
+  REQUIRE(s(emit().add(xreg::x0, xreg::x1, 16)) == "20400091");
+  REQUIRE(s(emit().add(wreg::w0, wreg::w1, 4095)) == "20FC3F11");
+  REQUIRE(s(emit().add(xreg::x0, xreg::x1, 4096)) == "20044091");
+  REQUIRE(s(emit().add(xreg::sp, xreg::sp, 32)) == "FF830091");
+  REQUIRE(s(emit().adds(xreg::x0, xreg::x1, 1)) == "200400B1");
+  REQUIRE(s(emit().sub(xreg::sp, xreg::sp, 0x10000)) == "FF4340D1");
+  REQUIRE(s(emit().subs(wreg::w2, wreg::w3, 7)) == "621C0071");
+  REQUIRE_THROWS_AS(emit().add(xreg::x0, xreg::x1, 4097), std::out_of_range);
+  REQUIRE(s(emit().add(xreg::x0, xreg::x1, xreg::x2)) == "2000028B");
+  REQUIRE(s(emit().add(xreg::x0, xreg::x1, xreg::x2, shift::lsl, 3)) == "200C028B");
+  REQUIRE(s(emit().sub(wreg::w0, wreg::w1, wreg::w2, shift::asr, 31)) == "207C824B");
+  REQUIRE(s(emit().adds(xreg::x0, xreg::x1, xreg::x2, shift::lsr, 1)) == "200442AB");
+  REQUIRE_THROWS_AS(emit().add(xreg::x0, xreg::x1, xreg::x2, shift::ror, 1), std::invalid_argument);
+  REQUIRE_THROWS_AS(emit().add(wreg::w0, wreg::w1, wreg::w2, shift::lsl, 32), std::out_of_range);
+  REQUIRE(s(emit().add(xreg::x0, xreg::sp, wreg::w1, extend::uxtw, 2)) == "E04B218B");
+  REQUIRE(s(emit().add(xreg::x0, xreg::x1, xreg::x2, extend::sxtx)) == "20E0228B");
+  REQUIRE(s(emit().sub(wreg::w0, wreg::wsp, wreg::w1, extend::uxtb)) == "E003214B");
+  REQUIRE_THROWS_AS(emit().add(xreg::x0, xreg::x1, wreg::w2, extend::sxtw, 5), std::out_of_range);
+  REQUIRE(s(emit().cmp(xreg::x0, 42)) == "1FA800F1");
+  REQUIRE(s(emit().cmp(xreg::x0, xreg::x1)) == "1F0001EB");
+  REQUIRE(s(emit().cmp(wreg::w0, wreg::w1, shift::lsl, 2)) == "1F08016B");
+  REQUIRE(s(emit().cmn(xreg::x0, 1)) == "1F0400B1");
+  REQUIRE(s(emit().neg(xreg::x0, xreg::x1)) == "E00301CB");
+}
+
+TEST_CASE("atomics") {
+  REQUIRE(s(emit().ldxr(wreg::w0, xreg::x1)) == "207C5F88");
+  REQUIRE(s(emit().ldxr(xreg::x2, xreg::sp)) == "E27F5FC8");
+  REQUIRE(s(emit().ldaxr(xreg::x0, xreg::x1)) == "20FC5FC8");
+  REQUIRE(s(emit().stxr(wreg::w3, wreg::w0, xreg::x1)) == "207C0388");
+  REQUIRE(s(emit().stxr(wreg::w3, xreg::x0, xreg::x1)) == "207C03C8");
+  REQUIRE(s(emit().stlxr(wreg::w4, xreg::x5, xreg::x6)) == "C5FC04C8");
+  REQUIRE(s(emit().ldar(xreg::x0, xreg::x1)) == "20FCDFC8");
+  REQUIRE(s(emit().ldar(wreg::w0, xreg::x1)) == "20FCDF88");
+  REQUIRE(s(emit().stlr(xreg::x0, xreg::x1)) == "20FC9FC8");
+  REQUIRE(s(emit().stlr(wreg::w2, xreg::x3)) == "62FC9F88");
+  REQUIRE(s(emit().clrex()) == "5F3F03D5");
+  REQUIRE(s(emit().ldadd(wreg::w0, wreg::w1, xreg::x2)) == "410020B8");
+  REQUIRE(s(emit().ldadd(xreg::x0, xreg::x1, xreg::x2)) == "410020F8");
+  REQUIRE(s(emit().ldadd(xreg::x0, xreg::x1, xreg::x2, order::acquire)) == "4100A0F8");
+  REQUIRE(s(emit().ldadd(xreg::x0, xreg::x1, xreg::x2, order::release)) == "410060F8");
+  REQUIRE(s(emit().ldadd(xreg::x3, xreg::x4, xreg::sp, order::acq_rel)) == "E403E3F8");
+  REQUIRE(s(emit().ldclr(xreg::x0, xreg::x1, xreg::x2, order::acq_rel)) == "4110E0F8");
+  REQUIRE(s(emit().ldeor(wreg::w0, wreg::w1, xreg::x2)) == "412020B8");
+  REQUIRE(s(emit().ldset(xreg::x0, xreg::x1, xreg::x2)) == "413020F8");
+  REQUIRE(s(emit().ldsmax(xreg::x0, xreg::x1, xreg::x2)) == "414020F8");
+  REQUIRE(s(emit().ldumin(wreg::w0, wreg::w1, xreg::x2)) == "417020B8");
+  REQUIRE(s(emit().swp(xreg::x0, xreg::x1, xreg::x2)) == "418020F8");
+  REQUIRE(s(emit().swp(wreg::w0, wreg::w1, xreg::x2, order::acq_rel)) == "4180E0B8");
+  REQUIRE(s(emit().cas(xreg::x0, xreg::x1, xreg::x2)) == "417CA0C8");
+  REQUIRE(s(emit().cas(wreg::w0, wreg::w1, xreg::x2, order::acquire)) == "417CE088");
+  REQUIRE(s(emit().cas(xreg::x0, xreg::x1, xreg::x2, order::release)) == "41FCA0C8");
+  REQUIRE(s(emit().cas(xreg::x0, xreg::x1, xreg::x2, order::acq_rel)) == "41FCE0C8");
+}
+
+TEST_CASE("barriers") {
+  REQUIRE(s(emit().dmb()) == "BF3B03D5");
+  REQUIRE(s(emit().dmb(barrier::ishld)) == "BF3903D5");
+  REQUIRE(s(emit().dmb(barrier::ishst)) == "BF3A03D5");
+  REQUIRE(s(emit().dmb(barrier::sy)) == "BF3F03D5");
+  REQUIRE(s(emit().dsb()) == "9F3F03D5");
+  REQUIRE(s(emit().dsb(barrier::ish)) == "9F3B03D5");
+  REQUIRE(s(emit().isb()) == "DF3F03D5");
+}
+
+TEST_CASE("bit_counting") {
+  REQUIRE(s(emit().clz(xreg::x0, xreg::x1)) == "2010C0DA");
+  REQUIRE(s(emit().clz(wreg::w0, wreg::w1)) == "2010C05A");
+  REQUIRE(s(emit().cls(xreg::x0, xreg::x1)) == "2014C0DA");
+  REQUIRE(s(emit().cnt(xreg::x0, xreg::x1)) == "201CC0DA");
+  REQUIRE(s(emit().cnt(wreg::w0, wreg::w1)) == "201CC05A");
+  REQUIRE(s(emit().ctz(xreg::x0, xreg::x1)) == "2018C0DA");
+}
+
+TEST_CASE("bit_reversal") {
+  REQUIRE(s(emit().rbit(xreg::x2, xreg::x3)) == "6200C0DA");
+  REQUIRE(s(emit().rev(xreg::x0, xreg::x1)) == "200CC0DA");
+  REQUIRE(s(emit().rev(wreg::w0, wreg::w1)) == "2008C05A");
+}
+
+TEST_CASE("bitfield") {
+  REQUIRE(s(emit().bfm(xreg::x0, xreg::x1, 4, 8)) == "202044B3");
+  REQUIRE(s(emit().sbfm(xreg::x0, xreg::x1, 0, 7)) == "201C4093");
+  REQUIRE(s(emit().ubfm(wreg::w0, wreg::w1, 8, 15)) == "203C0853");
+  REQUIRE(s(emit().bfi(xreg::x0, xreg::x1, 8, 4)) == "200C78B3");
+  REQUIRE(s(emit().bfxil(wreg::w0, wreg::w1, 3, 5)) == "201C0333");
+  REQUIRE(s(emit().sbfx(xreg::x0, xreg::x1, 4, 8)) == "202C4493");
+  REQUIRE(s(emit().ubfx(wreg::w0, wreg::w1, 4, 8)) == "202C0453");
+  REQUIRE(s(emit().sbfiz(xreg::x0, xreg::x1, 2, 10)) == "20247E93");
+  REQUIRE(s(emit().ubfiz(xreg::x0, xreg::x1, 32, 32)) == "207C60D3");
+  REQUIRE_THROWS_AS(emit().ubfx(wreg::w0, wreg::w1, 24, 9), std::out_of_range);
+  REQUIRE_THROWS_AS(emit().ubfx(xreg::x0, xreg::x1, 0, 0), std::out_of_range);
+  REQUIRE(s(emit().sxtb(xreg::x0, wreg::w1)) == "201C4093");
+  REQUIRE(s(emit().sxth(wreg::w0, wreg::w1)) == "203C0013");
+  REQUIRE(s(emit().sxtw(xreg::x0, wreg::w1)) == "207C4093");
+  REQUIRE(s(emit().uxtb(wreg::w0, wreg::w1)) == "201C0053");
+  REQUIRE(s(emit().uxth(wreg::w0, wreg::w1)) == "203C0053");
+}
+
+TEST_CASE("bitmask_immediate") {
+  using emitter = arm_emitter<decltype(_buffer)>;
+  std::uint32_t encoding;
+  REQUIRE(emitter::encode_bitmask(0xFF, 64, encoding));
+  REQUIRE(encoding == 0x1007);
+  REQUIRE(emitter::encode_bitmask(0x5555555555555555, 64, encoding));
+  REQUIRE(encoding == 0x03C);
+  REQUIRE(emitter::encode_bitmask(0x8000000000000000, 64, encoding));
+  REQUIRE(encoding == 0x1040);
+  REQUIRE(emitter::encode_bitmask(0x0F0F0F0F, 32, encoding));
+  REQUIRE(encoding == 0x033);
+  REQUIRE_FALSE(emitter::encode_bitmask(0, 64, encoding));
+  REQUIRE_FALSE(emitter::encode_bitmask(0xFFFFFFFFFFFFFFFF, 64, encoding));
+  REQUIRE_FALSE(emitter::encode_bitmask(0xFFFFFFFF, 32, encoding));
+  REQUIRE_FALSE(emitter::encode_bitmask(0x1234, 64, encoding));
+  REQUIRE_FALSE(emitter::encode_bitmask(0x0F0F0F0F, 64, encoding));
+}
+
+TEST_CASE("branch") {
+  auto emitter = emit();
+  const auto loop = emitter.new_label();
+  const auto done = emitter.new_label();
+  emitter.bind(loop).nop().b(cc::ne, loop).bl(loop);
+  emitter.cbz(wreg::w0, done).tbz(wreg::w2, 3, done).b(done).bind(done).ret();
+  REQUIRE(s(emitter) == "1F2003D5E1FFFF54FEFFFF97600000344200183601000014C0035FD6");
+  REQUIRE(emitter.offset(done) == 24);
+  REQUIRE_THROWS_AS(emitter.bind(done), std::logic_error);
+  REQUIRE_THROWS_AS(emitter.tbz(wreg::w0, 32, done), std::out_of_range);
+
+  auto other = emit();
+  const auto back = other.new_label();
+  other.bind(back).nop().cbnz(xreg::x1, back).tbnz(xreg::x3, 40, back);
+  REQUIRE(s(other) == "1F2003D5E1FFFFB5C3FF47B7");
+  REQUIRE(s(emit().br(xreg::x16)) == "00021FD6");
+  REQUIRE(s(emit().blr(xreg::x17)) == "20023FD6");
+  REQUIRE(s(emit().ret()) == "C0035FD6");
+  REQUIRE(s(emit().ret(xreg::x1)) == "20005FD6");
+}
+
+TEST_CASE("branch_veneer") {
+  auto emitter = emit();
+  const auto loop = emitter.new_label();
+  const auto far = emitter.new_label();
+  emitter.nop().tbz(xreg::x0, 0, far).align(16).bind(loop);
+  for (auto i = 0; i < 8192; i++) {
+    emitter.nop();
+  }
+  emitter.b(loop).bind(far).ret();
+  /* The TBZ is inverted around a B, which the alignment padding absorbs: */
+  REQUIRE(emitter.offset() == 32792);
+  REQUIRE(emitter.offset(loop) == 16);
+  REQUIRE(emitter.offset(far) == 32788);
+  REQUIRE(word(4) == 0x37000040);      /* TBNZ W0, #0, #8 */
+  REQUIRE(word(8) == 0x14002003);      /* B far */
+  REQUIRE(word(12) == 0xD503201F);     /* NOP */
+  REQUIRE(word(32784) == 0x17FFE000);  /* B loop */
+}
+
+TEST_CASE("branch_veneer_backward") {
+  auto emitter = emit();
+  const auto loop = emitter.new_label();
+  emitter.bind(loop);
+  for (auto i = 0; i < 262145; i++) {
+    emitter.nop();
+  }
+  emitter.b(cc::eq, loop);
+  REQUIRE(emitter.offset() == 1048588);
+  REQUIRE(word(1048580) == 0x54000041); /* B.NE #8 */
+  REQUIRE(word(1048584) == 0x17FBFFFE); /* B loop */
+}
+
+TEST_CASE("conditional_select") {
+  REQUIRE(s(emit().csel(xreg::x0, xreg::x1, xreg::x2, cc::eq)) == "2000829A");
+  REQUIRE(s(emit().csinc(wreg::w0, wreg::w1, wreg::w2, cc::ne)) == "2014821A");
+  REQUIRE(s(emit().csinv(xreg::x0, xreg::x1, xreg::x2, cc::lt)) == "20B082DA");
+  REQUIRE(s(emit().csneg(xreg::x0, xreg::x1, xreg::x2, cc::ge)) == "20A482DA");
+  REQUIRE(s(emit().cset(xreg::x0, cc::eq)) == "E0179F9A");
+  REQUIRE(s(emit().cset(wreg::w0, cc::lo)) == "E0279F1A");
+  REQUIRE(s(emit().csetm(xreg::x0, cc::gt)) == "E0D39FDA");
+  REQUIRE(s(emit().cinc(xreg::x0, xreg::x1, cc::hi)) == "2094819A");
+  REQUIRE(s(emit().cneg(xreg::x0, xreg::x1, cc::mi)) == "205481DA");
+}
+
+TEST_CASE("load_store") {
+  REQUIRE(s(emit().ldr(xreg::x0, mem{xreg::x1})) == "200040F9");
+  REQUIRE(s(emit().ldr(xreg::x0, mem{xreg::x1, 8})) == "200440F9");
+  REQUIRE(s(emit().ldr(wreg::w0, mem{xreg::sp, 16380})) == "E0FF7FB9");
+  REQUIRE(s(emit().ldr(xreg::x0, mem{xreg::x1, -8})) == "20805FF8");
+  REQUIRE(s(emit().ldr(xreg::x0, mem{xreg::x1, 3})) == "203040F8");
+  REQUIRE(s(emit().ldr(xreg::x0, mem::pre_index(xreg::x1, 16))) == "200C41F8");
+  REQUIRE(s(emit().ldr(wreg::w0, mem::post_index(xreg::x1, -4))) == "20C45FB8");
+  REQUIRE(s(emit().ldr(xreg::x0, mem{xreg::x1, xreg::x2})) == "206862F8");
+  REQUIRE(s(emit().ldr(xreg::x0, mem{xreg::x1, xreg::x2, 3})) == "207862F8");
+  REQUIRE(s(emit().ldr(wreg::w0, mem{xreg::x1, wreg::w2, extend::sxtw, 2})) == "20D862B8");
+  REQUIRE(s(emit().ldr(xreg::x0, mem{xreg::x1, wreg::w2, extend::uxtw})) == "204862F8");
+  REQUIRE(s(emit().ldrb(wreg::w0, mem{xreg::x1, 4095})) == "20FC7F39");
+  REQUIRE(s(emit().ldrb(wreg::w0, mem{xreg::x1, xreg::x2})) == "20686238");
+  REQUIRE(s(emit().ldrh(wreg::w0, mem{xreg::x1, 2})) == "20044079");
+  REQUIRE(s(emit().ldrsb(xreg::x0, mem{xreg::x1})) == "20008039");
+  REQUIRE(s(emit().ldrsb(wreg::w0, mem{xreg::x1})) == "2000C039");
+  REQUIRE(s(emit().ldrsh(xreg::x0, mem{xreg::x1, 6})) == "200C8079");
+  REQUIRE(s(emit().ldrsh(wreg::w0, mem{xreg::x1, xreg::x2, 1})) == "2078E278");
+  REQUIRE(s(emit().ldrsw(xreg::x0, mem{xreg::x1, 4})) == "200480B9");
+  REQUIRE(s(emit().ldrsw(xreg::x0, mem::post_index(xreg::x1, 4))) == "204480B8");
+  REQUIRE(s(emit().str(xreg::x0, mem{xreg::x1})) == "200000F9");
+  REQUIRE(s(emit().str(wreg::w0, mem{xreg::x1, 4})) == "200400B9");
+  REQUIRE(s(emit().str(xreg::x0, mem::pre_index(xreg::sp, -16))) == "E00F1FF8");
+  REQUIRE(s(emit().str(xreg::x0, mem::post_index(xreg::x1, 8))) == "208400F8");
+  REQUIRE(s(emit().strb(wreg::w0, mem{xreg::x1, 1})) == "20040039");
+  REQUIRE(s(emit().strh(wreg::w0, mem{xreg::x1, xreg::x2})) == "20682278");
+  REQUIRE_THROWS_AS(emit().ldr(xreg::x0, mem{xreg::x1, 32768}), std::out_of_range);
+  REQUIRE_THROWS_AS(emit().ldr(xreg::x0, mem::pre_index(xreg::x1, 256)), std::out_of_range);
+  REQUIRE_THROWS_AS(emit().ldr(xreg::x0, mem{xreg::x1, xreg::x2, 2}), std::invalid_argument);
+  REQUIRE_THROWS_AS(mem(xreg::x1, wreg::w2, extend::uxtb), std::invalid_argument);
+}
+
+TEST_CASE("load_store_unscaled") {
+  REQUIRE(s(emit().ldur(xreg::x0, mem{xreg::x1, -1})) == "20F05FF8");
+  REQUIRE(s(emit().ldur(wreg::w0, mem{xreg::x1, 255})) == "20F04FB8");
+  REQUIRE(s(emit().ldurb(wreg::w0, mem{xreg::x1, -256})) == "20005038");
+  REQUIRE(s(emit().ldurh(wreg::w0, mem{xreg::x1, 1})) == "20104078");
+  REQUIRE(s(emit().ldursb(xreg::x0, mem{xreg::x1, -1})) == "20F09F38");
+  REQUIRE(s(emit().ldursh(wreg::w0, mem{xreg::x1, -2})) == "20E0DF78");
+  REQUIRE(s(emit().ldursw(xreg::x0, mem{xreg::x1, -4})) == "20C09FB8");
+  REQUIRE(s(emit().stur(xreg::x0, mem{xreg::x1, -8})) == "20801FF8");
+  REQUIRE(s(emit().sturb(wreg::w0, mem{xreg::x1, 3})) == "20300038");
+  REQUIRE(s(emit().sturh(wreg::w0, mem{xreg::x1, -6})) == "20A01F78");
+  REQUIRE_THROWS_AS(emit().ldur(xreg::x0, mem{xreg::x1, 256}), std::out_of_range);
+  REQUIRE_THROWS_AS(emit().ldur(xreg::x0, mem::pre_index(xreg::x1, 8)), std::invalid_argument);
+}
+
+TEST_CASE("load_store_pair") {
+  REQUIRE(s(emit().ldp(xreg::x0, xreg::x1, mem{xreg::x2})) == "400440A9");
+  REQUIRE(s(emit().ldp(xreg::x29, xreg::x30, mem::post_index(xreg::sp, 16))) == "FD7BC1A8");
+  REQUIRE(s(emit().ldp(wreg::w0, wreg::w1, mem{xreg::x2, 8})) == "40044129");
+  REQUIRE(s(emit().ldpsw(xreg::x0, xreg::x1, mem{xreg::x2, -8})) == "40047F69");
+  REQUIRE(s(emit().stp(xreg::x29, xreg::x30, mem::pre_index(xreg::sp, -16))) == "FD7BBFA9");
+  REQUIRE(s(emit().stp(xreg::x0, xreg::x1, mem{xreg::x2, 504})) == "40841FA9");
+  REQUIRE(s(emit().stp(wreg::w0, wreg::w1, mem{xreg::x2, -256})) == "40042029");
+  REQUIRE_THROWS_AS(emit().stp(xreg::x0, xreg::x1, mem{xreg::x2, 512}), std::out_of_range);
+  REQUIRE_THROWS_AS(emit().stp(xreg::x0, xreg::x1, mem{xreg::x2, 4}), std::out_of_range);
+  REQUIRE_THROWS_AS(emit().ldp(xreg::x0, xreg::x1, mem{xreg::x2, xreg::x3}), std::invalid_argument);
+}
+
+TEST_CASE("logical") {
+  REQUIRE(s(emit().and_(xreg::x0, xreg::x1, 0xFF)) == "201C4092");
+  REQUIRE(s(emit().and_(wreg::w0, wreg::w1, 0x0F0F0F0F)) == "20CC0012");
+  REQUIRE(s(emit().orr(xreg::x0, xreg::x1, 0x5555555555555555)) == "20F000B2");
+  REQUIRE(s(emit().eor(xreg::x0, xreg::x1, 0x8000000000000000)) == "200041D2");
+  REQUIRE(s(emit().ands(wreg::w0, wreg::w1, 1)) == "20000072");
+  REQUIRE(s(emit().and_(xreg::sp, xreg::x1, 0xFFFFFFFFFFFFFFF0)) == "3FEC7C92");
+  REQUIRE(s(emit().tst(xreg::x0, 0xFFF0)) == "1F2C7CF2");
+  REQUIRE_THROWS_AS(emit().and_(xreg::x0, xreg::x1, 0x1234), std::invalid_argument);
+  REQUIRE(s(emit().and_(xreg::x0, xreg::x1, xreg::x2)) == "2000028A");
+  REQUIRE(s(emit().orr(wreg::w0, wreg::w1, wreg::w2, shift::ror, 8)) == "2020C22A");
+  REQUIRE(s(emit().eor(xreg::x0, xreg::x1, xreg::x2, shift::lsr, 4)) == "201042CA");
+  REQUIRE(s(emit().ands(xreg::x0, xreg::x1, xreg::x2)) == "200002EA");
+  REQUIRE(s(emit().bic(xreg::x0, xreg::x1, xreg::x2)) == "2000228A");
+  REQUIRE(s(emit().bics(wreg::w0, wreg::w1, wreg::w2)) == "2000226A");
+  REQUIRE(s(emit().orn(xreg::x0, xreg::x1, xreg::x2, shift::lsl, 1)) == "200422AA");
+  REQUIRE(s(emit().eon(xreg::x0, xreg::x1, xreg::x2)) == "200022CA");
+  REQUIRE(s(emit().mvn(xreg::x0, xreg::x1)) == "E00321AA");
+  REQUIRE(s(emit().tst(wreg::w0, wreg::w1)) == "1F00016A");
+}
+
+TEST_CASE("move") {
+  REQUIRE(s(emit().mov(xreg::x0, xreg::x1)) == "E00301AA");
+  REQUIRE(s(emit().mov(wreg::w0, wreg::w1)) == "E003012A");
+  REQUIRE(s(emit().movz(xreg::x0, 0x1234, 16)) == "8046A2D2");
+  REQUIRE(s(emit().movk(xreg::x0, 0xBEEF, 48)) == "E0DDF7F2");
+  REQUIRE(s(emit().movn(wreg::w0, 0)) == "00008012");
+  REQUIRE(s(emit().movz(wreg::w0, 0xFFFF)) == "E0FF9F52");
+  REQUIRE_THROWS_AS(emit().movz(wreg::w0, 0, 32), std::out_of_range);
+  REQUIRE_THROWS_AS(emit().movz(xreg::x0, 0, 8), std::out_of_range);
+  REQUIRE_THROWS_AS(emit().movz(xreg::x0, 0x10000), std::out_of_range);
+}
+
+TEST_CASE("move_immediate") {
+  REQUIRE(s(emit().mov(xreg::x0, 0)) == "000080D2");
+  REQUIRE(s(emit().mov(xreg::x0, 0xFFFFFFFFFFFFFFFF)) == "00008092");
+  REQUIRE(s(emit().mov(wreg::w0, 0xFFFFFFFF)) == "00008012");
+  REQUIRE(s(emit().mov(xreg::x0, 0x12340000)) == "8046A2D2");
+  REQUIRE(s(emit().mov(xreg::x0, 0xFFFFFFFFFFFF1234)) == "60B99D92");
+  REQUIRE(s(emit().mov(xreg::x0, 0x5555555555555555)) == "E0F300B2");
+  REQUIRE(s(emit().mov(wreg::w0, 0xFF00FF00)) == "E09F0832");
+  REQUIRE(s(emit().mov(wreg::w0, 0x12345678)) == "00CF8A52" "8046A272");
+  REQUIRE(s(emit().mov(xreg::x0, 0xFFFF1234FFFF5678)) == "E0309592" "8046C2F2");
+  REQUIRE(s(emit().mov(xreg::x0, 0x123456789ABCDEF0)) ==
+    "00DE9BD2" "8057B3F2" "00CFCAF2" "8046E2F2");
+}
+
+TEST_CASE("multiply_divide") {
+  REQUIRE(s(emit().madd(xreg::x0, xreg::x1, xreg::x2, xreg::x3)) == "200C029B");
+  REQUIRE(s(emit().msub(wreg::w0, wreg::w1, wreg::w2, wreg::w3)) == "208C021B");
+  REQUIRE(s(emit().mul(xreg::x0, xreg::x1, xreg::x2)) == "207C029B");
+  REQUIRE(s(emit().mneg(xreg::x0, xreg::x1, xreg::x2)) == "20FC029B");
+  REQUIRE(s(emit().smulh(xreg::x0, xreg::x1, xreg::x2)) == "207C429B");
+  REQUIRE(s(emit().umulh(xreg::x0, xreg::x1, xreg::x2)) == "207CC29B");
+  REQUIRE(s(emit().smull(xreg::x0, wreg::w1, wreg::w2)) == "207C229B");
+  REQUIRE(s(emit().umull(xreg::x0, wreg::w1, wreg::w2)) == "207CA29B");
+  REQUIRE(s(emit().sdiv(xreg::x0, xreg::x1, xreg::x2)) == "200CC29A");
+  REQUIRE(s(emit().udiv(wreg::w0, wreg::w1, wreg::w2)) == "2008C21A");
+}
+
+TEST_CASE("shifts") {
+  REQUIRE(s(emit().lsl(xreg::x0, xreg::x1, 3)) == "20F07DD3");
+  REQUIRE(s(emit().lsl(wreg::w0, wreg::w1, 31)) == "20000153");
+  REQUIRE(s(emit().lsr(xreg::x0, xreg::x1, 63)) == "20FC7FD3");
+  REQUIRE(s(emit().asr(wreg::w0, wreg::w1, 4)) == "207C0413");
+  REQUIRE(s(emit().ror(xreg::x0, xreg::x1, 7)) == "201CC193");
+  REQUIRE_THROWS_AS(emit().lsl(wreg::w0, wreg::w1, 32), std::out_of_range);
+  REQUIRE(s(emit().lsl(xreg::x0, xreg::x1, xreg::x2)) == "2020C29A");
+  REQUIRE(s(emit().lsr(wreg::w0, wreg::w1, wreg::w2)) == "2024C21A");
+  REQUIRE(s(emit().asr(xreg::x0, xreg::x1, xreg::x2)) == "2028C29A");
+  REQUIRE(s(emit().ror(xreg::x0, xreg::x1, xreg::x2)) == "202CC29A");
+  REQUIRE(s(emit().extr(xreg::x0, xreg::x1, xreg::x2, 16)) == "2040C293");
+}
+
+TEST_CASE("vector_arithmetic") {
+  REQUIRE(s(emit().add(vreg::v0, vreg::v1, vreg::v2, arrangement::b16)) == "2084224E");
+  REQUIRE(s(emit().add(vreg::v3, vreg::v4, vreg::v5, arrangement::d2)) == "8384E54E");
+  REQUIRE(s(emit().sub(vreg::v0, vreg::v1, vreg::v2, arrangement::s4)) == "2084A26E");
+  REQUIRE(s(emit().addp(vreg::v0, vreg::v1, vreg::v2, arrangement::h8)) == "20BC624E");
+  REQUIRE(s(emit().mul(vreg::v0, vreg::v1, vreg::v2, arrangement::s4)) == "209CA24E");
+  REQUIRE(s(emit().mla(vreg::v0, vreg::v1, vreg::v2, arrangement::b8)) == "2094220E");
+  REQUIRE(s(emit().mls(vreg::v0, vreg::v1, vreg::v2, arrangement::h4)) == "2094622E");
+  REQUIRE(s(emit().smax(vreg::v0, vreg::v1, vreg::v2, arrangement::s4)) == "2064A24E");
+  REQUIRE(s(emit().smin(vreg::v0, vreg::v1, vreg::v2, arrangement::b16)) == "206C224E");
+  REQUIRE(s(emit().umax(vreg::v0, vreg::v1, vreg::v2, arrangement::h8)) == "2064626E");
+  REQUIRE(s(emit().umin(vreg::v0, vreg::v1, vreg::v2, arrangement::s2)) == "206CA22E");
+  REQUIRE(s(emit().sqadd(vreg::v0, vreg::v1, vreg::v2, arrangement::d2)) == "200CE24E");
+  REQUIRE(s(emit().uqadd(vreg::v0, vreg::v1, vreg::v2, arrangement::b16)) == "200C226E");
+  REQUIRE(s(emit().sqsub(vreg::v0, vreg::v1, vreg::v2, arrangement::h8)) == "202C624E");
+  REQUIRE(s(emit().uqsub(vreg::v0, vreg::v1, vreg::v2, arrangement::s4)) == "202CA26E");
+  REQUIRE(s(emit().abs(vreg::v0, vreg::v1, arrangement::s4)) == "20B8A04E");
+  REQUIRE(s(emit().neg(vreg::v0, vreg::v1, arrangement::d2)) == "20B8E06E");
+  REQUIRE(s(emit().cnt(vreg::v0, vreg::v1, arrangement::b8)) == "2058200E");
+  REQUIRE(s(emit().cnt(vreg::v31, vreg::v30, arrangement::b16)) == "DF5B204E");
+  REQUIRE_THROWS_AS(emit().add(vreg::v0, vreg::v1, vreg::v2, arrangement::d1), std::invalid_argument);
+  REQUIRE_THROWS_AS(emit().mul(vreg::v0, vreg::v1, vreg::v2, arrangement::d2), std::invalid_argument);
+  REQUIRE_THROWS_AS(emit().cnt(vreg::v0, vreg::v1, arrangement::h8), std::invalid_argument);
+}
+
+TEST_CASE("vector_compare") {
+  REQUIRE(s(emit().cmeq(vreg::v0, vreg::v1, vreg::v2, arrangement::b16)) == "208C226E");
+  REQUIRE(s(emit().cmge(vreg::v0, vreg::v1, vreg::v2, arrangement::s4)) == "203CA24E");
+  REQUIRE(s(emit().cmgt(vreg::v0, vreg::v1, vreg::v2, arrangement::d2)) == "2034E24E");
+  REQUIRE(s(emit().cmhi(vreg::v0, vreg::v1, vreg::v2, arrangement::h8)) == "2034626E");
+  REQUIRE(s(emit().cmhs(vreg::v0, vreg::v1, vreg::v2, arrangement::b8)) == "203C222E");
+  REQUIRE(s(emit().cmtst(vreg::v0, vreg::v1, vreg::v2, arrangement::s4)) == "208CA24E");
+  REQUIRE(s(emit().cmeq(vreg::v0, vreg::v1, arrangement::b16)) == "2098204E");
+  REQUIRE(s(emit().cmge(vreg::v0, vreg::v1, arrangement::s4)) == "2088A06E");
+  REQUIRE(s(emit().cmgt(vreg::v0, vreg::v1, arrangement::d2)) == "2088E04E");
+  REQUIRE(s(emit().cmle(vreg::v0, vreg::v1, arrangement::h8)) == "2098606E");
+  REQUIRE(s(emit().cmlt(vreg::v0, vreg::v1, arrangement::s2)) == "20A8A00E");
+}
+
+TEST_CASE("vector_float") {
+  REQUIRE(s(emit().fadd(vreg::v0, vreg::v1, vreg::v2, arrangement::s4)) == "20D4224E");
+  REQUIRE(s(emit().fadd(vreg::v0, vreg::v1, vreg::v2, arrangement::d2)) == "20D4624E");
+  REQUIRE(s(emit().fsub(vreg::v0, vreg::v1, vreg::v2, arrangement::s2)) == "20D4A20E");
+  REQUIRE(s(emit().fmul(vreg::v0, vreg::v1, vreg::v2, arrangement::d2)) == "20DC626E");
+  REQUIRE(s(emit().fdiv(vreg::v0, vreg::v1, vreg::v2, arrangement::s4)) == "20FC226E");
+  REQUIRE(s(emit().fmla(vreg::v0, vreg::v1, vreg::v2, arrangement::s4)) == "20CC224E");
+  REQUIRE(s(emit().fmls(vreg::v0, vreg::v1, vreg::v2, arrangement::d2)) == "20CCE24E");
+  REQUIRE(s(emit().fmax(vreg::v0, vreg::v1, vreg::v2, arrangement::s4)) == "20F4224E");
+  REQUIRE(s(emit().fmin(vreg::v0, vreg::v1, vreg::v2, arrangement::d2)) == "20F4E24E");
+  REQUIRE(s(emit().fcmeq(vreg::v0, vreg::v1, vreg::v2, arrangement::s4)) == "20E4224E");
+  REQUIRE(s(emit().fcmge(vreg::v0, vreg::v1, vreg::v2, arrangement::d2)) == "20E4626E");
+  REQUIRE(s(emit().fcmgt(vreg::v0, vreg::v1, vreg::v2, arrangement::s4)) == "20E4A26E");
+  REQUIRE(s(emit().fabs(vreg::v0, vreg::v1, arrangement::s4)) == "20F8A04E");
+  REQUIRE(s(emit().fneg(vreg::v0, vreg::v1, arrangement::d2)) == "20F8E06E");
+  REQUIRE(s(emit().fsqrt(vreg::v0, vreg::v1, arrangement::s4)) == "20F8A16E");
+  REQUIRE(s(emit().fcvtzs(vreg::v0, vreg::v1, arrangement::s4)) == "20B8A14E");
+  REQUIRE(s(emit().fcvtzu(vreg::v0, vreg::v1, arrangement::d2)) == "20B8E16E");
+  REQUIRE(s(emit().scvtf(vreg::v0, vreg::v1, arrangement::s4)) == "20D8214E");
+  REQUIRE(s(emit().ucvtf(vreg::v0, vreg::v1, arrangement::d2)) == "20D8616E");
+  REQUIRE_THROWS_AS(emit().fadd(vreg::v0, vreg::v1, vreg::v2, arrangement::h8), std::invalid_argument);
+}
+
+TEST_CASE("vector_lanes") {
+  REQUIRE(s(emit().dup(vreg::v0, wreg::w1, arrangement::s4)) == "200C044E");
+  REQUIRE(s(emit().dup(vreg::v0, xreg::x1, arrangement::d2)) == "200C084E");
+  REQUIRE(s(emit().dup(vreg::v0, wreg::w1, arrangement::b16)) == "200C014E");
+  REQUIRE(s(emit().dup(vreg::v0, vreg::v1, 7, arrangement::h8)) == "20041E4E");
+  REQUIRE(s(emit().dup(vreg::v0, vreg::v1, 3, arrangement::s2)) == "20041C0E");
+  REQUIRE(s(emit().ins(vreg::v0, 1, wreg::w1, arrangement::s4)) == "201C0C4E");
+  REQUIRE(s(emit().ins(vreg::v0, 1, xreg::x1, arrangement::d2)) == "201C184E");
+  REQUIRE(s(emit().ins(vreg::v0, 15, wreg::w1, arrangement::b16)) == "201C1F4E");
+  REQUIRE(s(emit().umov(wreg::w0, vreg::v1, 3, arrangement::b16)) == "203C070E");
+  REQUIRE(s(emit().umov(xreg::x0, vreg::v1, 1, arrangement::d2)) == "203C184E");
+  REQUIRE(s(emit().umov(wreg::w0, vreg::v1, 2, arrangement::s4)) == "203C140E");
+  REQUIRE(s(emit().smov(xreg::x0, vreg::v1, 1, arrangement::s4)) == "202C0C4E");
+  REQUIRE(s(emit().smov(wreg::w0, vreg::v1, 4, arrangement::h8)) == "202C120E");
+  REQUIRE_THROWS_AS(emit().dup(vreg::v0, xreg::x1, arrangement::s4), std::invalid_argument);
+  REQUIRE_THROWS_AS(emit().ins(vreg::v0, 4, wreg::w1, arrangement::s4), std::out_of_range);
+  REQUIRE_THROWS_AS(emit().smov(xreg::x0, vreg::v1, 0, arrangement::d2), std::invalid_argument);
+}
+
+TEST_CASE("vector_load_store") {
+  REQUIRE(s(emit().ld1(vreg::v0, mem(xreg::x1), arrangement::b16)) == "2070404C");
+  REQUIRE(s(emit().ld1(vreg::v0, mem::post_index(xreg::x1, 32), arrangement::s4, 2)) == "20A8DF4C");
+  REQUIRE(s(emit().ld1(vreg::v0, mem(xreg::sp), arrangement::d1, 3)) == "E06F400C");
+  REQUIRE(s(emit().ld1(vreg::v0, mem::post_index(xreg::x1, 32), arrangement::b8, 4)) == "2020DF0C");
+  REQUIRE(s(emit().ld2(vreg::v0, mem(xreg::x1), arrangement::h8)) == "2084404C");
+  REQUIRE(s(emit().ld3(vreg::v0, mem::post_index(xreg::x1, 48), arrangement::s4)) == "2048DF4C");
+  REQUIRE(s(emit().ld4(vreg::v0, mem(xreg::x1), arrangement::b16)) == "2000404C");
+  REQUIRE(s(emit().st1(vreg::v0, mem::post_index(xreg::x1, 16), arrangement::d2)) == "207C9F4C");
+  REQUIRE(s(emit().st1(vreg::v0, mem(xreg::x1), arrangement::b16, 2)) == "20A0004C");
+  REQUIRE(s(emit().st2(vreg::v0, mem::post_index(xreg::x1, 16), arrangement::s2)) == "20889F0C");
+  REQUIRE(s(emit().st3(vreg::v0, mem(xreg::x1), arrangement::b8)) == "2040000C");
+  REQUIRE(s(emit().st4(vreg::v0, mem::post_index(xreg::x1, 64), arrangement::s4)) == "20089F4C");
+  REQUIRE_THROWS_AS(emit().ld1(vreg::v0, mem(xreg::x1, 16), arrangement::b16), std::out_of_range);
+  REQUIRE_THROWS_AS(emit().ld1(vreg::v0, mem::post_index(xreg::x1, 16), arrangement::b16, 2), std::out_of_range);
+  REQUIRE_THROWS_AS(emit().st2(vreg::v0, mem::pre_index(xreg::x1, 32), arrangement::b16), std::invalid_argument);
+  REQUIRE_THROWS_AS(emit().ld2(vreg::v0, mem(xreg::x1), arrangement::d1), std::invalid_argument);
+}
+
+TEST_CASE("vector_logical") {
+  REQUIRE(s(emit().and_(vreg::v0, vreg::v1, vreg::v2, arrangement::b16)) == "201C224E");
+  REQUIRE(s(emit().bic(vreg::v0, vreg::v1, vreg::v2, arrangement::b8)) == "201C620E");
+  REQUIRE(s(emit().orr(vreg::v0, vreg::v1, vreg::v2, arrangement::b16)) == "201CA24E");
+  REQUIRE(s(emit().orn(vreg::v0, vreg::v1, vreg::v2, arrangement::b16)) == "201CE24E");
+  REQUIRE(s(emit().eor(vreg::v0, vreg::v1, vreg::v2, arrangement::b16)) == "201C226E");
+  REQUIRE(s(emit().bsl(vreg::v0, vreg::v1, vreg::v2, arrangement::b16)) == "201C626E");
+  REQUIRE(s(emit().bit(vreg::v0, vreg::v1, vreg::v2, arrangement::b16)) == "201CA26E");
+  REQUIRE(s(emit().bif(vreg::v0, vreg::v1, vreg::v2, arrangement::b16)) == "201CE26E");
+  REQUIRE(s(emit().not_(vreg::v0, vreg::v1, arrangement::b16)) == "2058206E");
+  REQUIRE(s(emit().mov(vreg::v0, vreg::v1, arrangement::b16)) == "201CA14E");
+}
+
+TEST_CASE("vector_permute") {
+  REQUIRE(s(emit().zip1(vreg::v0, vreg::v1, vreg::v2, arrangement::b16)) == "2038024E");
+  REQUIRE(s(emit().zip2(vreg::v0, vreg::v1, vreg::v2, arrangement::s4)) == "2078824E");
+  REQUIRE(s(emit().uzp1(vreg::v0, vreg::v1, vreg::v2, arrangement::h8)) == "2018424E");
+  REQUIRE(s(emit().uzp2(vreg::v0, vreg::v1, vreg::v2, arrangement::d2)) == "2058C24E");
+  REQUIRE(s(emit().trn1(vreg::v0, vreg::v1, vreg::v2, arrangement::b8)) == "2028020E");
+  REQUIRE(s(emit().trn2(vreg::v0, vreg::v1, vreg::v2, arrangement::s2)) == "2068820E");
+  REQUIRE(s(emit().ext(vreg::v0, vreg::v1, vreg::v2, 15, arrangement::b16)) == "2078026E");
+  REQUIRE(s(emit().ext(vreg::v0, vreg::v1, vreg::v2, 3, arrangement::b8)) == "2018022E");
+  REQUIRE(s(emit().tbl(vreg::v0, vreg::v1, vreg::v2, arrangement::b16)) == "2000024E");
+  REQUIRE(s(emit().tbl(vreg::v0, vreg::v30, vreg::v2, arrangement::b8, 4)) == "C063020E");
+  REQUIRE(s(emit().tbx(vreg::v0, vreg::v1, vreg::v3, arrangement::b16, 2)) == "2030034E");
+  REQUIRE_THROWS_AS(emit().ext(vreg::v0, vreg::v1, vreg::v2, 8, arrangement::b8), std::out_of_range);
+  REQUIRE_THROWS_AS(emit().tbl(vreg::v0, vreg::v1, vreg::v2, arrangement::b16, 5), std::out_of_range);
+}
+
+TEST_CASE("vector_reduce") {
+  REQUIRE(s(emit().addv(vreg::v0, vreg::v1, arrangement::b16)) == "20B8314E");
+  REQUIRE(s(emit().addv(vreg::v0, vreg::v1, arrangement::s4)) == "20B8B14E");
+  REQUIRE(s(emit().smaxv(vreg::v0, vreg::v1, arrangement::h8)) == "20A8704E");
+  REQUIRE(s(emit().sminv(vreg::v0, vreg::v1, arrangement::b8)) == "20A8310E");
+  REQUIRE(s(emit().umaxv(vreg::v0, vreg::v1, arrangement::s4)) == "20A8B06E");
+  REQUIRE(s(emit().uminv(vreg::v0, vreg::v1, arrangement::h4)) == "20A8712E");
+  REQUIRE(s(emit().saddlv(vreg::v0, vreg::v1, arrangement::b16)) == "2038304E");
+  REQUIRE(s(emit().uaddlv(vreg::v0, vreg::v1, arrangement::s4)) == "2038B06E");
+}
+
+TEST_CASE("vector_shift") {
+  REQUIRE(s(emit().shl(vreg::v0, vreg::v1, 3, arrangement::s4)) == "2054234F");
+  REQUIRE(s(emit().shl(vreg::v0, vreg::v1, 7, arrangement::b16)) == "20540F4F");
+  REQUIRE(s(emit().sshr(vreg::v0, vreg::v1, 64, arrangement::d2)) == "2004404F");
+  REQUIRE(s(emit().ushr(vreg::v0, vreg::v1, 1, arrangement::h8)) == "20041F6F");
+  REQUIRE_THROWS_AS(emit().shl(vreg::v0, vreg::v1, 32, arrangement::s4), std::out_of_range);
+  REQUIRE_THROWS_AS(emit().ushr(vreg::v0, vreg::v1, 0, arrangement::h8), std::out_of_range);
+}
+
+TEST_CASE("vector_widen_narrow") {
+  REQUIRE(s(emit().sshll(vreg::v0, vreg::v1, 2, arrangement::b8)) == "20A40A0F");
+  REQUIRE(s(emit().ushll(vreg::v0, vreg::v1, 31, arrangement::s4)) == "20A43F6F");
+  REQUIRE(s(emit().sxtl(vreg::v0, vreg::v1, arrangement::h4)) == "20A4100F");
+  REQUIRE(s(emit().uxtl(vreg::v0, vreg::v1, arrangement::b16)) == "20A4086F");
+  REQUIRE(s(emit().shrn(vreg::v0, vreg::v1, 8, arrangement::b8)) == "2084080F");
+  REQUIRE(s(emit().shrn(vreg::v0, vreg::v1, 1, arrangement::s4)) == "20843F4F");
+  REQUIRE(s(emit().saddl(vreg::v0, vreg::v1, vreg::v2, arrangement::b8)) == "2000220E");
+  REQUIRE(s(emit().uaddl(vreg::v0, vreg::v1, vreg::v2, arrangement::h8)) == "2000626E");
+  REQUIRE(s(emit().ssubl(vreg::v0, vreg::v1, vreg::v2, arrangement::s2)) == "2020A20E");
+  REQUIRE(s(emit().usubl(vreg::v0, vreg::v1, vreg::v2, arrangement::b8)) == "2020222E");
+  REQUIRE(s(emit().smull(vreg::v0, vreg::v1, vreg::v2, arrangement::b8)) == "20C0220E");
+  REQUIRE(s(emit().umull(vreg::v0, vreg::v1, vreg::v2, arrangement::s4)) == "20C0A26E");
+  REQUIRE(s(emit().smlal(vreg::v0, vreg::v1, vreg::v2, arrangement::h4)) == "2080620E");
+  REQUIRE(s(emit().umlal(vreg::v0, vreg::v1, vreg::v2, arrangement::b8)) == "2080222E");
+  REQUIRE(s(emit().xtn(vreg::v0, vreg::v1, arrangement::b8)) == "2028210E");
+  REQUIRE(s(emit().xtn(vreg::v0, vreg::v1, arrangement::s4)) == "2028A14E");
+  REQUIRE(s(emit().sqxtn(vreg::v0, vreg::v1, arrangement::h4)) == "2048610E");
+  REQUIRE(s(emit().uqxtn(vreg::v0, vreg::v1, arrangement::s2)) == "2048A12E");
+  REQUIRE(s(emit().sqxtun(vreg::v0, vreg::v1, arrangement::b16)) == "2028216E");
+  REQUIRE_THROWS_AS(emit().saddl(vreg::v0, vreg::v1, vreg::v2, arrangement::d2), std::invalid_argument);
+}
+
+TEST_CASE("sve_arithmetic") {
+  REQUIRE(s(emit().add(zreg::z0, preg::p1, zreg::z2, element::b)) == "40040004");
+  REQUIRE(s(emit().sub(zreg::z3, preg::p7, zreg::z31, element::d)) == "E31FC104");
+  REQUIRE(s(emit().mul(zreg::z1, preg::p0, zreg::z2, element::s)) == "41009004");
+  REQUIRE(s(emit().sdiv(zreg::z4, preg::p2, zreg::z5, element::s)) == "A4089404");
+  REQUIRE(s(emit().udiv(zreg::z4, preg::p2, zreg::z5, element::d)) == "A408D504");
+  REQUIRE(s(emit().smax(zreg::z0, preg::p1, zreg::z2, element::h)) == "40044804");
+  REQUIRE(s(emit().smin(zreg::z0, preg::p1, zreg::z2, element::b)) == "40040A04");
+  REQUIRE(s(emit().umax(zreg::z0, preg::p1, zreg::z2, element::s)) == "40048904");
+  REQUIRE(s(emit().umin(zreg::z0, preg::p1, zreg::z2, element::d)) == "4004CB04");
+  REQUIRE(s(emit().and_(zreg::z0, preg::p1, zreg::z2, element::b)) == "40041A04");
+  REQUIRE(s(emit().orr(zreg::z0, preg::p1, zreg::z2, element::h)) == "40045804");
+  REQUIRE(s(emit().eor(zreg::z0, preg::p1, zreg::z2, element::d)) == "4004D904");
+  REQUIRE(s(emit().mla(zreg::z0, preg::p1, zreg::z2, zreg::z3, element::s)) == "40448304");
+  REQUIRE(s(emit().add(zreg::z0, zreg::z1, zreg::z2, element::s)) == "2000A204");
+  REQUIRE(s(emit().sub(zreg::z0, zreg::z1, zreg::z2, element::b)) == "20042204");
+  REQUIRE(s(emit().dup(zreg::z0, wreg::w1, element::h)) == "20386005");
+  REQUIRE(s(emit().dup(zreg::z0, xreg::x1, element::d)) == "2038E005");
+  REQUIRE_THROWS_AS(emit().add(zreg::z0, preg::p8, zreg::z2, element::b), std::invalid_argument);
+  REQUIRE_THROWS_AS(emit().sdiv(zreg::z0, preg::p1, zreg::z2, element::h), std::invalid_argument);
+  REQUIRE_THROWS_AS(emit().dup(zreg::z0, wreg::w1, element::d), std::invalid_argument);
+}
+
+TEST_CASE("sve_compare") {
+  REQUIRE(s(emit().cmpeq(preg::p0, preg::p1, zreg::z2, zreg::z3, element::b)) == "40A40324");
+  REQUIRE(s(emit().cmpne(preg::p15, preg::p1, zreg::z2, zreg::z3, element::h)) == "5FA44324");
+  REQUIRE(s(emit().cmpgt(preg::p0, preg::p7, zreg::z2, zreg::z3, element::s)) == "509C8324");
+  REQUIRE(s(emit().cmpge(preg::p0, preg::p1, zreg::z2, zreg::z3, element::d)) == "4084C324");
+  REQUIRE(s(emit().cmphi(preg::p0, preg::p1, zreg::z2, zreg::z3, element::s)) == "50048324");
+  REQUIRE(s(emit().cmphs(preg::p0, preg::p1, zreg::z2, zreg::z3, element::b)) == "40040324");
+  REQUIRE_THROWS_AS(emit().cmpeq(preg::p0, preg::p8, zreg::z2, zreg::z3, element::b), std::invalid_argument);
+}
+
+TEST_CASE("sve_count") {
+  REQUIRE(s(emit().cntb(xreg::x0)) == "E0E32004");
+  REQUIRE(s(emit().cnth(xreg::x1, pattern::vl8)) == "01E16004");
+  REQUIRE(s(emit().cntw(xreg::x2)) == "E2E3A004");
+  REQUIRE(s(emit().cntd(xreg::x3, pattern::all, 16)) == "E3E3EF04");
+  REQUIRE(s(emit().incb(xreg::x0)) == "E0E33004");
+  REQUIRE(s(emit().inch(xreg::x0, pattern::pow2, 2)) == "00E07104");
+  REQUIRE(s(emit().incw(xreg::x5)) == "E5E3B004");
+  REQUIRE(s(emit().incd(xreg::x5)) == "E5E3F004");
+  REQUIRE(s(emit().decb(xreg::x0, pattern::all, 4)) == "E0E73304");
+  REQUIRE(s(emit().dech(xreg::x0)) == "E0E77004");
+  REQUIRE(s(emit().decw(xreg::x0, pattern::mul4)) == "A0E7B004");
+  REQUIRE(s(emit().decd(xreg::x30)) == "FEE7F004");
+  REQUIRE_THROWS_AS(emit().cntb(xreg::x0, pattern::all, 0), std::out_of_range);
+  REQUIRE_THROWS_AS(emit().incw(xreg::x0, pattern::all, 17), std::out_of_range);
+}
+
+TEST_CASE("sve_float") {
+  REQUIRE(s(emit().fadd(zreg::z0, preg::p1, zreg::z2, element::s)) == "40848065");
+  REQUIRE(s(emit().fsub(zreg::z0, preg::p1, zreg::z2, element::d)) == "4084C165");
+  REQUIRE(s(emit().fmul(zreg::z0, preg::p1, zreg::z2, element::h)) == "40844265");
+  REQUIRE(s(emit().fdiv(zreg::z0, preg::p1, zreg::z2, element::s)) == "40848D65");
+  REQUIRE(s(emit().fmax(zreg::z0, preg::p1, zreg::z2, element::d)) == "4084C665");
+  REQUIRE(s(emit().fmin(zreg::z0, preg::p1, zreg::z2, element::s)) == "40848765");
+  REQUIRE(s(emit().fmla(zreg::z0, preg::p1, zreg::z2, zreg::z3, element::d)) == "4004E365");
+  REQUIRE_THROWS_AS(emit().fadd(zreg::z0, preg::p1, zreg::z2, element::b), std::invalid_argument);
+}
+
+TEST_CASE("sve_gather_first_fault") {
+  REQUIRE(s(emit().ld1w(zreg::z0, preg::p1, xreg::x2, zreg::z3, extend::uxtw)) == "40442385");
+  REQUIRE(s(emit().ld1w(zreg::z0, preg::p1, xreg::x2, zreg::z3, extend::sxtw)) == "40446385");
+  REQUIRE(s(emit().ld1d(zreg::z0, preg::p1, xreg::x2, zreg::z3)) == "40C4E3C5");
+  REQUIRE(s(emit().ldff1b(zreg::z0, preg::p1, mem(xreg::x2))) == "40641FA4");
+  REQUIRE(s(emit().ldff1h(zreg::z0, preg::p1, mem(xreg::x2, xreg::x3, 1))) == "4064A3A4");
+  REQUIRE(s(emit().ldff1w(zreg::z0, preg::p1, mem(xreg::x2, xreg::x3, 2))) == "406443A5");
+  REQUIRE(s(emit().ldff1d(zreg::z0, preg::p1, mem(xreg::x2))) == "4064FFA5");
+  REQUIRE(s(emit().setffr()) == "00902C25");
+  REQUIRE(s(emit().rdffr(preg::p0)) == "00F01925");
+  REQUIRE(s(emit().rdffr(preg::p0, preg::p9)) == "20F11825");
+  REQUIRE(s(emit().wrffr(preg::p3)) == "60902825");
+  REQUIRE_THROWS_AS(emit().ld1w(zreg::z0, preg::p1, xreg::x2, zreg::z3, extend::uxtx), std::invalid_argument);
+  REQUIRE_THROWS_AS(emit().ldff1b(zreg::z0, preg::p1, mem(xreg::x2, 1)), std::out_of_range);
+}
+
+TEST_CASE("sve_load_store") {
+  REQUIRE(s(emit().ld1b(zreg::z0, preg::p1, mem(xreg::x2))) == "40A400A4");
+  REQUIRE(s(emit().ld1h(zreg::z0, preg::p1, mem(xreg::x2, -8))) == "40A4A8A4");
+  REQUIRE(s(emit().ld1w(zreg::z0, preg::p1, mem(xreg::sp, 7))) == "E0A747A5");
+  REQUIRE(s(emit().ld1d(zreg::z31, preg::p7, mem(xreg::x2, xreg::x3, 3))) == "5F5CE3A5");
+  REQUIRE(s(emit().ld1b(zreg::z0, preg::p1, mem(xreg::x2, xreg::x3))) == "404403A4");
+  REQUIRE(s(emit().ld1w(zreg::z0, preg::p1, mem(xreg::x2, xreg::x3, 2))) == "404443A5");
+  REQUIRE(s(emit().st1b(zreg::z0, preg::p1, mem(xreg::x2, 1))) == "40E401E4");
+  REQUIRE(s(emit().st1h(zreg::z0, preg::p1, mem(xreg::x2, xreg::x3, 1))) == "4044A3E4");
+  REQUIRE(s(emit().st1w(zreg::z0, preg::p1, mem(xreg::x2))) == "40E440E5");
+  REQUIRE(s(emit().st1d(zreg::z0, preg::p1, mem(xreg::x2, -1))) == "40E4EFE5");
+  REQUIRE_THROWS_AS(emit().ld1b(zreg::z0, preg::p1, mem(xreg::x2, 8)), std::out_of_range);
+  REQUIRE_THROWS_AS(emit().st1d(zreg::z0, preg::p1, mem(xreg::x2, -9)), std::out_of_range);
+  REQUIRE_THROWS_AS(emit().ld1h(zreg::z0, preg::p1, mem(xreg::x2, xreg::x3)), std::invalid_argument);
+  REQUIRE_THROWS_AS(emit().ld1b(zreg::z0, preg::p1, mem(xreg::x2, xreg::xzr)), std::invalid_argument);
+  REQUIRE_THROWS_AS(emit().ld1w(zreg::z0, preg::p1, mem::post_index(xreg::x2, 16)), std::invalid_argument);
+  REQUIRE_THROWS_AS(emit().st1b(zreg::z0, preg::p8, mem(xreg::x2)), std::invalid_argument);
+}
+
+TEST_CASE("sve_predicate") {
+  REQUIRE(s(emit().ptrue(preg::p0, element::b)) == "E0E31825");
+  REQUIRE(s(emit().ptrue(preg::p15, element::d, pattern::vl4)) == "8FE0D825");
+  REQUIRE(s(emit().ptrue(preg::p1, element::s, pattern::mul3)) == "C1E39825");
+  REQUIRE(s(emit().whilelt(preg::p0, element::s, xreg::x1, xreg::x2)) == "2014A225");
+  REQUIRE(s(emit().whilelt(preg::p0, element::b, wreg::w1, wreg::w2)) == "20042225");
+  REQUIRE(s(emit().whilele(preg::p1, element::h, xreg::x1, xreg::x2)) == "31146225");
+  REQUIRE(s(emit().whilelo(preg::p1, element::d, xreg::x1, xreg::x2)) == "211CE225");
+  REQUIRE(s(emit().whilels(preg::p1, element::s, wreg::w1, wreg::w2)) == "310CA225");
+  REQUIRE(s(emit().whilege(preg::p2, element::s, xreg::x1, xreg::x2)) == "2210A225");
+  REQUIRE(s(emit().whilegt(preg::p2, element::b, xreg::x1, xreg::x2)) == "32102225");
+  REQUIRE(s(emit().whilehi(preg::p2, element::h, xreg::x1, xreg::x2)) == "32186225");
+  REQUIRE(s(emit().whilehs(preg::p2, element::d, wreg::w1, wreg::w2)) == "2208E225");
+}
+
 TEST_CASE("hint") {
   REQUIRE(s(emit().hint()) == "1F2003D5");
   REQUIRE(s(emit().hint(0)) == "1F2003D5");
@@ -67,3 +687,117 @@ TEST_CASE("wfi") {
 TEST_CASE("yield") {
   REQUIRE(s(emit().yield()) == "3F2003D5");
 }
+
+TEST_CASE("static_buffer") {
+  static_buffer<8> buffer;
+  arm_emitter<decltype(buffer)>(buffer).nop().yield();
+  REQUIRE(buffer.size() == 8);
+  REQUIRE(buffer.data()[4] == 0x3F);
+  REQUIRE_THROWS_AS(arm_emitter<decltype(buffer)>(buffer).nop(), std::length_error);
+}
+
+TEST_CASE("counting_buffer") {
+  counting_buffer buffer;
+  arm_emitter<decltype(buffer)>(buffer).nop().wfe().wfi();
+  REQUIRE(buffer.size() == 12);
+}
+
+TEST_CASE("counting_buffer_veneer") {
+  counting_buffer buffer;
+  arm_emitter<decltype(buffer)> emitter(buffer);
+  const auto loop = emitter.new_label();
+  const auto far = emitter.new_label();
+  emitter.nop().tbz(xreg::x0, 0, far).align(16).bind(loop);
+  for (auto i = 0; i < 8192; i++) {
+    emitter.nop();
+  }
+  emitter.b(loop).bind(far).ret();
+  /* The same layout as in "branch_veneer", without any bytes: */
+  REQUIRE(buffer.size() == 32792);
+  REQUIRE(emitter.offset(far) == 32788);
+}
+
+TEST_CASE("persistent_buffer_veneer") {
+  FILE* const stream = std::tmpfile();
+  REQUIRE(stream != nullptr);
+  {
+    persistent_buffer buffer(stream);
+    arm_emitter<decltype(buffer)> emitter(buffer);
+    const auto done = emitter.new_label();
+    emitter.b(done).cbz(wreg::w0, done).nop().bind(done).ret();
+    /* The CBZ gets its veneer up front, since the code can't move later: */
+    REQUIRE(buffer.size() == 20);
+    REQUIRE(emitter.offset(done) == 16);
+  }
+  std::rewind(stream);
+  std::uint8_t bytes[20];
+  REQUIRE(std::fread(bytes, 1, sizeof(bytes), stream) == sizeof(bytes));
+  std::fclose(stream);
+  REQUIRE(word(bytes) == 0x14000004);      /* B done */
+  REQUIRE(word(bytes + 4) == 0x35000040);  /* CBNZ W0, #8 */
+  REQUIRE(word(bytes + 8) == 0x14000002);  /* B done */
+}
+
+TEST_CASE("far_jump") {
+  REQUIRE(s(emit().far_jump(reinterpret_cast<const void*>(0x123456789ABCDEF0))) ==
+    "50000058" "00021FD6" "F0DEBC9A78563412");
+}
+
+TEST_CASE("segmented_buffer") {
+  segmented_buffer<arm_emitter> buffer(executable_mapping::page_size());
+  arm_emitter<decltype(buffer)> emitter(buffer);
+  std::size_t offset = 0;
+  while (buffer.segment_count() < 2) {
+    offset = buffer.size();
+    emitter.nop();
+  }
+  /* The last NOP moved to the second segment behind the link: */
+  REQUIRE(buffer.size() == offset + decltype(buffer)::link_size + 4);
+  REQUIRE(buffer.address(offset)[0] == 0x50);
+  REQUIRE(buffer.address(offset)[7] == 0xD6);
+  const std::uint8_t* target;
+  std::memcpy(&target, buffer.address(offset + 8), sizeof(target));
+  REQUIRE(target == buffer.address(offset + decltype(buffer)::link_size));
+}
+
+/* Returns the target of the B or B.cond instruction at the given address: */
+static const std::uint8_t*
+target_of(const std::uint8_t* const insn) {
+  const std::uint32_t value = word(insn);
+  if ((value >> 26) == 0x05) {
+    return insn + (static_cast<std::int32_t>(value << 6) >> 6) * 4;
+  }
+  return insn + (static_cast<std::int32_t>(value << 8) >> 13) * 4;
+}
+
+TEST_CASE("segmented_buffer_branch") {
+  segmented_buffer<arm_emitter> buffer(executable_mapping::page_size());
+  arm_emitter<decltype(buffer)> emitter(buffer);
+  const auto done = emitter.new_label();
+  const auto loop = emitter.new_label();
+  emitter.mov(wreg::w0, 1).b(done);
+  const std::size_t jump = buffer.size() - 4;
+  while (buffer.segment_count() < 2) {
+    emitter.mov(wreg::w0, 2);
+  }
+  /* Count W1 down to zero across the next segment link: */
+  emitter.bind(loop).subs(wreg::w1, wreg::w1, 1).mov(wreg::w0, 3);
+  while (buffer.segment_count() < 3) {
+    emitter.nop();
+  }
+  const std::size_t back = buffer.size();
+  emitter.b(cc::ne, loop).add(wreg::w0, wreg::w0, 4).ret();
+  emitter.bind(done).mov(wreg::w1, 3).b(loop);
+  REQUIRE(buffer.segment_count() == 3);
+
+  /* The branches reach their targets as laid out in memory: */
+  REQUIRE(target_of(buffer.address(jump)) == buffer.address(emitter.offset(done)));
+  const std::uint8_t* branch = buffer.address(back);
+  if ((branch[0] & 0xF) == static_cast<std::uint8_t>(cc::eq)) {
+    branch += 4; /* a veneer */
+  }
+  REQUIRE(target_of(branch) == buffer.address(emitter.offset(loop)));
+#if defined(__aarch64__)
+  REQUIRE(buffer.execute<std::uint32_t>() == 7);
+#endif
+}
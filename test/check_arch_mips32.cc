@@ -11,11 +11,61 @@
 #include <machinery/util/buffer.h>
 
 #include <cstdio> /* for std::sprintf() */
+#include <string> /* for std::string */
 
 using namespace machinery::arch;
 using namespace machinery::arch::mips32;
 using namespace machinery::util;
 
+static appendable_buffer _buffer;
+
+static mips32_emitter<decltype(_buffer)>
+emit() {
+  _buffer.clear();
+  return mips32_emitter<decltype(_buffer)>(_buffer);
+}
+
+static std::string
+s(const mips32_emitter<decltype(_buffer)>&) {
+  static char string[4096];
+  for (auto i = 0UL; i < _buffer.size(); i++) {
+    std::sprintf(string + i * 2, "%02X", _buffer.data()[i]);
+  }
+  return std::string{string};
+}
+
+TEST_CASE("align") {
+  REQUIRE(s(emit().nop().align(16)) == "00000000000000000000000000000000");
+  REQUIRE(s(emit().nop().align(8, padding::trap)) == "000000000D000000");
+  REQUIRE_THROWS_AS(emit().align(2), std::invalid_argument);
+}
+
+TEST_CASE("b_backward") {
+  auto emitter = emit();
+  const auto loop = emitter.new_label();
+  emitter.bind(loop).nop().b(loop);
+  REQUIRE(s(emitter) == "00000000" "FEFF0010" "00000000");
+}
+
+TEST_CASE("b_forward") {
+  auto emitter = emit();
+  const auto done = emitter.new_label();
+  emitter.b(done).nop().bind(done).nop();
+  REQUIRE(s(emitter) == "02000010" "00000000" "00000000" "00000000");
+  REQUIRE(emitter.offset(done) == 12);
+  REQUIRE_THROWS_AS(emitter.bind(done), std::logic_error);
+}
+
+TEST_CASE("b_far") {
+  auto emitter = emit();
+  const auto done = emitter.new_label();
+  emitter.b(done);
+  for (auto i = 0; i < 32768; i++) {
+    emitter.nop();
+  }
+  REQUIRE_THROWS_AS(emitter.bind(done), std::out_of_range);
+}
+
 TEST_CASE("nop") {
-  // TODO
+  REQUIRE(s(emit().nop()) == "00000000");
 }
@@ -75,17 +75,655 @@ TEST_CASE("ret") {
 }
 
 TEST_CASE("xor_al_al") {
-  //REQUIRE(s(emit().xor_(reg8::al, reg8::al)) == "30C0");
+  REQUIRE(s(emit().xor_(reg8::al, reg8::al)) == "30C0");
 }
 
 TEST_CASE("xor_ax_ax") {
-  //REQUIRE(s(emit().xor_(reg16::ax, reg16::ax)) == "6631C0");
+  REQUIRE(s(emit().xor_(reg16::ax, reg16::ax)) == "6631C0");
 }
 
 TEST_CASE("xor_eax_eax") {
-  //REQUIRE(s(emit().xor_(reg32::eax, reg32::eax)) == "31C0");
+  REQUIRE(s(emit().xor_(reg32::eax, reg32::eax)) == "31C0");
 }
 
 TEST_CASE("xor_rax_rax") {
-  //REQUIRE(s(emit().xor_(reg64::rax, reg64::rax)) == "4831C0");
+  REQUIRE(s(emit().xor_(reg64::rax, reg64::rax)) == "4831C0");
+}
+
+TEST_CASE("push_pop_r8_r15") {
+  REQUIRE(s(emit().push(reg64::r8)) == "4150");
+  REQUIRE(s(emit().push(reg64::r15)) == "4157");
+  REQUIRE(s(emit().pop(reg64::r12)) == "415C");
+  REQUIRE(s(emit().push(reg16::ax)) == "6650");
+}
+
+TEST_CASE("mov_reg_imm") {
+  REQUIRE(s(emit().mov(reg8::al, imm8{0x12})) == "B012");
+  REQUIRE(s(emit().mov(reg8::sil, imm8{0x12})) == "40B612");
+  REQUIRE(s(emit().mov(reg8::r9b, imm8{0x12})) == "41B112");
+  REQUIRE(s(emit().mov(reg16::r8w, imm16{0x1234})) == "6641B83412");
+  REQUIRE(s(emit().mov(reg32::r15d, imm32{0x12345678})) == "41BF78563412");
+  REQUIRE(s(emit().mov(reg64::rax, imm64{0x123456789ABCDEF0})) == "48B8F0DEBC9A78563412");
+  REQUIRE(s(emit().mov(reg64::r10, imm64{1})) == "41BA01000000");
+}
+
+TEST_CASE("mov_reg_imm_compact") {
+  REQUIRE(s(emit().mov(reg64::rax, imm64{1})) == "B801000000");
+  REQUIRE(s(emit().mov(reg64::rax, imm64{0xFFFFFFFF})) == "B8FFFFFFFF");
+  REQUIRE(s(emit().mov(reg64::rax, imm64{0xFFFFFFFFFFFFFFFF})) == "48C7C0FFFFFFFF");
+  REQUIRE(s(emit().mov(reg64::rax, imm64{0x100000000})) == "48B80000000001000000");
+  REQUIRE(s(emit().mov(reg64::r8, imm64{0})) == "4531C0");
+  REQUIRE(s(emit().mov(reg32::eax, imm32{0})) == "31C0");
+  REQUIRE(s(emit().set_compact_immediates(false).mov(reg64::r10, imm64{1})) == "49BA0100000000000000");
+  REQUIRE(s(emit().set_compact_immediates(false).mov(reg32::eax, imm32{0})) == "B800000000");
+}
+
+TEST_CASE("mov_reg_reg") {
+  REQUIRE(s(emit().mov(reg8::al, reg8::bl)) == "88D8");
+  REQUIRE(s(emit().mov(reg8::dil, reg8::al)) == "4088C7");
+  REQUIRE(s(emit().mov(reg16::cx, reg16::dx)) == "6689D1");
+  REQUIRE(s(emit().mov(reg32::r8d, reg32::eax)) == "4189C0");
+  REQUIRE(s(emit().mov(reg64::rax, reg64::r15)) == "4C89F8");
+  REQUIRE(s(emit().mov(reg64::r12, reg64::r13)) == "4D89EC");
+  REQUIRE_THROWS_AS(emit().mov(reg8::ah, reg8::sil), std::invalid_argument);
+  REQUIRE_THROWS_AS(emit().mov(reg8::r8b, reg8::bh), std::invalid_argument);
+}
+
+TEST_CASE("mov_reg_mem") {
+  REQUIRE(s(emit().mov(reg64::rax, mem{reg64::rbx})) == "488B03");
+  REQUIRE(s(emit().mov(reg64::rax, mem{reg64::rsp})) == "488B0424");
+  REQUIRE(s(emit().mov(reg64::rax, mem{reg64::rbp})) == "488B4500");
+  REQUIRE(s(emit().mov(reg64::rax, mem{reg64::r12})) == "498B0424");
+  REQUIRE(s(emit().mov(reg64::rax, mem{reg64::r13})) == "498B4500");
+  REQUIRE(s(emit().mov(reg32::eax, mem{reg64::rbx, 8})) == "8B4308");
+  REQUIRE(s(emit().mov(reg32::eax, mem{reg64::rbx, -128})) == "8B4380");
+  REQUIRE(s(emit().mov(reg32::eax, mem{reg64::rbx, 128})) == "8B8380000000");
+  REQUIRE(s(emit().mov(reg64::rcx, mem{reg64::rax, reg64::rbx, 4})) == "488B0C98");
+  REQUIRE(s(emit().mov(reg64::rcx, mem{reg64::rax, reg64::r9, 8, 0x10})) == "4A8B4CC810");
+  REQUIRE(s(emit().mov(reg64::r11, mem{reg64::r13, reg64::r14, 2})) == "4F8B5C7500");
+  REQUIRE(s(emit().mov(reg64::rax, mem::rip(0x100))) == "488B0500010000");
+  REQUIRE(s(emit().mov(reg64::rax, mem::absolute(0x1000))) == "488B042500100000");
+  REQUIRE(s(emit().mov(reg32::edx, mem::indexed(reg64::rcx, 4, 0x10))) == "8B148D10000000");
+  REQUIRE(s(emit().mov(reg8::al, mem{reg64::rsi})) == "8A06");
+  REQUIRE(s(emit().mov(reg16::ax, mem{reg64::rsi})) == "668B06");
+  REQUIRE_THROWS_AS(mem(reg64::rax, reg64::rsp), std::invalid_argument);
+  REQUIRE_THROWS_AS(mem(reg64::rax, reg64::rbx, 3), std::invalid_argument);
+}
+
+TEST_CASE("mov_mem_reg") {
+  REQUIRE(s(emit().mov(mem{reg64::rdi, 8}, reg64::rax)) == "48894708");
+  REQUIRE(s(emit().mov(mem{reg64::rdi}, reg8::r10b)) == "448817");
+  REQUIRE(s(emit().mov(mem{reg64::rdi}, reg8::ah)) == "8827");
+}
+
+TEST_CASE("mov_mem_imm") {
+  REQUIRE(s(emit().mov(mem{reg64::rax}, imm8{0x12})) == "C60012");
+  REQUIRE(s(emit().mov(mem{reg64::rax}, imm16{0x1234})) == "66C7003412");
+  REQUIRE(s(emit().mov(mem{reg64::rax}, imm32{0x12345678})) == "C70078563412");
+  REQUIRE(s(emit().mov(mem{reg64::rax}, imm64{static_cast<std::uint64_t>(-1)})) == "48C700FFFFFFFF");
+  REQUIRE(s(emit().mov(mem::rip(0), imm32{1})) == "C7050000000001000000");
+  REQUIRE_THROWS_AS(emit().mov(mem{reg64::rax}, imm64{0x100000000}), std::out_of_range);
+}
+
+TEST_CASE("lea") {
+  REQUIRE(s(emit().lea(reg64::rax, mem{reg64::rdi, reg64::rsi, 1})) == "488D0437");
+  REQUIRE(s(emit().lea(reg32::eax, mem{reg64::rdi, 1})) == "8D4701");
+  REQUIRE(s(emit().lea(reg64::r8, mem::rip(-7))) == "4C8D05F9FFFFFF");
+}
+
+TEST_CASE("alu_reg_reg") {
+  REQUIRE(s(emit().add(reg64::rax, reg64::rcx)) == "4801C8");
+  REQUIRE(s(emit().or_(reg32::eax, reg32::ecx)) == "09C8");
+  REQUIRE(s(emit().adc(reg16::ax, reg16::cx)) == "6611C8");
+  REQUIRE(s(emit().sbb(reg8::al, reg8::cl)) == "18C8");
+  REQUIRE(s(emit().and_(reg64::r8, reg64::r9)) == "4D21C8");
+  REQUIRE(s(emit().sub(reg64::rsp, reg64::rax)) == "4829C4");
+  REQUIRE(s(emit().xor_(reg32::r10d, reg32::r10d)) == "4531D2");
+  REQUIRE(s(emit().cmp(reg64::rax, reg64::rdx)) == "4839D0");
+}
+
+TEST_CASE("alu_reg_mem") {
+  REQUIRE(s(emit().add(reg64::rax, mem{reg64::rdi})) == "480307");
+  REQUIRE(s(emit().add(mem{reg64::rdi}, reg64::rax)) == "480107");
+  REQUIRE(s(emit().sub(reg8::al, mem{reg64::rdi, 1})) == "2A4701");
+  REQUIRE(s(emit().cmp(mem{reg64::rsp, 16}, reg32::ecx)) == "394C2410");
+}
+
+TEST_CASE("alu_reg_imm") {
+  REQUIRE(s(emit().add(reg8::bl, imm8{0x12})) == "80C312");
+  REQUIRE(s(emit().and_(reg8::r8b, imm8{0x0F})) == "4180E00F");
+  REQUIRE(s(emit().sub(reg16::bx, imm16{0x1234})) == "6681EB3412");
+  REQUIRE(s(emit().xor_(reg32::ebx, imm32{0x12345678})) == "81F378563412");
+  REQUIRE(s(emit().cmp(reg64::r15, imm32{0x12345678})) == "4981FF78563412");
+}
+
+TEST_CASE("alu_reg_imm_compact") {
+  REQUIRE(s(emit().add(reg64::rcx, imm32{8})) == "4883C108");
+  REQUIRE(s(emit().xor_(reg64::r9, imm32{127})) == "4983F17F");
+  REQUIRE(s(emit().sub(reg32::ecx, imm32{0xFFFFFF80})) == "83E980");
+  REQUIRE(s(emit().or_(reg16::r9w, imm16{128})) == "664181C98000");
+  REQUIRE(s(emit().add(reg32::eax, imm32{1000})) == "05E8030000");
+  REQUIRE(s(emit().sub(reg64::rax, imm32{1000})) == "482DE8030000");
+  REQUIRE(s(emit().cmp(reg8::al, imm8{5})) == "3C05");
+  REQUIRE(s(emit().add(imm32{1})) == "83C001");
+  REQUIRE(s(emit().add(imm64{0xFFFFFFFFFFFFFFFF})) == "4883C0FF");
+  REQUIRE(s(emit().set_compact_immediates(false).add(reg64::rcx, imm32{8})) == "4881C108000000");
+  REQUIRE(s(emit().set_compact_immediates(false).add(imm32{1})) == "0501000000");
+}
+
+TEST_CASE("alu_mem_imm") {
+  REQUIRE(s(emit().add(mem{reg64::rax}, imm8{1})) == "800001");
+  REQUIRE(s(emit().or_(mem{reg64::rax}, imm16{1})) == "66830801");
+  REQUIRE(s(emit().cmp(mem{reg64::rax}, imm32{1})) == "833801");
+  REQUIRE(s(emit().sub(mem{reg64::rax}, imm64{1})) == "48832801");
+  REQUIRE(s(emit().and_(mem{reg64::rdi}, imm16{0xFFFF})) == "668327FF");
+  REQUIRE(s(emit().add(mem{reg64::rdi}, imm64{0xFFFFFFFFFFFFFFFE})) == "488307FE");
+  REQUIRE(s(emit().cmp(mem{reg64::rax}, imm32{128})) == "813880000000");
+  REQUIRE(s(emit().set_compact_immediates(false).cmp(mem{reg64::rax}, imm32{1})) == "813801000000");
+}
+
+TEST_CASE("mul") {
+  REQUIRE(s(emit().mul(reg8::cl)) == "F6E1");
+  REQUIRE(s(emit().mul(reg16::cx)) == "66F7E1");
+  REQUIRE(s(emit().mul(reg32::ecx)) == "F7E1");
+  REQUIRE(s(emit().mul(reg64::r11)) == "49F7E3");
+}
+
+TEST_CASE("test") {
+  REQUIRE(s(emit().test(imm8{0x12})) == "A812");
+  REQUIRE(s(emit().test(imm32{1})) == "A901000000");
+  REQUIRE(s(emit().test(reg64::rax, reg64::rcx)) == "4885C8");
+  REQUIRE(s(emit().test(reg8::cl, reg8::al)) == "84C1");
+  REQUIRE(s(emit().test(reg32::r9d, reg32::r10d)) == "4585D1");
+  REQUIRE(s(emit().test(mem{reg64::rdi}, reg64::rax)) == "488507");
+  REQUIRE(s(emit().test(reg8::bl, mem{reg64::rsp, 8})) == "845C2408");
+  REQUIRE(s(emit().test(reg16::bx, imm16{0x1234})) == "66F7C33412");
+  REQUIRE(s(emit().test(reg32::ebx, imm32{0x12345678})) == "F7C378563412");
+  REQUIRE(s(emit().test(reg64::r15, imm32{0x12345678})) == "49F7C778563412");
+  REQUIRE(s(emit().test(mem{reg64::rax}, imm8{1})) == "F60001");
+  REQUIRE(s(emit().test(mem{reg64::rax}, imm16{1})) == "66F7000100");
+  REQUIRE(s(emit().test(mem{reg64::rax}, imm32{1})) == "F70001000000");
+  REQUIRE(s(emit().test(mem{reg64::rax}, imm64{static_cast<std::uint64_t>(-1)})) == "48F700FFFFFFFF");
+}
+
+TEST_CASE("setcc") {
+  REQUIRE(s(emit().setcc(cc::e, reg8::al)) == "0F94C0");
+  REQUIRE(s(emit().setcc(cc::ne, reg8::sil)) == "400F95C6");
+  REQUIRE(s(emit().setcc(cc::l, reg8::r8b)) == "410F9CC0");
+  REQUIRE(s(emit().setcc(cc::a, reg8::bl)) == "0F97C3");
+  REQUIRE(s(emit().setcc(cc::g, mem{reg64::rdi})) == "0F9F07");
+  for (auto i = 0; i < 16; i++) {
+    emit().setcc(static_cast<x86_cc>(i), reg8::al);
+    REQUIRE(_buffer.size() == 3);
+    REQUIRE(_buffer.data()[1] == 0x90 + i);
+  }
+}
+
+TEST_CASE("cmovcc") {
+  REQUIRE(s(emit().cmovcc(cc::e, reg32::eax, reg32::ecx)) == "0F44C1");
+  REQUIRE(s(emit().cmovcc(cc::l, reg64::r8, reg64::r9)) == "4D0F4CC1");
+  REQUIRE(s(emit().cmovcc(cc::b, reg16::ax, reg16::dx)) == "660F42C2");
+  REQUIRE(s(emit().cmovcc(cc::ge, reg64::rax, mem{reg64::rdi, 8})) == "480F4D4708");
+}
+
+TEST_CASE("movzx") {
+  REQUIRE(s(emit().movzx(reg32::eax, reg8::al)) == "0FB6C0");
+  REQUIRE(s(emit().movzx(reg32::eax, reg8::sil)) == "400FB6C6");
+  REQUIRE(s(emit().movzx(reg64::rcx, reg16::r9w)) == "490FB7C9");
+  REQUIRE(s(emit().movzx(reg32::r8d, reg8::bl)) == "440FB6C3");
+  REQUIRE(s(emit().movzx(reg32::edi, reg8::dil)) == "400FB6FF");
+}
+
+TEST_CASE("bit_counting") {
+  REQUIRE(s(emit().popcnt(reg64::rax, reg64::rcx)) == "F3480FB8C1");
+  REQUIRE(s(emit().popcnt(reg16::ax, reg16::cx)) == "66F30FB8C1");
+  REQUIRE(s(emit().popcnt(reg32::r8d, mem{reg64::rdi})) == "F3440FB807");
+  REQUIRE(s(emit().lzcnt(reg64::rax, reg64::rcx)) == "F3480FBDC1");
+  REQUIRE(s(emit().tzcnt(reg64::r9, reg64::r10)) == "F34D0FBCCA");
+  REQUIRE(s(emit().bsf(reg32::eax, reg32::ecx)) == "0FBCC1");
+  REQUIRE(s(emit().bsr(reg64::rax, reg64::rdi)) == "480FBDC7");
+}
+
+TEST_CASE("bit_manipulation") {
+  REQUIRE(s(emit().andn(reg64::rax, reg64::rbx, reg64::rcx)) == "C4E2E0F2C1");
+  REQUIRE(s(emit().andn(reg32::r8d, reg32::r9d, mem{reg64::rdi})) == "C46230F207");
+  REQUIRE(s(emit().bextr(reg64::rax, reg64::rcx, reg64::rdx)) == "C4E2E8F7C1");
+  REQUIRE(s(emit().blsr(reg64::rax, reg64::rcx)) == "C4E2F8F3C9");
+  REQUIRE(s(emit().blsi(reg32::r9d, reg32::r10d)) == "C4C230F3DA");
+  REQUIRE(s(emit().blsmsk(reg64::rax, mem{reg64::rdi})) == "C4E2F8F317");
+  REQUIRE(s(emit().bzhi(reg64::rax, reg64::rcx, reg64::rdx)) == "C4E2E8F5C1");
+  REQUIRE(s(emit().shlx(reg64::rax, reg64::rcx, reg64::rdx)) == "C4E2E9F7C1");
+  REQUIRE(s(emit().sarx(reg32::eax, reg32::ecx, reg32::edx)) == "C4E26AF7C1");
+  REQUIRE(s(emit().shrx(reg64::r8, reg64::r9, reg64::r10)) == "C442ABF7C1");
+  REQUIRE(s(emit().pdep(reg64::rax, reg64::rbx, reg64::rcx)) == "C4E2E3F5C1");
+  REQUIRE(s(emit().pext(reg32::eax, reg32::ebx, reg32::ecx)) == "C4E262F5C1");
+  REQUIRE(s(emit().mulx(reg64::rdx, reg64::rax, reg64::rcx)) == "C4E2FBF6D1");
+  REQUIRE(s(emit().mulx(reg64::r8, reg64::r9, mem{reg64::rdi})) == "C462B3F607");
+  REQUIRE(s(emit().rorx(reg64::rax, reg64::rcx, imm8{13})) == "C4E3FBF0C10D");
+}
+
+TEST_CASE("atomics") {
+  REQUIRE(s(emit().lock().cmpxchg(mem{reg64::rdi}, reg64::rcx)) == "F0480FB10F");
+  REQUIRE(s(emit().cmpxchg(mem{reg64::r8}, reg32::r9d)) == "450FB108");
+  REQUIRE(s(emit().cmpxchg(mem{reg64::rdi}, reg8::sil)) == "400FB037");
+  REQUIRE(s(emit().cmpxchg(mem{reg64::rdi}, reg16::cx)) == "660FB10F");
+  REQUIRE(s(emit().cmpxchg(reg32::ecx, reg32::edx)) == "0FB1D1");
+  REQUIRE(s(emit().lock().cmpxchg16b(mem{reg64::rdi})) == "F0480FC70F");
+  REQUIRE(s(emit().cmpxchg8b(mem{reg64::r9})) == "410FC709");
+  REQUIRE(s(emit().lock().xadd(mem{reg64::rdi}, reg64::rax)) == "F0480FC107");
+  REQUIRE(s(emit().xadd(mem{reg64::rdi, 8}, reg32::r10d)) == "440FC15708");
+  REQUIRE(s(emit().xadd(mem{reg64::rdi}, reg8::al)) == "0FC007");
+  REQUIRE(s(emit().lock().add(mem{reg64::rdi}, imm32{1})) == "F0830701");
+  REQUIRE(s(emit().lock().sub(mem{reg64::rdi, 8}, reg16::ax)) == "F066294708");
+  REQUIRE_THROWS_AS(emit().lock().add(reg64::rax, reg64::rcx), std::logic_error);
+  REQUIRE(s(emit().xchg(mem{reg64::rdi}, reg64::rax)) == "488707");
+  REQUIRE(s(emit().xchg(reg32::r8d, mem{reg64::rsi})) == "448706");
+  REQUIRE(s(emit().xchg(mem{reg64::rdi}, reg8::bl)) == "861F");
+  REQUIRE(s(emit().xchg(reg64::rdx, reg64::rcx)) == "4887CA");
+  REQUIRE(s(emit().mfence()) == "0FAEF0");
+  REQUIRE(s(emit().lfence()) == "0FAEE8");
+  REQUIRE(s(emit().sfence()) == "0FAEF8");
+}
+
+TEST_CASE("avx_integer") {
+  REQUIRE(s(emit().vpaddd(xmm::xmm0, xmm::xmm1, xmm::xmm2)) == "C5F1FEC2");
+  REQUIRE(s(emit().vpaddb(ymm::ymm8, ymm::ymm9, ymm::ymm10)) == "C44135FCC2");
+  REQUIRE(s(emit().vpaddq(ymm::ymm0, ymm::ymm1, mem{reg64::rdi, 32})) == "C5F5D44720");
+  REQUIRE(s(emit().vpsubw(xmm::xmm3, xmm::xmm4, xmm::xmm15)) == "C4C159F9DF");
+  REQUIRE(s(emit().vpmulld(ymm::ymm0, ymm::ymm1, ymm::ymm2)) == "C4E27540C2");
+  REQUIRE(s(emit().vpmaxud(xmm::xmm0, xmm::xmm1, mem{reg64::r8})) == "C4C2713F00");
+  REQUIRE(s(emit().vpsadbw(ymm::ymm1, ymm::ymm2, ymm::ymm3)) == "C5EDF6CB");
+  REQUIRE(s(emit().vpabsd(ymm::ymm1, ymm::ymm2)) == "C4E27D1ECA");
+  REQUIRE(s(emit().vpxor(ymm::ymm0, ymm::ymm0, ymm::ymm0)) == "C5FDEFC0");
+  REQUIRE(s(emit().vpandn(xmm::xmm1, xmm::xmm2, mem{reg64::rax, reg64::rcx, 8})) == "C5E9DF0CC8");
+  REQUIRE(s(emit().vpslld(ymm::ymm1, ymm::ymm2, imm8{3})) == "C5F572F203");
+  REQUIRE(s(emit().vpsrlq(xmm::xmm9, xmm::xmm10, imm8{63})) == "C4C13173D23F");
+  REQUIRE(s(emit().vpsrad(ymm::ymm0, ymm::ymm1, imm8{31})) == "C5FD72E11F");
+  REQUIRE(s(emit().vpsrldq(xmm::xmm0, xmm::xmm1, imm8{4})) == "C5F973D904");
+}
+
+TEST_CASE("avx_floating_point") {
+  REQUIRE(s(emit().vaddps(ymm::ymm0, ymm::ymm1, ymm::ymm2)) == "C5F458C2");
+  REQUIRE(s(emit().vaddpd(xmm::xmm0, xmm::xmm1, xmm::xmm2)) == "C5F158C2");
+  REQUIRE(s(emit().vmulpd(ymm::ymm11, ymm::ymm12, mem{reg64::rsp, 64})) == "C51D595C2440");
+  REQUIRE(s(emit().vdivps(xmm::xmm0, xmm::xmm1, xmm::xmm2)) == "C5F05EC2");
+  REQUIRE(s(emit().vsqrtpd(ymm::ymm0, ymm::ymm1)) == "C5FD51C1");
+  REQUIRE(s(emit().vhaddps(xmm::xmm0, xmm::xmm1, xmm::xmm2)) == "C5F37CC2");
+  REQUIRE(s(emit().vxorps(xmm::xmm0, xmm::xmm0, xmm::xmm0)) == "C5F857C0");
+  REQUIRE(s(emit().vfmadd231ps(ymm::ymm0, ymm::ymm1, ymm::ymm2)) == "C4E275B8C2");
+  REQUIRE(s(emit().vfmadd231pd(xmm::xmm0, xmm::xmm1, mem{reg64::rdi})) == "C4E2F1B807");
+  REQUIRE(s(emit().vcvtdq2ps(ymm::ymm0, ymm::ymm1)) == "C5FC5BC1");
+  REQUIRE(s(emit().vcvttps2dq(xmm::xmm0, xmm::xmm1)) == "C5FA5BC1");
+}
+
+TEST_CASE("avx_compare") {
+  REQUIRE(s(emit().vpcmpeqb(ymm::ymm0, ymm::ymm1, mem{reg64::rsi})) == "C5F57406");
+  REQUIRE(s(emit().vpcmpeqq(xmm::xmm0, xmm::xmm1, xmm::xmm2)) == "C4E27129C2");
+  REQUIRE(s(emit().vpcmpgtd(ymm::ymm0, ymm::ymm1, ymm::ymm2)) == "C5F566C2");
+  REQUIRE(s(emit().vpcmpgtq(ymm::ymm0, ymm::ymm1, ymm::ymm2)) == "C4E27537C2");
+  REQUIRE(s(emit().vcmpps(ymm::ymm0, ymm::ymm1, ymm::ymm2, imm8{1})) == "C5F4C2C201");
+  REQUIRE(s(emit().vcmppd(xmm::xmm0, xmm::xmm1, xmm::xmm2, imm8{4})) == "C5F1C2C204");
+  REQUIRE(s(emit().vptest(ymm::ymm0, ymm::ymm0)) == "C4E27D17C0");
+  REQUIRE(s(emit().vpcmpistri(xmm::xmm0, mem{reg64::rdi}, imm8{0x0C})) == "C4E37963070C");
+  REQUIRE(s(emit().vpmovmskb(reg32::eax, ymm::ymm0)) == "C5FDD7C0");
+  REQUIRE(s(emit().vmovmskps(reg32::r8d, xmm::xmm1)) == "C57850C1");
+}
+
+TEST_CASE("avx_shuffle") {
+  REQUIRE(s(emit().vpshufb(ymm::ymm0, ymm::ymm1, ymm::ymm2)) == "C4E27500C2");
+  REQUIRE(s(emit().vpshufd(xmm::xmm0, xmm::xmm1, imm8{0x1B})) == "C5F970C11B");
+  REQUIRE(s(emit().vshufps(ymm::ymm0, ymm::ymm1, ymm::ymm2, imm8{0x44})) == "C5F4C6C244");
+  REQUIRE(s(emit().vpalignr(xmm::xmm0, xmm::xmm1, xmm::xmm2, imm8{8})) == "C4E3710FC208");
+  REQUIRE(s(emit().vpunpcklqdq(xmm::xmm0, xmm::xmm1, xmm::xmm2)) == "C5F16CC2");
+  REQUIRE(s(emit().vpackuswb(ymm::ymm0, ymm::ymm1, ymm::ymm2)) == "C5F567C2");
+  REQUIRE(s(emit().vpermd(ymm::ymm0, ymm::ymm1, ymm::ymm2)) == "C4E27536C2");
+  REQUIRE(s(emit().vpermq(ymm::ymm0, ymm::ymm1, imm8{0xD8})) == "C4E3FD00C1D8");
+  REQUIRE(s(emit().vperm2i128(ymm::ymm0, ymm::ymm1, ymm::ymm2, imm8{0x21})) == "C4E37546C221");
+  REQUIRE(s(emit().vextracti128(xmm::xmm1, ymm::ymm2, imm8{1})) == "C4E37D39D101");
+  REQUIRE(s(emit().vextracti128(mem{reg64::rdi}, ymm::ymm2, imm8{1})) == "C4E37D391701");
+  REQUIRE(s(emit().vinserti128(ymm::ymm0, ymm::ymm1, xmm::xmm2, imm8{1})) == "C4E37538C201");
+}
+
+TEST_CASE("avx_blend") {
+  REQUIRE(s(emit().vblendps(ymm::ymm0, ymm::ymm1, ymm::ymm2, imm8{0x0F})) == "C4E3750CC20F");
+  REQUIRE(s(emit().vpblendd(xmm::xmm0, xmm::xmm1, xmm::xmm2, imm8{5})) == "C4E37102C205");
+  REQUIRE(s(emit().vpblendvb(ymm::ymm0, ymm::ymm1, ymm::ymm2, ymm::ymm3)) == "C4E3754CC230");
+  REQUIRE(s(emit().vblendvps(xmm::xmm0, xmm::xmm1, mem{reg64::rax}, xmm::xmm12)) == "C4E3714A00C0");
+}
+
+TEST_CASE("avx_move") {
+  REQUIRE(s(emit().vmovdqu(ymm::ymm0, mem{reg64::rdi})) == "C5FE6F07");
+  REQUIRE(s(emit().vmovdqu(mem{reg64::rdi, 32}, ymm::ymm0)) == "C5FE7F4720");
+  REQUIRE(s(emit().vmovdqa(xmm::xmm8, xmm::xmm9)) == "C441796FC1");
+  REQUIRE(s(emit().vmovdqa(mem{reg64::r12}, xmm::xmm1)) == "C4C1797F0C24");
+  REQUIRE(s(emit().vmovups(ymm::ymm0, mem{reg64::rax, reg64::r9, 4, 16})) == "C4A17C10448810");
+  REQUIRE(s(emit().vmovaps(mem::rip(0), xmm::xmm1)) == "C5F8290D00000000");
+  REQUIRE(s(emit().vmovntdq(mem{reg64::rdi}, ymm::ymm1)) == "C5FDE70F");
+  REQUIRE(s(emit().vmovd(xmm::xmm0, reg32::eax)) == "C5F96EC0");
+  REQUIRE(s(emit().vmovd(reg32::r9d, xmm::xmm1)) == "C4C1797EC9");
+  REQUIRE(s(emit().vmovd(xmm::xmm0, mem{reg64::rdi})) == "C5F96E07");
+  REQUIRE(s(emit().vmovq(xmm::xmm0, reg64::rax)) == "C4E1F96EC0");
+  REQUIRE(s(emit().vmovq(reg64::rax, xmm::xmm1)) == "C4E1F97EC8");
+  REQUIRE(s(emit().vpbroadcastd(ymm::ymm0, xmm::xmm1)) == "C4E27D58C1");
+  REQUIRE(s(emit().vpbroadcastb(xmm::xmm0, mem{reg64::rdi})) == "C4E2797807");
+  REQUIRE(s(emit().vbroadcastss(ymm::ymm0, mem{reg64::rdi})) == "C4E27D1807");
+  REQUIRE(s(emit().vpmaskmovd(ymm::ymm0, ymm::ymm1, mem{reg64::rdi})) == "C4E2758C07");
+  REQUIRE(s(emit().vpmaskmovd(mem{reg64::rdi}, ymm::ymm1, ymm::ymm2)) == "C4E2758E17");
+  REQUIRE(s(emit().vzeroupper()) == "C5F877");
+}
+
+TEST_CASE("avx512_registers") {
+  REQUIRE(s(emit().vpaddd(zmm::zmm0, zmm::zmm1, zmm::zmm2)) == "62F17548FEC2");
+  REQUIRE(s(emit().vpaddd(zmm::zmm16, zmm::zmm17, zmm::zmm31)) == "62817540FEC7");
+  REQUIRE(s(emit().vpaddq(ymm::ymm24, ymm::ymm1, ymm::ymm9)) == "6241F528D4C1");
+  REQUIRE(s(emit().vaddps(xmm::xmm20, xmm::xmm21, xmm::xmm22)) == "62A1540058E6");
+  REQUIRE(s(emit().vpsrld(zmm::zmm17, zmm::zmm1, imm8{3})) == "62F1754072D103");
+  REQUIRE(s(emit().vmovd(xmm::xmm16, reg32::eax)) == "62E17D086EC0");
+  REQUIRE(s(emit().vpbroadcastd(zmm::zmm0, xmm::xmm1)) == "62F27D4858C1");
+  REQUIRE(s(emit().vpermq(zmm::zmm0, zmm::zmm1, imm8{0x4E})) == "62F3FD4800C14E");
+  REQUIRE_THROWS_AS(emit().vpand(xmm::xmm16, xmm::xmm1, xmm::xmm2), std::invalid_argument);
+  REQUIRE_THROWS_AS(emit().vpmovmskb(reg32::eax, zmm::zmm0), std::invalid_argument);
+}
+
+TEST_CASE("avx512_masking") {
+  REQUIRE(s(emit().vpaddd(zmm::zmm0, zmm::zmm1, zmm::zmm2, mask::merge(kreg::k1))) == "62F17549FEC2");
+  REQUIRE(s(emit().vpaddd(zmm::zmm0, zmm::zmm1, zmm::zmm2, mask::zero(kreg::k7))) == "62F175CFFEC2");
+  REQUIRE(s(emit().vpaddd(xmm::xmm0, xmm::xmm1, xmm::xmm2, mask::zero(kreg::k1))) == "62F17589FEC2");
+  REQUIRE(s(emit().vmovdqu32(zmm::zmm0, mem{reg64::rdi}, mask::zero(kreg::k1))) == "62F17EC96F07");
+  REQUIRE(s(emit().vmovdqu32(mem{reg64::rdi}, zmm::zmm0, mask::merge(kreg::k2))) == "62F17E4A7F07");
+  REQUIRE(s(emit().vmovdqu8(ymm::ymm1, ymm::ymm2, mask::merge(kreg::k3))) == "62F17F2B6FCA");
+  REQUIRE(s(emit().vmovdqa64(zmm::zmm0, mem{reg64::rsi})) == "62F1FD486F06");
+  REQUIRE(s(emit().vmovdqu16(zmm::zmm1, mem{reg64::rsi})) == "62F1FF486F0E");
+  REQUIRE(s(emit().vmovups(zmm::zmm0, mem{reg64::rdi}, mask::zero(kreg::k1))) == "62F17CC91007");
+  REQUIRE(s(emit().vpcompressd(mem{reg64::rdi}, zmm::zmm0, mask::merge(kreg::k1))) == "62F27D498B07");
+  REQUIRE(s(emit().vpexpandd(zmm::zmm0, mem{reg64::rdi}, mask::zero(kreg::k1))) == "62F27DC98907");
+  REQUIRE(s(emit().vpblendmd(zmm::zmm0, zmm::zmm1, zmm::zmm2, mask::merge(kreg::k1))) == "62F2754964C2");
+  REQUIRE_THROWS_AS(mask::zero(kreg::k0), std::invalid_argument);
+  REQUIRE_THROWS_AS(emit().vmovdqu32(mem{reg64::rdi}, zmm::zmm0, mask::zero(kreg::k1)), std::invalid_argument);
+}
+
+TEST_CASE("avx512_broadcast") {
+  REQUIRE(s(emit().vpaddd(zmm::zmm0, zmm::zmm1, bcst{mem{reg64::rdi}})) == "62F17558FE07");
+  REQUIRE(s(emit().vpaddq(zmm::zmm0, zmm::zmm1, bcst{mem{reg64::rdi, 8}})) == "62F1F558D44701");
+  REQUIRE(s(emit().vaddps(ymm::ymm0, ymm::ymm1, bcst{mem{reg64::rax, 4}})) == "62F17438584001");
+  REQUIRE(s(emit().vpternlogd(zmm::zmm0, zmm::zmm1, bcst{mem{reg64::rdi}}, imm8{0x96})) == "62F37558250796");
+  REQUIRE_THROWS_AS(emit().vpaddb(zmm::zmm0, zmm::zmm1, bcst{mem{reg64::rdi}}), std::invalid_argument);
+}
+
+TEST_CASE("avx512_disp8") {
+  REQUIRE(s(emit().vmovdqu32(zmm::zmm0, mem{reg64::rdi, 64})) == "62F17E486F4701");
+  REQUIRE(s(emit().vmovdqu32(zmm::zmm0, mem{reg64::rdi, -8192})) == "62F17E486F4780");
+  REQUIRE(s(emit().vmovdqu32(zmm::zmm0, mem{reg64::rdi, 8128})) == "62F17E486F477F");
+  REQUIRE(s(emit().vmovdqu32(zmm::zmm0, mem{reg64::rdi, 8192})) == "62F17E486F8700200000");
+  REQUIRE(s(emit().vmovdqu32(zmm::zmm0, mem{reg64::rdi, 32})) == "62F17E486F8720000000");
+  REQUIRE(s(emit().vpaddd(ymm::ymm16, ymm::ymm1, mem{reg64::rdi, reg64::r9, 4, 96})) == "62A17528FE448F03");
+  REQUIRE(s(emit().vpaddd(zmm::zmm0, zmm::zmm1, bcst{mem{reg64::rdi, 20}})) == "62F17558FE4705");
+  REQUIRE(s(emit().vpbroadcastq(zmm::zmm0, mem{reg64::rdi, 16})) == "62F2FD48594702");
+  REQUIRE(s(emit().vinserti32x4(zmm::zmm0, zmm::zmm1, mem{reg64::rdi, 32}, imm8{1})) == "62F3754838470201");
+  REQUIRE(s(emit().vextracti64x4(mem{reg64::rdi, 64}, zmm::zmm1, imm8{1})) == "62F3FD483B4F0201");
+  REQUIRE(s(emit().vpmovdb(mem{reg64::rdi, 16}, zmm::zmm1)) == "62F27E48314F01");
+}
+
+TEST_CASE("avx512_compare") {
+  REQUIRE(s(emit().vpcmpd(kreg::k1, zmm::zmm0, zmm::zmm1, imm8{1})) == "62F37D481FC901");
+  REQUIRE(s(emit().vpcmpuq(kreg::k2, ymm::ymm0, mem{reg64::rdi}, imm8{2}, mask::merge(kreg::k3))) == "62F3FD2B1E1702");
+  REQUIRE(s(emit().vpcmpeqb(kreg::k1, zmm::zmm0, zmm::zmm1)) == "62F17D4874C9");
+  REQUIRE(s(emit().vpcmpeqd(kreg::k1, xmm::xmm0, xmm::xmm1)) == "62F17D0876C9");
+  REQUIRE(s(emit().vpcmpgtq(kreg::k1, zmm::zmm0, zmm::zmm1)) == "62F2FD4837C9");
+  REQUIRE(s(emit().vcmpps(kreg::k1, zmm::zmm0, zmm::zmm1, imm8{1})) == "62F17C48C2C901");
+  REQUIRE(s(emit().vptestmd(kreg::k1, zmm::zmm0, zmm::zmm0)) == "62F27D4827C8");
+  REQUIRE(s(emit().vptestnmd(kreg::k1, zmm::zmm0, zmm::zmm0)) == "62F27E4827C8");
+  REQUIRE(s(emit().vpmovb2m(kreg::k1, zmm::zmm0)) == "62F27E4829C8");
+  REQUIRE(s(emit().vpmovm2d(zmm::zmm0, kreg::k1)) == "62F27E4838C1");
+}
+
+TEST_CASE("avx512_operations") {
+  REQUIRE(s(emit().vpandd(zmm::zmm0, zmm::zmm1, zmm::zmm2)) == "62F17548DBC2");
+  REQUIRE(s(emit().vpxorq(zmm::zmm0, zmm::zmm1, zmm::zmm2)) == "62F1F548EFC2");
+  REQUIRE(s(emit().vpternlogq(zmm::zmm0, zmm::zmm1, zmm::zmm2, imm8{0xE8})) == "62F3F54825C2E8");
+  REQUIRE(s(emit().vpmullq(zmm::zmm0, zmm::zmm1, zmm::zmm2)) == "62F2F54840C2");
+  REQUIRE(s(emit().vpminuq(zmm::zmm0, zmm::zmm1, zmm::zmm2)) == "62F2F5483BC2");
+  REQUIRE(s(emit().vpabsq(zmm::zmm0, zmm::zmm1)) == "62F2FD481FC1");
+  REQUIRE(s(emit().vpermt2d(zmm::zmm0, zmm::zmm1, zmm::zmm2)) == "62F275487EC2");
+  REQUIRE(s(emit().valignd(zmm::zmm0, zmm::zmm1, zmm::zmm2, imm8{1})) == "62F3754803C201");
+  REQUIRE(s(emit().vshufi32x4(zmm::zmm0, zmm::zmm1, zmm::zmm2, imm8{0x4E})) == "62F3754843C24E");
+  REQUIRE(s(emit().vpmovqd(ymm::ymm0, zmm::zmm1)) == "62F27E4835C8");
+  REQUIRE(s(emit().vpshufb(zmm::zmm0, zmm::zmm1, zmm::zmm2)) == "62F2754800C2");
+  REQUIRE(s(emit().vfmadd231pd(zmm::zmm0, zmm::zmm1, zmm::zmm2)) == "62F2F548B8C2");
+  REQUIRE(s(emit().vmovq(reg64::rax, xmm::xmm17)) == "62E1FD087EC8");
+}
+
+TEST_CASE("avx512_opmask") {
+  REQUIRE(s(emit().kmovw(kreg::k1, reg32::eax)) == "C5F892C8");
+  REQUIRE(s(emit().kmovw(reg32::eax, kreg::k1)) == "C5F893C1");
+  REQUIRE(s(emit().kmovw(kreg::k1, kreg::k2)) == "C5F890CA");
+  REQUIRE(s(emit().kmovw(kreg::k1, mem{reg64::rdi})) == "C5F8900F");
+  REQUIRE(s(emit().kmovw(mem{reg64::rdi}, kreg::k1)) == "C5F8910F");
+  REQUIRE(s(emit().kmovb(kreg::k1, reg32::eax)) == "C5F992C8");
+  REQUIRE(s(emit().kmovd(kreg::k1, reg32::eax)) == "C5FB92C8");
+  REQUIRE(s(emit().kmovd(kreg::k1, kreg::k2)) == "C4E1F990CA");
+  REQUIRE(s(emit().kmovq(kreg::k1, reg64::rax)) == "C4E1FB92C8");
+  REQUIRE(s(emit().kmovq(reg64::r9, kreg::k7)) == "C461FB93CF");
+  REQUIRE(s(emit().kmovq(kreg::k1, kreg::k2)) == "C4E1F890CA");
+  REQUIRE(s(emit().kandw(kreg::k1, kreg::k2, kreg::k3)) == "C5EC41CB");
+  REQUIRE(s(emit().korq(kreg::k1, kreg::k2, kreg::k3)) == "C4E1EC45CB");
+  REQUIRE(s(emit().knotw(kreg::k1, kreg::k2)) == "C5F844CA");
+  REQUIRE(s(emit().kortestw(kreg::k1, kreg::k1)) == "C5F898C9");
+  REQUIRE(s(emit().kortestq(kreg::k1, kreg::k2)) == "C4E1F898CA");
+}
+
+TEST_CASE("static_buffer") {
+  static_buffer<16> buffer;
+  x86_emitter<decltype(buffer)>(buffer).mov(reg32::eax, imm32{42}).ret();
+  REQUIRE(buffer.size() == 6);
+  REQUIRE(buffer.data()[0] == 0xB8);
+  REQUIRE(buffer.data()[5] == 0xC3);
+  REQUIRE_THROWS_AS(x86_emitter<decltype(buffer)>(buffer).mov(reg64::rax, imm64{0x123456789}).mov(reg64::rax, imm64{0x123456789}),
+    std::length_error);
+}
+
+TEST_CASE("counting_buffer") {
+  counting_buffer buffer;
+  x86_emitter<decltype(buffer)>(buffer).mov(reg64::rcx, imm64{42}).add(imm32{1}).ret();
+  REQUIRE(buffer.size() == s(emit().mov(reg64::rcx, imm64{42}).add(imm32{1}).ret()).size() / 2);
+}
+
+TEST_CASE("counting_buffer_relax") {
+  counting_buffer buffer;
+  x86_emitter<decltype(buffer)> emitter(buffer);
+  const auto head = emitter.new_label();
+  const auto done = emitter.new_label();
+  emitter.jmp(done).align(16).bind(head).nop().jcc(cc::ne, head).bind(done).ret();
+  emitter.relax();
+  REQUIRE(buffer.size() == 20);
+  REQUIRE(emitter.offset(done) == 19);
+}
+
+TEST_CASE("far_jump") {
+  REQUIRE(s(emit().far_jump(reinterpret_cast<const void*>(0x123456789ABCDEF0))) ==
+    "FF2500000000F0DEBC9A78563412");
+}
+
+TEST_CASE("segmented_buffer") {
+  segmented_buffer<x86_emitter> buffer(executable_mapping::page_size());
+  const std::uint8_t* const entry = buffer.code();
+  x86_emitter<decltype(buffer)> emitter(buffer);
+  std::uint32_t i = 0;
+  while (buffer.segment_count() < 3) {
+    emitter.mov(reg32::eax, imm32{++i});
+  }
+  emitter.ret();
+  REQUIRE(buffer.code() == entry);
+  REQUIRE(*buffer.address(buffer.size() - 1) == 0xC3);
+#if defined(__x86_64__)
+  REQUIRE(buffer.execute<std::uint32_t>() == i);
+#endif
+}
+
+TEST_CASE("segmented_buffer_lock") {
+  segmented_buffer<x86_emitter> buffer(executable_mapping::page_size());
+  x86_emitter<decltype(buffer)> emitter(buffer);
+  while (buffer.capacity() - buffer.size() > 1) {
+    emitter.nop();
+  }
+  emitter.lock().xadd(mem{reg64::rdi}, reg64::rax);
+  REQUIRE(buffer.segment_count() == 2);
+  REQUIRE(*buffer.address(buffer.size() - 5) == 0xF0);
+  REQUIRE(*buffer.address(buffer.size() - 4) == 0x48);
+}
+
+TEST_CASE("segmented_buffer_branch") {
+  segmented_buffer<x86_emitter> buffer(executable_mapping::page_size());
+  x86_emitter<decltype(buffer)> emitter(buffer);
+  const auto done = emitter.new_label();
+  const auto loop = emitter.new_label();
+  emitter.mov(reg32::eax, imm32{1}).jmp(done);
+  while (buffer.segment_count() < 2) {
+    emitter.mov(reg32::eax, imm32{2});
+  }
+  /* Count ECX down to zero across the next segment link: */
+  emitter.bind(loop).sub(reg32::ecx, imm32{1}).mov(reg32::eax, imm32{3});
+  while (buffer.segment_count() < 3) {
+    emitter.nop();
+  }
+  emitter.jcc(cc::ne, loop).add(reg32::eax, imm32{4}).ret();
+  emitter.bind(done).mov(reg32::ecx, imm32{3}).jmp(loop);
+  REQUIRE(buffer.segment_count() == 3);
+#if defined(__x86_64__)
+  REQUIRE(buffer.execute<std::uint32_t>() == 7);
+#endif
+}
+
+TEST_CASE("segmented_buffer_rip") {
+  segmented_buffer<x86_emitter> buffer(executable_mapping::page_size());
+  x86_emitter<decltype(buffer)> emitter(buffer);
+  const auto start = emitter.new_label();
+  emitter.jmp(start);
+  buffer.append({0x2A, 0, 0, 0});
+  emitter.bind(start);
+  while (buffer.segment_count() < 2) {
+    emitter.nop();
+  }
+  const std::size_t end = buffer.size() + 6;
+  emitter.mov(reg32::eax, mem::rip(5 - static_cast<std::int32_t>(end))).ret();
+  REQUIRE_THROWS_AS(emitter.mov(reg32::eax, mem::rip(1)), std::out_of_range);
+#if defined(__x86_64__)
+  REQUIRE(buffer.execute<std::uint32_t>() == 42);
+#endif
+}
+
+TEST_CASE("jmp_backward") {
+  auto emitter = emit();
+  const auto loop = emitter.new_label();
+  emitter.bind(loop).nop().jmp(loop);
+  REQUIRE(s(emitter) == "90EBFD");
+}
+
+TEST_CASE("jmp_forward") {
+  auto emitter = emit();
+  const auto done = emitter.new_label();
+  emitter.jmp(done).nop().bind(done).ret();
+  REQUIRE(s(emitter) == "E90100000090C3");
+  emitter.relax();
+  REQUIRE(s(emitter) == "EB0190C3");
+  REQUIRE(emitter.offset(done) == 3);
+}
+
+TEST_CASE("jcc_call") {
+  auto emitter = emit();
+  const auto target = emitter.new_label();
+  emitter.jcc(cc::ne, target).call(target).bind(target).ret();
+  REQUIRE(s(emitter) == "0F8505000000E800000000C3");
+  emitter.relax();
+  REQUIRE(s(emitter) == "7505E800000000C3");
+  REQUIRE(s(emit().jmp(reg64::rax)) == "FFE0");
+  REQUIRE(s(emit().jmp(reg64::r11)) == "41FFE3");
+  REQUIRE(s(emit().call(mem{reg64::rax, 8})) == "FF5008");
+  REQUIRE(s(emit().jmp(mem::rip(0))) == "FF2500000000");
+}
+
+TEST_CASE("jmp_backward_far") {
+  auto emitter = emit();
+  const auto loop = emitter.new_label();
+  emitter.bind(loop);
+  for (auto i = 0; i < 200; i++) {
+    emitter.nop();
+  }
+  emitter.jcc(cc::l, loop);
+  REQUIRE(s(emitter).substr(400) == "0F8C32FFFFFF");
+}
+
+TEST_CASE("relax_chain") {
+  auto emitter = emit();
+  const auto first = emitter.new_label();
+  const auto second = emitter.new_label();
+  emitter.jmp(first);
+  for (auto i = 0; i < 124; i++) {
+    emitter.nop();
+  }
+  emitter.jmp(second).bind(first).nop().bind(second).ret();
+  REQUIRE(emitter.offset() == 5 + 124 + 5 + 2);
+  emitter.relax();
+  /* The first jump only fits once the second has been shortened: */
+  REQUIRE(emitter.offset() == 2 + 124 + 2 + 2);
+  const std::string code = s(emitter);
+  REQUIRE(code.substr(0, 4) == "EB7E");
+  REQUIRE(code.substr(4 + 124 * 2) == "EB0190C3");
+  REQUIRE(emitter.offset(first) == 128);
+}
+
+TEST_CASE("nop_sizes") {
+  REQUIRE(s(emit().nop(1)) == "90");
+  REQUIRE(s(emit().nop(2)) == "6690");
+  REQUIRE(s(emit().nop(3)) == "0F1F00");
+  REQUIRE(s(emit().nop(6)) == "660F1F440000");
+  REQUIRE(s(emit().nop(9)) == "660F1F840000000000");
+  REQUIRE(s(emit().nop(10)) == "662E0F1F840000000000");
+  REQUIRE(s(emit().nop(15)) == "6666666666662E0F1F840000000000");
+  REQUIRE_THROWS_AS(emit().nop(0), std::out_of_range);
+  REQUIRE_THROWS_AS(emit().nop(16), std::out_of_range);
+}
+
+TEST_CASE("align") {
+  REQUIRE(s(emit().nop().align(8)) == "900F1F8000000000");
+  REQUIRE(s(emit().nop().align(4, padding::trap)) == "90CCCCCC");
+  REQUIRE(s(emit().nop().nop().align(2)) == "9090");
+  REQUIRE(s(emit().nop().align(1)) == "90");
+  REQUIRE(emit().nop().align(64).offset() == 64);
+  REQUIRE(s(emit().nop().align(32)).substr(2, 30) == "6666666666662E0F1F840000000000");
+  REQUIRE_THROWS_AS(emit().align(0), std::invalid_argument);
+  REQUIRE_THROWS_AS(emit().align(24), std::invalid_argument);
+}
+
+TEST_CASE("relax_align") {
+  auto emitter = emit();
+  const auto head = emitter.new_label();
+  const auto done = emitter.new_label();
+  emitter.jmp(done).align(16).bind(head).nop().jcc(cc::ne, head).bind(done).ret();
+  REQUIRE(emitter.offset(head) == 16);
+  emitter.relax();
+  /* The padding grows to keep the loop head aligned: */
+  REQUIRE(emitter.offset(head) == 16);
+  REQUIRE(emitter.offset(done) == 19);
+  REQUIRE(s(emitter) == "EB11" "66666666662E0F1F840000000000" "90" "75FD" "C3");
+}
+
+TEST_CASE("relax_align_widen") {
+  auto emitter = emit();
+  const auto head = emitter.new_label();
+  emitter.jmp(head).bind(head);
+  for (auto i = 0; i < 123; i++) {
+    emitter.nop();
+  }
+  emitter.align(16).nop().nop().nop().jcc(cc::ne, head);
+  REQUIRE(s(emitter).substr(2 * 131) == "7580");
+  emitter.relax();
+  /* Shortening the first jump grows the padding, which pushes the loop
+   * branch out of reach, so that it must be widened instead: */
+  REQUIRE(emitter.offset(head) == 2);
+  REQUIRE(emitter.offset() == 137);
+  const std::string code = s(emitter);
+  REQUIRE(code.substr(0, 4) == "EB00");
+  REQUIRE(code.substr(2 * 125, 6) == "0F1F00");
+  REQUIRE(code.substr(2 * 131) == "0F8579FFFFFF");
 }
@@ -25,6 +25,44 @@ TEST_CASE("for_armv8_aarch64") {
 }
 #endif
 
+#ifndef DISABLE_ARM
+TEST_CASE("armv8_aarch64_jmp") {
+  auto compiler = compiler_for_armv8_aarch64();
+  const auto done = compiler->new_label();
+  compiler->jmp(done).nop().bind(done).ret();
+  const auto& output = compiler->output();
+  REQUIRE(output.size() == 12);
+  REQUIRE(output.data()[0] == 0x02);             /* B #8 */
+  REQUIRE(output.data()[3] == 0x14);
+  REQUIRE(output.data()[11] == 0xD6);            /* RET */
+}
+#endif
+
+#ifndef DISABLE_ARM
+TEST_CASE("armv8_aarch64_frame") {
+  auto compiler = compiler_for_armv8_aarch64();
+  compiler->enter().leave();
+  const auto& output = compiler->output();
+  REQUIRE(output.size() == 12);
+  REQUIRE(output.data()[3] == 0xA9);             /* STP X29, X30, [SP, #-16]! */
+  REQUIRE(output.data()[7] == 0x91);             /* MOV X29, SP */
+  REQUIRE(output.data()[11] == 0xA8);            /* LDP X29, X30, [SP], #16 */
+}
+#endif
+
+#ifndef DISABLE_ARM
+TEST_CASE("armv8_aarch64_cmp") {
+  auto compiler = compiler_for_armv8_aarch64();
+  /* x0 = (x1 <u x2), without branching: */
+  compiler->cmp(condition::ltu, reg{0}, reg{1}, reg{2});
+  const auto& output = compiler->output();
+  REQUIRE(output.size() == 8);
+  REQUIRE(output.data()[3] == 0xEB);             /* CMP X1, X2 */
+  REQUIRE(output.data()[5] == 0x27);             /* CSET X0, LO */
+  REQUIRE(output.data()[7] == 0x9A);
+}
+#endif
+
 #ifndef DISABLE_MIPS
 TEST_CASE("for_mips32") {
   REQUIRE(compiler_for("mips32"));
@@ -32,9 +70,109 @@ TEST_CASE("for_mips32") {
 }
 #endif
 
+#ifndef DISABLE_MIPS
+TEST_CASE("mips32_jmp") {
+  auto compiler = compiler_for_mips32();
+  const auto done = compiler->new_label();
+  compiler->jmp(done).nop().bind(done).nop();
+  REQUIRE(compiler->output().size() == 16);
+  REQUIRE(compiler->output().data()[0] == 0x02);   /* B +8 */
+  REQUIRE(compiler->output().data()[3] == 0x10);
+}
+#endif
+
+#ifndef DISABLE_MIPS
+TEST_CASE("mips32_cmp") {
+  auto compiler = compiler_for_mips32();
+  REQUIRE_THROWS_AS(compiler->cmp(condition::lt, reg{2}, reg{4}, reg{5}), std::logic_error);
+  REQUIRE(compiler->output().size() == 0);
+}
+#endif
+
 #ifndef DISABLE_X86
 TEST_CASE("for_x86_64") {
   REQUIRE(compiler_for("x86-64"));
   REQUIRE(compiler_for_x86_64());
 }
 #endif
+
+#ifndef DISABLE_X86
+TEST_CASE("x86_64_jmp") {
+  auto compiler = compiler_for_x86_64();
+  const auto done = compiler->new_label();
+  compiler->jmp(done).nop().bind(done).ret();
+  REQUIRE(compiler->output().size() == 7);
+  compiler->relax();
+  REQUIRE(compiler->output().size() == 4);
+  REQUIRE(compiler->output().data()[0] == 0xEB);
+  REQUIRE(compiler->output().data()[1] == 0x01);
+}
+#endif
+
+#ifndef DISABLE_X86
+TEST_CASE("x86_64_align") {
+  auto compiler = compiler_for_x86_64();
+  compiler->nop().align(16);
+  REQUIRE(compiler->output().size() == 16);
+  compiler->align(32, padding::trap);
+  REQUIRE(compiler->output().size() == 32);
+  REQUIRE(compiler->output().data()[31] == 0xCC);
+}
+#endif
+
+#ifndef DISABLE_X86
+TEST_CASE("x86_64_cmp") {
+  auto compiler = compiler_for_x86_64();
+  /* rax = (rdi < rsi), without branching: */
+  compiler->cmp(condition::lt, reg{0}, reg{7}, reg{6});
+  REQUIRE(compiler->output().size() == 8);
+  REQUIRE(compiler->output().data()[0] == 0x31);   /* XOR EAX, EAX */
+  REQUIRE(compiler->output().data()[2] == 0x48);   /* CMP RDI, RSI */
+  REQUIRE(compiler->output().data()[6] == 0x9C);   /* SETL AL */
+
+  /* rdi = (rdi == rsi), zero-extending afterwards: */
+  auto other = compiler_for_x86_64();
+  other->cmp(condition::eq, reg{7}, reg{7}, reg{6});
+  REQUIRE(other->output().size() == 3 + 4 + 4);
+  REQUIRE(other->output().data()[3] == 0x40);      /* SETE DIL */
+  REQUIRE(other->output().data()[7] == 0x40);      /* MOVZX EDI, DIL */
+}
+#endif
+
+#if !defined(DISABLE_X86) && defined(__x86_64__)
+TEST_CASE("x86_64_clz") {
+  auto compiler = compiler_for_x86_64();
+  /* rax = clz(rdi): */
+  compiler->clz(reg{0}, reg{7}).ret();
+  const auto& output = compiler->output();
+  executable_buffer buffer;
+  for (auto i = 0UL; i < output.size(); i++) {
+    buffer.append(output.data()[i]);
+  }
+  const auto clz = buffer.finalize<std::uint64_t(std::uint64_t)>();
+  REQUIRE(clz(1) == 63);
+  REQUIRE(clz(1ULL << 40) == 23);
+  REQUIRE(clz(~0ULL) == 0);
+  REQUIRE(clz(0) == 64);
+}
+
+TEST_CASE("x86_64_clz_without_lzcnt") {
+  cpu_features::override_host(cpu_features::detect().reset(cpu_feature::lzcnt));
+  auto compiler = compiler_for_x86_64();
+  cpu_features::reset_host();
+  REQUIRE(!compiler->features().has(cpu_feature::lzcnt));
+  compiler->clz(reg{0}, reg{7}).ret();
+  const auto& output = compiler->output();
+  REQUIRE(output.data()[0] == 0x48);                 /* BSR RAX, RDI */
+  REQUIRE(output.data()[2] == 0xBD);
+  executable_buffer buffer;
+  for (auto i = 0UL; i < output.size(); i++) {
+    buffer.append(output.data()[i]);
+  }
+  const auto clz = buffer.finalize<std::uint64_t(std::uint64_t)>();
+  REQUIRE(clz(1) == 63);
+  REQUIRE(clz(1ULL << 40) == 23);
+  REQUIRE(clz(~0ULL) == 0);
+  REQUIRE(clz(0) == 64);
+}
+#endif
@@ -9,8 +9,224 @@
 #include <machinery.h>
 #include <machinery/util/buffer.h>
 
+#include <cstdio>   /* for std::fread(), std::rewind(), std::tmpfile() */
+#include <unistd.h> /* for lseek(), pread() */
+#include <utility>  /* for std::move() */
+
 using namespace machinery::util;
 
 TEST_CASE("test_util_buffer") {
   // TODO
 }
+
+TEST_CASE("executable_buffer_grow") {
+  executable_buffer buffer;
+  const auto initial_capacity = buffer.capacity();
+  for (auto i = 0UL; i < initial_capacity * 3; i++) {
+    buffer.append(static_cast<std::uint8_t>(i));
+  }
+  REQUIRE(buffer.size() == initial_capacity * 3);
+  REQUIRE(buffer.capacity() >= buffer.size());
+  for (auto i = 0UL; i < buffer.size(); i++) {
+    REQUIRE(buffer.data()[i] == static_cast<std::uint8_t>(i));
+  }
+}
+
+TEST_CASE("executable_buffer_reserve") {
+  executable_buffer buffer;
+  buffer.reserve(1 << 20);
+  REQUIRE(buffer.capacity() >= (1 << 20));
+  const auto data = buffer.data();
+  for (auto i = 0; i < (1 << 20); i++) {
+    buffer.append(0x90);
+  }
+  REQUIRE(buffer.data() == data);
+  REQUIRE(buffer.size() == (1 << 20));
+}
+
+TEST_CASE("executable_buffer_copy") {
+  appendable_buffer code;
+  code.append(0x90).append(0xC3);
+  executable_buffer buffer(code);
+  REQUIRE(buffer.size() == 2);
+  REQUIRE(buffer.data()[1] == 0xC3);
+}
+
+TEST_CASE("executable_buffer_move") {
+  executable_buffer buffer;
+  buffer.append(0xC3);
+  executable_buffer other(std::move(buffer));
+  REQUIRE(buffer.data() == nullptr);
+  REQUIRE(other.size() == 1);
+  buffer = std::move(other);
+  REQUIRE(buffer.size() == 1);
+  REQUIRE(other.data() == nullptr);
+}
+
+TEST_CASE("executable_buffer_dual_mapped") {
+  executable_buffer buffer(0, executable_mode::dual_mapped);
+  REQUIRE(buffer.mode() == executable_mode::dual_mapped);
+  REQUIRE(buffer.code() != buffer.data());
+  buffer.append({0xB8, 0x2A, 0x00, 0x00, 0x00, 0xC3});
+  REQUIRE(buffer.code()[0] == 0xB8);
+  REQUIRE(buffer.code()[5] == 0xC3);
+#if defined(__x86_64__)
+  REQUIRE(buffer.execute<int>() == 42);
+#endif
+  buffer.reserve(buffer.capacity() * 4);
+  REQUIRE(buffer.code()[5] == 0xC3);
+#if defined(__x86_64__)
+  REQUIRE(buffer.execute<int>() == 42);
+#endif
+}
+
+TEST_CASE("executable_buffer_page_policy") {
+  for (const auto mode : {executable_mode::rwx, executable_mode::dual_mapped}) {
+    for (const auto policy : {page_policy::normal, page_policy::transparent_huge, page_policy::huge}) {
+      executable_buffer buffer(0, mode, policy);
+      REQUIRE(buffer.policy() <= policy);
+      if (buffer.policy() != page_policy::normal) {
+        REQUIRE((buffer.capacity() % executable_mapping::huge_page_size) == 0);
+      }
+      buffer.append(0xC3);
+      buffer.reserve(buffer.capacity() + 1);
+      REQUIRE(buffer.policy() <= policy);
+      REQUIRE(buffer.code()[0] == 0xC3);
+    }
+  }
+}
+
+TEST_CASE("persistent_buffer_stream") {
+  FILE* const stream = std::tmpfile();
+  REQUIRE(stream != nullptr);
+  std::uint8_t bytes[8] = {};
+  {
+    persistent_buffer buffer(stream, 4);
+    buffer.append({0x01, 0x02, 0x03});
+    buffer.append({0x04, 0x05, 0x06});
+    REQUIRE(buffer.size() == 6);
+    REQUIRE(buffer.offset() == 6);
+    const std::uint8_t fixup[] = {0xAA, 0xBB};
+    buffer.patch(2, fixup, 2);        /* straddles a flushed block */
+    buffer.patch(0, fixup, 1);        /* entirely flushed */
+    buffer.patch(5, fixup + 1, 1);    /* entirely buffered */
+    buffer.append(0x07);
+    persistent_buffer moved(std::move(buffer));
+    REQUIRE(moved.size() == 7);
+  }
+  std::rewind(stream);
+  REQUIRE(std::fread(bytes, 1, sizeof(bytes), stream) == 7);
+  REQUIRE(bytes[0] == 0xAA);
+  REQUIRE(bytes[1] == 0x02);
+  REQUIRE(bytes[2] == 0xAA);
+  REQUIRE(bytes[3] == 0xBB);
+  REQUIRE(bytes[4] == 0x05);
+  REQUIRE(bytes[5] == 0xBB);
+  REQUIRE(bytes[6] == 0x07);
+  std::fclose(stream);
+}
+
+TEST_CASE("persistent_buffer_mapped") {
+  FILE* const stream = std::tmpfile();
+  REQUIRE(stream != nullptr);
+  const int fd = fileno(stream);
+  std::uint8_t bytes[2] = {};
+  {
+    persistent_buffer buffer(fd, 1);
+    const std::size_t capacity = buffer.capacity();
+    for (std::size_t i = 0; i <= capacity; i++) {
+      buffer.append(static_cast<std::uint8_t>(i));
+    }
+    REQUIRE(buffer.capacity() > capacity);
+    const std::uint8_t fixup[] = {0xAA};
+    buffer.patch(1, fixup, 1);
+  }
+  REQUIRE(::pread(fd, bytes, sizeof(bytes), 0) == 2);
+  REQUIRE(bytes[0] == 0x00);
+  REQUIRE(bytes[1] == 0xAA);
+  REQUIRE(::lseek(fd, 0, SEEK_END) == static_cast<off_t>(executable_mapping::page_size() + 1));
+  std::fclose(stream);
+}
+
+TEST_CASE("persistent_buffer_invalid") {
+  REQUIRE_THROWS_AS(persistent_buffer(static_cast<FILE*>(nullptr)), std::invalid_argument);
+  REQUIRE_THROWS_AS(persistent_buffer(-1, 1), std::invalid_argument);
+}
+
+TEST_CASE("static_buffer") {
+  static_buffer<4> buffer;
+  REQUIRE(buffer.capacity() == 4);
+  buffer.append({0x01, 0x02, 0x03});
+  const std::uint8_t fixup[] = {0xAA};
+  buffer.patch(1, fixup, 1);
+  REQUIRE(buffer.data()[1] == 0xAA);
+  REQUIRE_THROWS_AS(buffer.extend(2), std::length_error);
+  REQUIRE(buffer.size() == 3);
+  buffer.clear().append(0x04);
+  REQUIRE(buffer.size() == 1);
+}
+
+TEST_CASE("counting_buffer") {
+  counting_buffer buffer;
+  buffer.append(0x01).append({0x02, 0x03});
+  buffer.extend(100)[99] = 0x04;
+  REQUIRE(buffer.size() == 103);
+  REQUIRE(buffer.data() == nullptr);
+  buffer.clear();
+  REQUIRE(buffer.size() == 0);
+}
+
+TEST_CASE("executable_buffer_finalize") {
+  for (const auto mode : {executable_mode::rwx, executable_mode::dual_mapped}) {
+    executable_buffer buffer(0, mode);
+    buffer.append({0xB8, 0x2A, 0x00, 0x00, 0x00, 0xC3});
+    const std::uint8_t* const code = buffer.code();
+    function_handle function = buffer.finalize();
+    REQUIRE(buffer.size() == 0);
+    REQUIRE(function);
+    REQUIRE(function.code() == code);
+    REQUIRE(function.size() == 6);
+    REQUIRE(function.code()[5] == 0xC3);
+#if defined(__x86_64__)
+    REQUIRE(function.execute<int>() == 42);
+#endif
+    function_handle moved(std::move(function));
+    REQUIRE(!function);
+    REQUIRE(moved.code() == code);
+  }
+}
+
+TEST_CASE("executable_mapping_seal") {
+  executable_mapping mapping(1, executable_mode::rwx);
+  mapping.data()[0] = 0xC3;
+  mapping.seal();
+  REQUIRE(mapping.sealed());
+  REQUIRE(mapping.data() == nullptr);
+  REQUIRE(mapping.code()[0] == 0xC3);
+  REQUIRE_THROWS_AS(mapping.resize(mapping.size() * 2), std::logic_error);
+}
+
+TEST_CASE("executable_mapping_seal_dual_mapped") {
+  executable_mapping mapping(1, executable_mode::dual_mapped);
+  mapping.data()[0] = 0xC3;
+  const std::uint8_t* const code = mapping.code();
+  mapping.seal();
+  REQUIRE(mapping.sealed());
+  REQUIRE(mapping.data() == nullptr);
+  REQUIRE(mapping.code() == code);
+  REQUIRE(mapping.code()[0] == 0xC3);
+  REQUIRE_THROWS_AS(mapping.resize(mapping.size() * 2), std::logic_error);
+}
+
+TEST_CASE("executable_buffer_finalize_typed") {
+  executable_buffer buffer;
+  buffer.append({0x8D, 0x04, 0x37});  /* LEA EAX, [RDI+RSI] */
+  buffer.append(0xC3);                /* RET */
+  const jit_function<int(int, int)> add = buffer.finalize<int(int, int)>();
+  REQUIRE(add);
+  REQUIRE(add.handle().size() == 4);
+  REQUIRE(reinterpret_cast<const std::uint8_t*>(add.get()) == add.handle().code());
+#if defined(__x86_64__) && !defined(_WIN32)
+  REQUIRE(add(40, 2) == 42);
+#endif
+}
@@ -0,0 +1,115 @@
+/* This is free and unencumbered software released into the public domain. */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include "catch.hpp"
+
+#include <machinery.h>
+#include <machinery/util/code_heap.h>
+
+#include <utility> /* for std::move() */
+#include <vector>  /* for std::vector */
+
+using namespace machinery::util;
+
+TEST_CASE("allocate") {
+  code_heap heap;
+  auto buffer = heap.allocate(10);
+  REQUIRE(buffer.capacity() == 16);
+  REQUIRE(buffer.size() == 0);
+  REQUIRE((reinterpret_cast<std::uintptr_t>(buffer.data()) % 16) == 0);
+  REQUIRE(heap.region_count() == 1);
+  REQUIRE(heap.allocated_size() == 16);
+}
+
+TEST_CASE("allocate_many") {
+  code_heap heap;
+  std::vector<code_heap_buffer> buffers;
+  for (auto i = 0; i < 10000; i++) {
+    buffers.push_back(heap.allocate(32));
+    buffers.back().append({0x90, 0xC3});
+  }
+  REQUIRE(heap.region_count() == 1);
+  REQUIRE(heap.allocated_size() == 10000 * 32);
+  REQUIRE(heap.occupancy() > 0.1);
+  REQUIRE(heap.fragmentation() == 0.0);
+}
+
+TEST_CASE("release_and_reuse") {
+  code_heap heap;
+  const std::uint8_t* data;
+  {
+    auto buffer = heap.allocate(64);
+    data = buffer.data();
+  }
+  REQUIRE(heap.allocated_size() == 0);
+  REQUIRE(heap.free_size() == 64);
+  REQUIRE(heap.fragmentation() == 1.0);
+  auto buffer = heap.allocate(64);
+  REQUIRE(buffer.data() == data);
+  REQUIRE(heap.free_size() == 0);
+}
+
+TEST_CASE("grow") {
+  code_heap heap;
+  auto buffer = heap.allocate(16);
+  for (auto i = 0; i < 1000; i++) {
+    buffer.append(static_cast<std::uint8_t>(i));
+  }
+  REQUIRE(buffer.size() == 1000);
+  REQUIRE(buffer.capacity() == 1024);
+  for (auto i = 0; i < 1000; i++) {
+    REQUIRE(buffer.data()[i] == static_cast<std::uint8_t>(i));
+  }
+  REQUIRE(heap.allocated_size() == 1024);
+}
+
+TEST_CASE("new_region") {
+  code_heap heap(4096);
+  auto buffer1 = heap.allocate(3000);
+  auto buffer2 = heap.allocate(3000);
+  REQUIRE(heap.region_count() == 2);
+  auto buffer3 = heap.allocate(4096 * 4);
+  REQUIRE(heap.region_count() == 3);
+  REQUIRE(buffer3.capacity() == 4096 * 4);
+}
+
+TEST_CASE("move") {
+  code_heap heap;
+  auto buffer = heap.allocate();
+  buffer.append(0xC3);
+  code_heap_buffer other(std::move(buffer));
+  REQUIRE(buffer.data() == nullptr);
+  REQUIRE(other.size() == 1);
+  REQUIRE(heap.allocated_size() == 16);
+}
+
+TEST_CASE("invalid_alignment") {
+  REQUIRE_THROWS_AS(code_heap(4096, 24), std::invalid_argument);
+}
+
+TEST_CASE("dual_mapped") {
+  code_heap heap(code_heap::default_region_size, code_heap::default_alignment,
+    executable_mode::dual_mapped);
+  auto buffer = heap.allocate();
+  REQUIRE(buffer.code() != buffer.data());
+  buffer.append({0xB8, 0x2A, 0x00, 0x00, 0x00, 0xC3});
+  REQUIRE(buffer.code()[5] == 0xC3);
+#if defined(__x86_64__)
+  REQUIRE(buffer.execute<int>() == 42);
+#endif
+}
+
+TEST_CASE("page_policy") {
+  code_heap heap(code_heap::default_region_size, code_heap::default_alignment,
+    executable_mode::rwx, page_policy::transparent_huge);
+  REQUIRE(heap.policy() == page_policy::transparent_huge);
+  auto buffer = heap.allocate();
+  REQUIRE(heap.policy() <= page_policy::transparent_huge);
+  if (heap.policy() == page_policy::transparent_huge) {
+    const auto address = reinterpret_cast<std::uintptr_t>(buffer.data());
+    REQUIRE((address % executable_mapping::huge_page_size) == 0);
+  }
+}
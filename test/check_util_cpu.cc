@@ -0,0 +1,76 @@
+/* This is free and unencumbered software released into the public domain. */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include "catch.hpp"
+
+#include <machinery.h>
+#include <machinery/util/cpu.h>
+
+#include <cstring> /* for std::strcmp() */
+
+using namespace machinery::util;
+
+TEST_CASE("empty") {
+  const cpu_features features;
+  for (auto i = 0U; i < static_cast<unsigned>(cpu_feature::count); i++) {
+    REQUIRE(!features.has(static_cast<cpu_feature>(i)));
+  }
+}
+
+TEST_CASE("set_and_reset") {
+  cpu_features features;
+  features.set(cpu_feature::avx2).set(cpu_feature::bmi2);
+  REQUIRE(features.has(cpu_feature::avx2));
+  REQUIRE(features.has(cpu_feature::bmi2));
+  REQUIRE(!features.has(cpu_feature::avx));
+  features.reset(cpu_feature::avx2);
+  REQUIRE(!features.has(cpu_feature::avx2));
+  REQUIRE(features == cpu_features().set(cpu_feature::bmi2));
+}
+
+TEST_CASE("names") {
+  REQUIRE(cpu_features::lookup("avx512f") == cpu_feature::avx512f);
+  REQUIRE(cpu_features::lookup("atomics") == cpu_feature::atomics);
+  REQUIRE(cpu_features::lookup("unknown") == cpu_feature::count);
+  for (auto i = 0U; i < static_cast<unsigned>(cpu_feature::count); i++) {
+    const auto feature = static_cast<cpu_feature>(i);
+    REQUIRE(cpu_features::lookup(cpu_features::name_of(feature)) == feature);
+  }
+}
+
+TEST_CASE("detect") {
+  const cpu_features features = cpu_features::detect();
+  REQUIRE(cpu_features::host() == features);
+#if defined(__x86_64__)
+  REQUIRE(features.has(cpu_feature::sse2));
+#endif
+#if defined(__x86_64__) || defined(__i386__)
+  REQUIRE(!features.has(cpu_feature::asimd));
+  if (features.has(cpu_feature::avx2)) {
+    REQUIRE(features.has(cpu_feature::avx));
+  }
+  if (features.has(cpu_feature::avx512vl)) {
+    REQUIRE(features.has(cpu_feature::avx512f));
+  }
+#endif
+}
+
+TEST_CASE("override_host") {
+  const cpu_features detected = cpu_features::detect();
+  const cpu_features baseline = cpu_features().set(cpu_feature::sse2);
+  cpu_features::override_host(baseline);
+  REQUIRE(cpu_features::host() == baseline);
+  REQUIRE(machinery_cpu_feature_exists("sse2"));
+  REQUIRE(!machinery_cpu_feature_exists("avx2"));
+  cpu_features::reset_host();
+  REQUIRE(cpu_features::host() == detected);
+}
+
+TEST_CASE("feature_exists") {
+  REQUIRE(machinery_feature_exists("ascii"));
+  REQUIRE(!machinery_feature_exists("unknown"));
+  REQUIRE(!machinery_cpu_feature_exists("unknown"));
+}